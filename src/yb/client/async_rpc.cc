@@ -714,6 +714,12 @@ ReadRpc::ReadRpc(const AsyncRpcData& data, YBConsistencyLevel yb_consistency_lev
   VTRACE_TO(1, trace_, "Tablet $0 table $1", data.tablet->tablet_id(), table()->name().ToString());
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(data.batcher->proxy_uuid());
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    auto read_your_writes_ht = data.batcher->read_your_writes_ht();
+    if (read_your_writes_ht && read_your_writes_ht != HybridTime::kMin) {
+      req_.set_read_your_writes_ht(read_your_writes_ht.ToUint64());
+    }
+  }
 
   switch (table()->table_type()) {
     case YBTableType::REDIS_TABLE_TYPE:
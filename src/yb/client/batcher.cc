@@ -707,6 +707,16 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
 
   if (s.ok() && rpc.resp().has_propagated_hybrid_time()) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
+    // Writes of a transaction become visible at its commit time, so only non-transactional writes
+    // are tracked. Write hybrid time is not reported when a retried write was already applied, in
+    // this case propagated hybrid time is used, since it is not less than the write hybrid time.
+    if (read_your_writes_ht_ && !transaction_) {
+      const auto& resp = rpc.resp();
+      UpdateAtomicMax(
+          read_your_writes_ht_.get(),
+          HybridTime(resp.has_write_hybrid_time() ? resp.write_hybrid_time()
+                                                  : resp.propagated_hybrid_time()));
+    }
   }
 
   // Check individual row errors.
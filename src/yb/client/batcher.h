@@ -241,6 +241,17 @@ class Batcher : public Runnable, public std::enable_shared_from_this<Batcher> {
 
   double RejectionScore(int attempt_num);
 
+  void SetReadYourWritesTime(std::shared_ptr<std::atomic<HybridTime>> read_your_writes_ht) {
+    read_your_writes_ht_ = std::move(read_your_writes_ht);
+  }
+
+  // Returns hybrid time of the last non-transactional write of the session, that consistent prefix
+  // reads should observe, or invalid hybrid time if the session is not in read-your-writes mode.
+  HybridTime read_your_writes_ht() const {
+    return read_your_writes_ht_ ? read_your_writes_ht_->load(std::memory_order_acquire)
+                                : HybridTime::kInvalid;
+  }
+
   // Returns errors occurred due tablet resolution or flushing operations to tablet server(s).
   // Caller takes ownership of the returned errors.
   CollectedErrors GetAndClearPendingErrors();
@@ -341,6 +352,9 @@ class Batcher : public Runnable, public std::enable_shared_from_this<Batcher> {
 
   RejectionScoreSourcePtr rejection_score_source_;
 
+  // Shared with the session, updated with hybrid times of completed writes.
+  std::shared_ptr<std::atomic<HybridTime>> read_your_writes_ht_;
+
   // Set of retryable request ids used in current batcher.
   // When creating WriteRpc, new ids will be registered into this set.
   // If the batcher has requests to be retried, request id is removed from current batcher
@@ -56,6 +56,7 @@ DECLARE_int32(yb_num_shards_per_tserver);
 DECLARE_int64(db_block_cache_size_bytes);
 DECLARE_bool(flush_rocksdb_on_shutdown);
 DECLARE_uint64(max_stale_read_bound_time_ms);
+DECLARE_bool(TEST_reject_follower_read_your_writes);
 
 using namespace std::literals;
 
@@ -1290,6 +1291,44 @@ TEST_F(QLDmlTest, ReadFollower) {
   ASSERT_TRUE(missing_rows.empty()) << "Missing rows: " << yb::ToString(missing_rows);
 }
 
+// Consistent prefix reads of the session in read-your-writes mode should observe its previous
+// writes, even when they are served by a follower.
+TEST_F(QLDmlTest, ReadFollowerReadYourWrites) {
+  constexpr int kNumRows = RegularBuildVsSanitizers(500, 100);
+
+  auto session = NewSession();
+  session->SetReadYourWrites(true);
+  ASSERT_EQ(session->read_your_writes_ht(), HybridTime::kMin);
+  for (int i = 0; i != kNumRows; ++i) {
+    InsertRow(session, KeyForIndex(i), ValueForIndex(i));
+    ASSERT_OK(session->TEST_Flush());
+    auto row = ASSERT_RESULT(
+        ReadRow(session, KeyForIndex(i), YBConsistencyLevel::CONSISTENT_PREFIX));
+    ASSERT_EQ(row, ValueForIndex(i));
+  }
+  ASSERT_GT(session->read_your_writes_ht(), HybridTime::kMin);
+
+  session->SetReadYourWrites(false);
+  ASSERT_FALSE(session->read_your_writes_ht().is_valid());
+}
+
+// A read rejected by stale followers should be retried at other replicas, and finally at the
+// leader, instead of at the closest follower until the deadline.
+TEST_F(QLDmlTest, ReadFollowerReadYourWritesFallbackToLeader) {
+  constexpr int kNumRows = 10;
+  FLAGS_TEST_reject_follower_read_your_writes = true;
+
+  auto session = NewSession();
+  session->SetReadYourWrites(true);
+  for (int i = 0; i != kNumRows; ++i) {
+    InsertRow(session, KeyForIndex(i), ValueForIndex(i));
+    ASSERT_OK(session->TEST_Flush());
+    auto row = ASSERT_RESULT(
+        ReadRow(session, KeyForIndex(i), YBConsistencyLevel::CONSISTENT_PREFIX));
+    ASSERT_EQ(row, ValueForIndex(i));
+  }
+}
+
 TEST_F(QLDmlTest, DeletePartialRangeKey) {
   auto session = NewSession();
   RowKey row_key{1, "a", 2, "b"};
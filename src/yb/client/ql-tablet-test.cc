@@ -74,6 +74,7 @@
 #include "yb/util/shared_lock.h"
 #include "yb/util/status_format.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/test_thread_holder.h"
 #include "yb/util/tsan_util.h"
 
 #include "yb/yql/cql/ql/util/statement_result.h"
@@ -113,6 +114,8 @@ DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(TEST_backfill_sabotage_frequency);
 DECLARE_string(regular_tablets_data_block_key_value_encoding);
 DECLARE_string(compression_type);
+DECLARE_uint32(tablet_max_concurrent_apply_writes);
+DECLARE_int32(TEST_concurrent_apply_delay_ms);
 
 namespace yb {
 namespace client {
@@ -1649,6 +1652,56 @@ TEST_F(QLTabletTest, FollowerRestartDuringWrite) {
   }
 }
 
+TEST_F(QLTabletTest, ConcurrentApplyWrites) {
+  constexpr size_t kMaxConcurrentApplies = 4;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_tablet_max_concurrent_apply_writes) = kMaxConcurrentApplies;
+  // Slow applies let committed rounds accumulate, and make applies of the same wave overlap.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_TEST_concurrent_apply_delay_ms) = 20;
+
+  constexpr int kNumWriters = 8;
+  constexpr int kKeysPerWriter = 100;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+
+  TestThreadHolder thread_holder;
+  for (int writer = 0; writer != kNumWriters; ++writer) {
+    thread_holder.AddThreadFunctor([this, writer, &table] {
+      auto session = CreateSession();
+      for (int key = writer * kKeysPerWriter; key != (writer + 1) * kKeysPerWriter; ++key) {
+        // The same row is written twice, so committed batches contain conflicting writes.
+        SetValue(session, key, -key, table);
+        SetValue(session, key, ValueForKey(key), table);
+      }
+    });
+  }
+  thread_holder.JoinAll();
+
+  constexpr int kTotalWrittenKeys = kNumWriters * kKeysPerWriter;
+  VerifyTable(0, kTotalWrittenKeys, table);
+  ASSERT_OK(WaitSync(0, kTotalWrittenKeys, table));
+
+  // Check that writes were actually applied concurrently, not just applied correctly.
+  size_t max_concurrent_applies = 0;
+  for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    for (const auto& peer :
+             cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers()) {
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        max_concurrent_applies = std::max(
+            max_concurrent_applies, tablet->TEST_MaxConcurrentApplies());
+      }
+    }
+  }
+  LOG(INFO) << "Max concurrent applies: " << max_concurrent_applies;
+  ASSERT_GE(max_concurrent_applies, 2U);
+  ASSERT_LE(max_concurrent_applies, kMaxConcurrentApplies);
+
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyTable(0, kTotalWrittenKeys, table);
+}
+
 TEST_F_EX(QLTabletTest, DataBlockKeyValueEncoding, QLTabletRf1Test) {
   // Key encoding gives benefits only when keys are nearly similar, for instance different columns
   // of the same row.
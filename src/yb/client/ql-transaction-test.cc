@@ -34,8 +34,11 @@
 
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/transaction_coordinator.h"
+#include "yb/tablet/transaction_participant.h"
+#include "yb/tablet/transaction_status_batcher.h"
 
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
@@ -44,6 +47,7 @@
 
 #include "yb/util/async_util.h"
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
@@ -62,6 +66,7 @@ DECLARE_bool(TEST_disable_proactive_txn_cleanup_on_abort);
 DECLARE_bool(TEST_fail_in_apply_if_no_metadata);
 DECLARE_bool(TEST_master_fail_transactional_tablet_lookups);
 DECLARE_bool(TEST_transaction_allow_rerequest_status);
+DECLARE_bool(batch_transaction_status_requests);
 DECLARE_bool(delete_intents_sst_files);
 DECLARE_bool(enable_load_balancing);
 DECLARE_bool(fail_on_out_of_range_clock_skew);
@@ -71,10 +76,13 @@ DECLARE_int32(TEST_delay_init_tablet_peer_ms);
 DECLARE_int32(log_min_seconds_to_retain);
 DECLARE_int32(remote_bootstrap_max_chunk_size);
 DECLARE_int64(transaction_rpc_timeout_ms);
+DECLARE_uint64(TEST_inject_txn_get_status_delay_ms);
 DECLARE_uint64(TEST_transaction_delay_status_reply_usec_in_tests);
 DECLARE_uint64(aborted_intent_cleanup_ms);
 DECLARE_uint64(max_clock_skew_usec);
 DECLARE_uint64(transaction_heartbeat_usec);
+DECLARE_uint64(transaction_status_cache_ttl_ms);
+DECLARE_uint64(txn_max_cached_intents_bytes);
 
 namespace yb {
 namespace client {
@@ -585,6 +593,56 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+TEST_F(QLTransactionTest, CachedIntents) {
+  FLAGS_txn_max_cached_intents_bytes = 1_MB;
+
+  auto cached_intents_bytes = [this] {
+    size_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      auto participant = peer->tablet()->transaction_participant();
+      result += participant ? participant->TEST_CachedIntentsBytes() : 0;
+    }
+    return result;
+  };
+  auto applied_from_cached_intents = [this] {
+    int64_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      result += peer->tablet()->metrics()->transactions_applied_from_cached_intents->value();
+    }
+    return result;
+  };
+
+  auto txn = CreateTransaction();
+  ASSERT_OK(WriteRows(CreateSession(txn)));
+  // Intents are cached while the transaction is running, but still written to the intents DB.
+  const auto bytes_before_commit = cached_intents_bytes();
+  ASSERT_GT(bytes_before_commit, 0);
+  ASSERT_GT(CountIntents(cluster_.get()), 0);
+  ASSERT_EQ(applied_from_cached_intents(), 0);
+  ASSERT_OK(WriteRows(CreateSession(txn), 1));
+  ASSERT_GT(cached_intents_bytes(), bytes_before_commit);
+  ASSERT_EQ(applied_from_cached_intents(), 0);
+  ASSERT_OK(txn->CommitFuture().get());
+  ASSERT_OK(WaitFor([&cached_intents_bytes] { return cached_intents_bytes() == 0; },
+                    10s * kTimeMultiplier, "Cached intents released"));
+  ASSERT_NO_FATALS(VerifyRows(CreateSession(), 0));
+  ASSERT_NO_FATALS(VerifyRows(CreateSession(), 1));
+  // Each replica of each tablet touched by the transaction applied it from cached intents.
+  const auto applied = applied_from_cached_intents();
+  ASSERT_GT(applied, 0);
+
+  // Intents of transactions that do not fit into the limit are applied from the intents DB.
+  FLAGS_txn_max_cached_intents_bytes = 1;
+  ASSERT_NO_FATALS(WriteData(WriteOpType::UPDATE));
+  ASSERT_EQ(cached_intents_bytes(), 0);
+  ASSERT_EQ(applied_from_cached_intents(), applied);
+  ASSERT_NO_FATALS(VerifyData(WriteOpType::UPDATE));
+
+  ASSERT_OK(cluster_->RestartSync());
+  ASSERT_NO_FATALS(VerifyData(WriteOpType::UPDATE));
+  AssertNoRunningTransactions();
+}
+
 void QLTransactionTest::TestReadOnlyTablets(IsolationLevel isolation_level,
                                             bool perform_write,
                                             bool written_intents_expected) {
@@ -789,6 +847,45 @@ TEST_F(QLTransactionTest, ResolveIntentsWriteReadUpdateRead) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, ResolveIntentsBatchStatusRequests) {
+  FLAGS_batch_transaction_status_requests = true;
+  // Disable the cache, so requests that did not result in RPCs were batched.
+  FLAGS_transaction_status_cache_ttl_ms = 0;
+  // Keep status RPCs in flight for a while, so requests of other tablets are queued meanwhile.
+  FLAGS_TEST_inject_txn_get_status_delay_ms = 50;
+  DisableApplyingIntents();
+
+  auto batchers_stats = [this] {
+    size_t num_requests = 0;
+    size_t num_rpcs = 0;
+    for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto* batcher = cluster_->mini_tablet_server(i)->server()->tablet_manager()->
+          TEST_transaction_status_batcher();
+      num_requests += batcher->TEST_num_requests();
+      num_rpcs += batcher->TEST_num_rpcs();
+    }
+    return std::make_pair(num_requests, num_rpcs);
+  };
+
+  // Intents of each transaction are resolved by several tablets, that share the status batcher.
+  constexpr size_t kNumTransactions = 5;
+  for (size_t i = 0; i != kNumTransactions; ++i) {
+    WriteData(WriteOpType::INSERT, i);
+  }
+  VerifyData(kNumTransactions);
+
+  WriteData(WriteOpType::UPDATE);
+  VerifyData(1, WriteOpType::UPDATE);
+
+  auto [num_requests, num_rpcs] = batchers_stats();
+  LOG(INFO) << "Status requests: " << num_requests << ", RPCs: " << num_rpcs;
+  ASSERT_GT(num_rpcs, 0);
+  ASSERT_LT(num_rpcs, num_requests);
+
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyData(1, WriteOpType::UPDATE);
+}
+
 TEST_F(QLTransactionTest, ResolveIntentsWriteReadWithinTransactionAndRollback) {
   SetAtomicFlag(0ULL, &FLAGS_max_clock_skew_usec); // To avoid read restart in this test.
   DisableApplyingIntents();
@@ -92,6 +92,22 @@ void YBSession::SetRejectionScoreSource(RejectionScoreSourcePtr rejection_score_
   batcher_config_.rejection_score_source = std::move(rejection_score_source);
 }
 
+void YBSession::SetReadYourWrites(bool value) {
+  if (value == (batcher_config_.read_your_writes_ht != nullptr)) {
+    return;
+  }
+  batcher_config_.read_your_writes_ht =
+      value ? std::make_shared<std::atomic<HybridTime>>(HybridTime::kMin) : nullptr;
+  if (batcher_) {
+    batcher_->SetReadYourWritesTime(batcher_config_.read_your_writes_ht);
+  }
+}
+
+HybridTime YBSession::read_your_writes_ht() const {
+  const auto& ht = batcher_config_.read_your_writes_ht;
+  return ht ? ht->load(std::memory_order_acquire) : HybridTime::kInvalid;
+}
+
 YBSession::~YBSession() {
   WARN_NOT_OK(Close(true), "Closed Session with pending operations.");
 }
@@ -136,6 +152,7 @@ internal::BatcherPtr CreateBatcher(const YBSession::BatcherConfig& config) {
       config.client, config.session.lock(), config.transaction, config.read_point(),
       config.force_consistent_read);
   batcher->SetRejectionScoreSource(config.rejection_score_source);
+  batcher->SetReadYourWritesTime(config.read_your_writes_ht);
   return batcher;
 }
 
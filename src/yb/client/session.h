@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <unordered_set>
 
@@ -234,6 +235,13 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void SetRejectionScoreSource(RejectionScoreSourcePtr rejection_score_source);
 
+  // Enables read-your-writes mode for consistent prefix reads of this session. Such reads are still
+  // served by followers, but only after their safe time reaches the last write of this session.
+  void SetReadYourWrites(bool value);
+
+  // Hybrid time of the last write of this session, tracked in read-your-writes mode only.
+  HybridTime read_your_writes_ht() const;
+
   struct BatcherConfig {
     std::weak_ptr<YBSession> session;
     client::YBClient* client;
@@ -242,6 +250,8 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
     bool allow_local_calls_in_curr_thread = true;
     bool force_consistent_read = false;
     RejectionScoreSourcePtr rejection_score_source;
+    // Max hybrid time of writes made by this session, null when read-your-writes mode is off.
+    std::shared_ptr<std::atomic<HybridTime>> read_your_writes_ht;
 
     ConsistentReadPoint* read_point() const;
   };
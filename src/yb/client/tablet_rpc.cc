@@ -97,8 +97,14 @@ void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
 
   std::vector<RemoteTabletServer*> candidates;
   current_ts_ = client_->data_->SelectTServer(tablet_.get(),
-                                              YBClient::ReplicaSelection::CLOSEST_REPLICA, {},
-                                              &candidates);
+                                              YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                              stale_followers_, &candidates);
+  if (!current_ts_ && !stale_followers_.empty()) {
+    VLOG(1) << "All replicas are stale followers: " << AsString(stale_followers_)
+            << ", using leader";
+    SelectTabletServer();
+    return;
+  }
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
@@ -271,7 +277,12 @@ Status TabletInvoker::FailToNewReplica(const Status& reason,
                                        const tserver::TabletServerErrorPB* error_code) {
   TRACE_TO(trace_, "FailToNewReplica($0)", reason.ToString());
   if (ErrorCode(error_code) == tserver::TabletServerErrorPB::STALE_FOLLOWER) {
-    VLOG(1) << "Stale follower for " << command_->ToString() << " just retry";
+    VLOG(1) << "Stale follower for " << command_->ToString() << ", retrying with a different "
+            << "replica";
+    // Closest replica selection would pick the same follower again, so exclude it.
+    if (current_ts_) {
+      stale_followers_.insert(current_ts_->permanent_uuid());
+    }
   } else if (ErrorCode(error_code) == tserver::TabletServerErrorPB::NOT_THE_LEADER) {
     VLOG(1) << "Not the leader for " << command_->ToString()
             << " retrying with a different replica";
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_set>
 
@@ -167,6 +168,10 @@ class TabletInvoker {
 
   std::unordered_map<RemoteTabletServer*, FollowerData> followers_;
 
+  // Permanent uuids of replicas that rejected this consistent prefix read as stale followers. They
+  // are not selected on retry, and when no other replica is left the read is sent to the leader.
+  std::set<std::string> stale_followers_;
+
   const bool local_tserver_only_;
 
   const bool consistent_prefix_;
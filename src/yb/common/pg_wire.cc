@@ -13,12 +13,11 @@
 //
 //--------------------------------------------------------------------------------------------------
 
-#include "yb/yql/pggate/util/pg_wire.h"
+#include "yb/common/pg_wire.h"
 
 #include "yb/gutil/endian.h"
 
 namespace yb {
-namespace pggate {
 
 void PgWire::WriteBool(bool value, WriteBuffer *buffer) {
   buffer->Append(pointer_cast<const char*>(&value), sizeof(bool));
@@ -150,5 +149,4 @@ size_t PgWire::ReadString(Slice *cursor, std::string *value, int64_t bytes) {
   return bytes;
 }
 
-}  // namespace pggate
 }  // namespace yb
@@ -22,13 +22,9 @@ namespace yb {
 
 class WriteBuffer;
 
-namespace pggate {
-
 // This class represent how YugaByte sends data over the wire. See also file
 // "yb/common/wire_protocol.proto".
-//
-// TODO(neil) Consider moving this file to "yb/common" directory and merging and organizing with
-// the existing functions in "wire_protocol.*" accordingly.
+// It is shared by pggate, which reads the data, and DocDB, which writes YSQL read results.
 class PgWire {
  public:
   //------------------------------------------------------------------------------------------------
@@ -119,5 +115,4 @@ class PgWireDataHeader {
   std::bitset<8> data_;
 };
 
-}  // namespace pggate
 }  // namespace yb
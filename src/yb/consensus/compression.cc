@@ -0,0 +1,282 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/compression.h"
+
+#include <string.h>
+
+#include <limits>
+
+#include <lz4.h>
+#include <snappy.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "yb/consensus/consensus.messages.h"
+#include "yb/consensus/log_cache.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/util/cast.h"
+#include "yb/util/coding.h"
+#include "yb/util/coding_consts.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/status_format.h"
+
+using namespace yb::size_literals;
+
+DEFINE_RUNTIME_int32(consensus_compression_type, 0,
+                     "Compression applied to operations sent to followers. "
+                     "0 - no compression, 1 - snappy, 2 - lz4. Should be enabled only when all "
+                     "tablet servers of the universe support compressed operations.");
+TAG_FLAG(consensus_compression_type, advanced);
+
+DEFINE_RUNTIME_uint64(compression_min_input_bytes, 1_KB,
+                      "WAL entry batches and operations sent to followers are compressed only "
+                      "when their serialized size is at least this number of bytes.");
+TAG_FLAG(compression_min_input_bytes, advanced);
+
+DECLARE_uint64(rpc_max_message_size);
+
+namespace yb {
+namespace consensus {
+
+namespace {
+
+using google::protobuf::internal::WireFormatLite;
+
+const uint32_t kOpsTag = WireFormatLite::MakeTag(
+    ConsensusRequestPB::kOpsFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
+} // namespace
+
+CompressionTypePB CompressionTypeFromFlag(int32_t value) {
+  if (PREDICT_FALSE(!CompressionTypePB_IsValid(value))) {
+    YB_LOG_EVERY_N_SECS(WARNING, 60) << "Unknown compression type: " << value;
+    return CompressionTypePB::NO_COMPRESSION;
+  }
+  return static_cast<CompressionTypePB>(value);
+}
+
+size_t MaxCompressedLength(CompressionTypePB type, size_t size) {
+  size_t result = kMaxVarint32Length;
+  switch (type) {
+    case CompressionTypePB::NO_COMPRESSION:
+      return result + size;
+    case CompressionTypePB::SNAPPY_COMPRESSION:
+      return result + snappy::MaxCompressedLength(size);
+    case CompressionTypePB::LZ4_COMPRESSION:
+      return result + LZ4_compressBound(narrow_cast<int>(size));
+  }
+  FATAL_INVALID_PB_ENUM_VALUE(CompressionTypePB, type);
+}
+
+Result<size_t> Compress(CompressionTypePB type, Slice input, char* output) {
+  if (type == CompressionTypePB::NO_COMPRESSION ||
+      input.size() < FLAGS_compression_min_input_bytes ||
+      input.size() > std::numeric_limits<uint32_t>::max()) {
+    return 0;
+  }
+  auto* body = pointer_cast<char*>(
+      EncodeVarint32(pointer_cast<uint8_t*>(output), narrow_cast<uint32_t>(input.size())));
+  const size_t header_length = body - output;
+  size_t body_length;
+  switch (type) {
+    case CompressionTypePB::NO_COMPRESSION:
+      return 0;
+    case CompressionTypePB::SNAPPY_COMPRESSION:
+      snappy::RawCompress(input.cdata(), input.size(), body, &body_length);
+      break;
+    case CompressionTypePB::LZ4_COMPRESSION: {
+      auto capacity = MaxCompressedLength(type, input.size()) - kMaxVarint32Length;
+      auto result = LZ4_compress_default(
+          input.cdata(), body, narrow_cast<int>(input.size()), narrow_cast<int>(capacity));
+      if (result <= 0) {
+        return STATUS_FORMAT(RuntimeError, "LZ4 compression failed: $0", result);
+      }
+      body_length = result;
+      break;
+    }
+    default:
+      FATAL_INVALID_PB_ENUM_VALUE(CompressionTypePB, type);
+  }
+  const auto length = header_length + body_length;
+  return length < input.size() ? length : 0;
+}
+
+Result<size_t> UncompressedLength(Slice input) {
+  uint32_t result;
+  if (!GetVarint32Ptr(input.data(), input.end(), &result)) {
+    return STATUS(Corruption, "Bad length of compressed data");
+  }
+  return result;
+}
+
+Status Uncompress(CompressionTypePB type, Slice input, char* output, size_t output_length) {
+  uint32_t length;
+  const auto* body = GetVarint32Ptr(input.data(), input.end(), &length);
+  if (!body || length != output_length) {
+    return STATUS_FORMAT(
+        Corruption, "Bad length of compressed data, expected: $0", output_length);
+  }
+  input.remove_prefix(body - input.data());
+  switch (type) {
+    case CompressionTypePB::NO_COMPRESSION:
+      if (input.size() != output_length) {
+        return STATUS(Corruption, "Bad length of uncompressed data");
+      }
+      memcpy(output, input.data(), output_length);
+      return Status::OK();
+    case CompressionTypePB::SNAPPY_COMPRESSION: {
+      size_t snappy_length;
+      if (!snappy::GetUncompressedLength(input.cdata(), input.size(), &snappy_length) ||
+          snappy_length != output_length ||
+          !snappy::RawUncompress(input.cdata(), input.size(), output)) {
+        return STATUS(Corruption, "Snappy decompression failed");
+      }
+      return Status::OK();
+    }
+    case CompressionTypePB::LZ4_COMPRESSION: {
+      auto result = LZ4_decompress_safe(
+          input.cdata(), output, narrow_cast<int>(input.size()), narrow_cast<int>(output_length));
+      if (result < 0 || static_cast<size_t>(result) != output_length) {
+        return STATUS_FORMAT(Corruption, "LZ4 decompression failed: $0", result);
+      }
+      return Status::OK();
+    }
+  }
+  return STATUS_FORMAT(NotSupported, "Unsupported compression type: $0", type);
+}
+
+Result<RefCntBuffer> CompressOps(CompressionTypePB type, const LWConsensusRequestPB& request) {
+  if (type == CompressionTypePB::NO_COMPRESSION ||
+      (request.ops().empty() && request.encoded_ops().empty())) {
+    return RefCntBuffer();
+  }
+
+  // Same bytes as serialized ConsensusRequestPB that has only ops.
+  using google::protobuf::io::CodedOutputStream;
+  const auto tag_size = CodedOutputStream::VarintSize32(kOpsTag);
+  auto field_size = [tag_size](size_t op_size) {
+    return tag_size + CodedOutputStream::VarintSize32(narrow_cast<uint32_t>(op_size)) + op_size;
+  };
+  size_t size = 0;
+  for (const auto& op : request.ops()) {
+    size += field_size(op.SerializedSize());
+  }
+  for (const auto& encoded_op : request.encoded_ops()) {
+    size += field_size(encoded_op.size());
+  }
+  if (size < FLAGS_compression_min_input_bytes) {
+    return RefCntBuffer();
+  }
+
+  RefCntBuffer serialized(size);
+  auto* out = serialized.udata();
+  for (const auto& op : request.ops()) {
+    out = CodedOutputStream::WriteVarint32ToArray(kOpsTag, out);
+    out = CodedOutputStream::WriteVarint32ToArray(
+        narrow_cast<uint32_t>(op.SerializedSize()), out);
+    out = op.SerializeToArray(out);
+  }
+  for (const auto& encoded_op : request.encoded_ops()) {
+    out = CodedOutputStream::WriteVarint32ToArray(kOpsTag, out);
+    out = CodedOutputStream::WriteVarint32ToArray(
+        narrow_cast<uint32_t>(encoded_op.size()), out);
+    memcpy(out, encoded_op.data(), encoded_op.size());
+    out += encoded_op.size();
+  }
+  RSTATUS_DCHECK_EQ(
+      out - serialized.udata(), size, InternalError, "Wrong serialized ops size");
+
+  RefCntBuffer compressed(MaxCompressedLength(type, size));
+  auto compressed_length = VERIFY_RESULT(Compress(type, serialized.AsSlice(), compressed.data()));
+  if (!compressed_length) {
+    return RefCntBuffer();
+  }
+  compressed.Shrink(compressed_length);
+  return compressed;
+}
+
+Status CompressOps(LWConsensusRequestPB* request, LogCache* log_cache) {
+  const auto type = CompressionTypeFromFlag(FLAGS_consensus_compression_type);
+  auto compressed = VERIFY_RESULT(
+      log_cache ? log_cache->CompressOps(type, *request) : CompressOps(type, *request));
+  if (!compressed) {
+    return Status::OK();
+  }
+  request->set_ops_compression(type);
+  request->dup_compressed_ops(compressed.AsSlice());
+  request->mutable_ops()->clear();
+  request->mutable_encoded_ops()->clear();
+  return Status::OK();
+}
+
+Status UncompressOps(LWConsensusRequestPB* request) {
+  if (!request->has_compressed_ops()) {
+    return Status::OK();
+  }
+  SCHECK(request->ops().empty() && request->encoded_ops().empty(), InvalidArgument,
+         "Both ops and compressed ops are specified");
+  const auto compressed = request->compressed_ops();
+  const auto length = VERIFY_RESULT(UncompressedLength(compressed));
+  // The length comes from the wire, so it is checked before allocating the buffer. Uncompressed ops
+  // would not fit into a single RPC either.
+  if (length > FLAGS_rpc_max_message_size) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Too large uncompressed ops: $0, max allowed: $1", length,
+        FLAGS_rpc_max_message_size);
+  }
+  auto* data = static_cast<char*>(request->arena().AllocateBytes(length));
+  RETURN_NOT_OK(Uncompress(request->ops_compression(), compressed, data, length));
+
+  // Only ops could be sent compressed, so other fields of the request are not parsed from the
+  // decompressed data.
+  const auto* pos = pointer_cast<const uint8_t*>(data);
+  const auto* end = pos + length;
+  while (pos != end) {
+    uint32_t tag = 0;
+    pos = GetVarint32Ptr(pos, end, &tag);
+    if (!pos || tag != kOpsTag) {
+      return STATUS_FORMAT(Corruption, "Unexpected field in compressed ops, tag: $0", tag);
+    }
+    uint32_t op_size;
+    pos = GetVarint32Ptr(pos, end, &op_size);
+    if (!pos || op_size > static_cast<size_t>(end - pos)) {
+      return STATUS(Corruption, "Bad length of compressed op");
+    }
+    RETURN_NOT_OK(request->mutable_ops()->emplace_back().ParseFromSlice(Slice(pos, op_size)));
+    pos += op_size;
+  }
+  request->clear_compressed_ops();
+  request->clear_ops_compression();
+  return Status::OK();
+}
+
+Status DecodeOps(LWConsensusRequestPB* request) {
+  if (request->encoded_ops().empty()) {
+    return Status::OK();
+  }
+  SCHECK(request->ops().empty(), InvalidArgument, "Both ops and encoded ops are specified");
+  for (const auto& encoded_op : request->encoded_ops()) {
+    RETURN_NOT_OK(request->mutable_ops()->emplace_back().ParseFromSlice(encoded_op));
+  }
+  request->mutable_encoded_ops()->clear();
+  return Status::OK();
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Block compression of WAL entry batches and of operations sent to followers, and decoding of
+// operations that were sent already serialized.
+// Compressed data is prefixed with the varint encoded length of the uncompressed data, so the
+// reader could allocate the exact buffer before decompression.
+
+#pragma once
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus_fwd.h"
+
+#include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace consensus {
+
+// Converts value of the compression type flag to the compression type. Unknown values are logged
+// and turn compression off.
+CompressionTypePB CompressionTypeFromFlag(int32_t value);
+
+// Max length of the compressed representation of size bytes of input.
+size_t MaxCompressedLength(CompressionTypePB type, size_t size);
+
+// Compresses input to output, that should have at least MaxCompressedLength bytes.
+// Returns the length of the compressed data, or 0 if compression is not worth it, i.e. input
+// is shorter than --compression_min_input_bytes or its compressed representation is not smaller
+// than the input itself.
+Result<size_t> Compress(CompressionTypePB type, Slice input, char* output);
+
+// Returns the length of the data, compressed to input, after decompression.
+Result<size_t> UncompressedLength(Slice input);
+
+// Decompresses input to output, that should have UncompressedLength(input) bytes.
+Status Uncompress(CompressionTypePB type, Slice input, char* output, size_t output_length);
+
+// Returns ops or encoded_ops of the request, serialized as ops fields of ConsensusRequestPB and
+// compressed with type. Returns an empty buffer if compression is off or not worth it.
+Result<RefCntBuffer> CompressOps(CompressionTypePB type, const LWConsensusRequestPB& request);
+
+// Moves ops or encoded_ops of the request to compressed_ops, when allowed by
+// --consensus_compression_type. When log_cache is specified, ops are compressed through it, so
+// the same batch sent to several followers is compressed once.
+// Memory for the compressed ops is allocated from the request arena.
+Status CompressOps(LWConsensusRequestPB* request, LogCache* log_cache = nullptr);
+
+// Restores ops of the request received with compressed_ops. The decompressed data is allocated
+// from the request arena, so ops reference it without copying. Decompressed data larger than
+// --rpc_max_message_size or containing fields other than ops is rejected.
+Status UncompressOps(LWConsensusRequestPB* request);
+
+// Parses encoded_ops of the received request to ops. Parsed ops reference the encoded data, that
+// belongs to the request, without copying.
+Status DecodeOps(LWConsensusRequestPB* request);
+
+} // namespace consensus
+} // namespace yb
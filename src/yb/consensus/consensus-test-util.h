@@ -934,6 +934,11 @@ class TestRaftConsensusQueueIface : public PeerMessageQueueObserver {
         timeout, Format("waiting for index $0 to be replicated", index)));
   }
 
+  int64_t notified_term() {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    return notified_term_;
+  }
+
  protected:
   void UpdateMajorityReplicated(
       const MajorityReplicatedData& data, OpId* committed_index,
@@ -943,7 +948,10 @@ class TestRaftConsensusQueueIface : public PeerMessageQueueObserver {
     *committed_index = data.op_id;
     *last_applied_op_id = data.op_id;
   }
-  void NotifyTermChange(int64_t term) override {}
+  void NotifyTermChange(int64_t term) override {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    notified_term_ = term;
+  }
   void NotifyFailedFollower(const std::string& uuid,
                             int64_t term,
                             const std::string& reason) override {}
@@ -952,6 +960,7 @@ class TestRaftConsensusQueueIface : public PeerMessageQueueObserver {
  private:
   mutable simple_spinlock lock_;
   OpId majority_replicated_op_id_;
+  int64_t notified_term_ = -1;
 };
 
 }  // namespace consensus
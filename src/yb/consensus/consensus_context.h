@@ -45,6 +45,11 @@ class ConsensusContext {
 
   virtual bool ShouldApplyWrite() = 0;
 
+  // Invoked with committed rounds right before they are applied in order, so that part of their
+  // apply could be performed concurrently.
+  // last_applied_op_id - op id of the last operation that was applied.
+  virtual void ApplyConcurrently(const OpId& last_applied_op_id, const ConsensusRounds& rounds) = 0;
+
   // Performs steps to prepare request for peer.
   // For instance it could enqueue some operations to the Raft.
   //
@@ -32,6 +32,7 @@ class ConsensusContext;
 class ConsensusRoundCallback;
 class ConsensusMetadata;
 class LWReplicateMsgsHolder;
+class LogCache;
 class MultiRaftManager;
 class PeerProxyFactory;
 class PeerMessageQueue;
@@ -83,9 +83,27 @@ DEFINE_UNKNOWN_int32(max_wait_for_processresponse_before_closing_ms,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_RUNTIME_uint32(consensus_max_in_flight_requests, 1,
+                      "Max number of requests with operations that the leader keeps in flight to "
+                      "a single follower. Values greater than 1 enable pipelining of operations, "
+                      "the actual number is adjusted to the round trip time and the apply lag of "
+                      "the follower.");
+TAG_FLAG(consensus_max_in_flight_requests, advanced);
+
+DEFINE_RUNTIME_uint64(consensus_pipelining_rtt_per_request_us, 2000,
+                      "Number of requests in flight to a follower grows by one for each this "
+                      "number of microseconds of the round trip time to the follower.");
+TAG_FLAG(consensus_pipelining_rtt_per_request_us, advanced);
+
+DEFINE_RUNTIME_int64(consensus_pipelining_max_apply_lag, 10000,
+                     "Operations are not pipelined to a follower, while the number of operations "
+                     "it received but not applied yet exceeds this value.");
+TAG_FLAG(consensus_pipelining_max_apply_lag, advanced);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DECLARE_bool(enable_multi_raft_heartbeat_batcher);
+DECLARE_bool(enable_multi_raft_update_batcher);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -116,6 +134,30 @@ using rpc::PeriodicTimer;
 using rpc::RpcController;
 using strings::Substitute;
 
+namespace {
+
+// Returns index of the last operation sent in the request, or kInvalidOpIdIndex if the request does
+// not contain operations.
+int64_t LastOpIndex(const LWConsensusRequestPB& request) {
+  const auto num_ops = request.ops().size() + request.encoded_ops().size();
+  // Operations of the request have consecutive indexes after the preceding one.
+  return num_ops ? request.preceding_id().index() + static_cast<int64_t>(num_ops)
+                 : kInvalidOpIdIndex;
+}
+
+} // namespace
+
+// Request with operations, that is sent while the request in update_request_ is in flight.
+struct Peer::PipelinedUpdate {
+  ThreadSafeArena arena;
+  LWConsensusRequestPB* request = nullptr;
+  LWConsensusResponsePB* response = nullptr;
+  rpc::RpcController controller;
+  int64_t seq = 0;
+  int64_t last_op_index = kInvalidOpIdIndex;
+  CoarseTimePoint send_time;
+};
+
 Peer::Peer(
     const RaftPeerPB& peer_pb, string tablet_id, string leader_uuid, PeerProxyPtr proxy,
     PeerMessageQueue* queue, MultiRaftHeartbeatBatcherPtr multi_raft_batcher,
@@ -159,6 +201,10 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   // If there are new requests in the queue we'll get them on ProcessResponse().
   auto performing_update_lock = LockPerformingUpdate(std::try_to_lock);
   if (!performing_update_lock.owns_lock()) {
+    // New operations could be sent without waiting for the response to the outstanding request.
+    if (trigger_mode == RequestTriggerMode::kNonEmptyOnly) {
+      MaybeSendPipelinedRequest();
+    }
     return Status::OK();
   }
 
@@ -303,6 +349,7 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   const bool req_is_heartbeat = update_request_->ops().empty() &&
+                                update_request_->encoded_ops().empty() &&
                                 commit_index_after <= commit_index_before;
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
@@ -351,11 +398,113 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   // and this new request in the same order they were received by the remote peer.
   // TODO: Remove batched but unsent heartbeats (in the respective MultiRaftBatcher) in this case
   minimum_viable_heartbeat_ = cur_heartbeat_id_ + 1;
+  update_seq_ = ++last_sent_update_seq_;
+  update_last_op_index_ = LastOpIndex(*update_request_);
   processing_lock.unlock();
   performing_update_lock.release();
-  controller_.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
-  proxy_->UpdateAsync(update_request_, trigger_mode, update_response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, retain_self));
+  s = queue_->CompressOps(update_request_);
+  if (!s.ok()) {
+    YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 60)
+        << "Failed to compress operations, sending them uncompressed: " << s;
+  }
+  // Requests with operations to tablets of the same tablet server are sent in a single RPC.
+  if (!req_is_heartbeat && multi_raft_batcher_ && FLAGS_enable_multi_raft_update_batcher) {
+    // TODO(lw_uc) support multiraft update with LW
+    update_request_->ToGoogleProtobuf(&batched_update_request_);
+    batched_update_response_.Clear();
+    update_send_time_ = CoarseMonoClock::Now();
+    multi_raft_batcher_->AddUpdateToBatch(
+        &batched_update_request_, &batched_update_response_,
+        std::bind(&Peer::ProcessBatchedUpdateResponse, retain_self, _1));
+  } else {
+    controller_.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+    update_send_time_ = CoarseMonoClock::Now();
+    proxy_->UpdateAsync(update_request_, trigger_mode, update_response_, &controller_,
+                        std::bind(&Peer::ProcessResponse, retain_self));
+  }
+
+  // Following operations, e.g. when the peer is catching up, could be sent without waiting for
+  // this request.
+  if (!req_is_heartbeat) {
+    MaybeSendPipelinedRequest();
+  }
+}
+
+void Peer::MaybeSendPipelinedRequest() {
+  // Window also includes the request sent by SendNextRequest.
+  const auto window = pipeline_window_.load(std::memory_order_acquire);
+  if (num_pipelined_requests_.load(std::memory_order_acquire) + 1 >= window) {
+    return;
+  }
+
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock() || state_ != kPeerRunning || failed_attempts_ > 0) {
+      return;
+    }
+    if (num_pipelined_requests_.fetch_add(1, std::memory_order_acq_rel) + 1 >= window) {
+      num_pipelined_requests_.fetch_sub(1, std::memory_order_acq_rel);
+      return;
+    }
+    using_thread_pool_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  auto status = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::SendPipelinedRequest, shared_from_this()));
+  using_thread_pool_.fetch_sub(1, std::memory_order_acq_rel);
+  if (!status.ok()) {
+    num_pipelined_requests_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+void Peer::SendPipelinedRequest() {
+  auto retain_self = shared_from_this();
+  bool sent = false;
+  auto se = ScopeExit([this, &sent] {
+    if (!sent) {
+      num_pipelined_requests_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  });
+
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock() || failed_attempts_ > 0) {
+    return;
+  }
+
+  auto update = std::make_shared<PipelinedUpdate>();
+  update->request = update->arena.NewObject<LWConsensusRequestPB>(&update->arena);
+  update->response = update->arena.NewObject<LWConsensusResponsePB>(&update->arena);
+  LWReplicateMsgsHolder msgs_holder;
+  auto s = queue_->PipelinedRequestForPeer(
+      peer_pb_.permanent_uuid(), update->request, &msgs_holder);
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG_WITH_PREFIX(INFO) << "Could not obtain pipelined request from queue for peer: " << s;
+    return;
+  }
+  update->last_op_index = LastOpIndex(*update->request);
+  if (update->last_op_index == kInvalidOpIdIndex) {
+    return;
+  }
+
+  update->request->ref_tablet_id(tablet_id_);
+  update->request->ref_caller_uuid(leader_uuid_);
+  update->request->ref_dest_uuid(peer_pb_.permanent_uuid());
+  minimum_viable_heartbeat_ = cur_heartbeat_id_ + 1;
+  update->seq = ++last_sent_update_seq_;
+  processing_lock.unlock();
+
+  s = queue_->CompressOps(update->request);
+  if (!s.ok()) {
+    YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 60)
+        << "Failed to compress operations, sending them uncompressed: " << s;
+  }
+  update->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  update->send_time = CoarseMonoClock::Now();
+  sent = true;
+  proxy_->UpdateAsync(
+      update->request, RequestTriggerMode::kNonEmptyOnly, update->response, &update->controller,
+      [retain_self, update] {
+        retain_self->ProcessPipelinedResponse(update.get());
+      });
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -369,8 +518,14 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
 }
 
 bool Peer::ProcessResponseWithStatus(const Status& status,
-                                     LWConsensusResponsePB* response) {
+                                     LWConsensusResponsePB* response,
+                                     bool pipelined,
+                                     bool stale) {
   if (!status.ok()) {
+    if (stale) {
+      // The failure is superseded by the already processed response to a later request.
+      return false;
+    }
     if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
@@ -432,8 +587,30 @@ bool Peer::ProcessResponseWithStatus(const Status& status,
     return false;
   }
 
+  if (stale) {
+    return queue_->StaleResponseFromPeer(peer_pb_.permanent_uuid(), *response, pipelined);
+  }
   failed_attempts_ = 0;
-  return queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), *response);
+  return pipelined ? queue_->PipelinedResponseFromPeer(peer_pb_.permanent_uuid(), *response)
+                   : queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), *response);
+}
+
+bool Peer::ProcessUpdateResponse(
+    const Status& status, LWConsensusResponsePB* response, int64_t seq, int64_t last_op_index,
+    CoarseTimePoint send_time, bool pipelined, bool* stale) {
+  *stale = seq < last_processed_update_seq_;
+  if (*stale) {
+    // Response to a later request was already processed, so only the progress reported by this
+    // response is outdated.
+    return ProcessResponseWithStatus(status, response, pipelined, /* stale= */ true);
+  }
+  last_processed_update_seq_ = seq;
+  if (status.ok()) {
+    UpdatePipelineWindow(CoarseMonoClock::Now() - send_time, *response);
+  }
+  bool more_pending = ProcessResponseWithStatus(status, response, pipelined);
+  CheckAllOpsReceived(status, *response, last_op_index);
+  return more_pending;
 }
 
 void Peer::ProcessResponse() {
@@ -449,12 +626,105 @@ void Peer::ProcessResponse() {
   if (!processing_lock.owns_lock()) {
     return;
   }
-  bool more_pending = ProcessResponseWithStatus(status, update_response_);
+  bool stale;
+  bool more_pending = ProcessUpdateResponse(
+      status, update_response_, update_seq_, update_last_op_index_, update_send_time_,
+      /* pipelined= */ false, &stale);
+
+  // Operations appended while the stale request was in flight could be not sent yet.
+  if (more_pending || (stale && failed_attempts_ == 0)) {
+    processing_lock.unlock();
+    performing_update_lock.release();
+    SendNextRequest(
+        more_pending ? RequestTriggerMode::kAlwaysSend : RequestTriggerMode::kNonEmptyOnly);
+  }
+}
+
+void Peer::ProcessPipelinedResponse(PipelinedUpdate* update) {
+  auto status = update->controller.status();
+  if (status.ok()) {
+    status = update->controller.thread_pool_failure();
+  }
+  update->controller.Reset();
+
+  // Request is counted as in flight until its response is processed, so ProcessResponseError
+  // could check it.
+  auto se = ScopeExit([this] {
+    num_pipelined_requests_.fetch_sub(1, std::memory_order_acq_rel);
+  });
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+  bool stale;
+  bool more_pending = ProcessUpdateResponse(
+      status, update->response, update->seq, update->last_op_index, update->send_time,
+      /* pipelined= */ true, &stale);
+  processing_lock.unlock();
 
   if (more_pending) {
+    auto performing_update_lock = LockPerformingUpdate(std::try_to_lock);
+    // Otherwise the next request is sent after the response to the outstanding request.
+    if (performing_update_lock.owns_lock()) {
+      performing_update_lock.release();
+      SendNextRequest(RequestTriggerMode::kAlwaysSend);
+    }
+  }
+}
+
+void Peer::UpdatePipelineWindow(CoarseDuration rtt, const LWConsensusResponsePB& response) {
+  const uint64_t max_window = FLAGS_consensus_max_in_flight_requests;
+  if (max_window <= 1) {
+    pipeline_window_.store(1, std::memory_order_release);
+    return;
+  }
+  // Moving average, so a single slow response does not change the window.
+  const auto rtt_us = ToMicroseconds(rtt);
+  smoothed_rtt_us_ = smoothed_rtt_us_ ? (smoothed_rtt_us_ * 7 + rtt_us) / 8 : rtt_us;
+  uint64_t window = 1;
+  // A peer that falls behind applying operations is not flooded with more of them. Peers that do
+  // not report the applied operation are not pipelined to.
+  if (response.has_status() && response.status().has_last_applied() &&
+      response.status().last_received().index() - response.status().last_applied().index() <=
+          FLAGS_consensus_pipelining_max_apply_lag) {
+    window += smoothed_rtt_us_ / std::max<uint64_t>(
+        FLAGS_consensus_pipelining_rtt_per_request_us, 1);
+  }
+  pipeline_window_.store(std::min(window, max_window), std::memory_order_release);
+}
+
+void Peer::CheckAllOpsReceived(
+    const Status& status, const LWConsensusResponsePB& response, int64_t last_op_index) {
+  if (status.ok() && last_op_index != kInvalidOpIdIndex && response.has_status() &&
+      !response.status().has_error() && response.status().last_received().index() < last_op_index) {
+    // Peer did not accept all operations from the request, so following requests should not start
+    // after them.
+    queue_->ResetLastSentIndex(peer_pb_.permanent_uuid());
+  }
+}
+
+void Peer::ProcessBatchedUpdateResponse(const Status& status) {
+  DCHECK(performing_update_mutex_.is_locked()) << "Got a response when nothing was pending.";
+
+  auto performing_update_lock = LockPerformingUpdate(std::adopt_lock);
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+
+  // TODO(lw_uc) support multiraft update with LW
+  auto lw_response = rpc::CopySharedMessage(batched_update_response_);
+  bool stale;
+  bool more_pending = ProcessUpdateResponse(
+      status, lw_response.get(), update_seq_, update_last_op_index_, update_send_time_,
+      /* pipelined= */ false, &stale);
+
+  // Operations appended while the stale request was in flight could be not sent yet.
+  if (more_pending || (stale && failed_attempts_ == 0)) {
     processing_lock.unlock();
     performing_update_lock.release();
-    SendNextRequest(RequestTriggerMode::kAlwaysSend);
+    SendNextRequest(
+        more_pending ? RequestTriggerMode::kAlwaysSend : RequestTriggerMode::kNonEmptyOnly);
   }
 }
 
@@ -533,8 +803,12 @@ void Peer::ProcessRemoteBootstrapResponse() {
 }
 
 void Peer::ProcessResponseError(const Status& status) {
-  DCHECK(performing_update_mutex_.is_locked() || performing_heartbeat_mutex_.is_locked());
+  DCHECK(performing_update_mutex_.is_locked() || performing_heartbeat_mutex_.is_locked() ||
+         num_pipelined_requests_.load(std::memory_order_acquire) > 0);
   failed_attempts_++;
+  // Operations that were sent after the failed request should be sent again.
+  queue_->ResetLastSentIndex(peer_pb_.permanent_uuid());
+  pipeline_window_.store(1, std::memory_order_release);
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Couldn't send request. "
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
       << " Already tried " << failed_attempts_ << " times. State: " << state_;
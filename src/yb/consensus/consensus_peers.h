@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/opid_util.h"
 
 #include "yb/gutil/integral_types.h"
 
@@ -59,6 +60,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/locks.h"
 #include "yb/util/memory/arena.h"
+#include "yb/util/monotime.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/result.h"
 #include "yb/util/semaphore.h"
@@ -125,6 +127,12 @@ namespace consensus {
 //        v                               v
 //  SignalRequest()                    return
 //
+// When --consensus_max_in_flight_requests is greater than 1, operations appended while a request
+// is outstanding are sent by pipelined requests, without waiting for its response. The number of
+// requests in flight is limited by a window, that is adjusted to the round trip time and to the
+// apply lag of the peer. Only errors, the term and the lease acknowledgement are processed from
+// responses that arrive after the response to a later request.
+//
 class Peer;
 typedef std::shared_ptr<Peer> PeerPtr;
 
@@ -189,9 +197,41 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // Signals that a heartbeat response was received from the peer.
   void ProcessHeartbeatResponse(const Status& status);
 
+  // Signals that a response for the request, sent in a multi-Raft batch, was received.
+  void ProcessBatchedUpdateResponse(const Status& status);
+
+  struct PipelinedUpdate;
+
+  // Sends operations that follow operations of the outstanding requests, when the number of
+  // requests in flight to the peer is below the pipelining window.
+  void MaybeSendPipelinedRequest();
+
+  void SendPipelinedRequest();
+
+  // Signals that a response for the pipelined request was received.
+  void ProcessPipelinedResponse(PipelinedUpdate* update);
+
+  // Adjusts the pipelining window to the round trip time of the last request and the apply lag
+  // reported by the peer.
+  void UpdatePipelineWindow(CoarseDuration rtt, const LWConsensusResponsePB& response);
+
+  // Makes the queue resend operations that the peer did not accept from the request, which last
+  // operation has last_op_index.
+  void CheckAllOpsReceived(
+      const Status& status, const LWConsensusResponsePB& response, int64_t last_op_index);
+
+  // Processes the response to the request with operations, that has sequence number seq.
+  // stale is set when the response to a later request was already processed.
+  // Returns true if there are more pending ops to process, false otherwise.
+  bool ProcessUpdateResponse(
+      const Status& status, LWConsensusResponsePB* response, int64_t seq, int64_t last_op_index,
+      CoarseTimePoint send_time, bool pipelined, bool* stale);
+
   // Returns true if there are more pending ops to process, false otherwise.
   bool ProcessResponseWithStatus(const Status& status,
-                                 LWConsensusResponsePB* response);
+                                 LWConsensusResponsePB* response,
+                                 bool pipelined = false,
+                                 bool stale = false);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -242,6 +282,10 @@ class Peer : public std::enable_shared_from_this<Peer> {
   ConsensusRequestPB heartbeat_request_;
   ConsensusResponsePB heartbeat_response_;
 
+  // Latest request with operations, sent in a multi-Raft batch, and its response.
+  ConsensusRequestPB batched_update_request_;
+  ConsensusResponsePB batched_update_response_;
+
   // Each time a heartbeat request is sent this value is incremented.
   int64_t cur_heartbeat_id_ = 0;
   // Indiciates the last valid heartbeat id that was sent.
@@ -251,6 +295,26 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // since a more recent op was sent so we won't process it's response.
   int64_t minimum_viable_heartbeat_ = 0;
 
+  // Each request with operations gets the next sequence number. Progress reported by responses to
+  // requests sent before the request, which response was already processed, is outdated and
+  // ignored.
+  int64_t last_sent_update_seq_ = 0;
+  int64_t last_processed_update_seq_ = 0;
+
+  // Sequence number, index of the last operation and send time of the request in update_request_.
+  int64_t update_seq_ = 0;
+  int64_t update_last_op_index_ = kInvalidOpIdIndex;
+  CoarseTimePoint update_send_time_;
+
+  // Number of pipelined requests in flight.
+  std::atomic<size_t> num_pipelined_requests_{0};
+
+  // Max number of requests in flight to the peer, including the request in update_request_.
+  std::atomic<uint64_t> pipeline_window_{1};
+
+  // Smoothed round trip time of requests to the peer.
+  int64_t smoothed_rtt_us_ = 0;
+
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
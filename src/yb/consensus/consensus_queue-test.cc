@@ -437,6 +437,116 @@ TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   ASSERT_EQ(queue_->TEST_GetLastAppliedOpId(), expected);
 }
 
+// Tests that pipelined requests contain only operations after the ones that are in flight.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  queue_->Init(OpId::Min());
+  queue_->SetLeaderMode(
+      OpId::Min(), OpId::Min().term, OpId::Min(), BuildRaftConfigPBForTests(3));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, kNumMessages);
+  WaitForLocalPeerToAckIndex(kNumMessages);
+
+  ThreadSafeArena arena;
+  LWConsensusRequestPB request(&arena);
+  LWConsensusResponsePB response(&arena);
+  response.ref_responder_uuid(kPeerUuid);
+
+  ASSERT_TRUE(UpdatePeerWatermarkToOp(
+      &request, &response, MakeOpIdForIndex(kNumMessages / 2), OpId::Min()));
+
+  // Nothing is pipelined to the peer, until the exchange with it is successful.
+  LWReplicateMsgsHolder refs;
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &request, &refs));
+  ASSERT_TRUE(request.ops().empty());
+  request.Clear();
+
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(kNumMessages / 2, request.ops().size());
+  SetLastReceivedAndLastCommitted(&response, MakeOpIdForIndex(kNumMessages));
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid().ToBuffer(), response));
+
+  // Request with the next operations is in flight.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, kNumMessages + 1, kNumMessages);
+  WaitForLocalPeerToAckIndex(2 * kNumMessages);
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(kNumMessages, request.ops().size());
+
+  // So the pipelined request starts after it.
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 2 * kNumMessages + 1, kNumMessages);
+  WaitForLocalPeerToAckIndex(3 * kNumMessages);
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &request, &refs));
+  ASSERT_EQ(OpId::FromPB(request.preceding_id()), MakeOpIdForIndex(2 * kNumMessages));
+  ASSERT_EQ(kNumMessages, request.ops().size());
+  ASSERT_FALSE(request.has_leader_lease_duration_ms());
+
+  // All operations are already in flight.
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &request, &refs));
+  ASSERT_TRUE(request.ops().empty());
+
+  // After the failure, operations are sent again starting after the last received one.
+  queue_->ResetLastSentIndex(kPeerUuid);
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->PipelinedRequestForPeer(kPeerUuid, &request, &refs));
+  ASSERT_EQ(OpId::FromPB(request.preceding_id()), MakeOpIdForIndex(kNumMessages));
+  ASSERT_EQ(2 * kNumMessages, request.ops().size());
+
+  SetLastReceivedAndLastCommitted(&response, MakeOpIdForIndex(3 * kNumMessages));
+  ASSERT_FALSE(queue_->PipelinedResponseFromPeer(
+      response.responder_uuid().ToBuffer(), response));
+}
+
+// Tests that a response to the earlier request, that arrived after the response to the later one,
+// does not move the peer back, but still delivers the term change.
+TEST_F(ConsensusQueueTest, TestStaleResponses) {
+  queue_->Init(OpId::Min());
+  queue_->SetLeaderMode(
+      OpId::Min(), OpId::Min().term, OpId::Min(), BuildRaftConfigPBForTests(3));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, kNumMessages);
+  WaitForLocalPeerToAckIndex(kNumMessages);
+
+  ThreadSafeArena arena;
+  LWConsensusRequestPB request(&arena);
+  LWConsensusResponsePB response(&arena);
+  response.ref_responder_uuid(kPeerUuid);
+
+  ASSERT_TRUE(UpdatePeerWatermarkToOp(
+      &request, &response, MakeOpIdForIndex(kNumMessages / 2), OpId::Min()));
+  LWReplicateMsgsHolder refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  SetLastReceivedAndLastCommitted(&response, MakeOpIdForIndex(kNumMessages));
+  ASSERT_FALSE(queue_->ResponseFromPeer(kPeerUuid, response));
+  ASSERT_EQ(queue_->GetTrackedPeerForTests(kPeerUuid).last_received,
+            MakeOpIdForIndex(kNumMessages));
+
+  // Progress reported by the stale response is ignored.
+  SetLastReceivedAndLastCommitted(&response, MakeOpIdForIndex(kNumMessages / 2));
+  ASSERT_FALSE(queue_->StaleResponseFromPeer(kPeerUuid, response, /* pipelined= */ true));
+  ASSERT_FALSE(queue_->StaleResponseFromPeer(kPeerUuid, response, /* pipelined= */ false));
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(peer.last_received, MakeOpIdForIndex(kNumMessages));
+  ASSERT_TRUE(peer.is_last_exchange_successful);
+
+  // While the term change is not lost.
+  constexpr int64_t kNewTerm = 5;
+  response.set_responder_term(kNewTerm);
+  auto* error = response.mutable_status()->mutable_error();
+  error->set_code(ConsensusErrorPB::INVALID_TERM);
+  StatusToPB(STATUS(IllegalState, "Invalid term."), error->mutable_status());
+  ASSERT_FALSE(queue_->StaleResponseFromPeer(kPeerUuid, response, /* pipelined= */ true));
+  ASSERT_OK(WaitFor(
+      [this] { return consensus_->notified_term() == kNewTerm; }, 10s, "Term change notified"));
+  ASSERT_EQ(queue_->GetTrackedPeerForTests(kPeerUuid).last_received,
+            MakeOpIdForIndex(kNumMessages));
+}
+
 TEST_F(ConsensusQueueTest, TestQueueAdvancesCommittedIndex) {
   queue_->Init(OpId::Min());
   queue_->SetLeaderMode(
@@ -42,6 +42,7 @@
 #include <boost/container/small_vector.hpp>
 #include <glog/logging.h>
 
+#include "yb/consensus/compression.h"
 #include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/consensus_context.h"
 #include "yb/consensus/log_util.h"
@@ -65,6 +66,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/random_util.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/result.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status_log.h"
@@ -102,6 +104,13 @@ DEFINE_UNKNOWN_int32(cdc_checkpoint_opid_interval_ms, 60 * 1000,
              "specified by cdc_checkpoint_opid_interval, then log cache does not consider that "
              "consumer while determining which op IDs to evict.");
 
+DEFINE_RUNTIME_bool(consensus_send_encoded_ops, false,
+                    "Whether the leader should send operations to followers in encoded_ops. Each "
+                    "operation is then serialized once and shared by requests to all followers. "
+                    "Should be enabled only when all tablet servers of the universe support "
+                    "encoded operations.");
+TAG_FLAG(consensus_send_encoded_ops, advanced);
+
 DEFINE_RUNTIME_bool(enable_consensus_exponential_backoff, true,
     "Whether exponential backoff based on number of retransmissions at tablet leader "
     "for number of entries to replicate to lagging follower is enabled.");
@@ -485,10 +494,38 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         bool* needs_remote_bootstrap,
                                         PeerMemberType* member_type,
                                         bool* last_exchange_successful) {
+  return DoRequestForPeer(
+      uuid, request, msgs_holder, needs_remote_bootstrap, member_type, last_exchange_successful,
+      /* pipelined= */ false);
+}
+
+Status PeerMessageQueue::PipelinedRequestForPeer(const string& uuid,
+                                                 LWConsensusRequestPB* request,
+                                                 LWReplicateMsgsHolder* msgs_holder) {
+  bool needs_remote_bootstrap = false;
+  return DoRequestForPeer(
+      uuid, request, msgs_holder, &needs_remote_bootstrap, /* member_type= */ nullptr,
+      /* last_exchange_successful= */ nullptr, /* pipelined= */ true);
+}
+
+Status PeerMessageQueue::CompressOps(LWConsensusRequestPB* request) {
+  return consensus::CompressOps(request, &log_cache_);
+}
+
+Status PeerMessageQueue::DoRequestForPeer(const string& uuid,
+                                          LWConsensusRequestPB* request,
+                                          LWReplicateMsgsHolder* msgs_holder,
+                                          bool* needs_remote_bootstrap,
+                                          PeerMemberType* member_type,
+                                          bool* last_exchange_successful,
+                                          bool pipelined) {
   static constexpr uint64_t kSendUnboundedLogOps = std::numeric_limits<uint64_t>::max();
   DCHECK(request->ops().empty()) << request->ShortDebugString();
+  DCHECK(request->encoded_ops().empty()) << request->ShortDebugString();
 
   OpId preceding_id;
+  // Id of the last operation that is sent in this request, if any.
+  OpId last_op_id = OpId::Invalid();
   MonoDelta unreachable_time = MonoDelta::kMin;
   bool is_voter = false;
   bool is_new;
@@ -516,7 +553,12 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     HybridTime now_ht;
 
     is_new = peer->is_new;
-    if (!is_new) {
+    if (pipelined && (is_new || peer->needs_remote_bootstrap ||
+                      !peer->is_last_exchange_successful || peer->current_retransmissions > 0)) {
+      // Operations are pipelined only to the peer that keeps up with the leader.
+      return Status::OK();
+    }
+    if (!is_new && !pipelined) {
       now_ht = clock_->Now();
 
       auto ht_lease_expiration_micros = now_ht.GetPhysicalValueMicros() +
@@ -543,8 +585,10 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       now_ht = clock_->Now();
       request->clear_leader_lease_duration_ms();
       request->clear_ht_lease_expiration();
-      peer->leader_lease_expiration.Reset();
-      peer->leader_ht_lease_expiration.Reset();
+      if (!pipelined) {
+        peer->leader_lease_expiration.Reset();
+        peer->leader_ht_lease_expiration.Reset();
+      }
     }
     // This is initialized to the queue's last appended op but gets set to the id of the
     // log entry preceding the first one in 'messages' if messages are found for the peer.
@@ -586,7 +630,13 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
 
     previously_sent_index = peer->next_index - 1;
-    if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0) {
+    if (pipelined || peer->last_num_messages_sent < 0) {
+      // Not a retransmission, so continue after operations that are still in flight.
+      previously_sent_index = std::max(previously_sent_index, peer->last_sent_index);
+    }
+    if (pipelined) {
+      num_log_ops_to_send = kSendUnboundedLogOps;
+    } else if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0) {
       // Previous request to peer has not been acked. Reduce number of entries to be sent
       // in this attempt using exponential backoff. Note that to_index is inclusive.
       num_log_ops_to_send = GetNumMessagesToSendWithBackoff(peer->last_num_messages_sent);
@@ -596,7 +646,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       num_log_ops_to_send = kSendUnboundedLogOps;
     }
 
-    peer->current_retransmissions++;
+    if (!pipelined) {
+      peer->current_retransmissions++;
+    }
 
     if (peer->member_type == PeerMemberType::VOTER) {
       is_voter = true;
@@ -650,11 +702,22 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
 
     preceding_id = result->preceding_op;
-    // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
-    // point. At some point we may want to allow partially loading (and not pinning) earlier
-    // messages. At that point we'll need to do something smarter here, like copy or ref-count.
-    for (const auto& msg : result->messages) {
-      request->mutable_ops()->push_back_ref(msg.get());
+    if (!result->messages.empty()) {
+      last_op_id = OpId::FromPB(result->messages.back()->id());
+    }
+    std::vector<RefCntBuffer> encoded_messages;
+    if (FLAGS_consensus_send_encoded_ops) {
+      encoded_messages = log_cache_.EncodeOps(result->messages);
+      for (const auto& encoded : encoded_messages) {
+        request->add_ref_encoded_ops(encoded.AsSlice());
+      }
+    } else {
+      // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
+      // point. At some point we may want to allow partially loading (and not pinning) earlier
+      // messages. At that point we'll need to do something smarter here, like copy or ref-count.
+      for (const auto& msg : result->messages) {
+        request->mutable_ops()->push_back_ref(msg.get());
+      }
     }
 
     {
@@ -664,14 +727,20 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
         return STATUS(NotFound, "Peer not tracked.");
       }
 
-      peer->last_num_messages_sent = result->messages.size();
+      if (!pipelined) {
+        peer->last_num_messages_sent = result->messages.size();
+      }
+      if (last_op_id.valid()) {
+        peer->last_sent_index = std::max(peer->last_sent_index, last_op_id.index);
+      }
     }
 
     ScopedTrackedConsumption consumption;
     if (result->read_from_disk_size) {
       consumption = ScopedTrackedConsumption(operations_mem_tracker_, result->read_from_disk_size);
     }
-    *msgs_holder = LWReplicateMsgsHolder(std::move(result->messages), std::move(consumption));
+    *msgs_holder = LWReplicateMsgsHolder(
+        std::move(result->messages), std::move(encoded_messages), std::move(consumption));
 
     if (propagated_safe_time &&
         !result->have_more_messages &&
@@ -695,14 +764,16 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   // We don't have to change committed_op_id when it is less than max_allowed_committed_op_id,
   // because it will have actual committed_op_id value and this operation is known to the
   // follower.
-  const auto max_allowed_committed_op_id = !request->ops().empty()
-      ? OpId::FromPB(request->ops().rbegin()->id()) : preceding_id;
+  const auto max_allowed_committed_op_id = last_op_id.valid() ? last_op_id : preceding_id;
   if (max_allowed_committed_op_id.index < request->committed_op_id().index()) {
     max_allowed_committed_op_id.ToPB(request->mutable_committed_op_id());
   }
 
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
-    if (!request->ops().empty()) {
+    if (!request->encoded_ops().empty()) {
+      VLOG_WITH_PREFIX(2) << "Sending request with encoded operations to Peer: " << uuid
+          << ". Size: " << request->encoded_ops().size() << ". To: " << last_op_id;
+    } else if (!request->ops().empty()) {
       VLOG_WITH_PREFIX(2) << "Sending request with operations to Peer: " << uuid
           << ". Size: " << request->ops().size()
           << ". From: " << request->ops().front().id().ShortDebugString() << ". To: "
@@ -1210,8 +1281,34 @@ void PeerMessageQueue::RequestWasNotSent(const std::string& peer_uuid) {
 }
 
 
+void PeerMessageQueue::ResetLastSentIndex(const std::string& peer_uuid) {
+  LockGuard scoped_lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_uuid);
+  if (peer) {
+    peer->last_sent_index = kInvalidOpIdIndex;
+  }
+}
+
 bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const LWConsensusResponsePB& response) {
+  return DoResponseFromPeer(peer_uuid, response, /* pipelined= */ false, /* stale= */ false);
+}
+
+bool PeerMessageQueue::PipelinedResponseFromPeer(const std::string& peer_uuid,
+                                                 const LWConsensusResponsePB& response) {
+  return DoResponseFromPeer(peer_uuid, response, /* pipelined= */ true, /* stale= */ false);
+}
+
+bool PeerMessageQueue::StaleResponseFromPeer(const std::string& peer_uuid,
+                                             const LWConsensusResponsePB& response,
+                                             bool pipelined) {
+  return DoResponseFromPeer(peer_uuid, response, pipelined, /* stale= */ true);
+}
+
+bool PeerMessageQueue::DoResponseFromPeer(const std::string& peer_uuid,
+                                          const LWConsensusResponsePB& response,
+                                          bool pipelined,
+                                          bool stale) {
   MajorityReplicatedData majority_replicated;
   Mode mode_copy;
   bool result = false;
@@ -1234,6 +1331,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
           << response.ShortDebugString();
 
       peer->needs_remote_bootstrap = true;
+      peer->last_sent_index = kInvalidOpIdIndex;
       // Since we received a response from the peer, we know it is alive. So we need to update
       // peer->last_successful_communication_time, otherwise, we will remove this peer from the
       // configuration if the remote bootstrap is not completed within
@@ -1264,9 +1362,24 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     peer->is_new = false;
     peer->last_successful_communication_time = MonoTime::Now();
 
-    peer->ResetLastRequest();
+    // The request of the primary exchange could be still in flight.
+    if (!pipelined) {
+      peer->ResetLastRequest();
+    }
 
-    if (response.has_status()) {
+    if (response.has_status() && stale) {
+      // Progress reported by the stale response is older than the one already processed, so only
+      // the term change is taken from it.
+      const auto& status = response.status();
+      if (PREDICT_FALSE(status.has_error()) &&
+          status.error().code() == ConsensusErrorPB::INVALID_TERM) {
+        CHECK(response.has_responder_term());
+        LOG_WITH_PREFIX_UNLOCKED(INFO) << "Peer responded invalid term: " << peer->ToString()
+                                       << ". Peer's new term: " << response.responder_term();
+        NotifyObserversOfTermChange(response.responder_term());
+        return false;
+      }
+    } else if (response.has_status()) {
       const auto& status = response.status();
       // The status must always have a last received op id and a last committed index.
       DCHECK(status.has_last_received());
@@ -1305,6 +1418,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
       if (PREDICT_FALSE(status.has_error())) {
         peer->is_last_exchange_successful = false;
+        peer->last_sent_index = kInvalidOpIdIndex;
         switch (status.error().code()) {
           case ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH: {
             DCHECK(status.has_last_received());
@@ -1334,10 +1448,14 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
     }
 
-    peer->is_last_exchange_successful = true;
-    peer->num_sst_files = response.num_sst_files();
+    // Result of the last exchange and the term are taken from the latest response, the term of the
+    // stale response could be lower than the term of the already processed one.
+    if (!stale) {
+      peer->is_last_exchange_successful = true;
+      peer->num_sst_files = response.num_sst_files();
+    }
 
-    if (response.has_responder_term()) {
+    if (response.has_responder_term() && !stale) {
       // The peer must have responded with a term that is greater than or equal to the last known
       // term for that peer.
       peer->CheckMonotonicTerms(response.responder_term());
@@ -1354,7 +1472,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     // If our log has the next request for the peer or if the peer's committed index is lower than
     // our own, set 'more_pending' to true.
-    result = log_cache_.HasOpBeenWritten(peer->next_index) ||
+    result = log_cache_.HasOpBeenWritten(std::max(peer->next_index, peer->last_sent_index + 1)) ||
         (peer->last_known_committed_idx < queue_state_.committed_op_id.index);
 
     mode_copy = queue_state_.mode;
@@ -1368,8 +1486,12 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         }
       }
 
-      peer->leader_lease_expiration.OnReplyFromFollower();
-      peer->leader_ht_lease_expiration.OnReplyFromFollower();
+      // Leases are extended only by requests that are not pipelined, so the lease sent by the
+      // request that is still in flight is not taken as acknowledged.
+      if (!pipelined) {
+        peer->leader_lease_expiration.OnReplyFromFollower();
+        peer->leader_ht_lease_expiration.OnReplyFromFollower();
+      }
 
       majority_replicated.op_id = queue_state_.majority_replicated_op_id;
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
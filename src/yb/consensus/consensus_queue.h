@@ -157,6 +157,11 @@ class PeerMessageQueue {
     // Number of retransmissions from same next_index_.
     int64_t current_retransmissions = -1;
 
+    // Index of the last operation sent to the peer. Could be ahead of next_index while requests
+    // are in flight, so following requests continue after it instead of resending the same ops.
+    // Reset when a request fails, or the peer does not accept all operations that were sent.
+    int64_t last_sent_index = kInvalidOpIdIndex;
+
     // The last operation that we've sent to this peer and that it acked. Used for watermark
     // movement.
     OpId last_received = yb::OpId::Min();
@@ -299,6 +304,20 @@ class PeerMessageQueue {
       PeerMemberType* member_type = nullptr,
       bool* last_exchange_successful = nullptr);
 
+  // Same as RequestForPeer, but for the request that is sent while previous requests to the peer
+  // are still in flight. Such request contains only operations after the last sent one, and is not
+  // used for leader leases and retransmission accounting, because its response could be received
+  // after responses to later requests.
+  // The request is left without operations, when there is nothing to pipeline to the peer.
+  Status PipelinedRequestForPeer(
+      const std::string& uuid,
+      LWConsensusRequestPB* request,
+      LWReplicateMsgsHolder* msgs_holder);
+
+  // Moves operations of the request for a peer to compressed_ops, see consensus::CompressOps.
+  // Operations sent to all peers are compressed once.
+  Status CompressOps(LWConsensusRequestPB* request);
+
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
   // peer->needs_remote_bootstrap to false.
@@ -321,6 +340,22 @@ class PeerMessageQueue {
   virtual bool ResponseFromPeer(const std::string& peer_uuid,
                                 const LWConsensusResponsePB& response);
 
+  // Same as ResponseFromPeer, but for the response to the request assembled by
+  // PipelinedRequestForPeer.
+  bool PipelinedResponseFromPeer(const std::string& peer_uuid,
+                                 const LWConsensusResponsePB& response);
+
+  // Processes the response that arrived after the response to a later request of the same peer
+  // was processed. Its progress of the peer is outdated, so only errors, the term and, for the
+  // request that is not pipelined, the leader lease acknowledgement are taken into account.
+  bool StaleResponseFromPeer(const std::string& peer_uuid,
+                             const LWConsensusResponsePB& response,
+                             bool pipelined);
+
+  // Forgets operations sent to the peer, that were not acknowledged yet. So the next request
+  // starts right after the last operation received by the peer.
+  void ResetLastSentIndex(const std::string& peer_uuid);
+
   void RequestWasNotSent(const std::string& peer_uuid);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
@@ -411,6 +446,19 @@ class PeerMessageQueue {
   FRIEND_TEST(ConsensusQueueTest, TestQueueAdvancesCommittedIndex);
   FRIEND_TEST(ConsensusQueueTest, TestReadReplicatedMessagesForCDC);
 
+  Status DoRequestForPeer(
+      const std::string& uuid,
+      LWConsensusRequestPB* request,
+      LWReplicateMsgsHolder* msgs_holder,
+      bool* needs_remote_bootstrap,
+      PeerMemberType* member_type,
+      bool* last_exchange_successful,
+      bool pipelined);
+
+  bool DoResponseFromPeer(
+      const std::string& peer_uuid, const LWConsensusResponsePB& response, bool pipelined,
+      bool stale);
+
   // Mode specifies how the queue currently behaves:
   //
   // LEADER - Means the queue tracks remote peers and replicates whatever messages are appended.
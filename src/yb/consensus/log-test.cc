@@ -46,8 +46,13 @@
 #include "yb/consensus/log.messages.h"
 #include "yb/consensus/log-test-base.h"
 #include "yb/consensus/log_index.h"
+#include "yb/consensus/log_segment_pool.h"
 #include "yb/consensus/opid_util.h"
 
+#include "yb/encryption/encrypted_file_factory.h"
+#include "yb/encryption/header_manager_mock_impl.h"
+
+#include "yb/gutil/casts.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 
@@ -67,6 +72,8 @@ DECLARE_int32(o_direct_block_size_bytes);
 DECLARE_bool(TEST_simulate_abrupt_server_restart);
 DECLARE_bool(TEST_skip_file_close);
 DECLARE_int64(reuse_unclosed_segment_threshold);
+DECLARE_int32(log_compression_type);
+DECLARE_uint32(log_segment_pool_max_segments);
 
 namespace yb {
 namespace log {
@@ -119,6 +126,33 @@ class LogTest : public LogTestBase {
     return Status::OK();
   }
 
+  void TestCompressedEntries(consensus::CompressionTypePB compression) {
+    FLAGS_log_compression_type = compression;
+    BuildLog();
+
+    constexpr int kNumEntries = 100;
+    OpIdPB op_id = MakeOpId(1, 1);
+    ssize_t size = 0;
+    ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &op_id, kNumEntries, &size));
+    ASSERT_LT(log_->metrics_->bytes_logged->value(), size);
+    ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+    SegmentSequence segments;
+    ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+    const ReadableLogSegmentPtr& first_segment = ASSERT_RESULT(segments.front());
+    auto read_entries = first_segment->ReadEntries();
+    ASSERT_OK(read_entries.status);
+    ASSERT_EQ(kNumEntries, read_entries.entries.size());
+    for (int i = 0; i != kNumEntries; ++i) {
+      ASSERT_EQ(yb::OpId(1, i + 1), OpId::FromPB(read_entries.entries[i]->replicate().id()));
+    }
+
+    auto loaded_op = ASSERT_RESULT(log_->GetLogReader()->LookupOpId(kNumEntries / 2));
+    ASSERT_EQ(yb::OpId(1, kNumEntries / 2), loaded_op);
+
+    ASSERT_OK(log_->Close());
+  }
+
   Status AppendNewEmptySegmentToReader(int sequence_number,
                                        int first_repl_index,
                                        LogReader* reader) {
@@ -350,6 +384,14 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+TEST_F(LogTest, CompressedEntriesSnappy) {
+  TestCompressedEntries(consensus::CompressionTypePB::SNAPPY_COMPRESSION);
+}
+
+TEST_F(LogTest, CompressedEntriesLZ4) {
+  TestCompressedEntries(consensus::CompressionTypePB::LZ4_COMPRESSION);
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
@@ -816,6 +858,130 @@ TEST_F(LogTest, TestGCWithLogRunning) {
   }
 }
 
+// Garbage collected segments should be recycled by the following rollovers, without old entries
+// appearing in the new segments.
+TEST_F(LogTest, RecycleSegments) {
+  constexpr int kNumTotalSegments = 5;
+  constexpr int kNumOpsPerSegment = 5;
+  constexpr int kPoolSize = 2;
+  FLAGS_log_segment_pool_max_segments = kPoolSize;
+
+  BuildLog();
+  auto* pool = log_->TEST_SegmentPool();
+  ASSERT_EQ(pool->TEST_size(), 0);
+
+  OpIdPB op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, nullptr));
+
+  // All but the last 2 segments are collected, the pool keeps only kPoolSize of them. They are
+  // moved out of the WAL dir by GC, and become available after zero filling in background.
+  int num_gced_segments;
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_EQ(kNumTotalSegments - 2, num_gced_segments);
+  CheckRightNumberOfSegmentFiles(2);
+  pool->TEST_WaitFilled();
+  ASSERT_EQ(pool->TEST_size(), kPoolSize);
+
+  for (int i = 0; i != kPoolSize; ++i) {
+    ASSERT_OK(RollLog());
+    ASSERT_OK(AppendNoOps(&op_id, kNumOpsPerSegment));
+  }
+  ASSERT_EQ(pool->TEST_size(), 0);
+
+  uint32_t num_entries;
+  {
+    SegmentSequence segments;
+    ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+    ASSERT_EQ(2 + kPoolSize, segments.size()) << DumpSegmentsToString(segments);
+    num_entries = ASSERT_RESULT(GetEntries(segments));
+  }
+  ASSERT_OK(log_->Close());
+  CheckRightNumberOfSegmentFiles(2 + kPoolSize);
+
+  BuildLog();
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(ASSERT_RESULT(GetEntries(segments)), num_entries) << DumpSegmentsToString(segments);
+}
+
+// Pool that failed to start is retried on the next use, instead of staying disabled.
+TEST_F(LogTest, RecycleSegmentsAfterPoolFailure) {
+  constexpr int kNumTotalSegments = 3;
+  constexpr int kNumOpsPerSegment = 5;
+  FLAGS_log_segment_pool_max_segments = kNumTotalSegments;
+
+  BuildLog();
+  auto* pool = log_->TEST_SegmentPool();
+
+  // A file in place of the pool directory makes the pool fail to start.
+  const auto pool_dir = JoinPathSegments(tablet_wal_path_, ".segment_pool");
+  {
+    std::unique_ptr<WritableFile> file;
+    ASSERT_OK(env_->NewWritableFile(pool_dir, &file));
+    ASSERT_OK(file->Close());
+  }
+
+  OpIdPB op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, nullptr));
+  int num_gced_segments;
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_GT(num_gced_segments, 0);
+  CheckRightNumberOfSegmentFiles(kNumTotalSegments - num_gced_segments);
+  pool->TEST_WaitFilled();
+  ASSERT_EQ(pool->TEST_size(), 0);
+
+  ASSERT_OK(env_->DeleteFile(pool_dir));
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, nullptr));
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_GT(num_gced_segments, 0);
+  pool->TEST_WaitFilled();
+  ASSERT_EQ(pool->TEST_size(), num_gced_segments);
+}
+
+// Encrypted segments are not recycled, since a pooled file is not reopened with a fresh encryption
+// header. Their entries should be readable after reopening the log.
+TEST_F(LogTest, NoRecycleWithEncryption) {
+  constexpr int kNumTotalSegments = 4;
+  constexpr int kNumOpsPerSegment = 5;
+  FLAGS_log_segment_pool_max_segments = kNumTotalSegments;
+
+  auto header_manager = encryption::GetMockHeaderManager();
+  down_cast<encryption::HeaderManagerMockImpl*>(header_manager.get())->SetFileEncryption(true);
+  auto encrypted_env = encryption::NewEncryptedEnv(std::move(header_manager));
+  ASSERT_TRUE(encrypted_env->IsEncrypted());
+  options_.env = encrypted_env.get();
+
+  BuildLog();
+  auto* pool = log_->TEST_SegmentPool();
+  OpIdPB op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendMultiSegmentSequence(kNumTotalSegments, kNumOpsPerSegment, &op_id, nullptr));
+  int num_gced_segments;
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_GT(num_gced_segments, 0);
+  pool->TEST_WaitFilled();
+  ASSERT_EQ(pool->TEST_size(), 0);
+  ASSERT_FALSE(env_->FileExists(JoinPathSegments(tablet_wal_path_, ".segment_pool")));
+
+  ASSERT_OK(RollLog());
+  ASSERT_OK(AppendNoOps(&op_id, kNumOpsPerSegment));
+  uint32_t num_entries;
+  {
+    SegmentSequence segments;
+    ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+    num_entries = ASSERT_RESULT(GetEntries(segments));
+  }
+  ASSERT_OK(log_->Close());
+
+  BuildLog();
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(ASSERT_RESULT(GetEntries(segments)), num_entries) << DumpSegmentsToString(segments);
+  ASSERT_OK(log_->Close());
+  // The log should not outlive its env.
+  log_.reset();
+  options_.env = Env::Default();
+}
+
 // Test that, when we are set to retain a given number of log segments,
 // we also retain any relevant log index chunks, even if those operations
 // are not necessary for recovery.
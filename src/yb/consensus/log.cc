@@ -52,6 +52,8 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_segment_pool.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 
 #include "yb/fs/fs_manager.h"
@@ -139,6 +141,13 @@ DEFINE_UNKNOWN_double(log_background_sync_interval_fraction, 0.6,
              "entry exceeds interval_durable_wal_write_ms*log_background_sync_interval_fraction "
              "the fsync task is pushed to the log-sync queue.");
 
+DEFINE_RUNTIME_bool(log_cross_tablet_group_commit, false,
+                    "Whether fsyncs of logs of different tablets, that are requested concurrently, "
+                    "should be performed together. Each segment is still synced by its own "
+                    "fdatasync, but fdatasyncs of a group are submitted by a single io_uring "
+                    "system call and executed concurrently. Requires --enable_io_uring, without it "
+                    "each log syncs its own segment.");
+TAG_FLAG(log_cross_tablet_group_commit, advanced);
 
 // Flags for controlling kernel watchdog limits.
 DEFINE_RUNTIME_int32(consensus_log_scoped_watch_delay_callback_threshold_ms, 1000,
@@ -617,6 +626,8 @@ Log::Log(
       cur_max_segment_size_((options.initial_segment_size_bytes + 1) / 2),
       appender_(new Appender(this, append_thread_pool)),
       allocation_token_(allocation_thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
+      segment_pool_(std::make_unique<LogSegmentPool>(
+          options_.env, wal_dir_, allocation_thread_pool)),
       background_sync_threadpool_token_(
           background_sync_threadpool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
       durable_wal_write_(options_.durable_wal_write),
@@ -1095,7 +1106,11 @@ Status Log::DoSync() {
   LOG_SLOW_EXECUTION_EVERY_N_SECS(INFO, /* log at most one slow execution every 1 sec */ 1,
                                   50, "Fsync log took a long time") {
     SCOPED_LATENCY_METRIC(metrics_, sync_latency);
-    status = active_segment_->Sync();
+    if (FLAGS_log_cross_tablet_group_commit) {
+      status = LogSyncGroup::Shared().Sync(active_segment_->writable_file().get());
+    } else {
+      status = active_segment_->Sync();
+    }
   }
 
   return status;
@@ -1444,7 +1459,11 @@ Status Log::GC(int64_t min_op_idx, int32_t* num_gced) {
       LOG_WITH_PREFIX(INFO) << "Deleting log segment in path: " << segment->path()
                             << " (GCed ops < " << segment->footer().max_replicate_index() + 1
                             << ")";
-      RETURN_NOT_OK(get_env()->DeleteFile(segment->path()));
+      // Segment that is still used by a reader is not recycled, because zero filling would
+      // change data that the reader sees.
+      if (!segment->HasOneRef() || !segment_pool_->Put(segment->path())) {
+        RETURN_NOT_OK(get_env()->DeleteFile(segment->path()));
+      }
       (*num_gced)++;
 
       if (metrics_) {
@@ -1534,6 +1553,7 @@ Status Log::Close() {
   // Allocation pool is used from appender pool, so we should shutdown appender first.
   appender_->Shutdown();
   allocation_token_.reset();
+  segment_pool_->Shutdown();
 
   if (PREDICT_FALSE(FLAGS_TEST_simulate_abrupt_server_restart)) {
     return Status::OK();
@@ -1785,7 +1805,17 @@ Status Log::PreAllocateNewSegment() {
   CHECK_EQ(allocation_state(), SegmentAllocationState::kAllocationInProgress);
 
   auto opts = GetNewSegmentWritableFileOptions();
-  RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  auto pooled_path = JoinPathSegments(wal_dir_, kSegmentPlaceholderFilePrefix + "pooled");
+  if (segment_pool_->Take(pooled_path)) {
+    // Pooled segment is zero filled, so it is written from the beginning, like a new one.
+    next_segment_path_ = pooled_path;
+    opts.mode = Env::OPEN_EXISTING;
+    opts.initial_offset = 0;
+    RETURN_NOT_OK(env_util::OpenFileForWrite(
+        opts, get_env(), next_segment_path_, &next_segment_file_));
+  } else {
+    RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  }
 
   if (options_.preallocate_segments) {
     uint64_t next_segment_size = NextSegmentDesiredSize();
@@ -238,6 +238,10 @@ class Log : public RefCountedThreadSafe<Log> {
   Status GetGCableDataSize(int64_t min_op_idx, int64_t* total_size) const;
 
   // Returns the file system location of the currently active WAL segment.
+  LogSegmentPool* TEST_SegmentPool() const {
+    return segment_pool_.get();
+  }
+
   const WritableLogSegment* TEST_ActiveSegment() const {
     return active_segment_.get();
   }
@@ -573,6 +577,9 @@ class Log : public RefCountedThreadSafe<Log> {
   // A thread pool for asynchronously pre-allocating new log segments.
   std::unique_ptr<ThreadPoolToken> allocation_token_;
 
+  // Garbage collected segments that are reused by new segments, zero filled on allocation pool.
+  std::unique_ptr<LogSegmentPool> segment_pool_;
+
   // A thread pool for performing log fsync operations.
   std::unique_ptr<ThreadPoolToken> background_sync_threadpool_token_;
 
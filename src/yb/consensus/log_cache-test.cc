@@ -41,7 +41,9 @@
 
 #include "yb/common/wire_protocol-test-util.h"
 
+#include "yb/consensus/compression.h"
 #include "yb/consensus/consensus-test-util.h"
+#include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_cache.h"
 #include "yb/consensus/log_reader.h"
@@ -65,6 +67,7 @@ using std::atomic;
 using std::shared_ptr;
 using std::thread;
 
+DECLARE_uint64(compression_min_input_bytes);
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_percentage);
@@ -219,6 +222,65 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
   EXPECT_EQ(MakeOpIdForIndex(start + 1), OpId::FromPB(read_result.messages[0]->id()));
 }
 
+// Test that operations are encoded once and the encoding is released on eviction.
+TEST_F(LogCacheTest, TestEncodeOps) {
+  constexpr int64_t kNumEncodedMessages = 10;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumEncodedMessages, /* payload_size= */ 100));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  const auto size_before_encoding = cache_->metrics_.size->value();
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumEncodedMessages, read_result.messages.size());
+  auto encoded = cache_->EncodeOps(read_result.messages);
+  ASSERT_EQ(read_result.messages.size(), encoded.size());
+  for (size_t i = 0; i != encoded.size(); ++i) {
+    ASSERT_EQ(read_result.messages[i]->SerializeAsString(), encoded[i].ToBuffer());
+  }
+  ASSERT_GT(cache_->metrics_.size->value(), size_before_encoding);
+
+  // The same buffers are returned for the next follower.
+  auto encoded_again = cache_->EncodeOps(read_result.messages);
+  for (size_t i = 0; i != encoded.size(); ++i) {
+    ASSERT_EQ(encoded[i].data(), encoded_again[i].data());
+  }
+
+  cache_->EvictThroughOp(kNumEncodedMessages);
+  ASSERT_EQ(0, cache_->metrics_.num_ops->value());
+  ASSERT_EQ(0, cache_->metrics_.size->value());
+}
+
+// The same batch of operations sent to several followers is compressed once.
+TEST_F(LogCacheTest, TestCompressOps) {
+  constexpr int64_t kNumMessages = 10;
+  FLAGS_compression_min_input_bytes = 0;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumMessages, /* payload_size= */ 100));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumMessages, read_result.messages.size());
+  ThreadSafeArena arena;
+  auto make_request = [&arena, &read_result](size_t skip) {
+    auto* request = arena.NewObject<LWConsensusRequestPB>(&arena);
+    request->mutable_preceding_id()->set_index(skip);
+    for (size_t i = skip; i != read_result.messages.size(); ++i) {
+      request->mutable_ops()->push_back_ref(read_result.messages[i].get());
+    }
+    return request;
+  };
+
+  const auto type = CompressionTypePB::SNAPPY_COMPRESSION;
+  auto compressed = ASSERT_RESULT(cache_->CompressOps(type, *make_request(0)));
+  ASSERT_TRUE(compressed);
+  ASSERT_EQ(compressed.ToBuffer(), ASSERT_RESULT(CompressOps(type, *make_request(0))).ToBuffer());
+  auto compressed_again = ASSERT_RESULT(cache_->CompressOps(type, *make_request(0)));
+  ASSERT_EQ(compressed.data(), compressed_again.data());
+
+  // Another batch is compressed separately.
+  auto compressed_other = ASSERT_RESULT(cache_->CompressOps(type, *make_request(1)));
+  ASSERT_NE(compressed.data(), compressed_other.data());
+  ASSERT_NE(compressed.ToBuffer(), compressed_other.ToBuffer());
+}
+
 // Test cache entry shouldn't be evicted until it's synced to disk.
 TEST_F(LogCacheTest, ShouldNotEvictUnsyncedOpFromCache) {
   ASSERT_OK(AppendReplicateMessageToCache(/* term = */ 1, /* index = */ 1));
@@ -37,6 +37,7 @@
 #include <mutex>
 #include <vector>
 
+#include "yb/consensus/compression.h"
 #include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log.h"
@@ -456,6 +457,96 @@ Result<ReadOpsResult> LogCache::ReadOps(
   return result;
 }
 
+std::vector<RefCntBuffer> LogCache::EncodeOps(const ReplicateMsgs& msgs) {
+  std::vector<RefCntBuffer> result(msgs.size());
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (size_t i = 0; i != msgs.size(); ++i) {
+      auto it = cache_.find(msgs[i]->id().index());
+      if (it != cache_.end() && it->second.msg == msgs[i]) {
+        result[i] = it->second.encoded;
+      }
+    }
+  }
+
+  // Serialize outside of the lock.
+  boost::container::small_vector<size_t, 8> just_encoded;
+  for (size_t i = 0; i != msgs.size(); ++i) {
+    if (result[i]) {
+      continue;
+    }
+    const auto& msg = *msgs[i];
+    RefCntBuffer encoded(msg.SerializedSize());
+    auto* end = msg.SerializeToArray(encoded.udata());
+    DCHECK_EQ(end, encoded.uend());
+    result[i] = std::move(encoded);
+    just_encoded.push_back(i);
+  }
+  if (just_encoded.empty()) {
+    return result;
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  for (auto i : just_encoded) {
+    auto it = cache_.find(msgs[i]->id().index());
+    if (it == cache_.end() || it->second.msg != msgs[i] || it->second.encoded) {
+      continue;
+    }
+    auto& entry = it->second;
+    entry.encoded = result[i];
+    const auto mem_usage = entry.encoded.DynamicMemoryUsage();
+    entry.mem_usage += mem_usage;
+    if (entry.tracked) {
+      tracker_->Consume(mem_usage);
+    }
+    metrics_.size->IncrementBy(mem_usage);
+  }
+  return result;
+}
+
+Result<RefCntBuffer> LogCache::CompressOps(
+    CompressionTypePB type, const LWConsensusRequestPB& request) {
+  const auto num_ops = request.ops().size() + request.encoded_ops().size();
+  if (type == CompressionTypePB::NO_COMPRESSION || num_ops == 0) {
+    return RefCntBuffer();
+  }
+  // Operations of the request have consecutive indexes after the preceding one.
+  const auto preceding_index = request.preceding_id().index();
+  const auto last_index = preceding_index + static_cast<int64_t>(num_ops);
+  ReplicateMsgPtr last_msg;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    auto it = cache_.find(last_index);
+    if (it != cache_.end()) {
+      const auto& entry = it->second;
+      const bool same_op = request.encoded_ops().empty()
+          ? entry.msg.get() == &request.ops().back()
+          : entry.encoded && entry.encoded.data() == request.encoded_ops().back().cdata();
+      if (same_op) {
+        last_msg = entry.msg;
+        const auto& last = last_compressed_ops_;
+        if (last.type == type && last.preceding_index == preceding_index &&
+            last.last_msg == last_msg) {
+          return last.data;
+        }
+      }
+    }
+  }
+
+  // Compress outside of the lock.
+  auto result = VERIFY_RESULT(consensus::CompressOps(type, request));
+  if (last_msg) {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    last_compressed_ops_ = CompressedOps {
+      .type = type,
+      .preceding_index = preceding_index,
+      .last_msg = std::move(last_msg),
+      .data = result,
+    };
+  }
+  return result;
+}
+
 size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
   // Capture the evicted messages and release the memory outside of lock.
   ReplicateMsgVector evicted_messages;
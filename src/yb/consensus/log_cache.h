@@ -60,6 +60,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/mutex.h"
 #include "yb/util/opid.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/status_callback.h"
 
@@ -132,6 +133,15 @@ class LogCache {
       CoarseTimePoint deadline = CoarseTimePoint::max(),
       bool fetch_single_entry = false);
 
+  // Returns serialized msgs, in the same order. Serialization of messages that are still in the
+  // cache is kept there, so each message is serialized once for requests to all followers.
+  std::vector<RefCntBuffer> EncodeOps(const ReplicateMsgs& msgs);
+
+  // Returns ops or encoded_ops of the request compressed with type, see consensus::CompressOps.
+  // The result for the last compressed batch of cached operations is kept, so the same batch sent
+  // to several followers is compressed once.
+  Result<RefCntBuffer> CompressOps(CompressionTypePB type, const LWConsensusRequestPB& request);
+
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
   //
@@ -199,6 +209,20 @@ class LogCache {
 
     // Did we start memory tracking for this entry.
     bool tracked = false;
+
+    // Serialized msg, filled by EncodeOps. Its memory is included in mem_usage.
+    RefCntBuffer encoded;
+  };
+
+  // Ops of the request compressed by CompressOps.
+  struct CompressedOps {
+    CompressionTypePB type = CompressionTypePB::NO_COMPRESSION;
+    int64_t preceding_index = 0;
+    // The last operation of the request. Operations are replaced only together with all following
+    // ones, so the same last operation means the same batch. Keeping the reference makes sure that
+    // its address is not reused.
+    ReplicateMsgPtr last_msg;
+    RefCntBuffer data;
   };
 
   typedef boost::container::small_vector<ReplicateMsgPtr, 8> ReplicateMsgVector;
@@ -258,6 +282,8 @@ class LogCache {
   typedef std::map<int64_t, CacheEntry> MessageCache;
   MessageCache cache_ GUARDED_BY(lock_);
 
+  CompressedOps last_compressed_ops_ GUARDED_BY(lock_);
+
   // The next log index to append. Each append operation must either start with this log index, or
   // go backward (but never skip forward).
   int64_t next_sequential_op_index_ GUARDED_BY(lock_);
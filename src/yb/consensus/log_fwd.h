@@ -30,6 +30,7 @@ class LogEntryPB;
 class LogIndex;
 class LogReader;
 class LogSegmentFooterPB;
+class LogSegmentPool;
 class LogSegmentHeaderPB;
 class ReadableLogSegment;
 class WritableLogSegment;
@@ -0,0 +1,225 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_segment_pool.h"
+
+#include <algorithm>
+
+#include "yb/gutil/strings/numbers.h"
+#include "yb/gutil/strings/util.h"
+
+#include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/status_log.h"
+#include "yb/util/threadpool.h"
+
+using namespace yb::size_literals;
+
+DEFINE_RUNTIME_uint32(log_segment_pool_max_segments, 0,
+                      "Max number of garbage collected WAL segments of a tablet that are kept zero "
+                      "filled for reuse by its new segments, instead of being deleted. "
+                      "0 disables recycling of WAL segments.");
+TAG_FLAG(log_segment_pool_max_segments, advanced);
+
+namespace yb {
+namespace log {
+
+namespace {
+
+const std::string kPoolDirName = ".segment_pool";
+const std::string kReadyPrefix = "segment-";
+const std::string kFillingPrefix = "filling-";
+
+constexpr size_t kZeroFillChunkSize = 1_MB;
+
+} // namespace
+
+LogSegmentPool::LogSegmentPool(Env* env, const std::string& wal_dir, ThreadPool* pool)
+    : env_(env), dir_(JoinPathSegments(wal_dir, kPoolDirName)),
+      fill_token_(pool->NewToken(ThreadPool::ExecutionMode::SERIAL)) {}
+
+LogSegmentPool::~LogSegmentPool() {
+  Shutdown();
+}
+
+void LogSegmentPool::Shutdown() {
+  fill_token_->Shutdown();
+}
+
+Status LogSegmentPool::EnsureInitialized() {
+  if (initialized_) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env_, dir_));
+  auto children = VERIFY_RESULT(env_->GetChildren(dir_, ExcludeDots::kTrue));
+  for (const auto& child : children) {
+    uint64_t id;
+    if (HasPrefixString(child, kReadyPrefix) &&
+        safe_strtou64(child.substr(kReadyPrefix.size()), &id)) {
+      files_.push_back(id);
+      next_id_ = std::max(next_id_, id + 1);
+      continue;
+    }
+    // Zero filling was interrupted by restart.
+    WARN_NOT_OK(env_->DeleteFile(JoinPathSegments(dir_, child)),
+                "Failed to delete incomplete pooled WAL segment");
+  }
+  LOG(INFO) << "WAL segment pool in " << dir_ << " has " << files_.size() << " segments";
+  initialized_ = true;
+  return Status::OK();
+}
+
+std::string LogSegmentPool::FilePath(uint64_t id) const {
+  return JoinPathSegments(dir_, kReadyPrefix + std::to_string(id));
+}
+
+std::string LogSegmentPool::FillingFilePath(uint64_t id) const {
+  return JoinPathSegments(dir_, kFillingPrefix + std::to_string(id));
+}
+
+bool LogSegmentPool::Enabled() const {
+  // Encrypted segments get their encryption header when created by NewTempWritableFile, while a
+  // pooled file is reopened and zero filled through the plain file interfaces.
+  return FLAGS_log_segment_pool_max_segments != 0 && !env_->IsEncrypted();
+}
+
+bool LogSegmentPool::Take(const std::string& path) {
+  if (env_->IsEncrypted()) {
+    return false;
+  }
+  for (;;) {
+    uint64_t id;
+    {
+      std::lock_guard lock(mutex_);
+      if (!initialized_ && FLAGS_log_segment_pool_max_segments == 0) {
+        return false;
+      }
+      auto status = EnsureInitialized();
+      if (!status.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 60)
+            << "Failed to init WAL segment pool in " << dir_ << ": " << status;
+        return false;
+      }
+      if (files_.empty()) {
+        return false;
+      }
+      id = files_.back();
+      files_.pop_back();
+    }
+    auto status = env_->RenameFile(FilePath(id), path);
+    if (status.ok()) {
+      VLOG(1) << "Reusing pooled WAL segment " << id << " as " << path;
+      return true;
+    }
+    LOG(WARNING) << "Failed to take pooled WAL segment " << id << ": " << status;
+  }
+}
+
+bool LogSegmentPool::Put(const std::string& path) {
+  if (!Enabled()) {
+    return false;
+  }
+  // Segments are hard linked to WAL dirs of other tablets, for instance by split, and such segment
+  // should not be zero filled.
+  auto num_links = env_->GetFileNumLinks(path);
+  if (!num_links.ok() || *num_links != 1) {
+    return false;
+  }
+
+  uint64_t id;
+  {
+    std::lock_guard lock(mutex_);
+    auto status = EnsureInitialized();
+    if (!status.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 60)
+          << "Failed to init WAL segment pool in " << dir_ << ": " << status;
+      return false;
+    }
+    if (files_.size() + num_filling_ >= FLAGS_log_segment_pool_max_segments) {
+      return false;
+    }
+    ++num_filling_;
+    id = next_id_++;
+  }
+
+  // Segment is moved out of the WAL dir before zero filling, so a restart could not find it
+  // partially filled among the segments of the log.
+  auto filling_path = FillingFilePath(id);
+  auto status = env_->RenameFile(path, filling_path);
+  const bool moved = status.ok();
+  if (moved) {
+    status = fill_token_->SubmitFunc([this, id] { Fill(id); });
+    if (status.ok()) {
+      return true;
+    }
+    // The file is not at path anymore, so it is deleted here.
+    WARN_NOT_OK(env_->DeleteFile(filling_path), "Failed to delete WAL segment");
+  }
+
+  LOG(WARNING) << "Failed to recycle WAL segment " << path << ": " << status;
+  {
+    std::lock_guard lock(mutex_);
+    --num_filling_;
+  }
+  return moved;
+}
+
+void LogSegmentPool::Fill(uint64_t id) {
+  auto filling_path = FillingFilePath(id);
+  auto status = ZeroFill(filling_path);
+  if (status.ok()) {
+    status = env_->RenameFile(filling_path, FilePath(id));
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to zero fill WAL segment " << filling_path << ": " << status;
+    WARN_NOT_OK(env_->DeleteFile(filling_path), "Failed to delete WAL segment");
+  }
+
+  std::lock_guard lock(mutex_);
+  --num_filling_;
+  if (status.ok()) {
+    files_.push_back(id);
+  }
+}
+
+Status LogSegmentPool::ZeroFill(const std::string& path) {
+  RWFileOptions opts;
+  opts.mode = Env::OPEN_EXISTING;
+  std::unique_ptr<RWFile> file;
+  RETURN_NOT_OK(env_->NewRWFile(opts, path, &file));
+  uint64_t size;
+  RETURN_NOT_OK(file->Size(&size));
+  static const std::string kZeros(kZeroFillChunkSize, '\0');
+  for (uint64_t offset = 0; offset < size; offset += kZeroFillChunkSize) {
+    RETURN_NOT_OK(file->Write(
+        offset, Slice(kZeros.data(), std::min<uint64_t>(kZeroFillChunkSize, size - offset))));
+  }
+  RETURN_NOT_OK(file->Sync());
+  return file->Close();
+}
+
+size_t LogSegmentPool::TEST_size() const {
+  std::lock_guard lock(mutex_);
+  return files_.size();
+}
+
+void LogSegmentPool::TEST_WaitFilled() {
+  fill_token_->Wait();
+}
+
+} // namespace log
+} // namespace yb
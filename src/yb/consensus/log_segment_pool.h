@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Recycling of WAL segment files.
+//
+// Creating a new segment file for each rollover and deleting garbage collected segments results in
+// a lot of file system metadata operations when there are thousands of tablets, and the first write
+// to a freshly preallocated extent also has to convert it. LogSegmentPool keeps garbage collected
+// segments of a log in a directory inside its WAL directory. Pooled files are zero filled, so a
+// recycled segment does not contain entries of its previous life, and its extents are already
+// written. Files are moved between the pool and the WAL directory with rename only.
+//
+// Segments are not recycled when the env is encrypted, since an encrypted segment should start with
+// a fresh encryption header.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Env;
+class ThreadPool;
+class ThreadPoolToken;
+
+namespace log {
+
+class LogSegmentPool {
+ public:
+  // Pooled files are kept in a subdirectory of wal_dir and are zero filled by tasks on pool.
+  LogSegmentPool(Env* env, const std::string& wal_dir, ThreadPool* pool);
+  ~LogSegmentPool();
+
+  // Moves a pooled segment file to path. Returns false if the pool is empty.
+  bool Take(const std::string& path) EXCLUDES(mutex_);
+
+  // Moves the garbage collected segment file at path to the pool, it is zero filled in background.
+  // Returns false if the file was not taken by the pool, so the caller should delete it. Files
+  // that have other hard links are never taken.
+  bool Put(const std::string& path) EXCLUDES(mutex_);
+
+  // Stops zero filling, files that were not filled yet are deleted on the next start.
+  void Shutdown();
+
+  size_t TEST_size() const EXCLUDES(mutex_);
+
+  // Waits until segments put to the pool are zero filled.
+  void TEST_WaitFilled();
+
+ private:
+  // Picks up files left by the previous start. Failure is not remembered, so it is retried on the
+  // next use of the pool.
+  Status EnsureInitialized() REQUIRES(mutex_);
+
+  // Whether new segments could be put to the pool.
+  bool Enabled() const;
+
+  void Fill(uint64_t id) EXCLUDES(mutex_);
+
+  Status ZeroFill(const std::string& path);
+
+  std::string FilePath(uint64_t id) const;
+  std::string FillingFilePath(uint64_t id) const;
+
+  Env* const env_;
+  const std::string dir_;
+  std::unique_ptr<ThreadPoolToken> fill_token_;
+
+  mutable std::mutex mutex_;
+  bool initialized_ GUARDED_BY(mutex_) = false;
+  // Ids of zero filled files available for reuse.
+  std::vector<uint64_t> files_ GUARDED_BY(mutex_);
+  // Number of files that are being zero filled, they are accounted against the pool size.
+  size_t num_filling_ GUARDED_BY(mutex_) = 0;
+  uint64_t next_id_ GUARDED_BY(mutex_) = 0;
+};
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <vector>
+
+#include "yb/util/env.h"
+#include "yb/util/io_uring.h"
+
+namespace yb {
+namespace log {
+
+struct LogSyncGroup::Group {
+  std::vector<WritableFile*> files;
+  // Filled by the leader, statuses[i] is the status of syncing files[i].
+  std::vector<Status> statuses;
+  // Waiters of this group only, so completion of a group does not wake up the next one.
+  std::condition_variable cond;
+  bool done = false;
+};
+
+LogSyncGroup& LogSyncGroup::Shared() {
+  static LogSyncGroup group;
+  return group;
+}
+
+Status LogSyncGroup::Sync(WritableFile* file) {
+  if (!ThreadLocalIoUring()) {
+    return file->Sync();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!pending_) {
+    pending_ = std::make_shared<Group>();
+  }
+  auto group = pending_;
+  const auto idx = group->files.size();
+  group->files.push_back(file);
+  // Wait until our group is synced by its leader, or there is no active leader, so this thread
+  // becomes the leader of our group. A group is detached from pending_ only by its leader, so a
+  // group that is not done while there is no active leader is still pending_.
+  group->cond.wait(lock, [this, &group]() NO_THREAD_SAFETY_ANALYSIS {
+    return group->done || !leader_active_;
+  });
+  if (group->done) {
+    return group->statuses[idx];
+  }
+
+  leader_active_ = true;
+  ++num_groups_;
+  pending_.reset();
+  lock.unlock();
+
+  // The group is detached, so nobody else accesses its files and statuses until it is done.
+  group->statuses.resize(group->files.size());
+  WritableFile::SyncFiles(group->files.data(), group->files.size(), group->statuses.data());
+
+  lock.lock();
+  group->done = true;
+  leader_active_ = false;
+  auto next = pending_;
+  lock.unlock();
+  group->cond.notify_all();
+  // Wake up one waiter of the next group, it becomes the leader.
+  if (next) {
+    next->cond.notify_one();
+  }
+  return group->statuses[idx];
+}
+
+size_t LogSyncGroup::TEST_num_groups() {
+  std::lock_guard lock(mutex_);
+  return num_groups_;
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Group commit of WAL syncs across tablets.
+//
+// Each tablet has its own log, so with thousands of tablets per server every small write pays for
+// a system call that blocks a thread until its fsync completes. LogSyncGroup collects syncs of
+// segment files that are requested concurrently by different logs and performs them together: the
+// first thread that requests a sync becomes the leader of the group, syncs files of the group with
+// WritableFile::SyncFiles and wakes up the followers of this group only. Requests that arrive while
+// the leader is syncing form the next group, and one of them becomes its leader.
+//
+// Every file is still synced by its own fdatasync, what the group saves are system calls:
+// fdatasyncs of the whole group are submitted by a single io_uring submission and executed by the
+// kernel concurrently, while followers only wait for the leader. Without io_uring SyncFiles syncs
+// files one by one, so the group would just serialize fsyncs of different logs, and each log syncs
+// its file directly instead.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+class WritableFile;
+
+namespace log {
+
+class LogSyncGroup {
+ public:
+  // Group shared by all logs of the process, used when --log_cross_tablet_group_commit is set.
+  static LogSyncGroup& Shared();
+
+  // Syncs file, possibly together with files of other logs. Returns status of syncing this file.
+  Status Sync(WritableFile* file);
+
+  // Number of groups synced by leaders so far.
+  size_t TEST_num_groups();
+
+ private:
+  struct Group;
+
+  std::mutex mutex_;
+  // Group that collects new requests, null when there are no such requests.
+  std::shared_ptr<Group> pending_ GUARDED_BY(mutex_);
+  // Whether some thread is syncing a group.
+  bool leader_active_ GUARDED_BY(mutex_) = false;
+  size_t num_groups_ GUARDED_BY(mutex_) = 0;
+};
+
+} // namespace log
+} // namespace yb
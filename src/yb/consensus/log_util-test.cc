@@ -13,8 +13,26 @@
 
 #include <gtest/gtest.h>
 
+#include "yb/consensus/compression.h"
+#include "yb/consensus/consensus.messages.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
+#include "yb/gutil/casts.h"
+#include "yb/util/coding.h"
+#include "yb/util/env.h"
+#include "yb/util/faststring.h"
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/io_uring.h"
+#include "yb/util/memory/arena.h"
 #include "yb/util/test_macros.h"
+#include "yb/util/test_thread_holder.h"
+#include "yb/util/test_util.h"
+
+DECLARE_uint64(compression_min_input_bytes);
+DECLARE_int32(consensus_compression_type);
+DECLARE_bool(enable_io_uring);
+DECLARE_uint64(rpc_max_message_size);
 
 namespace yb {
 
@@ -47,4 +65,149 @@ TEST(TestLogUtil, TestModifyDurableWriteFlagIfNotODirectPositive) {
   FLAGS_durable_wal_write = false;
   ASSERT_OK(log::ModifyDurableWriteFlagIfNotODirect());
 }
+
+TEST(TestLogUtil, CompressOps) {
+  gflags::FlagSaver flag_saver;
+  constexpr int kNumOps = 50;
+  for (auto type : {consensus::CompressionTypePB::SNAPPY_COMPRESSION,
+                    consensus::CompressionTypePB::LZ4_COMPRESSION}) {
+    FLAGS_consensus_compression_type = type;
+    ThreadSafeArena arena;
+    auto* request = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+    request->set_caller_term(1);
+    for (int i = 1; i <= kNumOps; ++i) {
+      auto& op = request->mutable_ops()->emplace_back();
+      op.mutable_id()->set_term(1);
+      op.mutable_id()->set_index(i);
+      op.set_op_type(consensus::NO_OP);
+      op.mutable_noop_request()->dup_payload_for_tests(std::string(100, 'a' + i % 26));
+    }
+    const auto expected = request->ShortDebugString();
+
+    ASSERT_OK(consensus::CompressOps(request));
+    ASSERT_TRUE(request->ops().empty());
+    ASSERT_TRUE(request->has_compressed_ops());
+    ASSERT_EQ(request->ops_compression(), type);
+
+    // Pass the request through serialization, like it happens when it is sent to a follower.
+    auto serialized = request->SerializeAsString();
+    ASSERT_LT(serialized.size(), kNumOps * 100);
+    auto* received = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+    ASSERT_OK(received->ParseFromSlice(serialized));
+    ASSERT_OK(consensus::UncompressOps(received));
+    ASSERT_FALSE(received->has_compressed_ops());
+    ASSERT_EQ(kNumOps, received->ops().size());
+    ASSERT_EQ(expected, received->ShortDebugString());
+  }
+}
+
+TEST(TestLogUtil, EncodedOps) {
+  gflags::FlagSaver flag_saver;
+  constexpr int kNumOps = 50;
+  for (auto type : {consensus::CompressionTypePB::NO_COMPRESSION,
+                    consensus::CompressionTypePB::SNAPPY_COMPRESSION}) {
+    FLAGS_consensus_compression_type = type;
+    ThreadSafeArena arena;
+    auto* expected = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+    auto* request = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+    for (int i = 1; i <= kNumOps; ++i) {
+      auto& op = expected->mutable_ops()->emplace_back();
+      op.mutable_id()->set_term(1);
+      op.mutable_id()->set_index(i);
+      op.set_op_type(consensus::NO_OP);
+      op.mutable_noop_request()->dup_payload_for_tests(std::string(100, 'a' + i % 26));
+      request->add_dup_encoded_ops(op.SerializeAsString());
+    }
+
+    ASSERT_OK(consensus::CompressOps(request));
+    ASSERT_EQ(request->has_compressed_ops(), type != consensus::CompressionTypePB::NO_COMPRESSION);
+
+    auto* received = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+    ASSERT_OK(received->ParseFromSlice(request->SerializeAsString()));
+    ASSERT_OK(consensus::UncompressOps(received));
+    ASSERT_OK(consensus::DecodeOps(received));
+    ASSERT_TRUE(received->encoded_ops().empty());
+    ASSERT_EQ(kNumOps, received->ops().size());
+    ASSERT_EQ(expected->ShortDebugString(), received->ShortDebugString());
+  }
+}
+
+TEST(TestLogUtil, UncompressOpsValidation) {
+  gflags::FlagSaver flag_saver;
+  const auto type = consensus::CompressionTypePB::SNAPPY_COMPRESSION;
+  ThreadSafeArena arena;
+
+  // Uncompressed length that exceeds max RPC message size is rejected before allocation.
+  auto* request = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+  faststring oversized;
+  PutVarint32(&oversized, narrow_cast<uint32_t>(FLAGS_rpc_max_message_size + 1));
+  oversized.append("garbage");
+  request->set_ops_compression(type);
+  request->dup_compressed_ops(Slice(oversized));
+  ASSERT_TRUE(consensus::UncompressOps(request).IsInvalidArgument());
+
+  // Compressed data could contain only ops.
+  FLAGS_compression_min_input_bytes = 0;
+  auto* source = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+  source->dup_tablet_id(std::string(100, 't'));
+  auto& op = source->mutable_ops()->emplace_back();
+  op.mutable_id()->set_term(1);
+  op.mutable_id()->set_index(1);
+  op.set_op_type(consensus::NO_OP);
+  auto serialized = source->SerializeAsString();
+  std::string compressed(consensus::MaxCompressedLength(type, serialized.size()), 0);
+  auto compressed_length = ASSERT_RESULT(consensus::Compress(type, serialized, compressed.data()));
+  ASSERT_GT(compressed_length, 0);
+  compressed.resize(compressed_length);
+  request = arena.NewObject<consensus::LWConsensusRequestPB>(&arena);
+  request->set_ops_compression(type);
+  request->dup_compressed_ops(compressed);
+  ASSERT_TRUE(consensus::UncompressOps(request).IsCorruption());
+}
+
+class LogSyncGroupTest : public YBTest {
+ protected:
+  // Syncs files of kNumThreads threads concurrently through group, returns total number of syncs.
+  size_t ConcurrentSyncs(log::LogSyncGroup* group) {
+    constexpr int kNumThreads = 8;
+    constexpr int kNumSyncs = 100;
+    TestThreadHolder thread_holder;
+    for (int i = 0; i != kNumThreads; ++i) {
+      thread_holder.AddThreadFunctor([this, group, i] {
+        std::unique_ptr<WritableFile> file;
+        ASSERT_OK(env_->NewWritableFile(GetTestPath(Format("wal_$0", i)), &file));
+        for (int j = 0; j != kNumSyncs; ++j) {
+          ASSERT_OK(file->Append(Format("entry $0 ", j)));
+          ASSERT_OK(group->Sync(file.get()));
+        }
+        ASSERT_OK(file->Close());
+      });
+    }
+    thread_holder.JoinAll();
+    return kNumThreads * kNumSyncs;
+  }
+};
+
+TEST_F(LogSyncGroupTest, ConcurrentSyncs) {
+  FLAGS_enable_io_uring = true;
+  if (!ThreadLocalIoUring()) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+  log::LogSyncGroup group;
+  auto num_syncs = ConcurrentSyncs(&group);
+  auto num_groups = group.TEST_num_groups();
+  LOG(INFO) << "Syncs: " << num_syncs << ", groups: " << num_groups;
+  ASSERT_GT(num_groups, 0);
+  // Syncs requested while the leader is syncing its group are grouped together.
+  ASSERT_LT(num_groups, num_syncs);
+}
+
+// Without io_uring files are synced one by one anyway, so syncs should not wait for each other.
+TEST_F(LogSyncGroupTest, BypassWithoutIoUring) {
+  FLAGS_enable_io_uring = false;
+  log::LogSyncGroup group;
+  ConcurrentSyncs(&group);
+  ASSERT_EQ(group.TEST_num_groups(), 0);
+}
+
 } // namespace yb
@@ -41,6 +41,7 @@
 
 #include "yb/common/hybrid_time.h"
 
+#include "yb/consensus/compression.h"
 #include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/log.messages.h"
@@ -53,6 +54,7 @@
 #include "yb/gutil/strings/util.h"
 
 #include "yb/util/atomic.h"
+#include "yb/util/cast.h"
 #include "yb/util/coding-inl.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
@@ -122,6 +124,12 @@ DEFINE_UNKNOWN_bool(
 TAG_FLAG(save_index_into_wal_segments, hidden);
 TAG_FLAG(save_index_into_wal_segments, advanced);
 
+DEFINE_RUNTIME_int32(log_compression_type, 0,
+                     "Compression applied to WAL entry batches. 0 - no compression, 1 - snappy, "
+                     "2 - lz4. WAL segments with compressed entries could not be read by "
+                     "versions that do not support compression.");
+TAG_FLAG(log_compression_type, advanced);
+
 namespace yb {
 namespace log {
 
@@ -150,7 +158,17 @@ const size_t kLogSegmentFooterMagicAndFooterLength  = 12;
 const size_t kEntryHeaderSize = 12;
 
 const int kLogMajorVersion = 1;
-const int kLogMinorVersion = 0;
+const int kLogMinorVersion = 1;
+
+namespace {
+
+// Starting from this minor version, high bits of the length in the entry header contain
+// the compression type of the entry batch.
+const int kLogMinorVersionWithCompression = 1;
+const int kEntryCompressionShift = 29;
+const uint32_t kEntryLengthMask = (1U << kEntryCompressionShift) - 1;
+
+} // namespace
 
 // Maximum log segment header/footer size, in bytes (8 MB).
 const uint32_t kLogSegmentMaxHeaderOrFooterSize = 8 * 1024 * 1024;
@@ -906,6 +924,13 @@ Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* hea
         Corruption, "Invalid checksum in log entry head header: found=$0, computed=$1",
         header->header_crc, computed_crc);
   }
+
+  if (header_.minor_version() >= kLogMinorVersionWithCompression) {
+    header->compression = header->msg_length >> kEntryCompressionShift;
+    header->msg_length &= kEntryLengthMask;
+  } else {
+    header->compression = consensus::CompressionTypePB::NO_COMPRESSION;
+  }
   return Status::OK();
 }
 
@@ -949,6 +974,28 @@ Result<std::shared_ptr<LWLogEntryBatchPB>> ReadableLogSegment::ReadEntryBatch(
                                          header.msg_crc, read_crc));
   }
 
+  // Compressed batches are kept compressed in the file and decompressed only when read.
+  Slice batch_data = entry_batch_slice.Prefix(header.msg_length);
+  if (header.compression != consensus::CompressionTypePB::NO_COMPRESSION) {
+    if (!consensus::CompressionTypePB_IsValid(header.compression)) {
+      return STATUS_FORMAT(
+          Corruption, "Unknown compression type $0 of entry at offset: $1", header.compression,
+          *offset);
+    }
+    const auto compression = static_cast<consensus::CompressionTypePB>(header.compression);
+    auto uncompressed_length = VERIFY_RESULT(consensus::UncompressedLength(batch_data));
+    RefCntBuffer uncompressed(uncompressed_length);
+    s = consensus::Uncompress(
+        compression, batch_data, uncompressed.data(), uncompressed_length);
+    if (!s.ok()) {
+      return STATUS_FORMAT(
+          Corruption, "Failed to decompress entry at offset: $0, length: $1. Cause: $2", *offset,
+          header.msg_length, s);
+    }
+    buffer = std::move(uncompressed);
+    batch_data = buffer.AsSlice();
+  }
+
   // TODO(lw_uc) embed buffer and first arena block into holder itself.
   struct DataHolder {
     RefCntBuffer buffer;
@@ -959,7 +1006,7 @@ Result<std::shared_ptr<LWLogEntryBatchPB>> ReadableLogSegment::ReadEntryBatch(
 
   auto holder = std::make_shared<DataHolder>(buffer);
   auto batch = holder->arena.NewArenaObject<LWLogEntryBatchPB>();
-  s = batch->ParseFromSlice(entry_batch_slice.Prefix(header.msg_length));
+  s = batch->ParseFromSlice(batch_data);
 
   if (!s.ok()) {
     return STATUS_FORMAT(
@@ -967,7 +1014,7 @@ Result<std::shared_ptr<LWLogEntryBatchPB>> ReadableLogSegment::ReadEntryBatch(
         header.msg_length, s);
   }
 
-  *offset += entry_batch_slice.size();
+  *offset += header.msg_length;
   return rpc::SharedField(holder, batch);
 }
 
@@ -1112,13 +1159,29 @@ Status WritableLogSegment::WriteIndexWithFooterAndClose(
   return Status::OK();
 }
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
-  // First encode the length of the message.
-  auto len = data.size();
+  Slice data = entry_batch_data;
+  uint32_t compression = consensus::CompressionTypePB::NO_COMPRESSION;
+  if (header_.minor_version() >= kLogMinorVersionWithCompression) {
+    auto type = consensus::CompressionTypeFromFlag(FLAGS_log_compression_type);
+    if (type != consensus::CompressionTypePB::NO_COMPRESSION) {
+      compression_buffer_.resize(consensus::MaxCompressedLength(type, data.size()));
+      auto compressed_length = VERIFY_RESULT(consensus::Compress(
+          type, data, pointer_cast<char*>(compression_buffer_.data())));
+      if (compressed_length) {
+        data = Slice(compression_buffer_.data(), compressed_length);
+        compression = type;
+      }
+    }
+    SCHECK_LE(data.size(), kEntryLengthMask, InvalidArgument, "Too big entry batch");
+  }
+
+  // First encode the length of the message, with compression type in high bits.
+  auto len = data.size() | (compression << kEntryCompressionShift);
   InlineEncodeFixed32(&header_buf[0], narrow_cast<uint32_t>(len));
 
   // Then the CRC of the message.
@@ -71,6 +71,7 @@ extern const char kTmpSuffix[];
 
 // Each log entry is prefixed by its length (4 bytes), CRC (4 bytes),
 // and checksum of the other two fields (see EntryHeader struct below).
+// Since minor version 1 the high 3 bits of the length contain compression type of the entry.
 extern const size_t kEntryHeaderSize;
 
 extern const int kLogMajorVersion;
@@ -303,9 +304,12 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   FRIEND_TEST(LogTest, TestWriteAndReadToAndFromInProgressSegment);
 
   struct EntryHeader {
-    // The length of the batch data.
+    // The length of the batch data, as stored in the file.
     uint32_t msg_length;
 
+    // The compression of the batch data, see consensus::CompressionTypePB.
+    uint32_t compression;
+
     // The CRC32C of the batch data.
     uint32_t msg_crc;
 
@@ -432,7 +436,7 @@ class WritableLogSegment {
   }
 
   // Appends the provided batch of data, including a header
-  // and checksum.
+  // and checksum. The batch is compressed according to --log_compression_type.
   // Makes sure that the log segment has not been closed.
   Status WriteEntryBatch(const Slice& entry_batch_data);
 
@@ -508,6 +512,9 @@ class WritableLogSegment {
 
   faststring index_block_header_buffer_;
 
+  // Buffer for compressed entry batches, reused between writes.
+  faststring compression_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
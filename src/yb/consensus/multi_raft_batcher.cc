@@ -19,11 +19,15 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus.proxy.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/util/flags.h"
+#include "yb/util/size_literals.h"
 
 using namespace std::literals;
+using namespace yb::size_literals;
 using namespace std::placeholders;
 
 DEFINE_UNKNOWN_bool(enable_multi_raft_heartbeat_batcher, false,
@@ -37,6 +41,20 @@ DEFINE_UNKNOWN_uint64(multi_raft_batch_size, 0,
               "Maximum batch size for a multi-Raft consensus payload. Ignored if set to zero.");
 TAG_FLAG(multi_raft_batch_size, advanced);
 
+DEFINE_RUNTIME_bool(enable_multi_raft_update_batcher, false,
+                    "If true, requests with operations to tablets at the same tablet server are "
+                    "also sent in multi-Raft batches.");
+
+DEFINE_RUNTIME_uint64(multi_raft_update_batch_window_us, 500,
+                      "Max time that a multi-Raft batch with operations waits for requests of "
+                      "other tablets before it is sent.");
+TAG_FLAG(multi_raft_update_batch_window_us, advanced);
+
+DEFINE_RUNTIME_uint64(multi_raft_update_batch_max_bytes, 1_MB,
+                      "Multi-Raft batch with operations is sent once its size reaches this "
+                      "number of bytes.");
+TAG_FLAG(multi_raft_update_batch_max_bytes, advanced);
+
 DECLARE_int32(consensus_rpc_timeout_ms);
 
 namespace yb {
@@ -59,6 +77,9 @@ struct MultiRaftHeartbeatBatcher::MultiRaftConsensusData {
   MultiRaftConsensusResponsePB batch_res;
   rpc::RpcController controller;
   std::vector<ResponseCallbackData> response_callback_data;
+  // Total size of requests with operations in this batch.
+  size_t ops_bytes = 0;
+  bool has_ops = false;
 };
 
 MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
@@ -93,23 +114,75 @@ MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
 void MultiRaftHeartbeatBatcher::AddRequestToBatch(ConsensusRequestPB* request,
                                                   ConsensusResponsePB* response,
                                                   HeartbeatResponseCallback callback) {
+  DoAddRequestToBatch(request, response, std::move(callback), /* has_ops= */ false);
+}
+
+void MultiRaftHeartbeatBatcher::AddUpdateToBatch(ConsensusRequestPB* request,
+                                                 ConsensusResponsePB* response,
+                                                 HeartbeatResponseCallback callback) {
+  DoAddRequestToBatch(request, response, std::move(callback), /* has_ops= */ true);
+}
+
+void MultiRaftHeartbeatBatcher::DoAddRequestToBatch(ConsensusRequestPB* request,
+                                                    ConsensusResponsePB* response,
+                                                    HeartbeatResponseCallback callback,
+                                                    bool has_ops) {
   std::shared_ptr<MultiRaftConsensusData> data = nullptr;
+  bool schedule_send = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      static const Status status = STATUS(Aborted, "MultiRaft shutdown");
+      callback(status);
+      return;
+    }
     current_batch_->response_callback_data.push_back({
       .resp = response,
       .callback = std::move(callback)
     });
+    if (has_ops) {
+      current_batch_->ops_bytes += request->ByteSizeLong();
+      current_batch_->has_ops = true;
+    }
     // Add a ConsensusRequestPB to the batch
     current_batch_->batch_req.add_consensus_request()->Swap(request);
-    if (FLAGS_multi_raft_batch_size > 0
-        && current_batch_->response_callback_data.size() >= FLAGS_multi_raft_batch_size) {
+    if ((FLAGS_multi_raft_batch_size > 0 &&
+         current_batch_->response_callback_data.size() >= FLAGS_multi_raft_batch_size) ||
+        current_batch_->ops_bytes >= FLAGS_multi_raft_update_batch_max_bytes) {
       data = PrepareNextBatchRequest();
+    } else if (has_ops && !send_updates_scheduled_) {
+      send_updates_scheduled_ = true;
+      schedule_send = true;
     }
   }
+  if (schedule_send) {
+    ScheduleSendUpdates();
+  }
   SendBatchRequest(data);
 }
 
+void MultiRaftHeartbeatBatcher::ScheduleSendUpdates() {
+  std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+  messenger_->scheduler().Schedule(
+      [weak_self](const Status& status) {
+        auto self = weak_self.lock();
+        if (!self) {
+          return;
+        }
+        std::shared_ptr<MultiRaftConsensusData> data;
+        {
+          std::lock_guard<std::mutex> lock(self->mutex_);
+          self->send_updates_scheduled_ = false;
+          // When the scheduler is shut down, pending requests are aborted by Shutdown.
+          if (status.ok()) {
+            data = self->PrepareNextBatchRequest();
+          }
+        }
+        self->SendBatchRequest(data);
+      },
+      std::chrono::microseconds(FLAGS_multi_raft_update_batch_window_us));
+}
+
 void MultiRaftHeartbeatBatcher::PrepareAndSendBatchRequest() {
   std::shared_ptr<MultiRaftConsensusData> data;
   {
@@ -138,6 +211,10 @@ void MultiRaftHeartbeatBatcher::SendBatchRequest(std::shared_ptr<MultiRaftConsen
   }
 
   data->controller.Reset();
+  if (data->has_ops) {
+    // Same as for UpdateConsensus of a single tablet.
+    data->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  }
   data->controller.set_timeout(MonoDelta::FromMilliseconds(
       FLAGS_consensus_rpc_timeout_ms * data->batch_req.consensus_request_size()));
   auto callback = [data, running_calls = running_calls_]() {
@@ -175,7 +252,7 @@ MultiRaftManager::MultiRaftManager(rpc::Messenger* messenger,
       local_peer_cloud_info_pb_(std::move(local_peer_cloud_info_pb)) {}
 
 MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const RaftPeerPB& remote_peer_pb) {
-  if (!FLAGS_enable_multi_raft_heartbeat_batcher) {
+  if (!FLAGS_enable_multi_raft_heartbeat_batcher && !FLAGS_enable_multi_raft_update_batcher) {
     return nullptr;
   }
 
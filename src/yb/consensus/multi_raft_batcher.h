@@ -40,6 +40,9 @@ using HeartbeatResponseCallback = std::function<void(const Status&)>;
 // - A heartbeat is added to a batch upon calling AddRequestToBatch and a batch is sent
 //   out every FLAGS_multi_raft_heartbeat_interval_ms ms or once the batch size reaches
 //   FLAGS_multi_raft_batch_size
+// - When FLAGS_enable_multi_raft_update_batcher is set, requests with operations are added
+//   by AddUpdateToBatch. Such a batch is sent FLAGS_multi_raft_update_batch_window_us after
+//   the first operation was added, or once its size reaches FLAGS_multi_raft_update_batch_max_bytes
 // - To improve efficency multiple batches may be processed concurrently
 //   but only a single batch is being built at any given time
 class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
@@ -62,6 +65,12 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
                          ConsensusResponsePB* response,
                          HeartbeatResponseCallback callback);
 
+  // Same as AddRequestToBatch, but for requests that carry operations, so the batch should be sent
+  // without waiting for the heartbeat interval.
+  void AddUpdateToBatch(ConsensusRequestPB* request,
+                        ConsensusResponsePB* response,
+                        HeartbeatResponseCallback callback);
+
   void Shutdown();
 
  private:
@@ -69,6 +78,13 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
   // ResponseCallbackData registered by each local peer with this batch in AddRequestToBatch().
   struct MultiRaftConsensusData;
 
+  void DoAddRequestToBatch(ConsensusRequestPB* request,
+                           ConsensusResponsePB* response,
+                           HeartbeatResponseCallback callback,
+                           bool has_ops);
+
+  void ScheduleSendUpdates();
+
   void PrepareAndSendBatchRequest();
 
   // This method will return a nullptr if the current batch is empty.
@@ -89,6 +105,9 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
 
   std::shared_ptr<MultiRaftConsensusData> current_batch_ GUARDED_BY(mutex_);
 
+  // Whether sending of the current batch, that contains operations, is scheduled.
+  bool send_updates_scheduled_ GUARDED_BY(mutex_) = false;
+
   std::atomic<int>* running_calls_;
 };
 
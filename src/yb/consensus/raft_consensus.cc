@@ -40,6 +40,7 @@
 
 #include "yb/common/wire_protocol.h"
 
+#include "yb/consensus/compression.h"
 #include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/consensus_context.h"
 #include "yb/consensus/consensus_peers.h"
@@ -1508,6 +1509,9 @@ Status RaftConsensus::Update(
 
   TEST_PAUSE_IF_FLAG(TEST_follower_pause_update_consensus_requests);
 
+  RETURN_NOT_OK(UncompressOps(request_ptr.get()));
+  RETURN_NOT_OK(DecodeOps(request_ptr.get()));
+
   const auto& request = *request_ptr;
   auto reject_mode = reject_mode_.load(std::memory_order_acquire);
   if (reject_mode != RejectMode::kNone) {
@@ -65,6 +65,12 @@ DEFINE_UNKNOWN_int32(inject_delay_commit_pre_voter_to_voter_secs, 0,
 TAG_FLAG(inject_delay_commit_pre_voter_to_voter_secs, unsafe);
 TAG_FLAG(inject_delay_commit_pre_voter_to_voter_secs, hidden);
 
+DEFINE_RUNTIME_uint32(tablet_max_concurrent_apply_writes, 0,
+    "Max number of non-conflicting committed write operations that are applied to RocksDB "
+    "concurrently. Only non-transactional writes are applied concurrently, operation ids and "
+    "MVCC still advance in order. 0 or 1 - write operations are applied one by one.");
+TAG_FLAG(tablet_max_concurrent_apply_writes, advanced);
+
 namespace yb {
 namespace consensus {
 
@@ -875,6 +881,25 @@ Result<bool> ReplicaState::AdvanceCommittedOpIdUnlocked(
   return last_committed_op_id_.index != old_index;
 }
 
+void ReplicaState::MaybeApplyConcurrently(const yb::OpId& committed_op_id, CouldStop could_stop) {
+  // At least 2 rounds that could be applied concurrently, and the last one that is applied in
+  // order only.
+  if (FLAGS_tablet_max_concurrent_apply_writes < 2 ||
+      committed_op_id.index - last_committed_op_id_.index < 3 ||
+      (could_stop && !context_->ShouldApplyWrite())) {
+    return;
+  }
+  ConsensusRounds rounds;
+  rounds.reserve(committed_op_id.index - last_committed_op_id_.index);
+  for (const auto& round : pending_operations_) {
+    if (round->id().index > committed_op_id.index) {
+      break;
+    }
+    rounds.push_back(round);
+  }
+  context_->ApplyConcurrently(last_committed_op_id_, rounds);
+}
+
 Status ReplicaState::ApplyPendingOperationsUnlocked(
     const yb::OpId& committed_op_id, CouldStop could_stop) {
   DCHECK(IsLocked());
@@ -896,6 +921,8 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
 
   Status status;
 
+  MaybeApplyConcurrently(committed_op_id, could_stop);
+
   while (!pending_operations_.empty()) {
     auto round = pending_operations_.front();
     auto current_id = round->id();
@@ -441,6 +441,10 @@ class ReplicaState {
   template <class Policy>
   LeaderLeaseStatus GetLeaseStatusUnlocked(Policy policy) const;
 
+  // Lets consensus context apply non-conflicting committed operations concurrently, before they
+  // are applied in order. Controlled by --tablet_max_concurrent_apply_writes.
+  void MaybeApplyConcurrently(const yb::OpId& committed_op_id, CouldStop could_stop);
+
   // Apply pending operations beginning at iter up to and including committed_op_id.
   // Updates last_committed_op_id_ to committed_op_id.
   Status ApplyPendingOperationsUnlocked(
@@ -51,24 +51,29 @@ void ReplicateMsgsHolder::Reset() {
 }
 
 LWReplicateMsgsHolder::LWReplicateMsgsHolder(
-    ReplicateMsgs messages, ScopedTrackedConsumption consumption)
+    ReplicateMsgs messages, std::vector<RefCntBuffer> encoded_messages,
+    ScopedTrackedConsumption consumption)
     : messages_(std::move(messages)),
+      encoded_messages_(std::move(encoded_messages)),
       consumption_(std::move(consumption)) {
 }
 
 LWReplicateMsgsHolder::LWReplicateMsgsHolder(LWReplicateMsgsHolder&& rhs)
     : messages_(std::move(rhs.messages_)),
+      encoded_messages_(std::move(rhs.encoded_messages_)),
       consumption_(std::move(rhs.consumption_)) {
 }
 
 void LWReplicateMsgsHolder::operator=(LWReplicateMsgsHolder&& rhs) {
   Reset();
   messages_ = std::move(rhs.messages_);
+  encoded_messages_ = std::move(rhs.encoded_messages_);
   consumption_ = std::move(rhs.consumption_);
 }
 
 void LWReplicateMsgsHolder::Reset() {
   messages_.clear();
+  encoded_messages_.clear();
   consumption_ = ScopedTrackedConsumption();
 }
 
@@ -19,6 +19,7 @@
 
 #include "yb/util/mem_tracker.h"
 #include "yb/util/memory/arena.h"
+#include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 namespace consensus {
@@ -62,7 +63,9 @@ class LWReplicateMsgsHolder {
  public:
   LWReplicateMsgsHolder() = default;
 
-  explicit LWReplicateMsgsHolder(ReplicateMsgs messages, ScopedTrackedConsumption consumption);
+  LWReplicateMsgsHolder(
+      ReplicateMsgs messages, std::vector<RefCntBuffer> encoded_messages,
+      ScopedTrackedConsumption consumption);
   LWReplicateMsgsHolder(LWReplicateMsgsHolder&& rhs);
   void operator=(LWReplicateMsgsHolder&& rhs);
 
@@ -70,6 +73,9 @@ class LWReplicateMsgsHolder {
  private:
   ReplicateMsgs messages_;
 
+  // Serialized messages_, referenced by encoded_ops of the request.
+  std::vector<RefCntBuffer> encoded_messages_;
+
   ScopedTrackedConsumption consumption_;
 };
 
@@ -26,6 +26,8 @@ class TestConsensusContext : public ConsensusContext {
 
   bool ShouldApplyWrite() override { return true; }
 
+  void ApplyConcurrently(const OpId& last_applied_op_id, const ConsensusRounds& rounds) override {}
+
   Result<HybridTime> PreparePeerRequest() override { return HybridTime(); }
 
   void MajorityReplicated() override {}
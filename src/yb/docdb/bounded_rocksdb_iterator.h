@@ -71,6 +71,10 @@ class BoundedRocksDbIterator : public rocksdb::Iterator {
     iterator_->RevalidateAfterUpperBoundChange();
   }
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    iterator_->PrefetchForSeeks(sorted_targets);
+  }
+
   void Reset() {
     iterator_.reset();
   }
@@ -13,9 +13,12 @@
 
 #include "yb/docdb/deadlock_detector.h"
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <vector>
 
 #include "yb/client/transaction_rpc.h"
 
@@ -59,6 +62,13 @@ METRIC_DEFINE_coarse_histogram(
 METRIC_DEFINE_coarse_histogram(
     tablet, deadlock_probe_latency, "Deadlock probe latency", yb::MetricUnit::kMicroseconds,
     "The time it takes to complete the probe from a waiting transaction to all of its blockers.");
+METRIC_DEFINE_counter(
+    tablet, deadlocks_detected, "Deadlocks detected", yb::MetricUnit::kUnits,
+    "The number of distinct deadlock cycles detected by probes originated at this deadlock "
+    "detector. A cycle is counted once, even when probes of several of its waiters detect it.");
+METRIC_DEFINE_coarse_histogram(
+    tablet, deadlock_detection_latency, "Deadlock detection latency", yb::MetricUnit::kMicroseconds,
+    "The time from receiving a waiting transaction to detecting the deadlock cycle it is part of.");
 METRIC_DEFINE_gauge_uint64(
     tablet, deadlock_detector_waiters, "Num Waiting Txns", yb::MetricUnit::kTransactions,
     "The total number of waiting transactions tracked by one deadlock detector.");
@@ -365,6 +375,8 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
         log_prefix_(Format("T $0 D $1 ", status_tablet_id, detector_id_)),
         deadlock_size_(METRIC_deadlock_size.Instantiate(metrics)),
         probe_latency_(METRIC_deadlock_probe_latency.Instantiate(metrics)),
+        deadlocks_detected_(METRIC_deadlocks_detected.Instantiate(metrics)),
+        deadlock_detection_latency_(METRIC_deadlock_detection_latency.Instantiate(metrics)),
         deadlock_detector_waiters_(METRIC_deadlock_detector_waiters.Instantiate(metrics, 0)) {
     VLOG_WITH_PREFIX(4) << "Deadlock detector started with instance id: " << detector_id_;
   }
@@ -436,12 +448,17 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
       UniqueLock<decltype(mutex_)> l(mutex_);
       for (const auto& waiter : req.waiting_transactions()) {
         auto waiter_txn_id = VERIFY_RESULT(FullyDecodeTransactionId(waiter.transaction_id()));
+        auto wait_start_time = HybridTime::FromPB(waiter.wait_start_time());
         if (waiter.blocking_transaction_size() == 0) {
-          LOG_WITH_PREFIX(WARNING) << "Received WaitFor relationship for waiter " << waiter_txn_id
-                                   << " with no blockers";
+          RemoveReleasedWaiter(waiter_txn_id, wait_start_time);
+          continue;
+        }
+        auto released_it = released_waiters_.find(waiter_txn_id);
+        if (released_it != released_waiters_.end() && released_it->second >= wait_start_time) {
+          VLOG_WITH_PREFIX(1) << "Skipping released waiter " << waiter_txn_id
+                              << " with start time " << wait_start_time;
           continue;
         }
-        auto wait_start_time = HybridTime::FromPB(waiter.wait_start_time());
         VLOG_WITH_PREFIX(4) << "Processing waiter " << waiter_txn_id;
 
         std::shared_ptr<WaiterData> waiter_data = nullptr;
@@ -467,6 +484,7 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
           waiter_it->second.reset(new WaiterData {
             .wait_start_time = std::move(wait_start_time),
             .blockers = std::make_shared<BlockerData>(BlockerData()),
+            .registered_at = CoarseMonoClock::Now(),
           });
           waiter_data = waiter_it->second;
         } else {
@@ -475,6 +493,7 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
           waiter_data = std::make_shared<WaiterData>(WaiterData {
             .wait_start_time = std::move(wait_start_time),
             .blockers = std::make_shared<BlockerData>(BlockerData()),
+            .registered_at = CoarseMonoClock::Now(),
           });
           auto it = waiters_.emplace(waiter_txn_id, waiter_data);
           DCHECK(it.second);
@@ -529,6 +548,8 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
     {
       UniqueLock<decltype(mutex_)> l(mutex_);
       controller_->RemoveInactiveTransactions(&waiters_);
+      released_waiters_.clear();
+      detected_cycles_.clear();
       deadlock_detector_waiters_->set_value(waiters_.size());
       if (is_probe_scan_active_) {
         return;
@@ -557,6 +578,46 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
   }
 
  private:
+  void RemoveReleasedWaiter(const TransactionId& waiter_txn_id, HybridTime wait_start_time)
+      REQUIRES(mutex_) {
+    auto [released_it, inserted] = released_waiters_.emplace(waiter_txn_id, wait_start_time);
+    if (!inserted) {
+      released_it->second = std::max(released_it->second, wait_start_time);
+    }
+    auto waiter_it = waiters_.find(waiter_txn_id);
+    if (waiter_it == waiters_.end()) {
+      return;
+    }
+    if (waiter_it->second->wait_start_time > wait_start_time) {
+      VLOG_WITH_PREFIX(1) << "Keeping waiter " << waiter_txn_id << " with start time "
+                          << waiter_it->second->wait_start_time << " released at "
+                          << wait_start_time;
+      return;
+    }
+    VLOG_WITH_PREFIX(1) << "Removing released waiter " << waiter_txn_id << " with start time "
+                        << wait_start_time;
+    waiters_.erase(waiter_it);
+    deadlock_detector_waiters_->set_value(waiters_.size());
+  }
+
+  // Returns true when the cycle of the deadlock was not detected by other probes since the last
+  // probe scan. Probes of different waiters of the same cycle report the same set of transactions.
+  bool IsNewDeadlockCycle(const tserver::ProbeTransactionDeadlockResponsePB& resp)
+      EXCLUDES(mutex_) {
+    std::vector<TransactionId> cycle;
+    cycle.reserve(resp.deadlocked_txn_ids_size());
+    for (const auto& txn_id : resp.deadlocked_txn_ids()) {
+      auto decoded = FullyDecodeTransactionId(txn_id);
+      if (!decoded.ok()) {
+        return true;
+      }
+      cycle.push_back(*decoded);
+    }
+    std::sort(cycle.begin(), cycle.end());
+    UniqueLock<decltype(mutex_)> l(mutex_);
+    return detected_cycles_.insert(std::move(cycle)).second;
+  }
+
   template <class T>
   std::vector<LocalProbeProcessorPtr> GetProbesToSend(const T& waiters) {
     std::vector<LocalProbeProcessorPtr> probes_to_send;
@@ -577,7 +638,8 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
         DCHECK(!blocker.status_tablet.empty());
         processor->AddBlocker(blocker);
       }
-      processor->SetCallback([detector = shared_from_this(), outstanding_probes, probe_num]
+      processor->SetCallback([detector = shared_from_this(), outstanding_probes, probe_num,
+                              registered_at = waiter_data->registered_at]
           (const auto& status, const auto& resp) {
         VLOG(4) << "Got callback for probe "
                 << Format("($0, $1)", probe_num, detector->detector_id_);
@@ -588,6 +650,12 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
         }
         if (resp.deadlocked_txn_ids_size() > 0) {
           detector->deadlock_size_->Increment(resp.deadlocked_txn_ids_size());
+          if (detector->IsNewDeadlockCycle(resp)) {
+            detector->deadlocks_detected_->Increment();
+            detector->deadlock_detection_latency_->Increment(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    CoarseMonoClock::Now() - registered_at).count());
+          }
           auto waiter_or_status = FullyDecodeTransactionId(resp.deadlocked_txn_ids(0));
           if (!waiter_or_status.ok()) {
             LOG(ERROR) << "Failed to decode transaction id in detected deadlock!";
@@ -756,6 +824,8 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
 
   scoped_refptr<Histogram> deadlock_size_;
   scoped_refptr<Histogram> probe_latency_;
+  scoped_refptr<Counter> deadlocks_detected_;
+  scoped_refptr<Histogram> deadlock_detection_latency_;
   scoped_refptr<AtomicGauge<uint64_t>> deadlock_detector_waiters_;
 
   mutable rw_spinlock mutex_;
@@ -772,6 +842,15 @@ class DeadlockDetector::Impl : public std::enable_shared_from_this<DeadlockDetec
 
   Waiters waiters_ GUARDED_BY(mutex_);
 
+  // Wait start time of waiters that were released, so a registration of the same wait that arrives
+  // after the release is not added back to waiters_. Cleared on each probe scan.
+  std::unordered_map<TransactionId, HybridTime, TransactionIdHash> released_waiters_
+      GUARDED_BY(mutex_);
+
+  // Sorted transactions of deadlock cycles that were detected since the last probe scan, so each
+  // cycle is counted once in deadlocks_detected_.
+  std::set<std::vector<TransactionId>> detected_cycles_ GUARDED_BY(mutex_);
+
   std::atomic<uint32_t> seq_no_ = 0;
 };
 
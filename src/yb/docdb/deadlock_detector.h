@@ -21,6 +21,8 @@
 #include "yb/common/transaction.h"
 #include "yb/docdb/wait_queue.h"
 
+#include "yb/util/monotime.h"
+
 namespace yb {
 namespace tablet {
 
@@ -35,6 +37,8 @@ using BlockerData = std::vector<BlockerTransactionInfo>;
 struct WaiterData {
     HybridTime wait_start_time;
     std::shared_ptr<BlockerData> blockers;
+    // Time when the waiter was received by this detector, used to measure detection latency.
+    CoarseTimePoint registered_at;
 };
 using Waiters = std::unordered_map<TransactionId,
                                    std::shared_ptr<WaiterData>,
@@ -61,7 +65,9 @@ using DeadlockDetectorRpcCallback = std::function<void(const Status&)>;
 //
 // When a transaction coordinator receives an UpdateTransactionWaitingForStatusRequestPB request
 // from a tserver, it forwards this directly to the deadlock detector. The deadlock detector then
-// adds or overwrites information for each waiting transaction_id found in that request.
+// adds or overwrites information for each waiting transaction_id found in that request, and
+// immediately probes the blockers of new waiters. A waiting transaction without blockers means that
+// the tserver released this waiter, so its wait-for edges are removed from the graph.
 //
 // On a regular interval (controlled by FLAGS_transaction_deadlock_detection_interval_usec), the
 // deadlock detector will scan all waiting transactions and, for each, do the following:
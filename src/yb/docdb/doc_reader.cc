@@ -32,6 +32,8 @@
 #include "yb/docdb/value.h"
 #include "yb/docdb/value_type.h"
 
+#include "yb/gutil/casts.h"
+
 #include "yb/util/fast_varint.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -237,6 +239,26 @@ DocDBTableReader::DocDBTableReader(
       << "Projection: " << AsString(projection_) << ", read time: " << iter_->read_time();
 }
 
+Result<const SchemaPacking&> DocDBTableReader::GetPacking(Slice* packed_row) {
+  auto version = narrow_cast<SchemaVersion>(
+      VERIFY_RESULT(util::FastDecodeUnsignedVarInt(packed_row)));
+  if (last_schema_packing_ && last_schema_version_ == version) {
+    return *last_schema_packing_;
+  }
+  const auto& packing = VERIFY_RESULT_REF(schema_packing_storage_.GetPacking(version));
+  last_schema_version_ = version;
+  last_schema_packing_ = &packing;
+  packed_column_indexes_.clear();
+  if (projection_) {
+    packed_column_indexes_.reserve(projection_->size());
+    for (const auto& column : *projection_) {
+      packed_column_indexes_.push_back(
+          column.IsColumnId() ? packing.GetIndex(column.GetColumnId()) : std::nullopt);
+    }
+  }
+  return packing;
+}
+
 void DocDBTableReader::SetTableTtl(const Schema& table_schema) {
   table_expiration_ = Expiration(TableTTL(table_schema));
 }
@@ -281,7 +303,7 @@ class DocDBTableReader::GetHelperBase {
     // projection could be null in tests only.
     if (reader_.projection_) {
       if (reader_.projection_->empty()) {
-        packed_column_data_ = GetPackedColumn(KeyEntryValue::kLivenessColumn.GetColumnId());
+        packed_column_data_ = GetPackedLivenessColumn();
         RETURN_NOT_OK(Scan(CheckExistOnly::kTrue));
         return Found();
       }
@@ -471,7 +493,7 @@ class DocDBTableReader::GetHelperBase {
   void UpdatePackedColumnData() {
     auto& column = (*reader_.projection_)[column_index_];
     if (column.IsColumnId()) {
-      packed_column_data_ = GetPackedColumn(column.GetColumnId());
+      packed_column_data_ = GetPackedColumn(column_index_, column.GetColumnId());
     } else {
       // Used in tests only.
       packed_column_data_.row = nullptr;
@@ -504,7 +526,7 @@ class DocDBTableReader::GetHelperBase {
     auto value_type = DecodeValueEntryType(value);
     if (value_type == ValueEntryType::kPackedRow) {
       value.consume_byte();
-      schema_packing_ = &VERIFY_RESULT(reader_.schema_packing_storage_.GetPacking(&value)).get();
+      schema_packing_ = &VERIFY_RESULT(reader_.GetPacking(&value)).get();
       packed_row_.Assign(value);
       packed_row_data_.doc_ht = doc_ht;
       packed_row_data_.control_fields = control_fields;
@@ -524,32 +546,45 @@ class DocDBTableReader::GetHelperBase {
     return Status::OK();
   }
 
-  PackedColumnData GetPackedColumn(ColumnId column_id) {
+  PackedColumnData GetPackedLivenessColumn() {
+    if (!schema_packing_) {
+      // Actual for tests only.
+      return PackedColumnData();
+    }
+
+    DVLOG_WITH_PREFIX_AND_FUNC(4) << "Packed row for liveness column";
+    return PackedColumnData {
+      .row = &packed_row_data_,
+      .encoded_value = NullSlice(),
+      .liveness_column = true,
+    };
+  }
+
+  // Returns packed data for the projection column with specified index.
+  PackedColumnData GetPackedColumn(size_t projection_index, ColumnId column_id) {
     if (!schema_packing_) {
       // Actual for tests only.
       return PackedColumnData();
     }
 
     if (column_id == KeyEntryValue::kLivenessColumn.GetColumnId()) {
-      DVLOG_WITH_PREFIX_AND_FUNC(4) << "Packed row for liveness column";
-      return PackedColumnData {
-        .row = &packed_row_data_,
-        .encoded_value = NullSlice(),
-        .liveness_column = true,
-      };
+      return GetPackedLivenessColumn();
     }
 
-    auto slice = schema_packing_->GetValue(column_id, packed_row_.AsSlice());
-    if (!slice) {
+    // schema_packing_ is always the last packing returned by the reader, so packed column indexes
+    // are related to it.
+    const auto& packed_index = reader_.packed_column_indexes_[projection_index];
+    if (!packed_index) {
       DVLOG_WITH_PREFIX_AND_FUNC(4) << "No packed row data for " << column_id;
       return PackedColumnData();
     }
 
+    auto slice = schema_packing_->GetValue(*packed_index, packed_row_.AsSlice());
     DVLOG_WITH_PREFIX_AND_FUNC(4) << "Packed row " << column_id << ": "
-                                  << slice->ToDebugHexString();
+                                  << slice.ToDebugHexString();
     return PackedColumnData {
       .row = &packed_row_data_,
-      .encoded_value = slice->empty() ? NullSlice() : *slice,
+      .encoded_value = slice.empty() ? NullSlice() : slice,
       .liveness_column = false,
     };
   }
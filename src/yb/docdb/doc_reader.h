@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -113,6 +114,10 @@ class DocDBTableReader {
   // at that row.
   Status InitForKey(const Slice& sub_doc_key);
 
+  // Returns schema packing for the packed row, consuming schema version from the start of it.
+  // The last used packing is cached together with packed column indexes for projection columns.
+  Result<const SchemaPacking&> GetPacking(Slice* packed_row);
+
   class GetHelperBase;
   class GetHelper;
   class FlatGetHelper;
@@ -125,6 +130,13 @@ class DocDBTableReader {
   const SchemaPackingStorage& schema_packing_storage_;
 
   std::vector<KeyBytes> encoded_projection_;
+
+  // Rows of a table are usually packed using the same schema version, so remember the packing
+  // of the last read packed row, to avoid schema version and column id lookups for each row.
+  SchemaVersion last_schema_version_ = 0;
+  const SchemaPacking* last_schema_packing_ = nullptr;
+  // Index of the projection column in last_schema_packing_, std::nullopt if column is not packed.
+  std::vector<std::optional<size_t>> packed_column_indexes_;
   EncodedDocHybridTime table_tombstone_time_{EncodedDocHybridTime::kMin};
   Expiration table_expiration_;
 };
@@ -12,6 +12,7 @@
 //
 
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include <algorithm>
 #include <iterator>
 
 #include <cstdint>
@@ -588,8 +589,10 @@ Status DocRowwiseIterator::DoNextRow(
       const auto ql_type = projection.column(column_projection_idx).type();
       QLTableColumn& column = table_row->AllocColumn(column_id);
 
-      const auto& column_value = (*values_)[column_reader_idx];
-      column_value.ToQLValuePB(ql_type, &column.value);
+      // Values are decoded for each row, so string content could be moved to the result row
+      // instead of being copied.
+      auto& column_value = (*values_)[column_reader_idx];
+      column_value.MoveToQLValuePB(ql_type, &column.value);
       column.ttl_seconds = column_value.GetTtl();
       if (column_value.IsWriteTimeSet()) {
         column.write_time = column_value.GetWriteTime();
@@ -618,6 +621,32 @@ Status DocRowwiseIterator::DoNextRow(
   return Status::OK();
 }
 
+std::optional<size_t> DocRowwiseIterator::RowValueIndex(ColumnId column_id) const {
+  if (!is_flat_doc_) {
+    return std::nullopt;
+  }
+  const auto subkey = KeyEntryValue::MakeColumnId(column_id);
+  auto it = std::lower_bound(projection_subkeys_.begin(), projection_subkeys_.end(), subkey);
+  if (it == projection_subkeys_.end() || *it != subkey) {
+    return std::nullopt;
+  }
+  return it - projection_subkeys_.begin();
+}
+
+Result<const std::vector<PrimitiveValue>*> DocRowwiseIterator::NextRowValues() {
+  SCHECK(is_flat_doc_, IllegalState, "Row values are available only for flat documents");
+  if (PREDICT_FALSE(done_)) {
+    return STATUS(NotFound, "end of iter");
+  }
+  if (!row_ready_) {
+    return STATUS(InternalError, "next row has not be prepared for reading");
+  }
+
+  DVLOG_WITH_FUNC(4) << "values: " << AsString(*values_);
+  row_ready_ = false;
+  return values_;
+}
+
 bool DocRowwiseIterator::LivenessColumnExists() const {
   if (is_flat_doc_) {
     const auto& type = (*values_)[0].type();
@@ -656,27 +685,55 @@ Result<Slice> DocRowwiseIterator::GetTupleId() const {
   return tuple_id;
 }
 
-Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
+bool DocRowwiseIterator::PrepareTupleKeyPrefix() {
   // If cotable id / colocation id is present in the table schema, then
   // we need to prepend it in the tuple key to seek.
-  if (doc_read_context_.schema.has_cotable_id() || doc_read_context_.schema.has_colocation_id()) {
-    uint32_t size = doc_read_context_.schema.has_colocation_id() ? sizeof(ColocationId) : kUuidSize;
-    if (!tuple_key_) {
-      tuple_key_.emplace();
-      tuple_key_->Reserve(1 + size + tuple_id.size());
-
-      if (doc_read_context_.schema.has_cotable_id()) {
-        std::string bytes;
-        doc_read_context_.schema.cotable_id().EncodeToComparable(&bytes);
-        tuple_key_->AppendKeyEntryType(KeyEntryType::kTableId);
-        tuple_key_->AppendRawBytes(bytes);
-      } else {
-        tuple_key_->AppendKeyEntryType(KeyEntryType::kColocationId);
-        tuple_key_->AppendUInt32(doc_read_context_.schema.colocation_id());
-      }
+  if (!doc_read_context_.schema.has_cotable_id() &&
+      !doc_read_context_.schema.has_colocation_id()) {
+    return false;
+  }
+  uint32_t size = doc_read_context_.schema.has_colocation_id() ? sizeof(ColocationId) : kUuidSize;
+  if (!tuple_key_) {
+    tuple_key_.emplace();
+    tuple_key_->Reserve(1 + size);
+
+    if (doc_read_context_.schema.has_cotable_id()) {
+      std::string bytes;
+      doc_read_context_.schema.cotable_id().EncodeToComparable(&bytes);
+      tuple_key_->AppendKeyEntryType(KeyEntryType::kTableId);
+      tuple_key_->AppendRawBytes(bytes);
     } else {
-      tuple_key_->Truncate(1 + size);
+      tuple_key_->AppendKeyEntryType(KeyEntryType::kColocationId);
+      tuple_key_->AppendUInt32(doc_read_context_.schema.colocation_id());
     }
+  } else {
+    tuple_key_->Truncate(1 + size);
+  }
+  return true;
+}
+
+void DocRowwiseIterator::PrefetchTuples(const std::vector<Slice>& sorted_tuple_ids) {
+  if (!PrepareTupleKeyPrefix()) {
+    db_iter_->PrefetchForSeeks(sorted_tuple_ids);
+    return;
+  }
+  // All tuple keys have the same prefix, so they remain sorted.
+  std::vector<KeyBytes> tuple_keys;
+  tuple_keys.reserve(sorted_tuple_ids.size());
+  std::vector<Slice> sorted_keys;
+  sorted_keys.reserve(sorted_tuple_ids.size());
+  for (const auto& tuple_id : sorted_tuple_ids) {
+    auto& key = tuple_keys.emplace_back();
+    key.Reserve(tuple_key_->size() + tuple_id.size());
+    key.AppendRawBytes(tuple_key_->AsSlice());
+    key.AppendRawBytes(tuple_id);
+    sorted_keys.push_back(key.AsSlice());
+  }
+  db_iter_->PrefetchForSeeks(sorted_keys);
+}
+
+Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
+  if (PrepareTupleKeyPrefix()) {
     tuple_key_->AppendRawBytes(tuple_id);
     db_iter_->Seek(*tuple_key_);
   } else {
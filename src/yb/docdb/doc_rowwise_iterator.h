@@ -120,6 +120,16 @@ class DocRowwiseIterator : public YQLRowwiseIteratorIf {
   // the cotable id.
   Result<bool> SeekTuple(const Slice& tuple_id) override;
 
+  // Reads the blocks required to seek to each of the given tuples in parallel. The tuple ids
+  // should be in the same format as for SeekTuple and sorted in ascending order.
+  void PrefetchTuples(const std::vector<Slice>& sorted_tuple_ids) override;
+
+  // Values of non key projection columns are available without building QLTableRow, when the
+  // iterator reads flat documents, i.e. YSQL rows with --ysql_use_flat_doc_reader.
+  std::optional<size_t> RowValueIndex(ColumnId column_id) const override;
+
+  Result<const std::vector<PrimitiveValue>*> NextRowValues() override;
+
   // Retrieves the next key to read after the iterator finishes for the given page.
   Status GetNextReadSubDocKey(SubDocKey* sub_doc_key) override;
 
@@ -132,6 +142,10 @@ class DocRowwiseIterator : public YQLRowwiseIteratorIf {
 
  private:
   void CheckInitOnce();
+
+  // Returns true if tuple id should be prefixed with cotable id / colocation id to get the key.
+  // In this case tuple_key_ is filled with such prefix.
+  bool PrepareTupleKeyPrefix();
   template <class T>
   Status DoInit(const T& spec);
   void ConfigureForYsql();
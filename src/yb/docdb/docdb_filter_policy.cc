@@ -111,4 +111,13 @@ DocDbAwareV3FilterPolicy::GetKeyTransformer() const {
   return &DocKeyComponentsExtractor<DocKeyPart::kUpToHashOrFirstRange>::GetInstance();
 }
 
+const rocksdb::FilterPolicy::KeyTransformer*
+DocDbAwareV3RibbonFilterPolicy::GetKeyTransformer() const {
+  return &DocKeyComponentsExtractor<DocKeyPart::kUpToHashOrFirstRange>::GetInstance();
+}
+
+const rocksdb::FilterPolicy::KeyTransformer* DocKeyHashIndexKeyTransformer() {
+  return &DocKeyComponentsExtractor<DocKeyPart::kWholeDocKey>::GetInstance();
+}
+
 }   // namespace yb::docdb
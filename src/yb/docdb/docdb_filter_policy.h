@@ -19,10 +19,13 @@ namespace yb::docdb {
 
 class DocDbAwareFilterPolicyBase : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicyBase(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  explicit DocDbAwareFilterPolicyBase(size_t filter_block_size_bits, rocksdb::Logger* logger)
+      : DocDbAwareFilterPolicyBase(rocksdb::NewFixedSizeFilterPolicy(
+            filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+            logger)) {}
+
+  explicit DocDbAwareFilterPolicyBase(const rocksdb::FilterPolicy* builtin_policy)
+      : builtin_policy_(builtin_policy) {}
 
   void CreateFilter(const Slice* keys, int n, std::string* dst) const override;
 
@@ -78,4 +81,24 @@ class DocDbAwareV3FilterPolicy : public DocDbAwareFilterPolicyBase {
   const KeyTransformer* GetKeyTransformer() const override;
 };
 
+// Uses the same keys parts for filtering as DocDbAwareV3FilterPolicy, but builds fixed-size Ribbon
+// filter blocks, which hold ~26% more keys than bloom filter blocks of the same size with the same
+// false positive rate. Filter blocks are tagged with format version, see ribbon_filter.cc.
+class DocDbAwareV3RibbonFilterPolicy : public DocDbAwareFilterPolicyBase {
+ public:
+  explicit DocDbAwareV3RibbonFilterPolicy(size_t filter_block_size_bits)
+      : DocDbAwareFilterPolicyBase(rocksdb::NewFixedSizeRibbonFilterPolicy(
+            filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate)) {}
+
+  const char* Name() const override { return "DocKeyV3RibbonFilter"; }
+
+  const KeyTransformer* GetKeyTransformer() const override;
+};
+
+// Returns key transformer which extracts encoded DocKey from the key, used to build data block hash
+// index (see rocksdb::BlockBasedTableOptions::data_block_hash_index_key_transformer) and to place
+// subcompaction boundaries between documents
+// (see rocksdb::DBOptions::subcompaction_key_transformer).
+const rocksdb::FilterPolicy::KeyTransformer* DocKeyHashIndexKeyTransformer();
+
 }  // namespace yb::docdb
@@ -25,6 +25,7 @@
 namespace yb {
 namespace docdb {
 
+class CachedIntents;
 class ConsensusFrontier;
 class DeadlineInfo;
 class DocDBCompactionFilterFactory;
@@ -104,6 +104,11 @@ DEFINE_UNKNOWN_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 102
              "Threshold beyond which compaction is considered large.");
 DEFINE_UNKNOWN_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_UNKNOWN_uint32(rocksdb_max_subcompactions, 1,
+             "Maximal number of threads running a single compaction of regular RocksDB. Large "
+             "compactions are split into subcompactions by DocKey ranges. 1 - no subcompactions.");
+DEFINE_UNKNOWN_uint64(rocksdb_min_subcompaction_input_size_bytes, 1_GB,
+             "Minimal approximate input size of a single subcompaction.");
 DEFINE_UNKNOWN_int32(rocksdb_max_write_buffer_number, 2,
              "Maximum number of write buffers that are built up in memory.");
 
@@ -127,6 +132,11 @@ DEFINE_UNKNOWN_int32(memstore_size_mb, 128,
 
 DEFINE_UNKNOWN_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+
+DEFINE_UNKNOWN_bool(use_docdb_aware_ribbon_filter, false,
+            "Whether to use Ribbon filter instead of bloom filter for new SST files when "
+            "use_docdb_aware_bloom_filter is set. Ribbon filter blocks take less space for the "
+            "same false positive rate. Existing SST files could be read regardless of this flag.");
 // Empirically 2 is a minimal value that provides best performance on sequential scan.
 DEFINE_UNKNOWN_int32(max_nexts_to_avoid_seek, 2,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
@@ -140,6 +150,11 @@ DEFINE_RUNTIME_AUTO_string(regular_tablets_data_block_key_value_encoding, kExter
     "Key-value encoding to use for regular data blocks in RocksDB. Possible options: "
     "shared_prefix, three_shared_parts");
 
+DEFINE_UNKNOWN_bool(regular_tablets_data_block_hash_index, false,
+    "Whether to build hash index over DocKeys inside data blocks of regular RocksDB, so point "
+    "lookups could find the restart interval without binary search. SST files written with this "
+    "option could not be read by older versions.");
+
 DEFINE_UNKNOWN_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
 DEFINE_UNKNOWN_int32(num_reserved_small_compaction_threads, -1,
@@ -158,6 +173,12 @@ DEFINE_UNKNOWN_string(compression_type, "Snappy",
               "On-disk compression type to use in RocksDB."
               "By default, Snappy is used if supported.");
 
+DEFINE_UNKNOWN_uint32(compression_sampled_dict_max_bytes, 0,
+              "Max size of the dictionary used to compress SST data blocks. The dictionary is "
+              "not trained, it is a concatenation of data block prefixes sampled from the "
+              "previously written SST file of the same tablet. Only used by LZ4 compression type. "
+              "0 disables dictionary compression.");
+
 DEFINE_UNKNOWN_int32(block_restart_interval, kDefaultDataBlockRestartInterval,
              "Controls the number of keys to look at for computing the diff encoding.");
 
@@ -637,6 +658,7 @@ void InitRocksDBOptions(
   // Since the flag validator for FLAGS_compression_type will fail if the result of this call is not
   // OK, this CHECK_RESULT should never fail and is safe.
   options->compression = CHECK_RESULT(GetConfiguredCompressionType(FLAGS_compression_type));
+  options->compression_opts.max_dict_bytes = FLAGS_compression_sampled_dict_max_bytes;
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -645,6 +667,8 @@ void InitRocksDBOptions(
   // Set block cache options.
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.secondary_block_cache = tablet_options.secondary_block_cache;
+    table_options.prefetch_thread_pool = tablet_options.block_prefetch_pool;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
   } else {
@@ -657,10 +681,21 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     const auto filter_block_size_bits = table_options.filter_block_size * 8;
-    table_options.filter_policy = std::make_shared<const DocDbAwareV3FilterPolicy>(
-        filter_block_size_bits, options->info_log.get());
+    rocksdb::BlockBasedTableOptions::FilterPolicyPtr bloom_filter_policy =
+        std::make_shared<const DocDbAwareV3FilterPolicy>(
+            filter_block_size_bits, options->info_log.get());
+    rocksdb::BlockBasedTableOptions::FilterPolicyPtr ribbon_filter_policy =
+        std::make_shared<const DocDbAwareV3RibbonFilterPolicy>(filter_block_size_bits);
     table_options.supported_filter_policies =
         std::make_shared<rocksdb::BlockBasedTableOptions::FilterPoliciesMap>();
+    // Keep the other one supported, so SST files written before the flag change are readable.
+    if (FLAGS_use_docdb_aware_ribbon_filter) {
+      table_options.filter_policy = std::move(ribbon_filter_policy);
+      AddSupportedFilterPolicy(bloom_filter_policy, &table_options);
+    } else {
+      table_options.filter_policy = std::move(bloom_filter_policy);
+      AddSupportedFilterPolicy(ribbon_filter_policy, &table_options);
+    }
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareHashedComponentsFilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV2FilterPolicy>(
@@ -182,6 +182,7 @@ class DocRowwiseIteratorTest : public DocDBTestBase {
   void TestPackedRow();
   void TestDeleteMarkerWithPackedRow();
   void TestUpdatePackedRow();
+  void TestPackedRowsWithSeveralSchemaVersions();
   // Restore doesn't use delete tombstones for rows, instead marks all columns
   // as deleted.
   void TestDeletedDocumentUsingLivenessColumnDelete();
@@ -1856,6 +1857,110 @@ void DocRowwiseIteratorTest::TestUpdatePackedRow() {
       HybridTime::FromMicros(1500));
 }
 
+// Rows packed with different schema versions are interleaved, so the packing cached by the reader
+// is replaced while scanning, and projection columns are found at different positions or missing.
+void DocRowwiseIteratorTest::TestPackedRowsWithSeveralSchemaVersions() {
+  constexpr SchemaVersion kVersion0 = 0;
+  constexpr SchemaVersion kVersion1 = 1;
+  constexpr SchemaVersion kVersion2 = 2;
+  auto& schema_packing_storage = doc_read_context().schema_packing_storage;
+  // Version 1 does not have column e.
+  schema_packing_storage.AddSchema(kVersion1, Schema({
+        ColumnSchema("a", DataType::STRING, /* is_nullable = */ false),
+        ColumnSchema("b", DataType::INT64, false),
+        ColumnSchema("c", DataType::STRING, true),
+        ColumnSchema("d", DataType::INT64, true),
+    }, {
+        10_ColId,
+        20_ColId,
+        30_ColId,
+        40_ColId,
+    }, 2));
+  // Version 2 has the same columns as version 0, but packs them in reverse order.
+  schema_packing_storage.AddSchema(kVersion2, Schema({
+        ColumnSchema("a", DataType::STRING, /* is_nullable = */ false),
+        ColumnSchema("b", DataType::INT64, false),
+        ColumnSchema("e", DataType::STRING, true),
+        ColumnSchema("d", DataType::INT64, true),
+        ColumnSchema("c", DataType::STRING, true),
+    }, {
+        10_ColId,
+        20_ColId,
+        50_ColId,
+        40_ColId,
+        30_ColId,
+    }, 2));
+
+  auto& packing0 = ASSERT_RESULT(schema_packing_storage.GetPacking(kVersion0)).get();
+  auto& packing1 = ASSERT_RESULT(schema_packing_storage.GetPacking(kVersion1)).get();
+  auto& packing2 = ASSERT_RESULT(schema_packing_storage.GetPacking(kVersion2)).get();
+  auto doc_key = [](int64_t idx) {
+    return DocKey(KeyEntryValues(Format("row$0", idx), idx * 11111)).Encode();
+  };
+
+  InsertPackedRow(
+      kVersion0, packing0, doc_key(1), HybridTime::FromMicros(1000),
+      {
+          {30_ColId, QLValue::Primitive("row1_c")},
+          {40_ColId, QLValue::PrimitiveInt64(10000)},
+          {50_ColId, QLValue::Primitive("row1_e")},
+      });
+  InsertPackedRow(
+      kVersion1, packing1, doc_key(2), HybridTime::FromMicros(1000),
+      {
+          {30_ColId, QLValue::Primitive("row2_c")},
+          {40_ColId, QLValue::PrimitiveInt64(20000)},
+      });
+  InsertPackedRow(
+      kVersion2, packing2, doc_key(3), HybridTime::FromMicros(1000),
+      {
+          {50_ColId, QLValue::Primitive("row3_e")},
+          {40_ColId, QLValue::PrimitiveInt64(30000)},
+          {30_ColId, QLValue::Primitive("row3_c")},
+      });
+  InsertPackedRow(
+      kVersion2, packing2, doc_key(4), HybridTime::FromMicros(1000),
+      {
+          {50_ColId, QLValue::Primitive("row4_e")},
+          {40_ColId, QLValue::PrimitiveInt64(40000)},
+          {30_ColId, QLValue::Primitive("row4_c")},
+      });
+  InsertPackedRow(
+      kVersion0, packing0, doc_key(5), HybridTime::FromMicros(1000),
+      {
+          {30_ColId, QLValue::Primitive("row5_c")},
+          {40_ColId, QLValue::PrimitiveInt64(50000)},
+          {50_ColId, QLValue::Primitive("row5_e")},
+      });
+
+  DocDBDebugDumpToConsole();
+
+  CreateIteratorAndValidate(
+      ReadHybridTime::FromMicros(2000),
+      R"#(
+        {string:"row1",int64:11111,string:"row1_c",int64:10000,string:"row1_e"}
+        {string:"row2",int64:22222,string:"row2_c",int64:20000,null}
+        {string:"row3",int64:33333,string:"row3_c",int64:30000,string:"row3_e"}
+        {string:"row4",int64:44444,string:"row4_c",int64:40000,string:"row4_e"}
+        {string:"row5",int64:55555,string:"row5_c",int64:50000,string:"row5_e"}
+      )#",
+      HybridTime::FromMicros(1000));
+
+  // Projection without column d, so cached indexes differ from packed column indexes.
+  Schema projection;
+  ASSERT_OK(doc_read_context().schema.CreateProjectionByNames({"e", "c"}, &projection));
+  CreateIteratorAndValidate(
+      doc_read_context().schema, ReadHybridTime::FromMicros(2000),
+      R"#(
+        {missing,missing,string:"row1_c",missing,string:"row1_e"}
+        {missing,missing,string:"row2_c",missing,null}
+        {missing,missing,string:"row3_c",missing,string:"row3_e"}
+        {missing,missing,string:"row4_c",missing,string:"row4_e"}
+        {missing,missing,string:"row5_c",missing,string:"row5_e"}
+      )#",
+      HybridTime::FromMicros(1000), &projection);
+}
+
 void DocRowwiseIteratorTest::TestPartialKeyColumnsProjection() {
   InsertPopulationData();
 
@@ -1982,6 +2087,10 @@ TEST_F(DocRowwiseIteratorTest, UpdatePackedRow) {
   TestUpdatePackedRow();
 }
 
+TEST_F(DocRowwiseIteratorTest, PackedRowsWithSeveralSchemaVersions) {
+  TestPackedRowsWithSeveralSchemaVersions();
+}
+
 TEST_F(DocRowwiseIteratorTest, DeletedDocumentUsingLivenessColumnDeleteTest) {
   TestDeletedDocumentUsingLivenessColumnDelete();
 }
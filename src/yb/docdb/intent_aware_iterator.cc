@@ -155,6 +155,13 @@ void IntentAwareIterator::Seek(const Slice& key) {
   }
 }
 
+void IntentAwareIterator::PrefetchForSeeks(const std::vector<Slice>& sorted_keys) {
+  if (!status_.ok()) {
+    return;
+  }
+  iter_.PrefetchForSeeks(sorted_keys);
+}
+
 void IntentAwareIterator::SeekForward(const Slice& key) {
   KeyBytes key_bytes;
   // Reserve space for key plus kMaxBytesPerEncodedHybridTime + 1 bytes for SeekForward() below to
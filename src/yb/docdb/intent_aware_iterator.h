@@ -72,6 +72,11 @@ class IntentAwareIterator : public IntentAwareIteratorIf {
   // hybrid time).
   void Seek(const Slice& key) override;
 
+  // Hints that iterator is about to be sought to each of sorted_keys (encoded keys without
+  // hybrid time, sorted in ascending order), so the regular DB blocks required by those seeks
+  // could be read in parallel. Intents are still resolved by each seek.
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_keys);
+
   // Seek forward to specified encoded key (it is responsibility of caller to make sure it
   // doesn't have hybrid time). For efficiency, the method that takes a non-const KeyBytes pointer
   // avoids memory allocation by using the KeyBytes buffer to prepare the key to seek to, and may
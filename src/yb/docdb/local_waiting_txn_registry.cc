@@ -31,6 +31,7 @@
 #include "yb/server/clock.h"
 #include "yb/tserver/tserver_service.fwd.h"
 #include "yb/tserver/tserver_service.pb.h"
+#include "yb/util/flags.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/shared_lock.h"
@@ -43,6 +44,12 @@ using namespace std::literals;
 
 DECLARE_bool(enable_deadlock_detection);
 
+DEFINE_RUNTIME_bool(report_released_waiters_to_deadlock_detector, false,
+                    "Whether the tablet server should notify transaction coordinators when a "
+                    "waiting transaction stops waiting, so the deadlock detector removes its "
+                    "wait-for edges immediately instead of on the next full scan.");
+TAG_FLAG(report_released_waiters_to_deadlock_detector, advanced);
+
 namespace yb {
 namespace docdb {
 
@@ -83,69 +90,118 @@ void AttachWaitingTransaction(
 // transactions. WaitingTransactionData data indicates which waiters to report to this status tablet
 // and is weakly held -- WaitingTransactionData instances are kept alive by clients of the
 // LocalWaitingTxnRegistry which returns a wrapped WaitingTransactionData to clients to keep alive.
-class StatusTabletData {
+class StatusTabletData : public std::enable_shared_from_this<StatusTabletData> {
  public:
-  explicit StatusTabletData(rpc::Rpcs* rpcs, client::YBClient* client):
-      rpcs_(rpcs), client_(client), rpc_handle_(rpcs_->InvalidHandle()) {}
+  StatusTabletData(
+      rpc::Rpcs* rpcs, client::YBClient* client, const TabletId& status_tablet_id,
+      const server::ClockPtr& clock):
+      rpcs_(rpcs), client_(client), status_tablet_id_(status_tablet_id), clock_(clock),
+      rpc_handle_(rpcs_->InvalidHandle()) {}
 
   void AddWaitingTransactionData(const std::shared_ptr<WaitingTransactionData>& waiter) {
     UniqueLock<decltype(mutex_)> tablet_lock(mutex_);
     waiters.emplace_back(waiter);
   }
 
+  // Sends all live waiters to the coordinator. When another update to this status tablet is in
+  // flight, the full update is queued and sent after that update completes.
   Status SendFullUpdate(const TabletId& status_tablet_id, HybridTime now) {
-    tserver::UpdateTransactionWaitingForStatusRequestPB req;
     UniqueLock<decltype(mutex_)> l(mutex_);
+    DCHECK_EQ(status_tablet_id, status_tablet_id_);
+    full_update_pending_ = true;
+    if (rpc_handle_ != rpcs_->InvalidHandle()) {
+      VLOG(4) << "Queue full update for status tablet " << status_tablet_id_
+              << ", another update is in flight";
+      return Status::OK();
+    }
+    return SendUpdateUnlocked(now);
+  }
 
-    auto has_pending_request = rpc_handle_ != rpcs_->InvalidHandle();
+  // Notifies the coordinator that the waiter no longer waits. Released waiters are reported as
+  // waiting transactions without blockers. Waiters released while another update to this status
+  // tablet is in flight are batched into a single request, sent after that update completes.
+  void AddReleasedWaiter(const TransactionId& id, HybridTime wait_start_time) {
+    UniqueLock<decltype(mutex_)> l(mutex_);
+    released_waiters_.emplace_back(id, wait_start_time);
+    if (rpc_handle_ == rpcs_->InvalidHandle()) {
+      WARN_NOT_OK(SendUpdateUnlocked(clock_->Now()),
+                  Format("Failed to report released waiters to status tablet: $0",
+                         status_tablet_id_));
+    }
+  }
 
-    // Attach live waiters to req and remove any waiters which are no longer live.
-    EraseIf([&req, has_pending_request](const auto& item) {
-      if (auto blocked = item.lock()) {
-        if (PREDICT_TRUE(!has_pending_request)) {
+ private:
+  void UpdateDone() {
+    UniqueLock<decltype(mutex_)> l(mutex_);
+    rpcs_->Unregister(&rpc_handle_);
+    if (full_update_pending_ || !released_waiters_.empty()) {
+      WARN_NOT_OK(SendUpdateUnlocked(clock_->Now()),
+                  Format("Failed to send queued WaitFor update to status tablet: $0",
+                         status_tablet_id_));
+    }
+  }
+
+  // Sends live waiters, if a full update is pending, and released waiters in a single request.
+  Status SendUpdateUnlocked(HybridTime now) REQUIRES(mutex_) {
+    DCHECK(rpc_handle_ == rpcs_->InvalidHandle());
+    tserver::UpdateTransactionWaitingForStatusRequestPB req;
+
+    if (full_update_pending_) {
+      full_update_pending_ = false;
+      // Attach live waiters to req and remove any waiters which are no longer live.
+      EraseIf([&req](const auto& item) {
+        if (auto blocked = item.lock()) {
           AttachWaitingTransaction(*blocked, &req);
+          return false;
         }
-        return false;
-      }
-      return true;
-    }, &waiters);
-
-    if (req.waiting_transactions_size() > 0) {
-      DCHECK(!has_pending_request)
-          << "req should only have waiting transactions if there is no pending request.";
-      req.set_tablet_id(status_tablet_id);
-      req.set_propagated_hybrid_time(now.ToUint64());
-      auto did_send = rpcs_->RegisterAndStart(
-          client::UpdateTransactionWaitingForStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client_,
-            &req,
-            [this](const auto& status, const auto& resp) {
-              UniqueLock<decltype(mutex_)> l(mutex_);
-              rpcs_->Unregister(&rpc_handle_);
-            }),
-          &rpc_handle_);
-      if (did_send) {
-        VLOG(1) << "Sent UpdateTransactionWaitingForStatusRequestPB - "
-                << req.ShortDebugString();
-        return Status::OK();
-      }
-      return STATUS(InternalError, "Failed to register waiter with transaction coordinator");
+        return true;
+      }, &waiters);
+    }
+    for (const auto& [id, wait_start_time] : released_waiters_) {
+      auto* txn = req.add_waiting_transactions();
+      txn->set_transaction_id(id.data(), id.size());
+      txn->set_wait_start_time(wait_start_time.ToUint64());
+    }
+    // Coordinator removes the edges of these waiters on the next full scan, if the request fails.
+    released_waiters_.clear();
+
+    if (req.waiting_transactions_size() == 0) {
+      VLOG(4)
+          << "Not sending UpdateTransactionWaitingForStatusRequestPB for"
+          << " status_tablet: " << status_tablet_id_
+          << " waiting_transactions_size: " << req.waiting_transactions_size();
+      return Status::OK();
     }
 
-    VLOG(4)
-        << "Not sending UpdateTransactionWaitingForStatusRequestPB for"
-        << " status_tablet: " << status_tablet_id
-        << " waiting_transactions_size: " << req.waiting_transactions_size();
-    return Status::OK();
+    req.set_tablet_id(status_tablet_id_);
+    req.set_propagated_hybrid_time(now.ToUint64());
+    auto did_send = rpcs_->RegisterAndStart(
+        client::UpdateTransactionWaitingForStatus(
+          TransactionRpcDeadline(),
+          nullptr /* tablet */,
+          client_,
+          &req,
+          [self = shared_from_this()](const auto& status, const auto& resp) {
+            self->UpdateDone();
+          }),
+        &rpc_handle_);
+    if (did_send) {
+      VLOG(1) << "Sent UpdateTransactionWaitingForStatusRequestPB - "
+              << req.ShortDebugString();
+      return Status::OK();
+    }
+    return STATUS(InternalError, "Failed to register waiter with transaction coordinator");
   }
 
- private:
   rpc::Rpcs* const rpcs_;
   client::YBClient* client_;
+  const TabletId status_tablet_id_;
+  const server::ClockPtr clock_;
   mutable rw_spinlock mutex_;
   std::vector<std::weak_ptr<const WaitingTransactionData>> waiters GUARDED_BY(mutex_);
+  std::vector<std::pair<TransactionId, HybridTime>> released_waiters_ GUARDED_BY(mutex_);
+  // Live waiters should be sent to the coordinator, when the request in flight completes.
+  bool full_update_pending_ GUARDED_BY(mutex_) = false;
   rpc::Rpcs::Handle rpc_handle_ GUARDED_BY(mutex_);
 };
 
@@ -163,6 +219,12 @@ class LocalWaitingTxnRegistry::Impl {
     explicit WaitingTransactionDataWrapper(LocalWaitingTxnRegistry::Impl* registry)
         : registry_(registry) {}
 
+    ~WaitingTransactionDataWrapper() {
+      if (blocked_data_) {
+        registry_->ReleaseWaitingFor(*blocked_data_);
+      }
+    }
+
     Status Register(
         const TransactionId& waiting,
         std::shared_ptr<ConflictDataManager> blockers,
@@ -224,6 +286,20 @@ class LocalWaitingTxnRegistry::Impl {
     shutting_down_ = true;
   }
 
+  void ReleaseWaitingFor(const WaitingTransactionData& data) {
+    if (!FLAGS_enable_deadlock_detection ||
+        !FLAGS_report_released_waiters_to_deadlock_detector) {
+      return;
+    }
+    {
+      SharedLock<decltype(mutex_)> l(mutex_);
+      if (shutting_down_) {
+        return;
+      }
+    }
+    data.status_tablet_data->AddReleasedWaiter(data.id, data.wait_start_time);
+  }
+
   void CompleteShutdown() {
 #ifndef NDEBUG
     SharedLock<decltype(mutex_)> l(mutex_);
@@ -233,8 +309,8 @@ class LocalWaitingTxnRegistry::Impl {
   }
 
  private:
-  std::shared_ptr<StatusTabletData> NewStatusTabletData() {
-    return std::make_shared<StatusTabletData>(&rpcs_, &client());
+  std::shared_ptr<StatusTabletData> NewStatusTabletData(const TabletId& status_tablet_id) {
+    return std::make_shared<StatusTabletData>(&rpcs_, &client(), status_tablet_id, clock_);
   }
 
   Result<std::shared_ptr<StatusTabletData>> GetOrAdd(const TabletId& status_tablet_id) {
@@ -251,14 +327,14 @@ class LocalWaitingTxnRegistry::Impl {
         return existing_data;
       }
       VLOG_WITH_FUNC(4) << "Overwriting existing status tablet data " << status_tablet_id;
-      auto new_data = NewStatusTabletData();
+      auto new_data = NewStatusTabletData(status_tablet_id);
       it->second = new_data;
       return new_data;
     }
 
     VLOG_WITH_FUNC(4) << "Inserting new status tablet data " << status_tablet_id;
 
-    auto new_data = NewStatusTabletData();
+    auto new_data = NewStatusTabletData(status_tablet_id);
     auto did_insert = status_tablets_.emplace(status_tablet_id, new_data).second;
     DCHECK(did_insert);
     return new_data;
@@ -13,7 +13,9 @@
 
 #include "yb/docdb/pgsql_operation.h"
 
+#include <algorithm>
 #include <limits>
+#include <optional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -106,6 +108,15 @@ DEFINE_test_flag(bool, ysql_suppress_ybctid_corruption_details, false,
 DEFINE_RUNTIME_bool(ysql_enable_pack_full_row_update, false,
                     "Whether to enable packed row for full row update.");
 
+DEFINE_RUNTIME_bool(ysql_prefetch_batched_ybctids, false,
+                    "Whether to read SST blocks for all ybctids of a batched read request in "
+                    "parallel before looking up the rows one by one.");
+
+DEFINE_RUNTIME_bool(ysql_write_row_values_directly, true,
+                    "Whether unfiltered YSQL reads of plain non key columns write values decoded "
+                    "from flat documents straight to the result buffer, instead of building a row "
+                    "and evaluating targets for it.");
+
 namespace yb {
 namespace docdb {
 
@@ -358,6 +369,44 @@ void WriteNumRows(size_t result_rows, const WriteBufferPos& pos, WriteBuffer* bu
   CHECK_OK(buffer->Write(pos, encoded_rows, sizeof(encoded_rows)));
 }
 
+// Index of the target column value in YQLRowwiseIteratorIf::NextRowValues and type of the column.
+using RowValueTarget = std::pair<size_t, DataType>;
+
+// Returns targets of the request, when values of its rows could be written to the result right
+// from the values decoded by the iterator, without building QLTableRow and evaluating expressions.
+// That is possible when rows are not filtered, and each target is a plain non key column of the
+// table. Returns nullopt otherwise.
+std::optional<std::vector<RowValueTarget>> GetRowValueTargets(
+    const PgsqlReadRequestPB& request, const Schema& schema, const YQLRowwiseIteratorIf& iter) {
+  if (!FLAGS_ysql_write_row_values_directly) {
+    return std::nullopt;
+  }
+  if (request.has_index_request() || request.is_aggregate() || !request.where_clauses().empty() ||
+      request.targets().empty()) {
+    return std::nullopt;
+  }
+  std::vector<RowValueTarget> result;
+  result.reserve(request.targets().size());
+  for (const auto& expr : request.targets()) {
+    // Negative ids are used by system columns, e.g. ybctid.
+    if (!expr.has_column_id() || expr.column_id() < 0) {
+      return std::nullopt;
+    }
+    const ColumnId column_id(expr.column_id());
+    auto column = schema.column_by_id(column_id);
+    if (!column.ok()) {
+      return std::nullopt;
+    }
+    const auto data_type = column->type()->main();
+    auto value_index = iter.RowValueIndex(column_id);
+    if (!CanWritePgColumn(data_type) || !value_index) {
+      return std::nullopt;
+    }
+    result.emplace_back(*value_index, data_type);
+  }
+  return result;
+}
+
 } // namespace
 
 class PgsqlWriteOperation::RowPackContext {
@@ -880,7 +929,7 @@ Status PgsqlWriteOperation::ApplyFetchSequence(const DocOperationApplyData& data
     // Reserve space for num rows.
     write_buffer_ = &sidecars_->Start();
     row_num_pos_ = write_buffer_->Position();
-    pggate::PgWire::WriteInt64(0, write_buffer_);
+    PgWire::WriteInt64(0, write_buffer_);
   }
 
   // Read last_value and is_called from the sequence record
@@ -995,7 +1044,7 @@ Status PgsqlWriteOperation::PopulateResultSet(const QLTableRow& table_row) {
     // Reserve space for num rows.
     write_buffer_ = &sidecars_->Start();
     row_num_pos_ = write_buffer_->Position();
-    pggate::PgWire::WriteInt64(0, write_buffer_);
+    PgWire::WriteInt64(0, write_buffer_);
   }
   ++result_rows_;
   for (const PgsqlExpressionPB& expr : request_.targets()) {
@@ -1105,7 +1154,7 @@ Result<size_t> PgsqlReadOperation::Execute(const YQLStorageIf& ql_storage,
   size_t fetched_rows = 0;
   auto num_rows_pos = result_buffer->Position();
   // Reserve space for fetched rows count.
-  pggate::PgWire::WriteInt64(0, result_buffer);
+  PgWire::WriteInt64(0, result_buffer);
   auto se = ScopeExit([&fetched_rows, num_rows_pos, result_buffer] {
     WriteNumRows(fetched_rows, num_rows_pos, result_buffer);
   });
@@ -1372,6 +1421,9 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const YQLStorageIf& ql_storage,
   VLOG(1) << "Started iterator - EndReferenceKeyColumnIndex: "
           << end_referenced_key_column_index;
 
+  const auto row_value_targets = GetRowValueTargets(request_, doc_schema, *iter);
+  VLOG(1) << "Write row values directly: " << row_value_targets.has_value();
+
   // Set scan end time. We want to iterate as long as we can, but stop before client timeout.
   // The more rows we do per request, the less RPCs will be needed, but if client times out,
   // efforts are wasted.
@@ -1383,6 +1435,18 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const YQLStorageIf& ql_storage,
   QLTableRow row;
   while (fetched_rows < row_count_limit && VERIFY_RESULT(iter->HasNext()) &&
          !scan_time_exceeded) {
+    if (row_value_targets) {
+      // Rows are not filtered, so values of the row are written to the result right away.
+      const auto& values = *VERIFY_RESULT(iter->NextRowValues());
+      for (const auto& [value_index, data_type] : *row_value_targets) {
+        RETURN_NOT_OK(WritePgColumn(values[value_index], data_type, result_buffer));
+      }
+      ++match_count;
+      ++fetched_rows;
+      scan_time_exceeded = CoarseMonoClock::now() >= stop_scan;
+      continue;
+    }
+
     row.Clear();
     bool is_match = true;
 
@@ -1507,7 +1571,25 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(const YQLStorageIf& ql_sto
     }
   }
 
-  bool iter_valid = false;
+  RETURN_NOT_OK(ql_storage.GetIterator(
+      request_.stmt_id(), projection, doc_read_context, txn_op_context_,
+      deadline, read_time, min_arg->ybctid().value(),
+      max_arg->ybctid().value(), &table_iter_));
+
+  // Rows should be returned in the order of the batch arguments, so lookups are not reordered.
+  // But the blocks required by all lookups are read at once, so each lookup does not wait for its
+  // own IO.
+  if (FLAGS_ysql_prefetch_batched_ybctids && batch_args.size() > 1) {
+    std::vector<Slice> sorted_tuple_ids;
+    sorted_tuple_ids.reserve(batch_args.size());
+    for (const auto& batch_argument : batch_args) {
+      sorted_tuple_ids.emplace_back(batch_argument.ybctid().value().binary_value());
+    }
+    std::sort(sorted_tuple_ids.begin(), sorted_tuple_ids.end());
+    table_iter_->PrefetchTuples(sorted_tuple_ids);
+  }
+
+  bool iter_valid = true;
   for(const PgsqlBatchArgumentPB& batch_argument : batch_args) {
     if (!iter_valid) {
       // It can be the case like when there is a tablet split that we still want
@@ -23,6 +23,7 @@
 
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/primitive_value_util.h"
 #include "yb/docdb/value_type.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -33,6 +34,9 @@
 #include "yb/util/result.h"
 #include "yb/util/string_trim.h"
 #include "yb/util/test_macros.h"
+#include "yb/util/write_buffer.h"
+
+#include "yb/yql/pggate/util/pg_doc_data.h"
 
 using std::map;
 using std::string;
@@ -241,6 +245,54 @@ TEST(PrimitiveValueTest, PrimitiveValueRoundTrip) {
   TestRoundTrip(PrimitiveValue::Float(1e-37), DataType::FLOAT);
 }
 
+TEST(PrimitiveValueTest, MoveToQLValuePB) {
+  for (auto data_type : {DataType::STRING, DataType::BINARY, DataType::INT64}) {
+    auto ql_type = QLType::Create(data_type);
+    auto primitive_value = data_type == DataType::INT64
+        ? PrimitiveValue::Int64(123456789000l) : PrimitiveValue(std::string(100, 'x'));
+    QLValuePB expected;
+    primitive_value.ToQLValuePB(ql_type, &expected);
+    QLValuePB moved;
+    primitive_value.MoveToQLValuePB(ql_type, &moved);
+    ASSERT_EQ(QLValue(expected), QLValue(moved))
+        << Format("{ expected: $0, actual: $1 }", expected, moved);
+  }
+}
+
+TEST(PrimitiveValueTest, WritePgColumn) {
+  const std::vector<std::pair<PrimitiveValue, DataType>> cases = {
+    {PrimitiveValue(ValueEntryType::kTrue), DataType::BOOL},
+    {PrimitiveValue(ValueEntryType::kFalse), DataType::BOOL},
+    {PrimitiveValue::Int32(-12), DataType::INT8},
+    {PrimitiveValue::Int32(-1234), DataType::INT16},
+    {PrimitiveValue::Int32(-123456), DataType::INT32},
+    {PrimitiveValue::Int64(123456789000l), DataType::INT64},
+    {PrimitiveValue::UInt32(123456), DataType::UINT32},
+    {PrimitiveValue::UInt64(123456789000ul), DataType::UINT64},
+    {PrimitiveValue::Float(1.5), DataType::FLOAT},
+    {PrimitiveValue::Double(-2.25), DataType::DOUBLE},
+    {PrimitiveValue("text"), DataType::STRING},
+    {PrimitiveValue(std::string("bin\0ary", 7)), DataType::BINARY},
+    {PrimitiveValue::Decimal("encoded decimal"), DataType::DECIMAL},
+    {PrimitiveValue::GinNull(2), DataType::INT32},
+    {PrimitiveValue(ValueEntryType::kNullLow), DataType::STRING},
+    {PrimitiveValue(ValueEntryType::kInvalid), DataType::INT64},
+    {PrimitiveValue(ValueEntryType::kTombstone), DataType::DOUBLE},
+  };
+  for (const auto& [value, data_type] : cases) {
+    SCOPED_TRACE(Format("value: $0, type: $1", value, DataType_Name(data_type)));
+    ASSERT_TRUE(CanWritePgColumn(data_type));
+    QLValuePB ql_value;
+    value.ToQLValuePB(QLType::Create(data_type), &ql_value);
+    WriteBuffer expected(0x100);
+    ASSERT_OK(pggate::WriteColumn(ql_value, &expected));
+    WriteBuffer actual(0x100);
+    ASSERT_OK(WritePgColumn(value, data_type, &actual));
+    ASSERT_EQ(expected.ToBuffer(), actual.ToBuffer());
+  }
+  ASSERT_FALSE(CanWritePgColumn(DataType::JSONB));
+}
+
 TEST(PrimitiveValueTest, TestEncoding) {
   TestEncoding(R"#("Sfoo\x00\x00")#", KeyEntryValue("foo"));
   TestEncoding(R"#("Sfoo\x00\x01bar\x01\x00\x00")#", KeyEntryValue(string("foo\0bar\x01", 8)));
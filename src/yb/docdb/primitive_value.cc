@@ -2257,6 +2257,23 @@ void PrimitiveValue::ToQLValuePB(const std::shared_ptr<QLType>& ql_type,
   LOG(FATAL) << "Unsupported datatype " << ql_type->ToString();
 }
 
+void PrimitiveValue::MoveToQLValuePB(
+    const std::shared_ptr<QLType>& ql_type, QLValuePB* ql_value) {
+  if (IsStoredAsString()) {
+    switch (ql_type->main()) {
+      case DataType::STRING:
+        ql_value->set_string_value(std::move(str_val_));
+        return;
+      case DataType::BINARY:
+        ql_value->set_binary_value(std::move(str_val_));
+        return;
+      default:
+        break;
+    }
+  }
+  ToQLValuePB(ql_type, ql_value);
+}
+
 KeyEntryValue::KeyEntryValue() : type_(KeyEntryType::kInvalid) {
 }
 
@@ -97,6 +97,10 @@ class PrimitiveValue {
   // Set a primitive value in a QLValuePB.
   void ToQLValuePB(const std::shared_ptr<QLType>& ql_type, QLValuePB* ql_val) const;
 
+  // Same as ToQLValuePB, but moves string content to ql_val instead of copying it.
+  // Content of this value is unspecified after this call.
+  void MoveToQLValuePB(const std::shared_ptr<QLType>& ql_type, QLValuePB* ql_val);
+
   ValueEntryType value_type() const { return type_; }
   ValueEntryType type() const { return type_; }
 
@@ -14,6 +14,7 @@
 
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_value.h"
+#include "yb/common/pg_wire.h"
 #include "yb/common/pgsql_protocol.messages.h"
 #include "yb/common/schema.h"
 
@@ -113,6 +114,88 @@ Result<vector<KeyEntryValue>> InitKeyColumnPrimitiveValues(
   return DoInitKeyColumnPrimitiveValues(column_values, schema, start_idx);
 }
 
+bool CanWritePgColumn(DataType data_type) {
+  switch (data_type) {
+    case DataType::BOOL:
+    case DataType::INT8:
+    case DataType::INT16:
+    case DataType::INT32:
+    case DataType::INT64:
+    case DataType::UINT32:
+    case DataType::UINT64:
+    case DataType::FLOAT:
+    case DataType::DOUBLE:
+    case DataType::STRING:
+    case DataType::BINARY:
+    case DataType::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Status WritePgColumn(const PrimitiveValue& value, DataType data_type, WriteBuffer* buffer) {
+  // Same null handling as in PrimitiveValue::ToQLValuePB.
+  const auto type = value.type();
+  PgWireDataHeader header;
+  if (type == ValueEntryType::kNullLow || type == ValueEntryType::kNullHigh ||
+      type == ValueEntryType::kInvalid || type == ValueEntryType::kTombstone) {
+    header.set_null();
+    PgWire::WriteUint8(header.ToUint8(), buffer);
+    return Status::OK();
+  }
+  PgWire::WriteUint8(header.ToUint8(), buffer);
+
+  if (type == ValueEntryType::kGinNull) {
+    PgWire::WriteUint8(value.GetGinNull(), buffer);
+    return Status::OK();
+  }
+
+  switch (data_type) {
+    case DataType::BOOL:
+      PgWire::WriteBool(type == ValueEntryType::kTrue, buffer);
+      return Status::OK();
+    case DataType::INT8:
+      PgWire::WriteInt8(static_cast<int8_t>(value.GetInt32()), buffer);
+      return Status::OK();
+    case DataType::INT16:
+      PgWire::WriteInt16(static_cast<int16_t>(value.GetInt32()), buffer);
+      return Status::OK();
+    case DataType::INT32:
+      PgWire::WriteInt32(value.GetInt32(), buffer);
+      return Status::OK();
+    case DataType::INT64:
+      PgWire::WriteInt64(value.GetInt64(), buffer);
+      return Status::OK();
+    case DataType::UINT32:
+      PgWire::WriteUint32(value.GetUInt32(), buffer);
+      return Status::OK();
+    case DataType::UINT64:
+      PgWire::WriteUint64(value.GetUInt64(), buffer);
+      return Status::OK();
+    case DataType::FLOAT:
+      PgWire::WriteFloat(value.GetFloat(), buffer);
+      return Status::OK();
+    case DataType::DOUBLE:
+      PgWire::WriteDouble(value.GetDouble(), buffer);
+      return Status::OK();
+    case DataType::STRING:
+      PgWire::WriteText(value.GetString(), buffer);
+      return Status::OK();
+    case DataType::BINARY:
+      PgWire::WriteBinary(value.GetString(), buffer);
+      return Status::OK();
+    case DataType::DECIMAL:
+      // Serialized form of YB Decimal, same as pggate::WriteColumn writes it.
+      PgWire::WriteText(value.GetDecimal(), buffer);
+      return Status::OK();
+    default:
+      break;
+  }
+  return STATUS_FORMAT(
+      NotSupported, "Unexpected type of YSQL column: $0", DataType_Name(data_type));
+}
+
 Result<vector<KeyEntryValue>> InitKeyColumnPrimitiveValues(
     const ArenaList<LWPgsqlExpressionPB> &column_values, const Schema &schema, size_t start_idx) {
   return DoInitKeyColumnPrimitiveValues(column_values, schema, start_idx);
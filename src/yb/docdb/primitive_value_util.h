@@ -17,11 +17,16 @@
 
 #include <google/protobuf/repeated_field.h>
 
+#include "yb/common/value.pb.h"
+
 #include "yb/docdb/docdb_encoding_fwd.h"
 
 #include "yb/util/memory/arena_list.h"
 
 namespace yb {
+
+class WriteBuffer;
+
 namespace docdb {
 
 // Add primary key column values to the component group. Verify that they are in the same order
@@ -38,5 +43,13 @@ Result<std::vector<KeyEntryValue>> InitKeyColumnPrimitiveValues(
 Result<std::vector<KeyEntryValue>> InitKeyColumnPrimitiveValues(
     const ArenaList<LWPgsqlExpressionPB> &column_values, const Schema &schema, size_t start_idx);
 
+// Returns true if values of columns of this type could be written by WritePgColumn.
+bool CanWritePgColumn(DataType data_type);
+
+// Writes value of a YSQL column to buffer in the PG wire format. The result is the same as
+// pggate::WriteColumn of the QLValuePB that PrimitiveValue::ToQLValuePB produces for the column
+// type, but without building QLValuePB.
+Status WritePgColumn(const PrimitiveValue& value, DataType data_type, WriteBuffer* buffer);
+
 }  // namespace docdb
 }  // namespace yb
@@ -32,6 +32,17 @@ Result<bool> YQLRowwiseIteratorIf::SeekTuple(const Slice& tuple_id) {
   return STATUS(NotSupported, "This iterator cannot seek by tuple id");
 }
 
+void YQLRowwiseIteratorIf::PrefetchTuples(const std::vector<Slice>& sorted_tuple_ids) {
+}
+
+std::optional<size_t> YQLRowwiseIteratorIf::RowValueIndex(ColumnId column_id) const {
+  return std::nullopt;
+}
+
+Result<const std::vector<PrimitiveValue>*> YQLRowwiseIteratorIf::NextRowValues() {
+  return STATUS(NotSupported, "This iterator does not provide row values");
+}
+
 HybridTime YQLRowwiseIteratorIf::TEST_MaxSeenHt() {
   return HybridTime::kInvalid;
 }
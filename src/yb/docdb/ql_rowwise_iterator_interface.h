@@ -14,6 +14,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -75,6 +77,19 @@ class YQLRowwiseIteratorIf {
   // Seeks to the given tuple by its id. See DocRowwiseIterator for details.
   virtual Result<bool> SeekTuple(const Slice& tuple_id);
 
+  // Hints that the iterator is about to be sought to each of the given tuples, sorted by tuple
+  // id. See DocRowwiseIterator for details.
+  virtual void PrefetchTuples(const std::vector<Slice>& sorted_tuple_ids);
+
+  // Returns index of the column value in the result of NextRowValues, or nullopt when the value of
+  // the column is not available there, e.g. for key columns. See DocRowwiseIterator for details.
+  virtual std::optional<size_t> RowValueIndex(ColumnId column_id) const;
+
+  // Consumes the current row like NextRow, but returns decoded values of the row instead of
+  // building QLTableRow. Could be used only when RowValueIndex returns index for all columns that
+  // should be read. Values are valid until the next call to HasNext.
+  virtual Result<const std::vector<PrimitiveValue>*> NextRowValues();
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
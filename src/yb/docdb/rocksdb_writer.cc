@@ -310,6 +310,9 @@ Status TransactionalWriter::operator()(
     reverse_value_prefix = replicated_batches_state_;
   }
   AddIntent<kNumKeyParts>(transaction_id_, key_parts, value, handler_, reverse_value_prefix);
+  if (cached_intents_ && strong_intent_types_.Test(IntentType::kStrongWrite)) {
+    cached_intents_->Add(key_parts, value);
+  }
 
   return Status::OK();
 }
@@ -457,10 +460,13 @@ ApplyIntentsContext::ApplyIntentsContext(
       commit_ht_(commit_ht),
       log_ht_(log_ht),
       write_id_(apply_state ? apply_state->write_id : 0),
-      key_bounds_(key_bounds),
-      intent_iter_(CreateRocksDBIterator(
-          intents_db, key_bounds, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
-          rocksdb::kDefaultQueryId)) {
+      key_bounds_(key_bounds) {
+  // Intents DB is not passed when intents are applied from memory.
+  if (intents_db) {
+    intent_iter_ = CreateRocksDBIterator(
+        intents_db, key_bounds, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+        rocksdb::kDefaultQueryId);
+  }
 }
 
 Result<bool> ApplyIntentsContext::StoreApplyState(
@@ -505,7 +511,6 @@ Result<bool> ApplyIntentsContext::Entry(
     return StoreApplyState(key, handler);
   }
 
-  DocHybridTimeBuffer doc_ht_buffer;
   intent_iter_.Seek(value);
   if (!intent_iter_.Valid() || intent_iter_.key() != value) {
     Slice temp_slice = value;
@@ -517,12 +522,29 @@ Result<bool> ApplyIntentsContext::Entry(
     return false;
   }
 
-  auto intent = VERIFY_RESULT(ParseIntentKey(value, transaction_id().AsSlice()));
+  RETURN_NOT_OK(ApplyIntent(value, intent_iter_.value(), handler));
+  return false;
+}
+
+Status ApplyIntentsContext::ApplyCached(
+    const CachedIntents& intents, rocksdb::DirectWriteHandler* handler) {
+  return intents.ForEach([this, handler](const Slice& key, const Slice& value) -> Status {
+    if (!IsWithinBounds(key_bounds_, key)) {
+      return Status::OK();
+    }
+    RSTATUS_DCHECK(!reached_records_limit(), IllegalState, "Too many cached intents");
+    return ApplyIntent(key, value, handler);
+  });
+}
+
+Status ApplyIntentsContext::ApplyIntent(
+    const Slice& intent_key, const Slice& intent_value, rocksdb::DirectWriteHandler* handler) {
+  DocHybridTimeBuffer doc_ht_buffer;
+  auto intent = VERIFY_RESULT(ParseIntentKey(intent_key, transaction_id().AsSlice()));
 
   if (intent.types.Test(IntentType::kStrongWrite)) {
     const Slice transaction_id_slice = transaction_id().AsSlice();
-    auto decoded_value = VERIFY_RESULT(DecodeIntentValue(
-        intent_iter_.value(), &transaction_id_slice));
+    auto decoded_value = VERIFY_RESULT(DecodeIntentValue(intent_value, &transaction_id_slice));
 
     // Write id should match to one that were calculated during append of intents.
     // Doing it just for sanity check.
@@ -532,17 +554,17 @@ Result<bool> ApplyIntentsContext::Entry(
         Format("Unexpected write id. Expected: $0, found: $1, raw value: $2",
                write_id_,
                decoded_value.write_id,
-               intent_iter_.value().ToDebugHexString()));
+               intent_value.ToDebugHexString()));
     write_id_ = decoded_value.write_id;
 
     // Intents for row locks should be ignored (i.e. should not be written as regular records).
     if (decoded_value.body.starts_with(ValueEntryTypeAsChar::kRowLock)) {
-      return false;
+      return Status::OK();
     }
 
     // Intents from aborted subtransactions should not be written as regular records.
     if (aborted_.Test(decoded_value.subtransaction_id)) {
-      return false;
+      return Status::OK();
     }
 
     // After strip of prefix and suffix intent_key contains just SubDocKey w/o a hybrid time.
@@ -588,7 +610,7 @@ Result<bool> ApplyIntentsContext::Entry(
     }
   }
 
-  return false;
+  return Status::OK();
 }
 
 void ApplyIntentsContext::Complete(rocksdb::DirectWriteHandler* handler) {
@@ -606,6 +628,23 @@ void ApplyIntentsContext::Complete(rocksdb::DirectWriteHandler* handler) {
   }
 }
 
+CachedIntentsWriter::CachedIntentsWriter(
+    const CachedIntents& intents, ApplyIntentsContext* context)
+    : intents_(intents), context_(*context) {
+}
+
+bool CachedIntentsWriter::CanApply(const CachedIntents& intents) {
+  const auto max_records = FLAGS_txn_max_apply_batch_records;
+  return max_records > 0 && intents.size() <= static_cast<size_t>(max_records);
+}
+
+Status CachedIntentsWriter::Apply(rocksdb::DirectWriteHandler* handler) {
+  context_.Start(boost::none);
+  RETURN_NOT_OK(context_.ApplyCached(intents_, handler));
+  context_.Complete(handler);
+  return Status::OK();
+}
+
 RemoveIntentsContext::RemoveIntentsContext(const TransactionId& transaction_id, uint8_t reason)
     : IntentsWriterContext(transaction_id), reason_(reason) {
 }
@@ -59,6 +59,62 @@ class DocHybridTimeBuffer {
   std::array<char, 1 + kMaxBytesPerEncodedHybridTime> buffer_;
 };
 
+// Copy of strong write intents of a transaction, kept in memory after they were written to the
+// intents DB, so the transaction could be applied without reading them back.
+// This is only a cache for apply. Intents DB is still the source of truth: reads, conflict
+// resolution, CDC and loading of transactions on restart use it, and intents are written to it and
+// removed from it as before.
+// Intents are stored in the order of the transaction reverse index, i.e. in the order they
+// were written.
+class CachedIntents {
+ public:
+  template <size_t N, size_t M>
+  void Add(const std::array<Slice, N>& key, const std::array<Slice, M>& value) {
+    for (const auto& part : key) {
+      data_.append(part.cdata(), part.size());
+    }
+    const auto key_end = data_.size();
+    for (const auto& part : value) {
+      data_.append(part.cdata(), part.size());
+    }
+    entries_.push_back(Entry {
+      .key_end = key_end,
+      .value_end = data_.size(),
+    });
+  }
+
+  // Invokes callback with key and value of each intent.
+  template <class Callback>
+  Status ForEach(const Callback& callback) const {
+    size_t begin = 0;
+    for (const auto& entry : entries_) {
+      RETURN_NOT_OK(callback(
+          Slice(data_.data() + begin, data_.data() + entry.key_end),
+          Slice(data_.data() + entry.key_end, data_.data() + entry.value_end)));
+      begin = entry.value_end;
+    }
+    return Status::OK();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  // Number of bytes of memory used by stored intents.
+  size_t bytes() const {
+    return data_.capacity() + entries_.capacity() * sizeof(Entry);
+  }
+
+ private:
+  struct Entry {
+    size_t key_end;
+    size_t value_end;
+  };
+
+  std::string data_;
+  std::vector<Entry> entries_;
+};
+
 class TransactionalWriter : public rocksdb::DirectWriter {
  public:
   TransactionalWriter(
@@ -80,6 +136,11 @@ class TransactionalWriter : public rocksdb::DirectWriter {
     metadata_to_store_ = value;
   }
 
+  // Strong write intents are also added to cached_intents.
+  void SetCachedIntents(CachedIntents* cached_intents) {
+    cached_intents_ = cached_intents;
+  }
+
   Status operator()(
       IntentStrength intent_strength, FullDocKey, Slice value_slice, KeyBytes* key,
       LastKey last_key);
@@ -100,6 +161,7 @@ class TransactionalWriter : public rocksdb::DirectWriter {
   IntraTxnWriteId intra_txn_write_id_;
   IntraTxnWriteId write_id_ = 0;
   const LWTransactionMetadataPB* metadata_to_store_ = nullptr;
+  CachedIntents* cached_intents_ = nullptr;
 
   // TODO(dtxn) weak & strong intent in one batch.
   // TODO(dtxn) extract part of code knowing about intents structure to lower level.
@@ -202,9 +264,16 @@ class ApplyIntentsContext : public IntentsWriterContext {
     frontiers_ = frontiers;
   }
 
+  // Applies intents from memory instead of iterating the transaction reverse index. All intents
+  // should fit into a single batch, see CachedIntentsWriter::CanApply.
+  Status ApplyCached(const CachedIntents& intents, rocksdb::DirectWriteHandler* handler);
+
  private:
   Result<bool> StoreApplyState(const Slice& key, rocksdb::DirectWriteHandler* handler);
 
+  Status ApplyIntent(
+      const Slice& intent_key, const Slice& intent_value, rocksdb::DirectWriteHandler* handler);
+
   const ApplyTransactionState* apply_state_;
   const SubtxnSet& aborted_;
   HybridTime commit_ht_;
@@ -217,6 +286,23 @@ class ApplyIntentsContext : public IntentsWriterContext {
   ConsensusFrontiers* frontiers_;
 };
 
+// Applies transaction using its cached intents. The intents DB is not read.
+class CachedIntentsWriter : public rocksdb::DirectWriter {
+ public:
+  CachedIntentsWriter(const CachedIntents& intents, ApplyIntentsContext* context);
+
+  // Whether intents could be applied by CachedIntentsWriter. Transactions that do not fit into
+  // a single apply batch are applied from the intents DB, that is able to continue apply from the
+  // stored apply state.
+  static bool CanApply(const CachedIntents& intents);
+
+  Status Apply(rocksdb::DirectWriteHandler* handler) override;
+
+ private:
+  const CachedIntents& intents_;
+  ApplyIntentsContext& context_;
+};
+
 class RemoveIntentsContext : public IntentsWriterContext {
  public:
   explicit RemoveIntentsContext(const TransactionId& transaction_id, uint8_t reason);
@@ -139,12 +139,20 @@ Slice SchemaPacking::GetValue(size_t idx, const Slice& packed) const {
   return Slice(packed.data() + offset, packed.data() + end);
 }
 
-std::optional<Slice> SchemaPacking::GetValue(ColumnId column_id, const Slice& packed) const {
+std::optional<size_t> SchemaPacking::GetIndex(ColumnId column_id) const {
   auto it = column_to_idx_.find(column_id);
   if (it == column_to_idx_.end() || it->second == kSkippedColumnIdx) {
+    return std::nullopt;
+  }
+  return make_unsigned(it->second);
+}
+
+std::optional<Slice> SchemaPacking::GetValue(ColumnId column_id, const Slice& packed) const {
+  auto idx = GetIndex(column_id);
+  if (!idx) {
     return {};
   }
-  return GetValue(it->second, packed);
+  return GetValue(*idx, packed);
 }
 
 std::string SchemaPacking::ToString() const {
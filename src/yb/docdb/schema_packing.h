@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <optional>
 #include <unordered_map>
 
 #include <boost/functional/hash.hpp>
@@ -84,6 +85,11 @@ class SchemaPacking {
   }
 
   bool SkippedColumn(ColumnId column_id) const;
+
+  // Returns index of the column with specified id in this packing, or std::nullopt if column
+  // is not packed.
+  std::optional<size_t> GetIndex(ColumnId column_id) const;
+
   Slice GetValue(size_t idx, const Slice& packed) const;
   std::optional<Slice> GetValue(ColumnId column_id, const Slice& packed) const;
   void ToPB(SchemaPackingPB* out) const;
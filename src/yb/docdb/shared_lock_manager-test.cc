@@ -13,19 +13,25 @@
 
 #include <atomic>
 #include <mutex>
+#include <set>
 #include <stack>
 #include <thread>
 
 #include "yb/docdb/lock_batch.h"
 #include "yb/docdb/shared_lock_manager.h"
 
+#include "yb/gutil/endian.h"
+#include "yb/gutil/stringprintf.h"
+
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/random_util.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/result.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
+#include "yb/util/tostring.h"
 
 using namespace std::literals;
 
@@ -162,6 +168,95 @@ TEST_F(SharedLockManagerTest, QuickLockUnlock) {
   }
 }
 
+// Keys of a table share a long common prefix, check that they are still spread over all shards of
+// the lock table.
+TEST_F(SharedLockManagerTest, KeysSpreadAcrossShards) {
+  constexpr size_t kNumKeys = 1024;
+  const auto num_shards = SharedLockManager::TEST_NumShards();
+  const std::string prefix = "common_table_prefix";
+
+  std::vector<std::vector<RefCntPrefix>> key_sets(2);
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    key_sets[0].emplace_back(StringPrintf("key_%03zu", i));
+    // Big endian encoded sequential integers, like int64 columns of a doc key.
+    char encoded[sizeof(uint64_t)];
+    BigEndian::Store64(encoded, i);
+    key_sets[1].emplace_back(prefix + std::string(encoded, sizeof(encoded)));
+  }
+
+  for (const auto& keys : key_sets) {
+    std::vector<size_t> keys_per_shard(num_shards);
+    for (const auto& key : keys) {
+      auto shard = SharedLockManager::TEST_ShardIndex(key);
+      ASSERT_LT(shard, num_shards);
+      ++keys_per_shard[shard];
+    }
+    LOG(INFO) << "Keys per shard: " << AsString(keys_per_shard);
+    for (auto count : keys_per_shard) {
+      // 64 keys per shard expected, allow twice of it.
+      ASSERT_GT(count, 0);
+      ASSERT_LE(count, 2 * kNumKeys / num_shards);
+    }
+  }
+}
+
+// Keys of a batch usually fall into different shards of the lock table, check that the exclusive
+// lock on a key is held by a single batch at a time.
+TEST_F(SharedLockManagerTest, ExclusiveMultiKeyBatches) {
+  constexpr size_t kThreads = 16;
+  constexpr size_t kNumKeys = 64;
+  constexpr size_t kBatchSize = 3;
+
+  std::vector<RefCntPrefix> keys;
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    // Zero padded, so keys of the batch are sorted and batches lock keys in the same order.
+    keys.emplace_back(StringPrintf("key_%03zu", i));
+  }
+  std::set<size_t> shards;
+  for (const auto& key : keys) {
+    shards.insert(SharedLockManager::TEST_ShardIndex(key));
+  }
+  // Otherwise batches would mostly contend on the same shard lock.
+  ASSERT_GE(shards.size(), SharedLockManager::TEST_NumShards() * 3 / 4);
+  std::array<std::atomic<size_t>, kNumKeys> holders{};
+  std::atomic<bool> stop_requested{false};
+  std::atomic<size_t> violations{0};
+  std::vector<std::thread> threads;
+  while (threads.size() != kThreads) {
+    threads.emplace_back([this, &keys, &holders, &stop_requested, &violations] {
+      while (!stop_requested.load(std::memory_order_acquire)) {
+        std::set<size_t> indexes;
+        while (indexes.size() != kBatchSize) {
+          indexes.insert(RandomUniformInt<size_t>(0, kNumKeys - 1));
+        }
+        LockBatchEntries entries;
+        for (auto idx : indexes) {
+          entries.push_back(LockBatchEntry {
+            .key = keys[idx],
+            .intent_types = IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead}),
+          });
+        }
+        LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+        for (auto idx : indexes) {
+          if (holders[idx].fetch_add(1, std::memory_order_acq_rel) != 0) {
+            violations.fetch_add(1, std::memory_order_acq_rel);
+          }
+        }
+        for (auto idx : indexes) {
+          holders[idx].fetch_sub(1, std::memory_order_acq_rel);
+        }
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(5s);
+  stop_requested.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(violations.load(std::memory_order_acquire), 0);
+}
+
 TEST_F(SharedLockManagerTest, LockConflicts) {
   rpc::ThreadPool tp(rpc::ThreadPoolOptions{
     .name = "test_pool"s,
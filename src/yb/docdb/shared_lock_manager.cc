@@ -24,6 +24,8 @@
 
 #include "yb/docdb/lock_batch.h"
 
+#include "yb/gutil/port.h"
+
 #include "yb/util/enums.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/scope_exit.h"
@@ -96,6 +98,26 @@ std::array<LockState, kIntentTypeSetMapSize> GenerateByMask(LockState single_int
   return result;
 }
 
+// Keys are distributed between shards of the lock table by hash, so writes to different keys of
+// the same tablet don't contend on a single mutex.
+constexpr size_t kNumLockShardsLog2 = 4;
+constexpr size_t kNumLockShards = 1ULL << kNumLockShardsLog2;
+
+// Finalizer of 64 bit MurmurHash3. RefCntPrefixHash is FNV-1, whose high bits barely depend on the
+// trailing bytes of the key, so keys with a common prefix would fall into a few shards without it.
+uint64_t MixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+size_t LockShardIndex(const RefCntPrefix& key) {
+  // High bits are used, since low bits of the hash select the bucket inside the shard map.
+  return MixHash(RefCntPrefixHash()(key)) >> (64 - kNumLockShardsLog2);
+}
 
 } // namespace
 
@@ -129,14 +151,19 @@ bool IntentTypeSetsConflict(IntentTypeSet lhs, IntentTypeSet rhs) {
   return false;
 }
 
+struct LockShard;
+
 struct LockedBatchEntry {
   // Taken only for short duration, with no blocking wait.
   mutable std::mutex mutex;
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and covers this field for all LockBatchEntries.
+  // Shard that owns this entry. Entries are reused only within the same shard.
+  LockShard* shard = nullptr;
+
+  // Refcounting for garbage collection. Can only be used while the shard mutex is locked.
+  // Shard mutex resides in lock manager and covers this field for all entries of the shard.
   size_t ref_count = 0;
 
   // Number of holders for each type
@@ -156,34 +183,51 @@ struct LockedBatchEntry {
   }
 };
 
+// Part of the lock table, that contains keys with the same hash prefix.
+// Aligned to the cache line, so shards that are locked concurrently don't share a cache line.
+struct alignas(CACHELINE_SIZE) LockShard {
+  typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
+
+  // Taken only for short duration, with no blocking wait, to find or insert the entry of a key.
+  // It is not a spinlock, because inserting an entry allocates memory for the map node and,
+  // when there is no free entry to reuse, for the entry itself.
+  std::mutex mutex;
+
+  LockEntryMap locks GUARDED_BY(mutex);
+  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+  std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+
+  LockedBatchEntry* Acquire(const RefCntPrefix& key) REQUIRES(mutex);
+  void Release(const RefCntPrefix& key, LockedBatchEntry* entry) REQUIRES(mutex);
+};
+
 class SharedLockManager::Impl {
  public:
   MUST_USE_RESULT bool Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline);
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty()) << "Locks not empty in dtor: "
+                                           << yb::ToString(shard.locks);
+    }
   }
 
  private:
-  typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
+  LockShard& ShardForKey(const RefCntPrefix& key) {
+    return shards_[LockShardIndex(key)];
+  }
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Make sure the entries exist in the lock table and store pointers to them in the batch, so we
+  // can access them without holding the shard locks.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  std::array<LockShard, kNumLockShards> shards_;
 };
 
 std::string SharedLockManager::ToString(const LockState& state) {
@@ -302,21 +346,34 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
   return true;
 }
 
+LockedBatchEntry* LockShard::Acquire(const RefCntPrefix& key) {
+  auto& value = locks[key];
+  if (!value) {
+    if (!free_lock_entries.empty()) {
+      value = free_lock_entries.back();
+      free_lock_entries.pop_back();
+    } else {
+      lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+      value = lock_entries.back().get();
+      value->shard = this;
+    }
+  }
+  value->ref_count++;
+  return value;
+}
+
+void LockShard::Release(const RefCntPrefix& key, LockedBatchEntry* entry) {
+  if (--(entry->ref_count) == 0) {
+    locks.erase(key);
+    free_lock_entries.push_back(entry);
+  }
+}
+
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
-    if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
-      } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
-      }
-    }
-    value->ref_count++;
-    key_and_intent_type.locked = value;
+    auto& shard = ShardForKey(key_and_intent_type.key);
+    std::lock_guard lock(shard.mutex);
+    key_and_intent_type.locked = shard.Acquire(key_and_intent_type.key);
   }
 }
 
@@ -331,15 +388,21 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& item : key_to_intent_type) {
-    if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
-    }
+    auto& shard = *item.locked->shard;
+    std::lock_guard lock(shard.mutex);
+    shard.Release(item.key, item.locked);
   }
 }
 
+size_t SharedLockManager::TEST_NumShards() {
+  return kNumLockShards;
+}
+
+size_t SharedLockManager::TEST_ShardIndex(const RefCntPrefix& key) {
+  return LockShardIndex(key);
+}
+
 SharedLockManager::SharedLockManager() : impl_(new Impl) {
 }
 
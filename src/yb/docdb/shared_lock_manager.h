@@ -23,6 +23,9 @@
 #include "yb/util/monotime.h"
 
 namespace yb {
+
+class RefCntPrefix;
+
 namespace docdb {
 
 typedef uint64_t LockState;
@@ -51,6 +54,9 @@ class SharedLockManager {
   // Whether or not the state is possible
   static std::string ToString(const LockState& state);
 
+  static size_t TEST_NumShards();
+  static size_t TEST_ShardIndex(const RefCntPrefix& key);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -66,6 +66,18 @@ extern std::shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern std::shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with the same sharding and capacity semantics as NewLRUCache, that uses
+// CLOCK eviction over a fixed size open addressing table. Lookups and releases do not take any
+// locks, so this cache scales better with the number of concurrent readers.
+//
+// The table of each shard is sized for capacity / estimated_entry_charge entries. When actual
+// entries are much smaller than estimated_entry_charge, the cache would hold fewer bytes than its
+// capacity.
+extern std::shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits);
+extern std::shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                            bool strict_capacity_limit,
+                                            size_t estimated_entry_charge);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -46,6 +46,7 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/util/compression_dict.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/stop_watch.h"
 
@@ -83,11 +84,12 @@ std::unique_ptr<TableBuilder> NewTableBuilder(
     WritableFileWriter* data_file,
     const CompressionType compression_type,
     const CompressionOptions& compression_opts,
-    const bool skip_filters) {
+    const bool skip_filters,
+    std::shared_ptr<const std::string> compression_dict) {
   return ioptions.table_factory->NewTableBuilder(
       TableBuilderOptions(ioptions, internal_comparator,
           int_tbl_prop_collector_factories, compression_type,
-          compression_opts, skip_filters),
+          compression_opts, skip_filters, std::move(compression_dict)),
       column_family_id, metadata_file, data_file);
 }
 
@@ -124,7 +126,8 @@ Status BuildTable(const std::string& dbname,
                   InternalStats* internal_stats,
                   BoundaryValuesExtractor* boundary_values_extractor,
                   const yb::IOPriority io_priority,
-                  TableProperties* table_properties) {
+                  TableProperties* table_properties,
+                  SampledCompressionDict* sampled_compression_dict) {
   // Reports the IOStats for flush for every following bytes.
   const size_t kReportFlushIOStatsEvery = 1048576;
   Status s;
@@ -150,7 +153,8 @@ Status BuildTable(const std::string& dbname,
     std::unique_ptr<TableBuilder> builder(NewTableBuilder(
         ioptions, internal_comparator, int_tbl_prop_collector_factories,
         column_family_id, base_file_writer.get(), data_file_writer.get(), compression,
-        compression_opts));
+        compression_opts, /* skip_filters= */ false,
+        sampled_compression_dict ? sampled_compression_dict->Get() : nullptr));
 
     MergeHelper merge(env, internal_comparator->user_comparator(),
                       ioptions.merge_operator, nullptr, ioptions.info_log,
@@ -206,6 +210,9 @@ Status BuildTable(const std::string& dbname,
       if (table_properties) {
         *table_properties = builder->GetTableProperties();
       }
+      if (sampled_compression_dict) {
+        sampled_compression_dict->Update(builder->CompressionDictSamples());
+      }
     }
 
     // Finish and check for file errors
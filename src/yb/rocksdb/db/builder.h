@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,6 +50,7 @@ class TableBuilder;
 class WritableFileWriter;
 class InternalStats;
 class InternalIterator;
+class SampledCompressionDict;
 
 std::unique_ptr<TableBuilder> NewTableBuilder(
     const ImmutableCFOptions& options,
@@ -69,13 +71,16 @@ std::unique_ptr<TableBuilder> NewTableBuilder(
     WritableFileWriter* data_file,
     const CompressionType compression_type,
     const CompressionOptions& compression_opts,
-    const bool skip_filters = false);
+    const bool skip_filters = false,
+    std::shared_ptr<const std::string> compression_dict = nullptr);
 
 // Build a Table file from the contents of *iter.  The generated file
 // will be named according to number specified in meta. On success, the rest of
 // *meta will be filled with metadata about the generated table.
 // If no data is present in *iter, meta->total_file_size will be set to
 // zero, and no Table file will be produced.
+// If sampled_compression_dict is specified, its dictionary is used to compress data blocks and it
+// is updated with samples of the produced file afterwards.
 extern Status BuildTable(
     const std::string& dbname,
     Env* env,
@@ -95,6 +100,7 @@ extern Status BuildTable(
     InternalStats* internal_stats,
     BoundaryValuesExtractor* boundary_values_extractor,
     const yb::IOPriority io_priority = yb::IOPriority::kHigh,
-    TableProperties* table_properties = nullptr);
+    TableProperties* table_properties = nullptr,
+    SampledCompressionDict* sampled_compression_dict = nullptr);
 
 }  // namespace rocksdb
@@ -37,6 +37,7 @@
 #include "yb/rocksdb/db/write_controller.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/util/compression_dict.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
 #include "yb/rocksdb/util/thread_local.h"
 
@@ -254,6 +255,9 @@ class ColumnFamilyData {
 
   TableCache* table_cache() const { return table_cache_.get(); }
 
+  // Dictionary used to compress data blocks of new SST files, see CompressionOptions.
+  SampledCompressionDict* sampled_compression_dict() { return &sampled_compression_dict_; }
+
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
   bool NeedsCompaction() const;
@@ -364,6 +368,8 @@ class ColumnFamilyData {
 
   std::unique_ptr<InternalStats> internal_stats_;
 
+  SampledCompressionDict sampled_compression_dict_;
+
   WriteBuffer* write_buffer_;
 
   MemTable* mem_;
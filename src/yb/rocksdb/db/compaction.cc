@@ -588,7 +588,10 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // Single-level universal compaction writes its output to level 0, as separate files that do not
+    // overlap by keys. Sequence numbers of these files are squashed to distinct values, so they
+    // are ordered as regular level 0 files, that is possible only for the bottommost compaction.
+    return number_levels_ == 1 ? bottommost_level_ : output_level_ > 0;
   } else {
     return false;
   }
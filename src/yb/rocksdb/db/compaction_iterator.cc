@@ -70,6 +70,12 @@ CompactionIterator::CompactionIterator(
   }
 }
 
+void CompactionIterator::SquashSequenceNumbers(SequenceNumber seqno) {
+  DCHECK(bottommost_level_);
+  DCHECK(snapshots_->empty());
+  squashed_seqno_ = seqno;
+}
+
 void CompactionIterator::AddLiveRanges(const std::vector<std::pair<Slice, Slice>>& ranges) {
   for (auto it = ranges.rbegin(); it != ranges.rend(); ++it) {
     const auto& range = *it;
@@ -469,6 +475,15 @@ void CompactionIterator::PrepareOutput() {
 
   // This is safe for TransactionDB write-conflict checking since transactions
   // only care about sequence number larger than any active snapshots.
+  if (squashed_seqno_) {
+    // There are no snapshots and no other files with the same user keys at the level, so all
+    // records could be squashed, including the ones with the largest user key.
+    if (valid_ && ikey_.type != kTypeMerge) {
+      ikey_.sequence = *squashed_seqno_;
+      current_key_.UpdateInternalKey(ikey_.sequence, ikey_.type);
+    }
+    return;
+  }
   if (bottommost_level_ && valid_ && ikey_.sequence < earliest_snapshot_ &&
       ikey_.type != kTypeMerge &&
       !cmp_->Equal(compaction_->GetLargestUserKey(), ikey_.user_key)) {
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,13 @@ class CompactionIterator {
   // See live_key_ranges_stack_ comment for details.
   void AddLiveRanges(const std::vector<std::pair<Slice, Slice>>& ranges);
 
+  // Sets sequence number of all output records to seqno, instead of zeroing it out when possible.
+  // Used by subcompactions of the single-level universal compaction, so their output files have
+  // distinct sequence numbers.
+  //
+  // REQUIRED: Compaction is bottommost, there are no snapshots and no merge operator.
+  void SquashSequenceNumbers(SequenceNumber seqno);
+
   // Seek to the beginning of the compaction iterator output.
   //
   // REQUIRED: Call only once.
@@ -119,6 +127,8 @@ class CompactionIterator {
   SequenceNumber earliest_snapshot_;
   SequenceNumber latest_snapshot_;
   bool ignore_snapshots_;
+  // Sequence number of all output records, see SquashSequenceNumbers.
+  std::optional<SequenceNumber> squashed_seqno_;
 
   // State
   //
@@ -35,6 +35,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <thread>
@@ -83,6 +84,14 @@ using std::unique_ptr;
 
 namespace rocksdb {
 
+namespace {
+
+// Number of keys sampled from each input file per subcompaction, when subcompaction boundaries
+// are chosen for single-level universal compaction.
+constexpr size_t kSubcompactionSampleKeysPerSubcompaction = 8;
+
+} // namespace
+
 // Maintains state for each sub-compaction
 struct CompactionJob::SubcompactionState : public CompactionFeed {
   Compaction* compaction;
@@ -94,6 +103,13 @@ struct CompactionJob::SubcompactionState : public CompactionFeed {
   // 'start' is inclusive, 'end' is exclusive, and nullptr means unbounded
   Slice *start, *end;
 
+  // If set, sequence numbers of all output records are replaced with this value, see
+  // CompactionIterator::SquashSequenceNumbers.
+  std::optional<SequenceNumber> squashed_seqno;
+
+  // Sorted run id assigned to output files, see FileMetaData::sorted_run_id.
+  uint64_t sorted_run_id = 0;
+
   // The return status of this subcompaction
   Status status;
 
@@ -300,16 +316,37 @@ void CompactionJob::Prepare() {
   // Is this compaction producing files at the bottommost level?
   bottommost_level_ = c->bottommost_level();
 
-  if (c->ShouldFormSubcompactions()) {
+  // Output files of single-level universal subcompactions get squashed sequence numbers, that is
+  // not possible while there are snapshots or merge operands.
+  if (c->ShouldFormSubcompactions() &&
+      (c->output_level() > 0 ||
+       (existing_snapshots_.empty() &&
+        c->column_family_data()->ioptions()->merge_operator == nullptr))) {
     const uint64_t start_micros = env_->NowMicros();
     GenSubcompactionBoundaries();
     assert(sizes_.size() == boundaries_.size() + 1);
 
+    // Input files are deleted after compaction and file numbers are never reused, so the smallest
+    // input file number identifies output files of this compaction.
+    uint64_t sorted_run_id = std::numeric_limits<uint64_t>::max();
+    for (size_t level_idx = 0; level_idx < c->num_input_levels(); level_idx++) {
+      for (const auto* file : *c->inputs(level_idx)) {
+        sorted_run_id = std::min(sorted_run_id, file->fd.GetNumber());
+      }
+    }
+
     for (size_t i = 0; i <= boundaries_.size(); i++) {
       Slice* start = i == 0 ? nullptr : &boundaries_[i - 1];
       Slice* end = i == boundaries_.size() ? nullptr : &boundaries_[i];
       compact_->sub_compact_states.emplace_back(
           c, db_options_.boundary_extractor.get(), start, end, sizes_[i]);
+      if (c->output_level() == 0 && !boundaries_.empty()) {
+        // Level 0 files are ordered by sequence numbers and must not overlap by them. Output files
+        // of subcompactions do not overlap by keys, so each of them gets its own sequence number.
+        // Together they form a single sorted run of universal compaction.
+        compact_->sub_compact_states.back().squashed_seqno = i;
+        compact_->sub_compact_states.back().sorted_run_id = sorted_run_id;
+      }
     }
   } else {
     compact_->sub_compact_states.emplace_back(
@@ -357,6 +394,11 @@ void CompactionJob::GenSubcompactionBoundaries() {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
         }
+        if (out_lvl == 0) {
+          // Files of single-level universal compaction usually cover the same key range, so their
+          // starting and ending keys do not split it. Add keys sampled from their indexes.
+          SampleInputKeys(*flevel, &boundary_keys_);
+        }
       } else {
         // For all other levels add the smallest/largest key in the level to
         // encompass the range covered by that level
@@ -375,6 +417,27 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  bounds.insert(bounds.end(), boundary_keys_.begin(), boundary_keys_.end());
+
+  if (const auto* transformer = db_options_.subcompaction_key_transformer) {
+    // Replace each bound with the beginning of its key prefix, so keys with the same prefix are
+    // never split between subcompactions.
+    std::vector<std::string> prefix_keys;
+    prefix_keys.reserve(bounds.size());
+    for (const auto& bound : bounds) {
+      const auto prefix = transformer->Transform(ExtractUserKey(bound));
+      if (!prefix.empty()) {
+        prefix_keys.push_back(InternalKey::MaxPossibleForUserKey(prefix).Encode().ToBuffer());
+      }
+    }
+    boundary_keys_ = std::move(prefix_keys);
+    bounds.assign(boundary_keys_.begin(), boundary_keys_.end());
+  }
+  if (bounds.empty()) {
+    sizes_.emplace_back(0);
+    return;
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -409,6 +472,19 @@ void CompactionJob::GenSubcompactionBoundaries() {
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
       sum / min_file_fill_percent /
       cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  if (out_lvl == 0) {
+    // Output file size of single-level universal compaction is not limited, so the number of
+    // subcompactions is limited by their minimal input size instead.
+    max_output_files = std::max<uint64_t>(
+        sum / std::max<uint64_t>(db_options_.min_subcompaction_input_size, 1), 1);
+    // Output files get sequence numbers starting from 0, they should stay below the sequence
+    // numbers of newer files.
+    SequenceNumber largest_seqno = 0;
+    for (const auto* file : *c->inputs(0)) {
+      largest_seqno = std::max(largest_seqno, file->largest.seqno);
+    }
+    max_output_files = std::min<uint64_t>(max_output_files, largest_seqno + 1);
+  }
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -442,6 +518,31 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::SampleInputKeys(
+    const LevelFilesBrief& files, std::vector<std::string>* keys) {
+  auto* cfd = compact_->compaction->column_family_data();
+  const size_t max_keys_per_file =
+      kSubcompactionSampleKeysPerSubcompaction * db_options_.max_subcompactions;
+  for (size_t i = 0; i != files.num_files; ++i) {
+    const auto& fd = files.files[i].fd;
+    auto trwh = cfd->table_cache()->GetTableReader(
+        env_options_, cfd->internal_comparator(), fd, kDefaultQueryId, /* no_io = */ false,
+        /* file_read_hist = */ nullptr, /* skip_filters = */ true);
+    auto file_keys = trwh.ok() ? trwh->table_reader->GetSampleKeys(max_keys_per_file)
+                               : yb::Result<std::vector<std::string>>(trwh.status());
+    if (!file_keys.ok()) {
+      // Sampling only improves balance of subcompactions, so just go without samples.
+      RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+          "[%s] [JOB %d] Failed to sample keys from file %" PRIu64 ": %s",
+          cfd->GetName().c_str(), job_id_, fd.GetNumber(),
+          file_keys.status().ToString().c_str());
+      continue;
+    }
+    keys->insert(keys->end(), std::make_move_iterator(file_keys->begin()),
+                 std::make_move_iterator(file_keys->end()));
+  }
+}
+
 Result<FileNumbersHolder> CompactionJob::Run() {
   TEST_SYNC_POINT("CompactionJob::Run():Start");
   log_buffer_->FlushBufferToLog();
@@ -473,6 +574,16 @@ Result<FileNumbersHolder> CompactionJob::Run() {
     RETURN_NOT_OK(yb::ThreadJoiner(thread.get()).Join());
   }
 
+  // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
+  // filter. Each subcompaction has its own context, so take the largest frontier.
+  for (const auto& state : compact_->sub_compact_states) {
+    if (state.context) {
+      UserFrontier::Update(
+          state.context->GetLargestUserFrontier().get(), UpdateUserValueType::kLargest,
+          &largest_user_frontier_);
+    }
+  }
+
   if (output_directory_ && !db_options_.disableDataSync) {
     RETURN_NOT_OK(output_directory_->Fsync());
   }
@@ -653,6 +764,9 @@ void CompactionJob::ProcessKeyValueCompaction(
   if (sub_compact->context) {
     sub_compact->c_iter->AddLiveRanges(sub_compact->context->GetLiveRanges());
   }
+  if (sub_compact->squashed_seqno) {
+    sub_compact->c_iter->SquashSequenceNumbers(*sub_compact->squashed_seqno);
+  }
 
   sub_compact->open_compaction_output_file = [this, holder, sub_compact]() {
     return OpenCompactionOutputFile(holder, sub_compact);
@@ -712,12 +826,6 @@ void CompactionJob::ProcessKeyValueCompaction(
     status = sub_compact->feed->Flush();
   }
 
-  // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
-  // filter.
-  if (sub_compact->context) {
-    largest_user_frontier_ = sub_compact->context->GetLargestUserFrontier();
-  }
-
   sub_compact->num_input_records = c_iter_stats.num_input_records;
   sub_compact->compaction_job_stats.num_input_deletion_records =
       c_iter_stats.num_input_deletion_records;
@@ -831,6 +939,10 @@ Status CompactionJob::FinishCompactionOutputFile(
   }
   if (s.ok()) {
     s = sub_compact->builder->Finish();
+    if (s.ok()) {
+      sub_compact->compaction->column_family_data()->sampled_compression_dict()->Update(
+          sub_compact->builder->CompressionDictSamples());
+    }
   } else {
     sub_compact->builder->Abandon();
   }
@@ -997,6 +1109,7 @@ Status CompactionJob::OpenCompactionOutputFile(
   SubcompactionState::Output out;
   out.meta.fd =
       FileDescriptor(file_number, sub_compact->compaction->output_path_id(), 0, 0);
+  out.meta.sorted_run_id = sub_compact->sorted_run_id;
   // Update sequence number boundaries for out.
   for (size_t level_idx = 0; level_idx < compact_->compaction->num_input_levels(); level_idx++) {
     for (FileMetaData *fmd : *compact_->compaction->inputs(level_idx) ) {
@@ -1044,7 +1157,7 @@ Status CompactionJob::OpenCompactionOutputFile(
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
       sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
-      skip_filters);
+      skip_filters, cfd->sampled_compression_dict()->Get());
   LogFlush(db_options_.info_log);
   return Status::OK();
 }
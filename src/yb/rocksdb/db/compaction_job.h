@@ -103,6 +103,8 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Appends keys sampled from the files to keys, to be used as potential subcompaction boundaries.
+  void SampleInputKeys(const LevelFilesBrief& files, std::vector<std::string>* keys);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -176,6 +178,8 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
+  // Stores the keys which are not owned by input files, and are referenced by boundaries_.
+  std::vector<std::string> boundary_keys_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
 
@@ -1198,6 +1198,9 @@ struct UniversalCompactionPicker::SortedRun {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
     assert((level != 0) != (file != nullptr));
+    if (file) {
+      files.push_back(file);
+    }
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1214,13 +1217,33 @@ struct UniversalCompactionPicker::SortedRun {
   }
 
   bool delete_after_compaction() const {
-    return file ? file->delete_after_compaction() : false;
+    if (!file) {
+      return false;
+    }
+    for (const auto* f : files) {
+      if (!f->delete_after_compaction()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Adds level 0 file with the same sorted run id to this sorted run.
+  void AddFile(FileMetaData* f) {
+    assert(level == 0 && f->sorted_run_id != 0 && f->sorted_run_id == file->sorted_run_id);
+    files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
   }
 
   int level;
   // `file` Will be null for level > 0. For level = 0, the sorted run is
   // for this file.
   FileMetaData* file;
+  // For level = 0, all files of the sorted run, starting with `file`. More than one file is
+  // possible only for files with the same FileMetaData::sorted_run_id.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1255,8 +1278,7 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             file->fd.GetNumber(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1277,7 +1299,14 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
     // Any files that can be directly removed during compaction can be included, even if they
     // exceed the "max file size for compaction."
     if (f->fd.GetTotalFileSize() <= max_file_size || f->delete_after_compaction()) {
-      ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
+      auto& sequence = ret.back();
+      if (f->sorted_run_id != 0 && !sequence.empty() && sequence.back().file &&
+          sequence.back().file->sorted_run_id == f->sorted_run_id) {
+        // Output files of the same subcompacted compaction do not overlap by keys.
+        sequence.back().AddFile(f);
+        continue;
+      }
+      sequence.emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
@@ -1761,8 +1790,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalRe
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1814,8 +1843,7 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalDe
     const auto sr = &sorted_runs[loop];
 
     if (!sr->being_compacted && sr->delete_after_compaction()) {
-      FileMetaData* f = sr->file;
-      input_files.files.push_back(f);
+      input_files.files.insert(input_files.files.end(), sr->files.begin(), sr->files.end());
 
       char file_num_buf[kFormatFileSizeInfoBufSize];
       sr->DumpSizeInfo(file_num_buf, sizeof(file_num_buf), loop);
@@ -1952,8 +1980,8 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompactionUniversalSi
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
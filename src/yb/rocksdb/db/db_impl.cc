@@ -1903,7 +1903,8 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                        cfd->internal_stats(),
                        db_options_.boundary_extractor.get(),
                        yb::IOPriority::kHigh,
-                       &info.table_properties);
+                       &info.table_properties,
+                       cfd->sampled_compression_dict());
         LogFlush(db_options_.info_log);
         RLOG(InfoLogLevel::DEBUG_LEVEL, db_options_.info_log,
             "[%s] [WriteLevel0TableForRecovery]"
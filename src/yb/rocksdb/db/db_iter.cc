@@ -182,6 +182,7 @@ class DBIter: public Iterator {
   void Seek(const Slice& target) override;
   void SeekToFirst() override;
   void SeekToLast() override;
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override;
   bool ScanForward(
       Slice upperbound, KeyFilterCallback* key_filter_callback,
       ScanCallback* scan_callback) override;
@@ -782,6 +783,19 @@ void DBIter::Seek(const Slice& target) {
   }
 }
 
+void DBIter::PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {
+  // Use the same internal keys as Seek() does.
+  std::vector<InternalKey> keys;
+  keys.reserve(sorted_targets.size());
+  std::vector<Slice> internal_targets;
+  internal_targets.reserve(sorted_targets.size());
+  for (const auto& target : sorted_targets) {
+    keys.emplace_back(target, sequence_, kValueTypeForSeek);
+    internal_targets.push_back(keys.back().Encode());
+  }
+  iter_->PrefetchForSeeks(internal_targets);
+}
+
 void DBIter::SeekToFirst() {
   // Don't use iter_::Seek() if we set a prefix extractor
   // because prefix seek will be used.
@@ -944,6 +958,10 @@ void ArenaWrappedDBIter::RevalidateAfterUpperBoundChange() {
   db_iter_->RevalidateAfterUpperBoundChange();
 }
 
+void ArenaWrappedDBIter::PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {
+  db_iter_->PrefetchForSeeks(sorted_targets);
+}
+
 bool ArenaWrappedDBIter::ScanForward(
     Slice upperbound, KeyFilterCallback* key_filter_callback,
     ScanCallback* scan_callback) {
@@ -85,6 +85,8 @@ class ArenaWrappedDBIter : public Iterator {
 
   void RevalidateAfterUpperBoundChange() override;
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override;
+
   virtual bool ScanForward(
     Slice upperbound, KeyFilterCallback* key_filter_callback,
     ScanCallback* scan_callback) override;
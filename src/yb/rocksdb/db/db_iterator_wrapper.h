@@ -65,6 +65,10 @@ class DBIteratorWrapper : public Iterator {
     return wrapped_->GetProperty(prop_name, prop);
   }
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    wrapped_->PrefetchForSeeks(sorted_targets);
+  }
+
   bool ScanForward(
       Slice upperbound, KeyFilterCallback* key_filter_callback,
       ScanCallback* scan_callback) override {
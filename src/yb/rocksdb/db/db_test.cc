@@ -2296,6 +2296,62 @@ TEST_F(DBTest, MinLevelToCompress2) {
   MinLevelHelper(this, options);
 }
 
+TEST_F(DBTest, CompressionDictionary) {
+  constexpr int kNumFiles = 3;
+  constexpr int kNumKeysPerFile = 500;
+
+  std::vector<CompressionType> compression_types;
+  if (LZ4_Supported()) {
+    compression_types.push_back(kLZ4Compression);
+    compression_types.push_back(kLZ4HCCompression);
+  }
+
+  // Even iterations: only uncompressed block cache.
+  // Odd iterations: both block cache and compressed block cache.
+  // Files are compressed with different dictionaries, so reads that go through all of them check
+  // that compression streams reused by a thread are not mixed up.
+  for (int iter = 0; iter < 2 * static_cast<int>(compression_types.size()); ++iter) {
+    SCOPED_TRACE(yb::Format("Iteration: $0", iter));
+    Options options = CurrentOptions();
+    options.compression = compression_types[iter / 2];
+    options.compression_opts.max_dict_bytes = 4096;
+    options.disable_auto_compactions = true;
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 1024;
+    table_options.block_cache = NewLRUCache(64 * 1024);
+    if (iter % 2 == 1) {
+      table_options.block_cache_compressed = NewLRUCache(64 * 1024);
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    std::vector<std::string> values;
+    for (int file = 0; file < kNumFiles; ++file) {
+      for (int i = 0; i < kNumKeysPerFile; ++i) {
+        values.push_back(CompressibleString(&rnd, 200));
+        ASSERT_OK(Put(Key(file * kNumKeysPerFile + i), values.back()));
+      }
+      // Files after the first one are compressed with dictionary sampled from the previous one.
+      ASSERT_OK(Flush());
+    }
+    ASSERT_EQ(NumTableFilesAtLevel(0), kNumFiles);
+
+    auto verify = [this, &values] {
+      for (size_t i = 0; i != values.size(); ++i) {
+        ASSERT_EQ(values[i], Get(Key(static_cast<int>(i))));
+      }
+    };
+    ASSERT_NO_FATAL_FAILURE(verify());
+
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    ASSERT_NO_FATAL_FAILURE(verify());
+
+    Reopen(options);
+    ASSERT_NO_FATAL_FAILURE(verify());
+  }
+}
+
 TEST_F(DBTest, RepeatedWritesToSameKey) {
   do {
     Options options;
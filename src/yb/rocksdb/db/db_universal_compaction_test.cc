@@ -1465,6 +1465,124 @@ TEST_F(DBTestUniversalCompaction, IncludeFilesSmallerThanThreshold) {
   GenerateFilesAndCheckCompactionResult(options, file_sizes, value_size, 1);
 }
 
+namespace {
+
+// Extracts key without its last character, so groups of 10 consecutive keys generated by Key()
+// share the prefix.
+class DropLastCharKeyTransformer : public FilterPolicy::KeyTransformer {
+ public:
+  Slice Transform(Slice key) const override {
+    return key.size() > 1 ? key.Prefix(key.size() - 1) : Slice();
+  }
+};
+
+// Checks that output files of single-level subcompactions do not overlap by keys, keys with the
+// same prefix are in the same file, and the files are ordered by sequence numbers as regular
+// level 0 files.
+void CheckSingleLevelSubcompactionOutputs(
+    DB* db, const FilterPolicy::KeyTransformer& transformer) {
+  std::vector<LiveFileMetaData> files;
+  db->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1);
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.smallest.key < rhs.smallest.key;
+  });
+  for (size_t i = 1; i < files.size(); ++i) {
+    const auto& prev_largest = files[i - 1].largest.key;
+    const auto& smallest = files[i].smallest.key;
+    ASSERT_LT(prev_largest, smallest);
+    ASSERT_NE(transformer.Transform(prev_largest), transformer.Transform(smallest));
+  }
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.largest.seqno < rhs.largest.seqno;
+  });
+  for (size_t i = 1; i < files.size(); ++i) {
+    ASSERT_LE(files[i].smallest.seqno, files[i].largest.seqno);
+    ASSERT_LT(files[i - 1].largest.seqno, files[i].smallest.seqno);
+  }
+}
+
+} // namespace
+
+TEST_F(DBTestUniversalCompaction, SingleLevelSubcompactions) {
+  constexpr int kNumFiles = 4;
+  constexpr int kNumKeys = 2000;
+  constexpr int kValueSize = 100;
+
+  std::atomic<int> num_subcompactions{0};
+  yb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Inprogress", [&num_subcompactions](void* arg) {
+    ++num_subcompactions;
+  });
+  yb::SyncPoint::GetInstance()->EnableProcessing();
+
+  DropLastCharKeyTransformer transformer;
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  // Make write_buffer_size high to avoid auto flush.
+  options.write_buffer_size = 10000 * kValueSize;
+  options.max_subcompactions = 8;
+  options.min_subcompaction_input_size = 1;
+  options.subcompaction_key_transformer = &transformer;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "true"}}));
+
+  // Every file covers the whole key range.
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  auto write_file = [this, &rnd, &values](int step, int shift) {
+    for (int i = 0; i != kNumKeys; ++i) {
+      if ((i + shift) % step != 0) {
+        values[i] = RandomString(&rnd, kValueSize);
+        ASSERT_OK(Put(Key(i), values[i]));
+      }
+    }
+    ASSERT_OK(Flush());
+  };
+  auto check_values = [this, &values] {
+    for (int i = 0; i != kNumKeys; ++i) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  };
+  for (int file = 0; file != kNumFiles; ++file) {
+    ASSERT_NO_FATAL_FAILURE(write_file(3, file));
+  }
+  ASSERT_EQ(NumTableFilesAtLevel(0), kNumFiles);
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(num_subcompactions.load(), 1);
+  ASSERT_NO_FATAL_FAILURE(check_values());
+  ASSERT_NO_FATAL_FAILURE(CheckSingleLevelSubcompactionOutputs(db_, transformer));
+  const auto num_outputs = NumTableFilesAtLevel(0);
+  // Output files of subcompactions alone would be enough to trigger compaction if each of them was
+  // counted as a separate sorted run.
+  ASSERT_GE(num_outputs, options.level0_file_num_compaction_trigger);
+
+  // Output files of subcompactions form a single sorted run, so the regular universal compaction
+  // with default triggers does not compact them again, even together with a newer file.
+  num_subcompactions = 0;
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_NO_FATAL_FAILURE(write_file(5, 0));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(num_subcompactions.load(), 0);
+  ASSERT_EQ(NumTableFilesAtLevel(0), num_outputs + 1);
+  ASSERT_NO_FATAL_FAILURE(check_values());
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "true"}}));
+
+  // Output files of the previous compactions are split again.
+  ASSERT_NO_FATAL_FAILURE(write_file(7, 0));
+  num_subcompactions = 0;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  yb::SyncPoint::GetInstance()->DisableProcessing();
+  yb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(num_subcompactions.load(), 1);
+  ASSERT_NO_FATAL_FAILURE(check_values());
+  ASSERT_NO_FATAL_FAILURE(CheckSingleLevelSubcompactionOutputs(db_, transformer));
+}
+
 }  // namespace rocksdb
 
 
@@ -298,7 +298,8 @@ Result<FileNumbersHolder> FlushJob::WriteLevel0Table(
                      cfd_->internal_stats(),
                      db_options_.boundary_extractor.get(),
                      yb::IOPriority::kHigh,
-                     &table_properties_);
+                     &table_properties_,
+                     cfd_->sampled_compression_dict());
       info.table_properties = table_properties_;
       LogFlush(db_options_.info_log);
     }
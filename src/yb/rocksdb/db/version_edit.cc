@@ -252,6 +252,9 @@ bool VersionEdit::EncodeTo(VersionEditPB* dst) const {
     if (f.imported) {
       new_file.set_imported(true);
     }
+    if (f.sorted_run_id != 0) {
+      new_file.set_sorted_run_id(f.sorted_run_id);
+    }
   }
 
   // 0 is default and does not need to be explicitly written
@@ -340,6 +343,7 @@ Status VersionEdit::DecodeFrom(BoundaryValuesExtractor* extractor, const Slice&
     meta.marked_for_compaction = source.marked_for_compaction();
     max_level_ = std::max(max_level_, level);
     meta.imported = source.imported();
+    meta.sorted_run_id = source.sorted_run_id();
 
     // Use the relevant fields in the "largest" frontier to update the "flushed" frontier for this
     // version edit. In practice this will only look at OpId and will discard hybrid time and
@@ -421,6 +425,7 @@ void VersionEdit::AddCleanedFile(int level, const FileMetaData& f) {
   nf.largest = f.largest;
   nf.marked_for_compaction = f.marked_for_compaction;
   nf.imported = f.imported;
+  nf.sorted_run_id = f.sorted_run_id;
   new_files_.emplace_back(level, std::move(nf));
 }
 
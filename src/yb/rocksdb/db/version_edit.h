@@ -110,6 +110,9 @@ struct FileMetaData {
   BoundaryValues smallest;     // The smallest values in this file
   BoundaryValues largest;      // The largest values in this file
   bool imported = false;       // Was this file imported from another DB.
+  // Non zero for level 0 files written by subcompactions of the same universal compaction. Such
+  // files do not overlap by keys and are counted as a single sorted run.
+  uint64_t sorted_run_id = 0;
 
   // Needs to be disposed when refs becomes 0.
   Cache::Handle* table_reader_handle;
@@ -33,6 +33,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
 #include <boost/function.hpp>
 
 #include "yb/util/slice.h"
@@ -155,6 +157,12 @@ class Iterator : public Cleanable {
   // if the upper bound has increased.
   virtual void RevalidateAfterUpperBoundChange() {}
 
+  // Hints that the iterator is about to be positioned with Seek() to each of the provided
+  // targets, sorted in ascending order. Implementation could load the blocks required by those
+  // seeks in parallel, so subsequent seeks do not wait for IO one by one. Errors are not reported,
+  // they will be reported by the corresponding Seek().
+  virtual void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {}
+
   // Iterate over the key-values and call the callback functions, until:
   // 1. Provided upper bound is reached (optional)
   // 2. Iterator upper bound is reached (if present)
@@ -33,6 +33,7 @@
 
 #include "yb/rocksdb/rocksdb_fwd.h"
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/listener.h"
 #include "yb/rocksdb/universal_compaction.h"
 
@@ -167,9 +168,17 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of dictionary used to prime the compression library. Enabling dictionary can
+  // improve compression ratios when there are repetitions across data blocks.
+  // The dictionary is not trained: it is a concatenation of prefixes of data blocks sampled from
+  // the most recently built SST file of the column family, and is stored in a meta block of each
+  // SST file compressed with it.
+  // Only supported for LZ4 and LZ4HC compression types.
+  // Default: 0 (dictionary compression is disabled).
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -1015,6 +1024,13 @@ struct DBOptions {
   // Default: 1 (i.e. no subcompactions)
   uint32_t max_subcompactions;
 
+  // Minimal approximate input size of a subcompaction. Limits the number of subcompactions of
+  // the single-level universal compaction, since its output file size is not limited.
+  // Single-level universal compaction is split only when it is bottommost and there are no
+  // snapshots, because sequence numbers of its output files are squashed.
+  // Default: 1GB
+  uint64_t min_subcompaction_input_size;
+
   // Maximum number of concurrent background memtable flush jobs, submitted to
   // the HIGH priority thread pool.
   //
@@ -1328,6 +1344,13 @@ struct DBOptions {
 
   std::shared_ptr<CompactionContextFactory> compaction_context_factory;
 
+  // If set, subcompaction boundaries are placed only at the beginning of the key prefixes
+  // extracted by this transformer from the user keys, so all keys with the same prefix are
+  // processed by the same subcompaction. Keys with empty prefix are not used as boundaries.
+  // Extracted prefixes must satisfy the same requirements as
+  // BlockBasedTableOptions::data_block_hash_index_key_transformer.
+  const FilterPolicy::KeyTransformer* subcompaction_key_transformer = nullptr;
+
   // Function that returns max file size for compaction.
   // Supported only for level0 of universal style compactions.
   std::shared_ptr<std::function<uint64_t()>> max_file_size_for_compaction;
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// A SecondaryCache is a second tier of the block cache that keeps raw blocks on a fast local
+// device. Blocks that are read from the SST files are stored into it, and block based table
+// checks it on a miss in the in-memory block cache before reading the SST file.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/rocksdb/status.h"
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class MemTracker;
+class MetricEntity;
+
+}
+
+namespace rocksdb {
+
+class Env;
+
+class SecondaryCache {
+ public:
+  SecondaryCache() = default;
+  virtual ~SecondaryCache() = default;
+
+  SecondaryCache(const SecondaryCache&) = delete;
+  void operator=(const SecondaryCache&) = delete;
+
+  // Stores a copy of value under key. Values stored under the same key are expected to be
+  // identical, so the second insert of the key could be ignored. Insertion is best effort: the
+  // value could be dropped at any time and errors are not reported to the caller. The value could
+  // be written to the device asynchronously, so it is not necessarily found right after insert.
+  virtual void Insert(const Slice& key, const Slice& value) = 0;
+
+  // Waits until values inserted before this call are written to the device or dropped.
+  virtual void Flush() = 0;
+
+  // Looks up key. On hit copies the value to scratch and returns true. A stored value that is not
+  // exactly expected_size bytes long, or that cannot be read back intact, is treated as a miss.
+  virtual bool Lookup(const Slice& key, size_t expected_size, char* scratch) = 0;
+
+  virtual void Erase(const Slice& key) = 0;
+
+  // Returns a new id to be used as a cache key prefix for files without unique id.
+  virtual uint64_t NewId() = 0;
+
+  virtual size_t GetCapacity() const = 0;
+
+  // Returns the number of bytes the cache occupies on its device.
+  virtual size_t GetUsage() const = 0;
+
+  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
+};
+
+struct FileSecondaryCacheOptions {
+  // Directory for the cache files. Files are not reused across restarts, the directory is cleaned
+  // up when the cache is created.
+  std::string path;
+
+  // Maximal number of bytes occupied by the cache files.
+  size_t capacity = 0;
+
+  // The cache is log-structured: values are appended to the segment files of this size, and the
+  // whole oldest segment is dropped when the cache runs out of capacity.
+  size_t segment_size = 64 * 1024 * 1024;
+
+  // The cache is sharded to 2^num_shard_bits shards by hash of the key. Each shard has its own
+  // segments.
+  int num_shard_bits = 4;
+
+  // Values are written to the device by a background thread. Inserts are dropped while this many
+  // bytes are waiting to be written.
+  size_t max_pending_write_bytes = 16 * 1024 * 1024;
+
+  // Memory used by the in-memory index and by values waiting to be written is charged to this
+  // tracker.
+  std::shared_ptr<yb::MemTracker> mem_tracker;
+
+  Env* env = nullptr;
+};
+
+// Creates secondary cache that keeps values in the files under options.path.
+extern Status NewFileSecondaryCache(
+    const FileSecondaryCacheOptions& options, std::shared_ptr<SecondaryCache>* result);
+
+}  // namespace rocksdb
@@ -35,16 +35,24 @@
 #include <string>
 #include <unordered_map>
 
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/status.h"
 #include "yb/rocksdb/types.h"
 
 #include "yb/util/size_literals.h"
 
+namespace yb {
+
+class ThreadPool;
+
+}
+
 namespace rocksdb {
 
 // -- Block-based Table
 class FlushBlockPolicyFactory;
+class SecondaryCache;
 struct TableReaderOptions;
 struct TableBuilderOptions;
 class TableBuilder;
@@ -75,6 +83,15 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+YB_DEFINE_ENUM(DataBlockIndexType,
+  // Binary search over restart points followed by linear scan within the restart interval.
+  (kBinarySearch)
+
+  // In addition to restart points, data block contains hash index mapping key prefixes to restart
+  // intervals, see data_block_hash_index.h.
+  (kBinarySearchAndHash)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -119,6 +136,14 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL, data, index and filter blocks read from the SST files are also stored in this
+  // cache, and it is checked on block cache miss before reading the SST file.
+  std::shared_ptr<SecondaryCache> secondary_block_cache = nullptr;
+
+  // If non-NULL, data blocks prefetched for a batch of seeks are read in parallel on this pool.
+  // If NULL, they are read by the calling thread. The pool should outlive table readers.
+  yb::ThreadPool* prefetch_thread_pool = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -163,6 +188,19 @@ struct BlockBasedTableOptions {
   KeyValueEncodingFormat data_block_key_value_encoding_format =
       KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
 
+  // Specifies index to be used for lookups inside data blocks. kBinarySearchAndHash requires
+  // data_block_hash_index_key_transformer to be set and is ignored otherwise.
+  DataBlockIndexType data_block_index_type = DataBlockIndexType::kBinarySearch;
+
+  // Ratio of the number of indexed key prefixes to the number of hash index buckets.
+  double data_block_hash_table_util_ratio = 0.75;
+
+  // Extracts key prefix to be indexed by the data block hash index from the user key. Extracted
+  // prefix must be a prefix of the user key and no extracted prefix could be a proper prefix of
+  // another one (for example, encoded DocKey), so keys with the same prefix are contiguous in key
+  // order. Empty prefix means that the key is not indexed.
+  const FilterPolicy::KeyTransformer* data_block_hash_index_key_transformer = nullptr;
+
   // If non-nullptr, use the specified filter policy for new SST files to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -36,6 +36,7 @@
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_internal.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
@@ -185,9 +186,12 @@ void BlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (hash_index_) {
+    ok = HashSeek(target, &index);
+  } else if (data_block_hash_index_) {
+    ok = DataBlockHashSeek(target, &index);
   } else {
-    ok = hash_index_ ? HashSeek(target, &index)
-      : BinarySeek(target, 0, num_restarts_ - 1, &index);
+    ok = BinarySeek(target, 0, num_restarts_ - 1, &index);
   }
 
   if (!ok) {
@@ -537,9 +541,61 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   }
 }
 
+bool BlockIter::DataBlockHashSeek(const Slice& target, uint32_t* index) {
+  DCHECK(data_block_hash_index_);
+  if (target.size() >= kLastInternalComponentSize) {
+    const auto key_prefix =
+        data_block_hash_index_key_transformer_->Transform(ExtractUserKey(target));
+    if (!key_prefix.empty()) {
+      const uint32_t restart_index = data_block_hash_index_->Lookup(
+          data_, data_block_hash_map_offset_, key_prefix);
+      // Special values kDataBlockHashIndexNoEntry and kDataBlockHashIndexCollision are always
+      // greater than number of restarts in the block with hash index.
+      if (restart_index < num_restarts_) {
+        uint32_t restart_key_size;
+        const char* restart_key_ptr = DecodeRestartEntry(
+            key_value_encoding_format_, data_ + GetRestartPoint(restart_index), data_ + restarts_,
+            data_, &restart_key_size);
+        if (restart_key_ptr == nullptr) {
+          CorruptionError("DecodeRestartEntry failed");
+          return false;
+        }
+        const Slice restart_key(restart_key_ptr, restart_key_size);
+        if (Compare(restart_key, target) <= 0) {
+          // All keys before restart_index are less than target, so we only need to check whether
+          // the next restart interval also starts before target.
+          if (restart_index + 1 == num_restarts_) {
+            *index = restart_index;
+            return true;
+          }
+          const auto cmp = CompareBlockKey(restart_index + 1, target);
+          if (!status_.ok()) {
+            return false;
+          }
+          if (cmp > 0) {
+            *index = restart_index;
+            return true;
+          }
+          return BinarySeek(target, restart_index + 1, num_restarts_ - 1, index);
+        }
+        if (data_block_hash_index_key_transformer_->Transform(ExtractUserKey(restart_key)) ==
+                key_prefix) {
+          // Restart interval starts with the first key having the same prefix as target, so all
+          // previous keys are less than target.
+          *index = restart_index;
+          return true;
+        }
+      }
+    }
+  }
+  // Key prefix is not indexed or the hash lookup result is not usable, fall back to the full
+  // binary search.
+  return BinarySeek(target, 0, num_restarts_ - 1, index);
+}
+
 uint32_t Block::NumRestarts() const {
   assert(size_ >= kMinBlockSize);
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return num_restarts_;
 }
 
 Block::Block(BlockContents&& contents)
@@ -548,20 +604,32 @@ Block::Block(BlockContents&& contents)
       size_(contents_.data.size()) {
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
-  } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
-      // The size is too small for NumRestarts() and therefore
-      // restart_offset_ wrapped around.
-      size_ = 0;
+    return;
+  }
+  UnpackIndexTypeAndNumRestarts(
+      DecodeFixed32(data_ + size_ - sizeof(uint32_t)), &index_type_, &num_restarts_);
+  // Offset of the restarts array end.
+  auto restarts_end = static_cast<uint32_t>(size_ - sizeof(uint32_t));
+  if (index_type_ == DataBlockIndexType::kBinarySearchAndHash) {
+    if (num_restarts_ == 0 || num_restarts_ - 1 > kMaxRestartSupportedByHashIndex ||
+        !data_block_hash_index_.Initialize(data_, restarts_end, &data_block_hash_map_offset_)) {
+      size_ = 0;  // Error marker
+      return;
     }
+    restarts_end = data_block_hash_map_offset_;
+  }
+  restart_offset_ = restarts_end - num_restarts_ * sizeof(uint32_t);
+  if (num_restarts_ > restarts_end / sizeof(uint32_t)) {
+    // The size is too small for NumRestarts() and therefore
+    // restart_offset_ wrapped around.
+    size_ = 0;
   }
 }
 
 InternalIterator* Block::NewIterator(
     const Comparator* cmp, const KeyValueEncodingFormat key_value_encoding_format, BlockIter* iter,
-    const bool total_order_seek) const {
+    const bool total_order_seek,
+    const FilterPolicy::KeyTransformer* data_block_hash_index_key_transformer) const {
   if (size_ < kMinBlockSize) {
     if (iter != nullptr) {
       iter->SetStatus(BadBlockContentsError());
@@ -591,6 +659,11 @@ InternalIterator* Block::NewIterator(
       iter = new BlockIter(cmp, data_, key_value_encoding_format, restart_offset_, num_restarts,
                            hash_index_ptr, prefix_index_ptr);
     }
+    if (data_block_hash_index_key_transformer && data_block_hash_index_.Valid()) {
+      iter->SetDataBlockHashIndex(
+          &data_block_hash_index_, data_block_hash_map_offset_,
+          data_block_hash_index_key_transformer);
+    }
   }
 
   return iter;
@@ -701,4 +774,22 @@ yb::Result<std::string> Block::GetMiddleKey(
       /* restart_idx = */ 0, cmp, key_value_encoding_format, middle_entry_policy));
 }
 
+yb::Result<std::vector<std::string>> Block::GetRestartKeys(
+    const KeyValueEncodingFormat key_value_encoding_format, const size_t max_keys) const {
+  if (size_ == kMinBlockSize) {
+    return std::vector<std::string>();
+  }
+  const size_t num_restarts = NumRestarts();
+  const size_t num_keys = std::min(num_restarts, max_keys);
+  std::vector<std::string> result;
+  result.reserve(num_keys);
+  for (size_t i = 0; i != num_keys; ++i) {
+    // Take restart point in the middle of i-th of num_keys equal parts.
+    const auto restart_idx = static_cast<uint32_t>((2 * i + 1) * num_restarts / (2 * num_keys));
+    const auto key = VERIFY_RESULT(GetRestartKey(restart_idx, key_value_encoding_format));
+    result.push_back(key.ToBuffer());
+  }
+  return result;
+}
+
 }  // namespace rocksdb
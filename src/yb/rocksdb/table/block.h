@@ -34,6 +34,7 @@
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 
@@ -71,6 +72,7 @@ class Block {
     return size_;
   }
   uint32_t NumRestarts() const;
+  DataBlockIndexType IndexType() const { return index_type_; }
   CompressionType compression_type() const {
     return contents_.compression_type;
   }
@@ -90,10 +92,15 @@ class Block {
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
   // key_value_encoding_format specifies what kind of algorithm to use for decoding entries.
-  InternalIterator* NewIterator(const Comparator* comparator,
-                                KeyValueEncodingFormat key_value_encoding_format,
-                                BlockIter* iter = nullptr,
-                                bool total_order_seek = true) const;
+  //
+  // If the block contains data block hash index and data_block_hash_index_key_transformer is
+  // specified, the iterator will use the hash index to find the restart interval on Seek before
+  // falling back to binary search. The transformer must be the same as the one used to build
+  // the block.
+  InternalIterator* NewIterator(
+      const Comparator* comparator, KeyValueEncodingFormat key_value_encoding_format,
+      BlockIter* iter = nullptr, bool total_order_seek = true,
+      const FilterPolicy::KeyTransformer* data_block_hash_index_key_transformer = nullptr) const;
 
   inline InternalIterator* NewIndexIterator(
       const Comparator* comparator, BlockIter* iter = nullptr, bool total_order_seek = true) const {
@@ -124,6 +131,10 @@ class Block {
       MiddlePointPolicy middle_entry_policy = MiddlePointPolicy::kMiddleLow
   ) const;
 
+  // Returns keys of up to max_keys restart points evenly spread over the block, in key order.
+  yb::Result<std::vector<std::string>> GetRestartKeys(
+      KeyValueEncodingFormat key_value_encoding_format, size_t max_keys) const;
+
  private:
   // Returns key for corresponding restart block.
   yb::Result<Slice> GetRestartKey(
@@ -139,6 +150,10 @@ class Block {
   const char* data_;            // contents_.data.data()
   size_t size_;                 // contents_.data.size()
   uint32_t restart_offset_;     // Offset in data_ of restart array
+  uint32_t num_restarts_ = 0;
+  DataBlockIndexType index_type_ = DataBlockIndexType::kBinarySearch;
+  DataBlockHashIndex data_block_hash_index_;
+  uint32_t data_block_hash_map_offset_ = 0; // Offset in data_ of data block hash index buckets
   std::unique_ptr<BlockHashIndex> hash_index_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
 
@@ -179,6 +194,15 @@ class BlockIter : public InternalIterator {
     status_ = s;
   }
 
+  // Enables usage of data block hash index for Seek, see Block::NewIterator.
+  void SetDataBlockHashIndex(
+      const DataBlockHashIndex* data_block_hash_index, uint32_t map_offset,
+      const FilterPolicy::KeyTransformer* key_transformer) {
+    data_block_hash_index_ = data_block_hash_index;
+    data_block_hash_map_offset_ = map_offset;
+    data_block_hash_index_key_transformer_ = key_transformer;
+  }
+
   virtual bool Valid() const override { return current_ < restarts_; }
   virtual Status status() const override { return status_; }
 
@@ -241,6 +265,9 @@ class BlockIter : public InternalIterator {
   Status status_;
   const BlockHashIndex* hash_index_;
   const BlockPrefixIndex* prefix_index_;
+  const DataBlockHashIndex* data_block_hash_index_ = nullptr;
+  uint32_t data_block_hash_map_offset_ = 0;
+  const FilterPolicy::KeyTransformer* data_block_hash_index_key_transformer_ = nullptr;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -285,6 +312,10 @@ class BlockIter : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  // Uses data block hash index to narrow down the range of restart intervals to search, falls
+  // back to the full range binary search if the key prefix is not found in the hash index.
+  bool DataBlockHashSeek(const Slice& target, uint32_t* index);
+
 };
 
 }  // namespace rocksdb
@@ -27,6 +27,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -76,6 +77,11 @@ typedef FilterPolicy::FilterType FilterType;
 // Without anonymous namespace here, we fail the warning -Wmissing-prototypes
 namespace {
 
+// Each data block contributes up to max(kMinCompressionDictSampleBytes,
+// max_dict_bytes / kCompressionDictSampleBlocks) bytes to the compression dictionary samples.
+constexpr size_t kMinCompressionDictSampleBytes = 64;
+constexpr size_t kCompressionDictSampleBlocks = 64;
+
 FilterType GetFilterType(const BlockBasedTableOptions& table_opt) {
   std::shared_ptr<const FilterPolicy> policy(table_opt.filter_policy);
   return policy != nullptr ? policy->GetFilterType() : FilterType::kNoFilter;
@@ -107,10 +113,12 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 }
 
 // format_version is the block format as defined in include/rocksdb/table.h
+// compression_dict, when not empty, is used as a preset dictionary by LZ4 and LZ4HC.
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    std::string* compressed_output) {
+                    std::string* compressed_output,
+                    const Slice& compression_dict = Slice()) {
   if (*type == kNoCompression) {
     return raw;
   }
@@ -147,7 +155,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -156,7 +164,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4HC_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -301,6 +309,11 @@ struct BlockBasedTableBuilder::Rep {
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // Dictionary used to compress data blocks of this table, empty if none.
+  std::shared_ptr<const std::string> compression_dict;
+  // Prefixes of raw data blocks collected to be used as a dictionary for subsequent tables.
+  std::string compression_dict_samples;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   yb::MemTrackerPtr mem_tracker;
@@ -316,7 +329,12 @@ struct BlockBasedTableBuilder::Rep {
       WritableFileWriter* data_file,
       const CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
-      const bool skip_filters);
+      const bool skip_filters,
+      std::shared_ptr<const std::string> _compression_dict);
+
+  Slice compression_dict_slice() const {
+    return compression_dict ? Slice(*compression_dict) : Slice();
+  }
 
   bool is_split_sst() const { return data_writer != metadata_writer; }
 };
@@ -353,7 +371,8 @@ BlockBasedTableBuilder::Rep::Rep(
     WritableFileWriter* data_file,
     const CompressionType _compression_type,
     const CompressionOptions& _compression_opts,
-    const bool skip_filters)
+    const bool skip_filters,
+    std::shared_ptr<const std::string> _compression_dict)
     : ioptions(_ioptions),
       table_options(table_opt),
       internal_comparator(icomparator),
@@ -362,7 +381,9 @@ BlockBasedTableBuilder::Rep::Rep(
           _ioptions, table_options, filter_type)),
       data_block_builder(
           table_options.block_restart_interval,
-          table_options.data_block_key_value_encoding_format, table_options.use_delta_encoding),
+          table_options.data_block_key_value_encoding_format, table_options.use_delta_encoding,
+          table_options.data_block_index_type, table_options.data_block_hash_table_util_ratio,
+          table_options.data_block_hash_index_key_transformer),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -380,7 +401,9 @@ BlockBasedTableBuilder::Rep::Rep(
       compression_opts(_compression_opts),
       flush_block_policy(
           table_options.flush_block_policy_factory->NewFlushBlockPolicy(
-              table_options, data_block_builder)) {
+              table_options, data_block_builder)),
+      compression_dict(CompressionDictSupported(_compression_type) && _compression_dict &&
+                       !_compression_dict->empty() ? std::move(_compression_dict) : nullptr) {
   if (_ioptions.mem_tracker) {
     mem_tracker = yb::MemTracker::FindOrCreateTracker(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
@@ -413,7 +436,8 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     WritableFileWriter* data_file,
     const CompressionType compression_type,
     const CompressionOptions& compression_opts,
-    const bool skip_filters) {
+    const bool skip_filters,
+    std::shared_ptr<const std::string> compression_dict) {
   BlockBasedTableOptions sanitized_table_options(table_options);
   if (sanitized_table_options.format_version == 0 &&
       sanitized_table_options.checksum != kCRC32c) {
@@ -427,7 +451,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
 
   rep_ = new Rep(ioptions, sanitized_table_options, internal_comparator,
                  int_tbl_prop_collector_factories, column_family_id, metadata_file, data_file,
-                 compression_type, compression_opts, skip_filters);
+                 compression_type, compression_opts, skip_filters, std::move(compression_dict));
 
   if (rep_->filter_block_builder != nullptr) {
     rep_->filter_block_builder->StartBlock(0);
@@ -502,7 +526,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
 
   if (!r->data_block_builder.empty()) {
     data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+        r->data_writer.get(), r->compression_dict_slice());
   }
   if (!ok()) return;
 
@@ -575,15 +599,36 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice* const next_block_firs
 
 size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
+  const auto raw_block_contents = block->Finish();
+  SampleForCompressionDict(raw_block_contents);
+  size_t block_size = WriteBlock(raw_block_contents, handle, writer_info, compression_dict);
   block->Reset();
   return block_size;
 }
 
+void BlockBasedTableBuilder::SampleForCompressionDict(const Slice& raw_block_contents) {
+  Rep* r = rep_;
+  const size_t max_dict_bytes = r->compression_opts.max_dict_bytes;
+  if (max_dict_bytes == 0 || !CompressionDictSupported(r->compression_type) ||
+      r->compression_dict_samples.size() >= max_dict_bytes) {
+    return;
+  }
+  // Take a prefix of each data block, so the dictionary covers as many distinct blocks as
+  // possible instead of being filled by the first few of them.
+  const size_t per_block_bytes = std::max<size_t>(kMinCompressionDictSampleBytes,
+                                                  max_dict_bytes / kCompressionDictSampleBlocks);
+  const size_t sample_size = std::min({
+      raw_block_contents.size(), per_block_bytes,
+      max_dict_bytes - r->compression_dict_samples.size()});
+  r->compression_dict_samples.append(raw_block_contents.cdata(), sample_size);
+}
+
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     BlockHandle* handle,
-    FileWriterWithOffsetAndCachePrefix* writer_info) {
+    FileWriterWithOffsetAndCachePrefix* writer_info,
+    const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -596,7 +641,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, &r->compressed_output, compression_dict);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -807,6 +852,15 @@ Status BlockBasedTableBuilder::Finish() {
 
       meta_index_builder.Add(kPropertiesBlock, properties_block_handle);
     }  // end of properties block writing
+
+    // Write dictionary used to compress data blocks, so readers are able to decompress them.
+    if (r->compression_dict) {
+      BlockHandle compression_dict_block_handle;
+      WriteRawBlock(
+          *r->compression_dict, kNoCompression, &compression_dict_block_handle,
+          r->metadata_writer.get());
+      meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+    }
   }    // meta blocks
 
   BlockHandle meta_index_block_handle;
@@ -897,6 +951,10 @@ const std::string& BlockBasedTableBuilder::LastKey() const {
   return rep_->last_key;
 }
 
+Slice BlockBasedTableBuilder::CompressionDictSamples() const {
+  return rep_->compression_dict_samples;
+}
+
 void BlockBasedTableBuilder::TEST_skip_writing_key_value_encoding_format() {
   rep_->TEST_skip_writing_key_value_encoding_format_ = true;
 }
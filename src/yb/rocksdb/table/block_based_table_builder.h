@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -58,7 +59,8 @@ class BlockBasedTableBuilder : public TableBuilder {
       uint32_t column_family_id, WritableFileWriter* metadata_file,
       WritableFileWriter* data_file,
       const CompressionType compression_type,
-      const CompressionOptions& compression_opts, const bool skip_filters);
+      const CompressionOptions& compression_opts, const bool skip_filters,
+      std::shared_ptr<const std::string> compression_dict = nullptr);
 
   // REQUIRES: Either Finish() or Abandon() has been called.
   ~BlockBasedTableBuilder();
@@ -104,6 +106,8 @@ class BlockBasedTableBuilder : public TableBuilder {
 
   const std::string& LastKey() const override;
 
+  Slice CompressionDictSamples() const override;
+
   void TEST_skip_writing_key_value_encoding_format();
 
  private:
@@ -113,10 +117,14 @@ class BlockBasedTableBuilder : public TableBuilder {
   // Call block's Finish() method and then write the finalize block contents to
   // file. Returns number of bytes written to file.
   size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
-                    FileWriterWithOffsetAndCachePrefix* writer_info);
+                    FileWriterWithOffsetAndCachePrefix* writer_info,
+                    const Slice& compression_dict = Slice());
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
+  // Append a prefix of the raw data block to compression dictionary samples, if enabled.
+  void SampleForCompressionDict(const Slice& raw_block_contents);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
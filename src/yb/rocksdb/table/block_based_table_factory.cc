@@ -102,7 +102,8 @@ std::unique_ptr<TableBuilder> BlockBasedTableFactory::NewTableBuilder(
       data_file,
       table_builder_options.compression_type,
       table_builder_options.compression_opts,
-      table_builder_options.skip_filters);
+      table_builder_options.skip_filters,
+      table_builder_options.compression_dict);
 }
 
 Status BlockBasedTableFactory::SanitizeOptions(
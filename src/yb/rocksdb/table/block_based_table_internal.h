@@ -35,10 +35,12 @@ inline Status ReadBlockFromFile(
     RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
     const BlockHandle& handle, std::unique_ptr<Block>* result, Env* env,
     const std::shared_ptr<yb::MemTracker>& mem_tracker,
-    bool do_uncompress = true) {
+    bool do_uncompress = true, const Slice& compression_dict = Slice(),
+    SecondaryCache* secondary_cache = nullptr, const Slice& secondary_cache_key = Slice()) {
   BlockContents contents;
   Status s = ReadBlockContents(file, footer, options, handle, &contents, env,
-                               mem_tracker, do_uncompress);
+                               mem_tracker, do_uncompress, compression_dict, secondary_cache,
+                               secondary_cache_key);
   if (s.ok()) {
     result->reset(new Block(std::move(contents)));
   }
@@ -69,8 +71,10 @@ inline Slice GetCacheKey(const CacheKeyPrefixBuffer& cache_key_prefix, const Blo
 }
 
 // Generate a cache key prefix from the file. Used for both data and metadata files.
+// CacheType is either Cache or SecondaryCache.
+template <class CacheType>
 inline void GenerateCachePrefix(
-    Cache* cc, yb::FileWithUniqueId* file, CacheKeyPrefixBuffer* prefix) {
+    CacheType* cc, yb::FileWithUniqueId* file, CacheKeyPrefixBuffer* prefix) {
   // generate an id from the file
   prefix->size = file->GetUniqueId(prefix->data);
 
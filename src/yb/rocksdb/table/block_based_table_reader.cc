@@ -23,6 +23,7 @@
 
 #include "yb/rocksdb/table/block_based_table_reader.h"
 
+#include <array>
 #include <string>
 #include <utility>
 
@@ -35,6 +36,7 @@
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/block.h"
@@ -62,12 +64,17 @@
 
 #include "yb/util/atomic.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/flags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/stats/perf_step_timer.h"
 #include "yb/util/status_format.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
+
+DECLARE_bool(enable_io_uring);
 
 namespace rocksdb {
 
@@ -150,6 +157,9 @@ struct BlockBasedTable::FileReaderWithCachePrefix {
   // Similar prefix, but for compressed blocks cache:
   block_based_table::CacheKeyPrefixBuffer compressed_cache_key_prefix;
 
+  // Similar prefix, but for secondary blocks cache:
+  block_based_table::CacheKeyPrefixBuffer secondary_cache_key_prefix;
+
   explicit FileReaderWithCachePrefix(unique_ptr<RandomAccessFileReader>&& _reader) :
       reader(std::move(_reader)) {}
 };
@@ -243,6 +253,9 @@ struct BlockBasedTable::Rep {
 
   DataIndexLoadMode data_index_load_mode = static_cast<DataIndexLoadMode>(0);
   yb::MemTrackerPtr mem_tracker;
+
+  // Dictionary used to compress data blocks, empty if data blocks were compressed without it.
+  BlockContents compression_dict_block;
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -270,6 +283,15 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
     return table_->PrefixMayMatch(internal_key);
   }
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    if (block_type_ != BlockType::kData) {
+      return;
+    }
+    auto status = table_->PrefetchForSeeks(read_options_, sorted_targets);
+    // Prefetch is just a hint, the error will be reported by the seek that needs the block.
+    VLOG_IF(1, !status.ok()) << "Failed to prefetch blocks for seeks: " << status;
+  }
+
  private:
   // Don't own table_. BlockEntryIteratorState should only be stored in iterators or in
   // corresponding BlockBasedTable. TableReader (superclass of BlockBasedTable) is only destroyed
@@ -303,6 +325,7 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep,
     FileReaderWithCachePrefix* reader_with_cache_prefix) {
   reader_with_cache_prefix->cache_key_prefix.size = 0;
   reader_with_cache_prefix->compressed_cache_key_prefix.size = 0;
+  reader_with_cache_prefix->secondary_cache_key_prefix.size = 0;
   if (rep->table_options.block_cache != nullptr) {
     GenerateCachePrefix(rep->table_options.block_cache.get(),
         reader_with_cache_prefix->reader->file(),
@@ -313,6 +336,11 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep,
         reader_with_cache_prefix->reader->file(),
         &reader_with_cache_prefix->compressed_cache_key_prefix);
   }
+  if (rep->table_options.secondary_block_cache != nullptr) {
+    GenerateCachePrefix(rep->table_options.secondary_block_cache.get(),
+        reader_with_cache_prefix->reader->file(),
+        &reader_with_cache_prefix->secondary_cache_key_prefix);
+  }
 }
 
 KeyValueEncodingFormat BlockBasedTable::GetKeyValueEncodingFormat(
@@ -434,6 +462,8 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   RETURN_NOT_OK(new_table->ReadPropertiesBlock(meta_iter.get()));
 
+  RETURN_NOT_OK(new_table->ReadCompressionDictBlock(meta_iter.get()));
+
   RETURN_NOT_OK(new_table->SetupFilter(meta_iter.get()));
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
@@ -576,6 +606,26 @@ Status BlockBasedTable::ReadPropertiesBlock(InternalIterator* meta_iter) {
   return Status::OK();
 }
 
+Status BlockBasedTable::ReadCompressionDictBlock(InternalIterator* meta_iter) {
+  meta_iter->Seek(kCompressionDictBlock);
+  RETURN_NOT_OK(meta_iter->status());
+  if (!meta_iter->Valid() || meta_iter->key() != kCompressionDictBlock) {
+    return Status::OK();
+  }
+
+  BlockHandle handle;
+  Slice input = meta_iter->value();
+  RETURN_NOT_OK(handle.DecodeFrom(&input));
+  return ReadBlockContents(
+      rep_->base_reader_with_cache_prefix->reader.get(), rep_->footer, ReadOptions::kDefault,
+      handle, &rep_->compression_dict_block, rep_->ioptions.env, rep_->mem_tracker,
+      /* do_uncompress = */ false);
+}
+
+Slice BlockBasedTable::GetCompressionDict(BlockType block_type) const {
+  return block_type == BlockType::kData ? rep_->compression_dict_block.data : Slice();
+}
+
 Status BlockBasedTable::SetupFilter(InternalIterator* meta_iter) {
   // Find filter handle and filter type.
   if (!rep_->filter_policy) {
@@ -762,7 +812,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -806,7 +856,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -834,7 +884,7 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -843,7 +893,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -903,10 +953,19 @@ FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_ha
   if (rep->filter_type == FilterType::kNoFilter) {
     return nullptr;
   }
+  SecondaryCache* secondary_cache = rep->table_options.secondary_block_cache.get();
+  char secondary_cache_key_buffer[block_based_table::kCacheKeyBufferSize];
+  Slice secondary_cache_key;
+  if (secondary_cache != nullptr) {
+    secondary_cache_key = GetCacheKey(
+        rep->base_reader_with_cache_prefix->secondary_cache_key_prefix, filter_handle,
+        secondary_cache_key_buffer);
+  }
   BlockContents block;
   if (!ReadBlockContents(
            rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
-           filter_handle, &block, rep->ioptions.env, rep->mem_tracker, false).ok()) {
+           filter_handle, &block, rep->ioptions.env, rep->mem_tracker, false,
+           /* compression_dict = */ Slice(), secondary_cache, secondary_cache_key).ok()) {
     // Error reading the block
     return nullptr;
   }
@@ -1183,6 +1242,7 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
   RETURN_NOT_OK(handle.DecodeFrom(&input));
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  const Slice compression_dict = GetCompressionDict(block_type);
 
   // If either block cache is enabled, we'll try to read from it.
   if (PREDICT_TRUE(use_cache) && (block_cache != nullptr || block_cache_compressed != nullptr)) {
@@ -1203,20 +1263,30 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
 
     Status status = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
+      // Blocks read without filling the block cache, e.g. by compactions, do not go to the
+      // secondary cache either.
+      SecondaryCache* secondary_cache = rep_->table_options.secondary_block_cache.get();
+      char secondary_cache_key[block_based_table::kCacheKeyBufferSize];
+      Slice skey; /* key to the secondary block cache */
+      if (secondary_cache != nullptr) {
+        skey = GetCacheKey(reader->secondary_cache_key_prefix, handle, secondary_cache_key);
+      }
       std::unique_ptr<Block> raw_block;
       {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         RETURN_NOT_OK(block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr));
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict,
+            secondary_cache, skey));
       }
 
       RETURN_NOT_OK(PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                         ro, statistics, &block, raw_block.release(),
-                                        rep_->table_options.format_version, rep_->mem_tracker));
+                                        rep_->table_options.format_version, rep_->mem_tracker,
+                                        compression_dict));
       status = Status::OK();
     }
 
@@ -1236,7 +1306,7 @@ yb::Result<BlockBasedTable::CachableEntry<Block>> BlockBasedTable::RetrieveBlock
   std::unique_ptr<Block> block_value;
   RETURN_NOT_OK(block_based_table::ReadBlockFromFile(
       reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-      rep_->mem_tracker));
+      rep_->mem_tracker, /* do_uncompress = */ true, compression_dict));
 
   block.value = block_value.release();
   RSTATUS_DCHECK(block.value, Incomplete, "No data block"); // Not expected to happen.
@@ -1258,7 +1328,10 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   auto block = RetrieveBlock(ro, index_value, block_type);
   if (block) {
     InternalIterator* iter = block->value->NewIterator(
-        rep_->comparator.get(), GetKeyValueEncodingFormat(block_type), input_iter);
+        rep_->comparator.get(), GetKeyValueEncodingFormat(block_type), input_iter,
+        /* total_order_seek = */ true,
+        block_type == BlockType::kData
+            ? rep_->table_options.data_block_hash_index_key_transformer : nullptr);
     if (block->cache_handle) {
       Cache* block_cache = rep_->table_options.block_cache.get();
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache, block->cache_handle);
@@ -1540,6 +1613,159 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
   return Status::OK();
 }
 
+Status BlockBasedTable::PrefetchForSeeks(
+    const ReadOptions& read_options, const std::vector<Slice>& sorted_targets) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr || !read_options.fill_cache ||
+      read_options.read_tier == kBlockCacheTier || sorted_targets.empty()) {
+    // There is no place to keep prefetched blocks or IO is not allowed.
+    return Status::OK();
+  }
+
+  IndexIteratorHolder iiter_holder(this, read_options);
+  InternalIterator& iiter = *iiter_holder.iter();
+  RETURN_NOT_OK(iiter.status());
+
+  // Collect handles of the data blocks required by the seeks. Since targets are sorted, each
+  // handle is collected once and the index is sought only when the target is past the current
+  // data block.
+  const auto& comparator = *rep_->comparator;
+  std::vector<std::string> block_handles;
+  for (const auto& target : sorted_targets) {
+    if (iiter.Valid() && comparator.Compare(target, iiter.key()) <= 0) {
+      continue;
+    }
+    iiter.Seek(target);
+    if (!iiter.Valid()) {
+      break;
+    }
+    block_handles.push_back(iiter.value().ToBuffer());
+  }
+  RETURN_NOT_OK(iiter.status());
+
+  auto load_block = [this, block_cache](const ReadOptions& ro, const Slice& handle) -> Status {
+    auto block = VERIFY_RESULT(RetrieveBlock(ro, handle, BlockType::kData));
+    if (block.cache_handle) {
+      block.Release(block_cache);
+    } else {
+      delete block.value;
+    }
+    return Status::OK();
+  };
+
+  // Skip blocks that are already present in the block cache.
+  ReadOptions no_io_read_options = read_options;
+  no_io_read_options.read_tier = kBlockCacheTier;
+  std::vector<Slice> missing_blocks;
+  for (const auto& handle : block_handles) {
+    auto status = load_block(no_io_read_options, handle);
+    if (status.IsIncomplete()) {
+      missing_blocks.push_back(handle);
+    } else {
+      RETURN_NOT_OK(status);
+    }
+  }
+  if (missing_blocks.empty()) {
+    return Status::OK();
+  }
+
+  if (FLAGS_enable_io_uring && missing_blocks.size() > 1) {
+    // All blocks are submitted to the kernel at once, so there is no need in parallel reads.
+    return MultiReadDataBlocks(read_options, missing_blocks);
+  }
+
+  auto* thread_pool = rep_->table_options.prefetch_thread_pool;
+  std::vector<Status> statuses(missing_blocks.size());
+  yb::CountDownLatch latch(missing_blocks.size());
+  auto read_block = [&load_block, &read_options, &missing_blocks, &statuses, &latch](size_t idx) {
+    statuses[idx] = load_block(read_options, missing_blocks[idx]);
+    latch.CountDown();
+  };
+  // The last block is read by the calling thread, instead of waiting idle.
+  for (size_t idx = 0; idx + 1 < missing_blocks.size(); ++idx) {
+    if (!thread_pool || !thread_pool->SubmitFunc(std::bind(read_block, idx)).ok()) {
+      read_block(idx);
+    }
+  }
+  read_block(missing_blocks.size() - 1);
+  latch.Wait();
+
+  for (const auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
+  return Status::OK();
+}
+
+Status BlockBasedTable::MultiReadDataBlocks(
+    const ReadOptions& read_options, const std::vector<Slice>& index_values) {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  Cache* block_cache_compressed = rep_->table_options.block_cache_compressed.get();
+  SecondaryCache* secondary_cache = rep_->table_options.secondary_block_cache.get();
+  FileReaderWithCachePrefix* reader = GetBlockReader(BlockType::kData);
+  const Slice compression_dict = GetCompressionDict(BlockType::kData);
+
+  const size_t count = index_values.size();
+  std::vector<BlockHandle> handles(count);
+  for (size_t i = 0; i != count; ++i) {
+    Slice input = index_values[i];
+    RETURN_NOT_OK(handles[i].DecodeFrom(&input));
+  }
+
+  std::vector<Slice> secondary_cache_keys;
+  std::vector<std::array<char, block_based_table::kCacheKeyBufferSize>> secondary_cache_key_bufs;
+  if (secondary_cache != nullptr) {
+    secondary_cache_keys.reserve(count);
+    secondary_cache_key_bufs.resize(count);
+    for (size_t i = 0; i != count; ++i) {
+      secondary_cache_keys.push_back(GetCacheKey(
+          reader->secondary_cache_key_prefix, handles[i], secondary_cache_key_bufs[i].data()));
+    }
+  }
+
+  std::vector<BlockContents> contents;
+  std::vector<Status> statuses;
+  {
+    StopWatch sw(rep_->ioptions.env, rep_->ioptions.statistics, READ_BLOCK_GET_MICROS);
+    MultiReadBlockContents(
+        reader->reader.get(), rep_->footer, read_options, handles, rep_->mem_tracker,
+        /* do_uncompress = */ block_cache_compressed == nullptr, compression_dict,
+        secondary_cache, secondary_cache_keys, &contents, &statuses);
+  }
+
+  Status result;
+  for (size_t i = 0; i != count; ++i) {
+    if (!statuses[i].ok()) {
+      LOG(ERROR) << "Failed to read block " << handles[i].ToDebugString() << " from "
+                 << reader->reader->file()->filename() << ": " << statuses[i];
+      result = statuses[i];
+      continue;
+    }
+    char cache_key[block_based_table::kCacheKeyBufferSize];
+    char compressed_cache_key[block_based_table::kCacheKeyBufferSize];
+    Slice key, ckey;
+    if (block_cache != nullptr) {
+      key = GetCacheKey(reader->cache_key_prefix, handles[i], cache_key);
+    }
+    if (block_cache_compressed != nullptr) {
+      ckey = GetCacheKey(reader->compressed_cache_key_prefix, handles[i], compressed_cache_key);
+    }
+    CachableEntry<Block> block;
+    auto status = PutDataBlockToCache(
+        key, ckey, block_cache, block_cache_compressed, read_options,
+        rep_->ioptions.statistics, &block, new Block(std::move(contents[i])),
+        rep_->table_options.format_version, rep_->mem_tracker, compression_dict);
+    if (block.cache_handle) {
+      block.Release(block_cache);
+    } else {
+      delete block.value;
+    }
+    if (!status.ok()) {
+      result = status;
+    }
+  }
+  return result;
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIterator> iiter(NewIndexIterator(options));
@@ -1959,6 +2185,34 @@ yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
       rep_->comparator.get(), MiddlePointPolicy::kMiddleHigh);
 }
 
+yb::Result<std::vector<std::string>> BlockBasedTable::GetSampleKeys(size_t max_keys) {
+  std::vector<std::string> index_keys;
+  {
+    auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
+    auto se = yb::ScopeExit([this, &index_reader] {
+      index_reader.Release(rep_->table_options.block_cache.get());
+    });
+    index_keys = VERIFY_RESULT(index_reader.value->GetSampleKeys(max_keys));
+  }
+
+  // Index keys might not exist in the file, so seek to the nearest data block key.
+  std::unique_ptr<InternalIterator> iter(
+      NewIterator(ReadOptions::kDefault, nullptr, /* skip_filters = */ true));
+  std::vector<std::string> result;
+  result.reserve(index_keys.size());
+  for (const auto& index_key : index_keys) {
+    iter->Seek(index_key);
+    if (!iter->Valid()) {
+      RETURN_NOT_OK(iter->status());
+      break;
+    }
+    if (result.empty() || iter->key() != result.back()) {
+      result.push_back(iter->key().ToBuffer());
+    }
+  }
+  return result;
+}
+
 yb::Result<IndexReaderCleanablePtr> BlockBasedTable::TEST_GetIndexReader() {
   auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
   auto cache = rep_->table_options.block_cache;
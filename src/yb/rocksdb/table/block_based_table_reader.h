@@ -28,6 +28,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "yb/rocksdb/immutable_options.h"
 #include "yb/rocksdb/options.h"
@@ -158,6 +159,13 @@ class BlockBasedTable : public TableReader {
   // IO or iteration error.
   Status Prefetch(const Slice* begin, const Slice* end) override;
 
+  // Loads to the block cache data blocks that would be read by Seek() to each of sorted_targets.
+  // Targets are internal keys sorted in ascending order. The index is traversed once for all
+  // targets, and blocks missing from the block cache are read in parallel, either by a single
+  // multi read with io_uring or on BlockBasedTableOptions::prefetch_thread_pool.
+  Status PrefetchForSeeks(
+      const ReadOptions& read_options, const std::vector<Slice>& sorted_targets);
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file).  The returned value is in terms of file
@@ -203,6 +211,8 @@ class BlockBasedTable : public TableReader {
 
   yb::Result<std::string> GetMiddleKey() override;
 
+  yb::Result<std::vector<std::string>> GetSampleKeys(size_t max_keys) override;
+
   // Helper function that force reading block from a file and takes care about block cleanup.
   yb::Result<std::unique_ptr<Block>> RetrieveBlockFromFile(const ReadOptions& ro,
       const Slice& index_value, BlockType block_type);
@@ -263,7 +273,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -278,7 +289,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -301,6 +313,12 @@ class BlockBasedTable : public TableReader {
 
   Status ReadPropertiesBlock(InternalIterator* meta_iter);
 
+  // Loads dictionary used to compress data blocks, if the table has one.
+  Status ReadCompressionDictBlock(InternalIterator* meta_iter);
+
+  // Returns dictionary to be used for decompression of the block of specified type.
+  Slice GetCompressionDict(BlockType block_type) const;
+
   Status SetupFilter(InternalIterator* meta_iter);
 
   // Read the meta block from sst.
@@ -326,6 +344,11 @@ class BlockBasedTable : public TableReader {
   yb::Result<CachableEntry<Block>> RetrieveBlock(const ReadOptions& ro, const Slice& index_value,
       BlockType block_type, bool use_cache = true);
 
+  // Reads data blocks identified by index_values with a single multi read of the file, and
+  // inserts them to the block cache.
+  Status MultiReadDataBlocks(
+      const ReadOptions& read_options, const std::vector<Slice>& index_values);
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
@@ -44,6 +44,8 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// Data blocks could also contain hash index between restarts and num_restarts, see
+// data_block_hash_index.h for details.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -73,6 +75,18 @@ BlockBuilder::BlockBuilder(
   restarts_.push_back(0);       // First restart point is at offset 0
 }
 
+BlockBuilder::BlockBuilder(
+    int block_restart_interval, const KeyValueEncodingFormat key_value_encoding_format,
+    const bool use_delta_encoding, const DataBlockIndexType index_type,
+    const double hash_table_util_ratio,
+    const FilterPolicy::KeyTransformer* hash_index_key_transformer)
+    : BlockBuilder(block_restart_interval, key_value_encoding_format, use_delta_encoding) {
+  if (index_type == DataBlockIndexType::kBinarySearchAndHash && hash_index_key_transformer) {
+    hash_index_key_transformer_ = hash_index_key_transformer;
+    hash_index_builder_.Initialize(hash_table_util_ratio);
+  }
+}
+
 void BlockBuilder::Reset() {
   buffer_.clear();
   restarts_.clear();
@@ -80,6 +94,8 @@ void BlockBuilder::Reset() {
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  hash_index_builder_.Reset();
+  last_hash_key_prefix_.clear();
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -88,6 +104,9 @@ size_t BlockBuilder::CurrentSizeEstimate() const {
     // Restarts haven't been flushed to buffer yet.
     size += restarts_.size() * sizeof(uint32_t) +    // Restart array.
             sizeof(uint32_t);                        // Restart array length.
+    if (hash_index_builder_.Valid()) {
+      size += hash_index_builder_.EstimateSize();
+    }
   }
   return size;
 }
@@ -335,7 +354,16 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  auto index_type = DataBlockIndexType::kBinarySearch;
+  // Restart intervals after the last indexed key prefix could also exceed the limit supported by
+  // hash index.
+  if (hash_index_builder_.Valid() && !last_hash_key_prefix_.empty() &&
+      restarts_.size() - 1 <= kMaxRestartSupportedByHashIndex) {
+    hash_index_builder_.Finish(&buffer_);
+    index_type = DataBlockIndexType::kBinarySearchAndHash;
+  }
+  PutFixed32(&buffer_, PackIndexTypeAndNumRestarts(
+      index_type, static_cast<uint32_t>(restarts_.size())));
   finished_ = true;
   return Slice(buffer_);
 }
@@ -405,6 +433,16 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
 
   assert(Slice(last_key_) == key);
   counter_++;
+
+  if (hash_index_builder_.Valid()) {
+    const auto key_prefix = hash_index_key_transformer_->Transform(ExtractUserKey(key));
+    // Keys with the same prefix are contiguous, so it is enough to compare with the previous one
+    // to add each prefix only once, pointing to the restart interval of its first key.
+    if (!key_prefix.empty() && key_prefix != Slice(last_hash_key_prefix_)) {
+      hash_index_builder_.Add(key_prefix, restarts_.size() - 1);
+      last_hash_key_prefix_.assign(key_prefix.cdata(), key_prefix.size());
+    }
+  }
 }
 
 }  // namespace rocksdb
@@ -24,8 +24,13 @@
 #pragma once
 
 #include <stdint.h>
+
+#include <string>
 #include <vector>
 
+#include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/table.h"
+#include "yb/rocksdb/table/data_block_hash_index.h"
 #include "yb/rocksdb/types.h"
 
 #include "yb/util/slice.h"
@@ -41,6 +46,16 @@ class BlockBuilder {
                         KeyValueEncodingFormat key_value_encoding_format,
                         bool use_delta_encoding = true);
 
+  // Builder for data blocks with internal keys. If index_type is kBinarySearchAndHash, block is
+  // built with hash index over key prefixes extracted by hash_index_key_transformer from user
+  // keys (see data_block_hash_index.h).
+  BlockBuilder(int block_restart_interval,
+               KeyValueEncodingFormat key_value_encoding_format,
+               bool use_delta_encoding,
+               DataBlockIndexType index_type,
+               double hash_table_util_ratio,
+               const FilterPolicy::KeyTransformer* hash_index_key_transformer);
+
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
 
@@ -77,6 +92,11 @@ class BlockBuilder {
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+
+  const FilterPolicy::KeyTransformer* hash_index_key_transformer_ = nullptr;
+  DataBlockHashIndexBuilder hash_index_builder_;
+  // Last key prefix added to hash_index_builder_.
+  std::string last_hash_key_prefix_;
 };
 
 }  // namespace rocksdb
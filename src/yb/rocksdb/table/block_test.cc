@@ -852,6 +852,99 @@ TEST_F(BlockTest, IterPerfDisabledDeltaEncoding) {
   TestBlockScanPerf(KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts, true);
 }
 
+namespace {
+
+// Extracts fixed size primary key prefix generated by GenerateKey.
+class PrimaryKeyExtractor : public FilterPolicy::KeyTransformer {
+ public:
+  Slice Transform(Slice key) const override {
+    return key.size() >= kPrimaryKeySize ? key.Prefix(kPrimaryKeySize) : Slice();
+  }
+
+ private:
+  static constexpr size_t kPrimaryKeySize = 6;
+};
+
+std::string GenerateInternalKey(int primary_key, int secondary_key, SequenceNumber seqno) {
+  return InternalKey(GenerateKey(primary_key, secondary_key, 0, nullptr), seqno, kTypeValue)
+      .Encode().ToBuffer();
+}
+
+void CheckDataBlockHashIndex(
+    KeyValueEncodingFormat key_value_encoding_format, int block_restart_interval,
+    int num_primary_keys, DataBlockIndexType expected_index_type) {
+  constexpr int kPrimaryKeyStep = 2;
+  constexpr int kKeysPerPrimaryKey = 5;
+  constexpr SequenceNumber kSeqNo = 1000;
+
+  const PrimaryKeyExtractor key_extractor;
+  const InternalKeyComparator comparator(BytewiseComparator());
+
+  BlockBuilder builder(
+      block_restart_interval, key_value_encoding_format, /* use_delta_encoding = */ true,
+      DataBlockIndexType::kBinarySearchAndHash, /* hash_table_util_ratio = */ 0.75,
+      &key_extractor);
+  for (int i = 0; i < num_primary_keys * kPrimaryKeyStep; i += kPrimaryKeyStep) {
+    for (int j = 0; j < kKeysPerPrimaryKey; ++j) {
+      builder.Add(GenerateInternalKey(i, j, kSeqNo), std::to_string(i * kKeysPerPrimaryKey + j));
+    }
+  }
+
+  BlockContents contents;
+  contents.data = builder.Finish();
+  contents.cachable = false;
+  Block reader(std::move(contents));
+  ASSERT_EQ(reader.IndexType(), expected_index_type);
+
+  std::unique_ptr<InternalIterator> hash_iter(reader.NewIterator(
+      &comparator, key_value_encoding_format, /* iter = */ nullptr,
+      /* total_order_seek = */ true, &key_extractor));
+  std::unique_ptr<InternalIterator> binary_iter(
+      reader.NewIterator(&comparator, key_value_encoding_format));
+
+  // Seek both to existing and missing keys, including keys with primary key missing in the block.
+  for (int i = -1; i <= num_primary_keys * kPrimaryKeyStep; ++i) {
+    for (int j = -1; j <= kKeysPerPrimaryKey; ++j) {
+      for (auto seqno : {kMaxSequenceNumber, kSeqNo, kSeqNo - 1}) {
+        const auto target = GenerateInternalKey(i, j, seqno);
+        hash_iter->Seek(target);
+        binary_iter->Seek(target);
+        ASSERT_OK(hash_iter->status());
+        ASSERT_OK(binary_iter->status());
+        ASSERT_EQ(hash_iter->Valid(), binary_iter->Valid()) << "i: " << i << ", j: " << j;
+        if (binary_iter->Valid()) {
+          ASSERT_EQ(hash_iter->key(), binary_iter->key()) << "i: " << i << ", j: " << j;
+          ASSERT_EQ(hash_iter->value(), binary_iter->value()) << "i: " << i << ", j: " << j;
+        }
+      }
+    }
+  }
+
+  // Check the whole block content is readable.
+  int count = 0;
+  for (hash_iter->SeekToFirst(); hash_iter->Valid(); hash_iter->Next()) {
+    ++count;
+  }
+  ASSERT_OK(hash_iter->status());
+  ASSERT_EQ(count, num_primary_keys * kKeysPerPrimaryKey);
+}
+
+} // namespace
+
+TEST_F(BlockTest, DataBlockHashIndex) {
+  for (auto key_value_encoding_format : KeyValueEncodingFormatList()) {
+    for (int block_restart_interval : {1, 3, 16}) {
+      ASSERT_NO_FATAL_FAILURE(CheckDataBlockHashIndex(
+          key_value_encoding_format, block_restart_interval, /* num_primary_keys = */ 40,
+          DataBlockIndexType::kBinarySearchAndHash));
+    }
+    // Block with too many restarts is written without hash index.
+    ASSERT_NO_FATAL_FAILURE(CheckDataBlockHashIndex(
+        key_value_encoding_format, /* block_restart_interval = */ 1,
+        /* num_primary_keys = */ 100, DataBlockIndexType::kBinarySearch));
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char **argv) {
@@ -0,0 +1,123 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr uint32_t kDataBlockHashIndexSeed = 0x3e8a6f27;
+
+inline uint32_t DataBlockHash(const Slice& key_prefix) {
+  return Hash(key_prefix.cdata(), key_prefix.size(), kDataBlockHashIndexSeed);
+}
+
+} // namespace
+
+uint32_t PackIndexTypeAndNumRestarts(DataBlockIndexType index_type, uint32_t num_restarts) {
+  DCHECK_LE(num_restarts, kMaxNumRestarts);
+  return index_type == DataBlockIndexType::kBinarySearchAndHash
+      ? num_restarts | kDataBlockHashIndexFooterFlag : num_restarts;
+}
+
+void UnpackIndexTypeAndNumRestarts(
+    uint32_t block_footer, DataBlockIndexType* index_type, uint32_t* num_restarts) {
+  if (block_footer & kDataBlockHashIndexFooterFlag) {
+    *index_type = DataBlockIndexType::kBinarySearchAndHash;
+    *num_restarts = block_footer & kMaxNumRestarts;
+  } else {
+    *index_type = DataBlockIndexType::kBinarySearch;
+    *num_restarts = block_footer;
+  }
+}
+
+void DataBlockHashIndexBuilder::Initialize(double util_ratio) {
+  if (util_ratio <= 0) {
+    util_ratio = 0.75;
+  }
+  bucket_per_key_ = 1 / util_ratio;
+  valid_ = true;
+}
+
+void DataBlockHashIndexBuilder::Add(const Slice& key_prefix, size_t restart_index) {
+  DCHECK(Valid());
+  if (restart_index > kMaxRestartSupportedByHashIndex) {
+    valid_ = false;
+    return;
+  }
+  hash_and_restart_pairs_.emplace_back(
+      DataBlockHash(key_prefix), static_cast<uint8_t>(restart_index));
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  const auto estimated_num_buckets =
+      static_cast<size_t>(hash_and_restart_pairs_.size() * bucket_per_key_) | 1;
+  return estimated_num_buckets * sizeof(uint8_t) + sizeof(uint16_t);
+}
+
+void DataBlockHashIndexBuilder::Finish(std::string* buffer) {
+  DCHECK(Valid());
+  // Odd number of buckets gives better distribution.
+  const auto num_buckets = static_cast<uint16_t>(std::min<size_t>(
+      static_cast<size_t>(hash_and_restart_pairs_.size() * bucket_per_key_) | 1,
+      std::numeric_limits<uint16_t>::max()));
+
+  std::vector<uint8_t> buckets(num_buckets, kDataBlockHashIndexNoEntry);
+  for (const auto& [hash, restart_index] : hash_and_restart_pairs_) {
+    auto& bucket = buckets[hash % num_buckets];
+    if (bucket == kDataBlockHashIndexNoEntry) {
+      bucket = restart_index;
+    } else if (bucket != restart_index) {
+      bucket = kDataBlockHashIndexCollision;
+    }
+  }
+
+  buffer->append(reinterpret_cast<const char*>(buckets.data()), num_buckets);
+  PutFixed16(buffer, num_buckets);
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  hash_and_restart_pairs_.clear();
+  valid_ = bucket_per_key_ > 0;
+}
+
+bool DataBlockHashIndex::Initialize(const char* data, uint32_t data_size, uint32_t* map_offset) {
+  if (data_size < sizeof(uint16_t)) {
+    return false;
+  }
+  num_buckets_ = DecodeFixed16(data + data_size - sizeof(uint16_t));
+  if (num_buckets_ == 0 || data_size < sizeof(uint16_t) + num_buckets_) {
+    num_buckets_ = 0;
+    return false;
+  }
+  *map_offset = static_cast<uint32_t>(data_size - sizeof(uint16_t) - num_buckets_);
+  return true;
+}
+
+uint8_t DataBlockHashIndex::Lookup(
+    const char* data, uint32_t map_offset, const Slice& key_prefix) const {
+  DCHECK(Valid());
+  const auto idx = DataBlockHash(key_prefix) % num_buckets_;
+  return static_cast<uint8_t>(data[map_offset + idx]);
+}
+
+} // namespace rocksdb
@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/rocksdb/table.h"
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+// Data block hash index is an optional part of the data block which maps hash of the key prefix
+// (extracted by BlockBasedTableOptions::data_block_hash_index_key_transformer, for DocDB it is
+// the encoded DocKey) to the restart interval containing the first key with such prefix. It allows
+// point lookups to skip binary search over restart points.
+//
+// Block layout with hash index:
+//     <entries>
+//     restarts: uint32[num_restarts]
+//     buckets: uint8[num_buckets]
+//     num_buckets: uint16
+//     footer: uint32 - the most significant bit is set to indicate hash index presence, the
+//                      rest bits hold num_restarts.
+//
+// Each bucket holds the index of restart interval or one of the special values kNoEntry
+// and kCollision. Only blocks with at most kMaxRestartSupportedByHashIndex restarts get the hash
+// index, other blocks are written in the regular format.
+
+constexpr uint8_t kDataBlockHashIndexNoEntry = 255;
+constexpr uint8_t kDataBlockHashIndexCollision = 254;
+constexpr uint8_t kMaxRestartSupportedByHashIndex = 253;
+
+// Number of restarts in a block is limited, so the most significant bit of the footer is used to
+// mark blocks with hash index.
+constexpr uint32_t kDataBlockHashIndexFooterFlag = 1u << 31;
+constexpr uint32_t kMaxNumRestarts = kDataBlockHashIndexFooterFlag - 1;
+
+uint32_t PackIndexTypeAndNumRestarts(DataBlockIndexType index_type, uint32_t num_restarts);
+
+void UnpackIndexTypeAndNumRestarts(
+    uint32_t block_footer, DataBlockIndexType* index_type, uint32_t* num_restarts);
+
+class DataBlockHashIndexBuilder {
+ public:
+  void Initialize(double util_ratio);
+
+  bool Valid() const { return valid_ && bucket_per_key_ > 0; }
+
+  // Adds key prefix which first occurs in restart interval with specified index.
+  // Prefixes should be added only once per block.
+  void Add(const Slice& key_prefix, size_t restart_index);
+
+  // Appends buckets and num_buckets to the buffer.
+  void Finish(std::string* buffer);
+
+  // Returns estimated size of the hash index appended on Finish.
+  size_t EstimateSize() const;
+
+  void Reset();
+
+ private:
+  double bucket_per_key_ = -1; // Negative value means hash index is disabled.
+  bool valid_ = false;
+  std::vector<std::pair<uint32_t, uint8_t>> hash_and_restart_pairs_;
+};
+
+class DataBlockHashIndex {
+ public:
+  // Initializes index from block data, hash index is located right before the block footer.
+  // data_size is the size of block data without footer.
+  // Sets *map_offset to the offset of buckets within the block data.
+  // Returns false if index is corrupted.
+  bool Initialize(const char* data, uint32_t data_size, uint32_t* map_offset);
+
+  // Returns restart index for the key prefix or kDataBlockHashIndexNoEntry /
+  // kDataBlockHashIndexCollision.
+  uint8_t Lookup(const char* data, uint32_t map_offset, const Slice& key_prefix) const;
+
+  bool Valid() const { return num_buckets_ != 0; }
+
+ private:
+  uint16_t num_buckets_ = 0;
+};
+
+} // namespace rocksdb
@@ -97,6 +97,10 @@ class FilteringIterator : public InternalIterator {
     return iterator_->GetProperty(std::move(prop_name), prop);
   }
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    iterator_->PrefetchForSeeks(sorted_targets);
+  }
+
   bool ScanForward(
       const Comparator* user_key_comparator, const Slice& upperbound,
       KeyFilterCallback* key_filter_callback, ScanCallback* scan_callback) override {
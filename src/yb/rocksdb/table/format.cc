@@ -28,6 +28,7 @@
 #include <string>
 
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/crc32c.h"
@@ -35,6 +36,7 @@
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/xxhash.h"
 
+#include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/env.h"
 #include "yb/util/mem_tracker.h"
@@ -346,6 +348,24 @@ Status VerifyBlockChecksum(
   return Status::OK();
 }
 
+// Checks that read_result contains the whole block with its trailer, and verifies the block
+// checksum when requested.
+Status ValidateBlockRead(
+    RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
+    const BlockHandle& handle, const Slice& read_result) {
+  const size_t expected_read_size = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+  if (read_result.size() != expected_read_size) {
+    return STATUS_FORMAT(
+        Corruption, "Truncated block read in file: $0, block handle: $1, expected size: $2",
+        file->file()->filename(), handle.ToDebugString(), expected_read_size);
+  }
+
+  if (options.verify_checksums) {
+    return VerifyBlockChecksum(file, footer, handle, read_result.cdata(), handle.size());
+  }
+  return Status::OK();
+}
+
 // Read a block and check its CRC. When this function returns, *contents will contain the result of
 // reading.
 Status ReadBlock(
@@ -359,32 +379,21 @@ Status ReadBlock(
     struct BlockChecksumValidator : public yb::ReadValidator {
       BlockChecksumValidator(
           RandomAccessFileReader* file_, const Footer& footer_, const ReadOptions& options_,
-          const BlockHandle& handle_, size_t expected_read_size_)
+          const BlockHandle& handle_)
           : file(file_),
             footer(footer_),
             options(options_),
-            handle(handle_),
-            expected_read_size(expected_read_size_) {}
+            handle(handle_) {}
 
       Status Validate(const Slice& read_result) const override {
-        if (read_result.size() != expected_read_size) {
-          return STATUS_FORMAT(
-              Corruption, "Truncated block read in file: $0, block handle: $1, expected size: $2",
-              file->file()->filename(), handle.ToDebugString(), expected_read_size);
-        }
-
-        if (options.verify_checksums) {
-          return VerifyBlockChecksum(file, footer, handle, read_result.cdata(), handle.size());
-        }
-        return Status::OK();
+        return ValidateBlockRead(file, footer, options, handle, read_result);
       };
 
       RandomAccessFileReader* file;
       const Footer& footer;
       const ReadOptions& options;
       const BlockHandle& handle;
-      const size_t expected_read_size;
-    } validator(file, footer, options, handle, expected_read_size);
+    } validator(file, footer, options, handle);
 
     s = file->ReadAndValidate(handle.offset(), expected_read_size, contents, buf, validator);
   }
@@ -395,6 +404,35 @@ Status ReadBlock(
   return s;
 }
 
+// Fills contents from the block read to used_buf, slice is the result of the read. heap_buf is
+// either null or holds used_buf, in the latter case its ownership is passed to contents.
+Status FinishBlockContents(
+    const Slice& slice, size_t n, const char* used_buf, std::unique_ptr<char[]>* heap_buf,
+    const Footer& footer, const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+    const Slice& compression_dict, BlockContents* contents) {
+  PERF_TIMER_GUARD(block_decompress_time);
+
+  auto compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
+
+  if (decompression_requested && compression_type != kNoCompression) {
+    return UncompressBlockContents(
+        slice.cdata(), n, contents, footer.version(), mem_tracker, compression_dict);
+  }
+
+  if (slice.cdata() != used_buf) {
+    *contents = BlockContents(Slice(slice.data(), n), false, compression_type);
+    return Status::OK();
+  }
+
+  if (!*heap_buf) {
+    heap_buf->reset(new char[n]);
+    memcpy(heap_buf->get(), used_buf, n);
+  }
+
+  *contents = BlockContents(std::move(*heap_buf), n, true, compression_type, mem_tracker);
+  return Status::OK();
+}
+
 }  // namespace
 
 TrackedAllocation::TrackedAllocation()
@@ -439,14 +477,15 @@ BlockContents::BlockContents(
 Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
                          const ReadOptions& options, const BlockHandle& handle,
                          BlockContents* contents, Env* env,
-                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested) {
+                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                         const Slice& compression_dict, SecondaryCache* secondary_cache,
+                         const Slice& secondary_cache_key) {
   Status status;
   Slice slice;
   size_t n = static_cast<size_t>(handle.size());
   std::unique_ptr<char[]> heap_buf;
   char stack_buf[DefaultStackBufferSize];
   char* used_buf = nullptr;
-  rocksdb::CompressionType compression_type;
 
   if (decompression_requested &&
       n + kBlockTrailerSize < DefaultStackBufferSize) {
@@ -458,33 +497,106 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
     used_buf = heap_buf.get();
   }
 
-  status = ReadBlock(file, footer, options, handle, &slice, used_buf);
+  // Secondary cache keeps the block data followed by the compression type, so the rest of the
+  // block trailer is not stored. The checksum was verified before the block was inserted.
+  const size_t secondary_cache_value_size = n + 1;
+  if (secondary_cache != nullptr &&
+      secondary_cache->Lookup(secondary_cache_key, secondary_cache_value_size, used_buf)) {
+    slice = Slice(used_buf, secondary_cache_value_size);
+  } else {
+    status = ReadBlock(file, footer, options, handle, &slice, used_buf);
 
-  if (!status.ok()) {
-    LOG(ERROR) << __func__ << ": " << status << "\n" << yb::GetStackTrace();
-    return status;
-  }
+    if (!status.ok()) {
+      LOG(ERROR) << __func__ << ": " << status << "\n" << yb::GetStackTrace();
+      return status;
+    }
 
-  PERF_TIMER_GUARD(block_decompress_time);
+    if (secondary_cache != nullptr) {
+      secondary_cache->Insert(secondary_cache_key, Slice(slice.data(), secondary_cache_value_size));
+    }
+  }
 
-  compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
+  return FinishBlockContents(
+      slice, n, used_buf, &heap_buf, footer, mem_tracker, decompression_requested,
+      compression_dict, contents);
+}
 
-  if (decompression_requested && compression_type != kNoCompression) {
-    return UncompressBlockContents(slice.cdata(), n, contents, footer.version(), mem_tracker);
+void MultiReadBlockContents(
+    RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
+    const std::vector<BlockHandle>& handles, const yb::MemTrackerPtr& mem_tracker,
+    bool decompression_requested, const Slice& compression_dict,
+    SecondaryCache* secondary_cache, const std::vector<Slice>& secondary_cache_keys,
+    std::vector<BlockContents>* contents, std::vector<Status>* statuses) {
+  const size_t count = handles.size();
+  contents->resize(count);
+  statuses->resize(count);
+  std::vector<std::unique_ptr<char[]>> bufs(count);
+  std::vector<Slice> slices(count);
+
+  // Blocks found in the secondary cache are not read from the file.
+  std::vector<RandomAccessFile::ReadRequest> requests;
+  std::vector<size_t> request_blocks;
+  requests.reserve(count);
+  request_blocks.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    const size_t n = static_cast<size_t>(handles[i].size());
+    bufs[i].reset(new char[n + kBlockTrailerSize]);
+    if (secondary_cache != nullptr &&
+        secondary_cache->Lookup(secondary_cache_keys[i], n + 1, bufs[i].get())) {
+      slices[i] = Slice(bufs[i].get(), n + 1);
+      continue;
+    }
+    requests.push_back(RandomAccessFile::ReadRequest {
+      .offset = handles[i].offset(),
+      .n = n + kBlockTrailerSize,
+      .scratch = pointer_cast<uint8_t*>(bufs[i].get()),
+    });
+    request_blocks.push_back(i);
   }
 
-  if (slice.cdata() != used_buf) {
-    *contents = BlockContents(Slice(slice.data(), n), false, compression_type);
-    return status;
+  if (!requests.empty()) {
+    PERF_TIMER_GUARD(block_read_time);
+    file->MultiRead(requests.data(), requests.size());
   }
 
-  if (used_buf == &stack_buf[0]) {
-    heap_buf = std::unique_ptr<char[]>(new char[n]);
-    memcpy(heap_buf.get(), stack_buf, n);
+  for (size_t r = 0; r != requests.size(); ++r) {
+    const auto i = request_blocks[r];
+    auto& request = requests[r];
+    PERF_COUNTER_ADD(block_read_count, 1);
+    PERF_COUNTER_ADD(block_read_byte, request.n);
+    auto& status = (*statuses)[i];
+    status = request.status;
+    if (status.ok()) {
+      status = ValidateBlockRead(file, footer, options, handles[i], request.result);
+    }
+    if (!status.ok()) {
+      // Retry with a regular read, that also handles files which have to validate the read
+      // themselves, like encrypted ones.
+      VLOG(1) << "Multi read of block " << handles[i].ToDebugString() << " from "
+              << file->file()->filename() << " failed: " << status << ", reading it again";
+      status = ReadBlockContents(
+          file, footer, options, handles[i], &(*contents)[i], /* env= */ nullptr, mem_tracker,
+          decompression_requested, compression_dict, secondary_cache,
+          secondary_cache != nullptr ? secondary_cache_keys[i] : Slice());
+      bufs[i].reset();
+      continue;
+    }
+    slices[i] = request.result;
+    if (secondary_cache != nullptr) {
+      secondary_cache->Insert(
+          secondary_cache_keys[i], Slice(slices[i].data(), handles[i].size() + 1));
+    }
   }
 
-  *contents = BlockContents(std::move(heap_buf), n, true, compression_type, mem_tracker);
-  return status;
+  for (size_t i = 0; i != count; ++i) {
+    if (!bufs[i]) {
+      continue;
+    }
+    const char* used_buf = bufs[i].get();
+    (*statuses)[i] = FinishBlockContents(
+        slices[i], static_cast<size_t>(handles[i].size()), used_buf, &bufs[i], footer,
+        mem_tracker, decompression_requested, compression_dict, &(*contents)[i]);
+  }
 }
 
 //
@@ -497,7 +609,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents,
                                uint32_t format_version,
-                               const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               const Slice& compression_dict) {
   std::unique_ptr<char[]> ubuf;
   int decompress_size = 0;
   assert(data[n] != kNoCompression);
@@ -543,7 +656,7 @@ Status UncompressBlockContents(const char* data, size_t n,
     case kLZ4Compression:
       ubuf = std::unique_ptr<char[]>(LZ4_Uncompress(
           data, n, &decompress_size,
-          GetCompressFormatForVersion(kLZ4Compression, format_version)));
+          GetCompressFormatForVersion(kLZ4Compression, format_version), compression_dict));
       if (!ubuf) {
         static char lz4_corrupt_msg[] =
           "LZ4 not supported or corrupted LZ4 compressed block contents";
@@ -555,7 +668,7 @@ Status UncompressBlockContents(const char* data, size_t n,
     case kLZ4HCCompression:
       ubuf = std::unique_ptr<char[]>(LZ4_Uncompress(
           data, n, &decompress_size,
-          GetCompressFormatForVersion(kLZ4HCCompression, format_version)));
+          GetCompressFormatForVersion(kLZ4HCCompression, format_version), compression_dict));
       if (!ubuf) {
         static char lz4hc_corrupt_msg[] =
           "LZ4HC not supported or corrupted LZ4HC compressed block contents";
@@ -25,6 +25,8 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
+
 #include "yb/util/slice.h"
 #include "yb/rocksdb/status.h"
 #include "yb/rocksdb/options.h"
@@ -39,6 +41,7 @@ class MemTracker;
 namespace rocksdb {
 
 class Block;
+class SecondaryCache;
 struct ReadOptions;
 
 // the length of the magic number in bytes.
@@ -249,13 +252,35 @@ struct BlockContents {
 
 // Read the block identified by "handle" from "file".  On failure
 // return non-OK.  On success fill *result and return OK.
+// compression_dict is the dictionary the block was compressed with, if any.
+// If secondary_cache is specified, the block is looked up there by secondary_cache_key before
+// reading the file, and a block read from the file is stored there.
 extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const Footer& footer,
                                 const ReadOptions& options,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const Slice& compression_dict = Slice(),
+                                SecondaryCache* secondary_cache = nullptr,
+                                const Slice& secondary_cache_key = Slice());
+
+// Reads the blocks identified by "handles" from "file" with a single RandomAccessFile::MultiRead
+// call, so the file could issue all the reads at once. Result is the same as of ReadBlockContents
+// for each block, the block and the status of handles[i] are stored to (*contents)[i] and
+// (*statuses)[i]. secondary_cache_keys are used only when secondary_cache is specified.
+extern void MultiReadBlockContents(RandomAccessFileReader* file,
+                                   const Footer& footer,
+                                   const ReadOptions& options,
+                                   const std::vector<BlockHandle>& handles,
+                                   const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                   bool do_uncompress,
+                                   const Slice& compression_dict,
+                                   SecondaryCache* secondary_cache,
+                                   const std::vector<Slice>& secondary_cache_keys,
+                                   std::vector<BlockContents>* contents,
+                                   std::vector<Status>* statuses);
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -267,7 +292,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const Slice& compression_dict = Slice());
 
 // Implementation details follow.  Clients should ignore,
 
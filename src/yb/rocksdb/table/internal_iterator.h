@@ -21,6 +21,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/status.h"
 
@@ -100,6 +102,9 @@ class InternalIterator : public Cleanable {
     return STATUS(NotSupported, "");
   }
 
+  // See Iterator::PrefetchForSeeks, sorted_targets are internal keys.
+  virtual void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {}
+
   // Iterate over the key-values and call the callback functions, until:
   // 1. Provided upper bound is reached (optional)
   // 2. Iterator upper bound is reached (if present)
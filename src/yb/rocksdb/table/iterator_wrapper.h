@@ -126,6 +126,10 @@ class IteratorWrapper {
   void Seek(const Slice& k) { assert(iter_); iter_->Seek(k);       Update(); }
   void SeekToFirst()        { assert(iter_); iter_->SeekToFirst(); Update(); }
   void SeekToLast()         { assert(iter_); iter_->SeekToLast();  Update(); }
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {
+    assert(iter_);
+    iter_->PrefetchForSeeks(sorted_targets);
+  }
   bool ScanForward(
       const Comparator* user_key_comparator, const Slice& upperbound,
       KeyFilterCallback* key_filter_callback, ScanCallback* scan_callback) {
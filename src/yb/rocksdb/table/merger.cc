@@ -321,6 +321,12 @@ class MergingIterator : public InternalIterator {
     return current_->IsKeyPinned();
   }
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    for (auto& child : children_) {
+      child.PrefetchForSeeks(sorted_targets);
+    }
+  }
+
   bool ScanForward(
       const Comparator* user_key_comparator, const Slice& upperbound,
       KeyFilterCallback* key_filter_callback, ScanCallback* scan_callback) override {
@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -66,13 +67,15 @@ struct TableBuilderOptions {
       const IntTblPropCollectorFactories& _int_tbl_prop_collector_factories,
       CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
-      bool _skip_filters)
+      bool _skip_filters,
+      std::shared_ptr<const std::string> _compression_dict = nullptr)
       : ioptions(_ioptions),
         internal_comparator(_internal_comparator),
         int_tbl_prop_collector_factories(&_int_tbl_prop_collector_factories),
         compression_type(_compression_type),
         compression_opts(_compression_opts),
-        skip_filters(_skip_filters) {}
+        skip_filters(_skip_filters),
+        compression_dict(std::move(_compression_dict)) {}
 
   const ImmutableCFOptions& ioptions;
   InternalKeyComparatorPtr internal_comparator;
@@ -81,6 +84,8 @@ struct TableBuilderOptions {
   const CompressionOptions& compression_opts;
   // This is only used for BlockBasedTableBuilder
   bool skip_filters = false;
+  // Preset dictionary for data blocks compression, nullptr if dictionary is not used.
+  std::shared_ptr<const std::string> compression_dict;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -133,6 +138,10 @@ class TableBuilder {
   virtual TableProperties GetTableProperties() const = 0;
 
   virtual const std::string& LastKey() const = 0;
+
+  // Raw data samples collected while building the table, which could be used as a compression
+  // dictionary for subsequently built tables. Empty if samples were not collected.
+  virtual Slice CompressionDictSamples() const { return Slice(); }
 };
 
 }  // namespace rocksdb
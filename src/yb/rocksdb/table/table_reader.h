@@ -24,6 +24,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/rocksdb/status.h"
 
@@ -123,6 +125,12 @@ class TableReader {
   virtual yb::Result<std::string> GetMiddleKey() {
     return STATUS(NotSupported, "GetMiddleKey() not supported");
   }
+
+  // Returns up to max_keys existing internal keys, in key order, which split SST file into parts of
+  // roughly the same size.
+  virtual yb::Result<std::vector<std::string>> GetSampleKeys(size_t max_keys) {
+    return STATUS(NotSupported, "GetSampleKeys() not supported");
+  }
 };
 
 }  // namespace rocksdb
@@ -25,6 +25,7 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -43,6 +44,7 @@
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/perf_context.h"
+#include "yb/rocksdb/secondary_cache.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
@@ -74,6 +76,7 @@ using std::unique_ptr;
 using namespace std::literals;
 
 DECLARE_double(cache_single_touch_ratio);
+DECLARE_bool(enable_io_uring);
 
 namespace rocksdb {
 
@@ -361,8 +364,8 @@ class TableConstructor: public Constructor {
   }
 
   virtual Status Reopen(const ImmutableCFOptions& ioptions) {
-    file_reader_.reset(test::GetRandomAccessFileReader(new test::StringSource(
-        GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads)));
+    source_ = new test::StringSource(GetSink()->contents(), uniq_id_, ioptions.allow_mmap_reads);
+    file_reader_.reset(test::GetRandomAccessFileReader(source_));
     return ioptions.table_factory->NewTableReader(
         TableReaderOptions(ioptions, soptions, last_internal_key_),
         std::move(file_reader_), GetSink()->contents().size(), &table_reader_);
@@ -372,6 +375,15 @@ class TableConstructor: public Constructor {
     return table_reader_.get();
   }
 
+  const std::string& file_contents() {
+    return GetSink()->contents();
+  }
+
+  // Source of the table reader opened by the last Reopen.
+  test::StringSource* source() const {
+    return source_;
+  }
+
   bool AnywayDeleteIterator() const override {
     return convert_to_internal_key_;
   }
@@ -385,6 +397,7 @@ class TableConstructor: public Constructor {
  private:
   void Reset() {
     uniq_id_ = 0;
+    source_ = nullptr;
     table_reader_.reset();
     file_writer_.reset();
     file_reader_.reset();
@@ -395,6 +408,7 @@ class TableConstructor: public Constructor {
   }
 
   uint64_t uniq_id_;
+  test::StringSource* source_ = nullptr;
   unique_ptr<WritableFileWriter> file_writer_;
   unique_ptr<RandomAccessFileReader> file_reader_;
   unique_ptr<TableReader> table_reader_;
@@ -1137,6 +1151,28 @@ void PrefetchRange(TableConstructor* c, Options* opt,
   AssertKeysInCache(table_reader, keys_in_cache, keys_not_in_cache);
 }
 
+void PrefetchForSeeks(TableConstructor* c, Options* opt,
+                      BlockBasedTableOptions* table_options,
+                      const std::vector<std::string>& targets,
+                      const std::vector<std::string>& keys_in_cache,
+                      const std::vector<std::string>& keys_not_in_cache) {
+  // reset the cache and reopen the table
+  table_options->block_cache =
+      NewLRUCache((16 * 1024 * 1024) / FLAGS_cache_single_touch_ratio);
+  opt->table_factory.reset(NewBlockBasedTableFactory(*table_options));
+  const ImmutableCFOptions ioptions2(*opt);
+  ASSERT_OK(c->Reopen(ioptions2));
+
+  // prefetch through the table iterator
+  auto* table_reader = dynamic_cast<BlockBasedTable*>(c->GetTableReader());
+  std::unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions::kDefault));
+  std::vector<Slice> sorted_targets(targets.begin(), targets.end());
+  iter->PrefetchForSeeks(sorted_targets);
+
+  // assert our expectation in cache warmup
+  AssertKeysInCache(table_reader, keys_in_cache, keys_not_in_cache);
+}
+
 TEST_F(BlockBasedTableTest, PrefetchTest) {
   // The purpose of this test is to test the prefetching operation built into
   // BlockBasedTable.
@@ -1217,6 +1253,104 @@ TEST_F(BlockBasedTableTest, PrefetchTest) {
   PrefetchRange(&c, &opt, &table_options, keys,
                 "k06", "k00", {}, {},
                 STATUS(InvalidArgument, Slice("k06 "), Slice("k07")));
+
+  // Prefetch for seeks loads only blocks that contain the targets.
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   /*targets=*/ {"k01", "k02", "k06"},
+                   /*keys_in_cache=*/ {"k01", "k02", "k03", "k06", "k07"},
+                   /*keys_not_in_cache=*/ {"k04", "k05"});
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {"k00", "k04", "k05", "k06"},
+                   {"k01", "k02", "k03", "k04", "k05", "k06", "k07"},
+                   {});
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {"k045", "z"},
+                   {"k05"},
+                   {"k01", "k02", "k03", "k04", "k06", "k07"});
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {},
+                   {},
+                   {"k01", "k02", "k03", "k04", "k05", "k06", "k07"});
+
+  // With io_uring enabled, blocks missing from the block cache are read by a single multi read.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_enable_io_uring) = true;
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {"k01", "k02", "k06"},
+                   {"k01", "k02", "k03", "k06", "k07"},
+                   {"k04", "k05"});
+  ASSERT_EQ(c.source()->total_multi_reads(), 1);
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {"k00", "k04", "k05", "k06"},
+                   {"k01", "k02", "k03", "k04", "k05", "k06", "k07"},
+                   {});
+  ASSERT_EQ(c.source()->total_multi_reads(), 1);
+  // A single missing block is read as usual.
+  PrefetchForSeeks(&c, &opt, &table_options,
+                   {"k045", "z"},
+                   {"k05"},
+                   {"k01", "k02", "k03", "k04", "k06", "k07"});
+  ASSERT_EQ(c.source()->total_multi_reads(), 0);
+}
+
+// Blocks read by a multi read, that fail validation, are read again with a regular read.
+TEST_F(BlockBasedTableTest, MultiReadBlockContents) {
+  Options opt;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(opt.comparator);
+  opt.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i != 100; ++i) {
+    c.Add("k" + std::to_string(1000 + i), std::string(100, static_cast<char>('a' + i % 26)));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(opt);
+  c.Finish(opt, ioptions, table_options, ikc, &keys, &kvmap);
+
+  auto* table_reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  std::unique_ptr<InternalIterator> index_iter(
+      table_reader->NewIndexIterator(ReadOptions::kDefault));
+  std::vector<BlockHandle> handles;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    Slice input = index_iter->value();
+    handles.emplace_back();
+    ASSERT_OK(handles.back().DecodeFrom(&input));
+  }
+  ASSERT_OK(index_iter->status());
+  ASSERT_GT(handles.size(), 2);
+  // Handle of the block that ends past the end of the file, so its read is truncated.
+  handles.emplace_back(c.file_contents().size() - 10, handles.back().size());
+
+  auto* source = new test::StringSource(c.file_contents(), 0, /* mmap = */ false);
+  std::unique_ptr<RandomAccessFileReader> file_reader(test::GetRandomAccessFileReader(source));
+  Footer footer;
+  ASSERT_OK(ReadFooterFromFile(
+      file_reader.get(), c.file_contents().size(), &footer, kBlockBasedTableMagicNumber));
+  source->set_total_reads(0);
+  std::vector<BlockContents> contents;
+  std::vector<Status> statuses;
+  MultiReadBlockContents(
+      file_reader.get(), footer, ReadOptions::kDefault, handles, /* mem_tracker = */ nullptr,
+      /* do_uncompress = */ true, /* compression_dict = */ Slice(),
+      /* secondary_cache = */ nullptr, /* secondary_cache_keys = */ {}, &contents, &statuses);
+  ASSERT_EQ(source->total_multi_reads(), 1);
+  // Each block is read once, and the truncated one is read again.
+  ASSERT_EQ(source->total_reads(), static_cast<int>(handles.size()) + 1);
+  ASSERT_EQ(contents.size(), handles.size());
+  ASSERT_EQ(statuses.size(), handles.size());
+
+  for (size_t i = 0; i + 1 != handles.size(); ++i) {
+    ASSERT_OK(statuses[i]);
+    BlockContents expected;
+    ASSERT_OK(ReadBlockContents(
+        file_reader.get(), footer, ReadOptions::kDefault, handles[i], &expected,
+        /* env = */ nullptr, /* mem_tracker = */ nullptr, /* do_uncompress = */ true));
+    ASSERT_EQ(contents[i].data.ToBuffer(), expected.data.ToBuffer());
+  }
+  ASSERT_TRUE(statuses.back().IsCorruption()) << statuses.back();
 }
 
 void TableTest::TestTotalOrderSeekOnHashIndex(
@@ -2028,6 +2162,123 @@ TEST_F(BlockBasedTableTest, BlockCacheLeak) {
   }
 }
 
+namespace {
+
+class CountingSecondaryCache : public SecondaryCache {
+ public:
+  explicit CountingSecondaryCache(std::shared_ptr<SecondaryCache> target)
+      : target_(std::move(target)) {}
+
+  void Insert(const Slice& key, const Slice& value) override {
+    ++inserts_;
+    target_->Insert(key, value);
+  }
+
+  void Flush() override {
+    target_->Flush();
+  }
+
+  bool Lookup(const Slice& key, size_t expected_size, char* scratch) override {
+    auto result = target_->Lookup(key, expected_size, scratch);
+    ++(result ? hits_ : misses_);
+    return result;
+  }
+
+  void Erase(const Slice& key) override {
+    target_->Erase(key);
+  }
+
+  uint64_t NewId() override {
+    return target_->NewId();
+  }
+
+  size_t GetCapacity() const override {
+    return target_->GetCapacity();
+  }
+
+  size_t GetUsage() const override {
+    return target_->GetUsage();
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    target_->SetMetrics(entity);
+  }
+
+  size_t inserts() const { return inserts_; }
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  std::shared_ptr<SecondaryCache> target_;
+  std::atomic<size_t> inserts_{0};
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+};
+
+void ReadAllAndCheck(TableConstructor* c, const stl_wrappers::KVMap& kvmap) {
+  std::unique_ptr<InternalIterator> iter(c->NewIterator());
+  auto expected = kvmap.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected) {
+    ASSERT_NE(expected, kvmap.end());
+    ASSERT_EQ(expected->first, iter->key().ToBuffer());
+    ASSERT_EQ(expected->second, iter->value().ToBuffer());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(expected, kvmap.end());
+}
+
+} // namespace
+
+TEST_F(BlockBasedTableTest, SecondaryBlockCache) {
+  Options opt;
+  auto ikc = std::make_shared<test::PlainInternalKeyComparator>(opt.comparator);
+  opt.compression = kNoCompression;
+
+  FileSecondaryCacheOptions cache_options;
+  cache_options.path = test::TmpDir() + "/table_test_secondary_block_cache";
+  cache_options.capacity = 16 * 1024 * 1024;
+  cache_options.segment_size = 1024 * 1024;
+  cache_options.num_shard_bits = 0;
+  std::shared_ptr<SecondaryCache> file_cache;
+  ASSERT_OK(NewFileSecondaryCache(cache_options, &file_cache));
+  auto secondary_cache = std::make_shared<CountingSecondaryCache>(file_cache);
+
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.block_cache = NewLRUCache(16 * 1024 * 1024);
+  table_options.secondary_block_cache = secondary_cache;
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  TableConstructor c(BytewiseComparator());
+  Random rnd(301);
+  for (int i = 0; i != 200; ++i) {
+    c.Add("k" + std::to_string(1000 + i), RandomString(&rnd, 100));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(opt);
+  c.Finish(opt, ioptions, table_options, ikc, &keys, &kvmap);
+
+  // Blocks read from the file go to the secondary cache.
+  ASSERT_NO_FATALS(ReadAllAndCheck(&c, kvmap));
+  secondary_cache->Flush();
+  const auto num_inserts = secondary_cache->inserts();
+  const auto num_misses = secondary_cache->misses();
+  ASSERT_GT(num_inserts, 10);
+  ASSERT_EQ(0, secondary_cache->hits());
+  ASSERT_GT(file_cache->GetUsage(), 0);
+
+  // Blocks missing in the new block cache are read from the secondary cache.
+  table_options.block_cache = NewLRUCache(16 * 1024 * 1024);
+  opt.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions2(opt);
+  ASSERT_OK(c.Reopen(ioptions2));
+  ASSERT_NO_FATALS(ReadAllAndCheck(&c, kvmap));
+  ASSERT_GE(secondary_cache->hits(), num_inserts);
+  ASSERT_EQ(num_misses, secondary_cache->misses());
+  ASSERT_EQ(num_inserts, secondary_cache->inserts());
+}
+
 std::string GenerateKey(int primary_key, int secondary_key, int padding_size, Random* rnd) {
   char buf[50];
   char* p = &buf[0];
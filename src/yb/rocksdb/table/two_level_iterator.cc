@@ -85,6 +85,10 @@ class TwoLevelIterator : public InternalIterator {
       const Comparator* user_key_comparator, const Slice& upperbound,
       KeyFilterCallback* key_filter_callback, ScanCallback* scan_callback) override;
 
+  void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) override {
+    state_->PrefetchForSeeks(sorted_targets);
+  }
+
  private:
   void SaveError(const Status& s) {
     if (status_.ok() && !s.ok()) status_ = s;
@@ -40,6 +40,9 @@ struct TwoLevelIteratorState {
   virtual InternalIterator* NewSecondaryIterator(const Slice& handle) = 0;
   virtual bool PrefixMayMatch(const Slice& internal_key) = 0;
 
+  // See InternalIterator::PrefetchForSeeks.
+  virtual void PrefetchForSeeks(const std::vector<Slice>& sorted_targets) {}
+
   // If call PrefixMayMatch()
   bool check_prefix_may_match;
 };
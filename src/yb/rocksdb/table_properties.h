@@ -109,6 +109,8 @@ struct TablePropertiesNames {
 };
 
 extern const std::string kPropertiesBlock;
+// Meta block holding the dictionary used to compress data blocks of the table.
+extern const std::string kCompressionDictBlock;
 
 enum EntryType {
   kEntryPut,
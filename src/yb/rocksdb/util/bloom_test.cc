@@ -236,7 +236,25 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
           nullptr)};
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+class FixedSizeRibbonFilterTestContext : public BloomTestContext {
+ public:
+  const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
+
+  size_t max_keys() const override { return std::numeric_limits<size_t>::max(); }
+
+  void CheckFilterSize(size_t filter_size, size_t num_keys) const override {
+    ASSERT_LE(filter_size, FilterPolicy::kDefaultFixedSizeFilterBits / 8 + 7) << num_keys;
+  }
+
+ private:
+  std::unique_ptr<const FilterPolicy> filter_policy_{
+      NewFixedSizeRibbonFilterPolicy(
+          FilterPolicy::kDefaultFixedSizeFilterBits,
+          FilterPolicy::kDefaultFixedSizeFilterErrorRate)};
+};
+
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+    (kFullFilter)(kFixedSizeFilter)(kFixedSizeRibbonFilter));
 
 namespace {
 
@@ -246,6 +264,8 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
       return std::make_unique<FixedSizeFilterBloomTestContext>();
+    case BuilderReaderBloomTestType::kFixedSizeRibbonFilter:
+      return std::make_unique<FixedSizeRibbonFilterTestContext>();
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -372,9 +392,32 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
   ASSERT_LE(mediocre_filters, good_filters/5);
 }
 
+TEST_F(BloomTest, FixedSizeRibbonFilterCapacity) {
+  auto count_keys_until_full = [](const FilterPolicy& policy) {
+    std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+    char buffer[sizeof(size_t)];
+    size_t num_keys = 0;
+    while (!builder->IsFull()) {
+      builder->AddKey(Key(num_keys++, buffer));
+    }
+    return num_keys;
+  };
+  std::unique_ptr<const FilterPolicy> bloom_policy(NewFixedSizeFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr));
+  std::unique_ptr<const FilterPolicy> ribbon_policy(NewFixedSizeRibbonFilterPolicy(
+      FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate));
+  const auto bloom_keys = count_keys_until_full(*bloom_policy);
+  const auto ribbon_keys = count_keys_until_full(*ribbon_policy);
+  LOG(INFO) << "Keys per filter block, bloom: " << bloom_keys << ", ribbon: " << ribbon_keys;
+  // Ribbon filter with lower false positive rate should still fit more keys into the same space.
+  ASSERT_GE(ribbon_keys, bloom_keys * 5 / 4);
+}
+
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFixedSizeRibbonFilter));
 
 }  // namespace rocksdb
 
@@ -0,0 +1,927 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// CLOCK cache implementation.
+//
+// Each shard keeps its entries in a fixed size open addressing table with double hashing. The
+// state of a slot together with its reference counter, CLOCK countdown and sub cache type are
+// packed into a single atomic word, so Lookup and Release are a few atomic operations on the
+// slot, without taking any mutex.
+//
+// Scan resistance follows the same rules as the LRU cache: an entry is promoted from the single
+// touch sub cache into the multi touch sub cache only when it is touched by a query different
+// from the one that added it. The CLOCK hand skips multi touch entries while the multi touch
+// sub cache fits its capacity, so entries brought in by a large scan are evicted first and
+// could not wash out the frequently used blocks.
+//
+// Slot life cycle:
+//   kEmpty -> kConstruction: Insert claims the slot.
+//   kConstruction -> kVisible: Insert has filled the slot and publishes it.
+//   kVisible -> kInvisible: Erase or Insert with the same key, the entry is freed by the last
+//                           Release.
+//   kVisible/kInvisible -> kConstruction: the thread that removes an unreferenced entry takes
+//                                         exclusive ownership of the slot to free it.
+//   kConstruction -> kEmpty: the entry is freed.
+//
+// Readers could speculatively increment the reference counter of a slot in any state, so state
+// transitions never overwrite the reference counter.
+//
+// When all slots of the table are occupied by pinned entries, a cache without strict capacity limit
+// still accepts the insert: the entry is allocated outside of the table as a detached handle. It is
+// returned to the caller, is never found by Lookup and is freed by its last Release.
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/statistics.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/flags.h"
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+
+using std::shared_ptr;
+
+DECLARE_bool(cache_overflow_single_touch);
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+constexpr size_t kDefaultNumShardBits = 4;
+constexpr size_t kDefaultEstimatedEntryCharge = 32 * 1024;
+
+// Maximal fraction of occupied slots, double hashing performs well up to this load.
+constexpr double kMaxLoadFactor = 0.7;
+// Load factor the table is sized for.
+constexpr double kTargetLoadFactor = 0.5;
+constexpr size_t kMinTableLengthBits = 4;
+constexpr size_t kMaxTableLengthBits = 30;
+
+// Layout of the slot meta word.
+constexpr uint64_t kOneRef = 1;
+constexpr uint64_t kRefsMask = 0xffffffffULL;
+constexpr int kClockShift = 32;
+constexpr uint64_t kOneClock = 1ULL << kClockShift;
+constexpr uint64_t kClockMask = 3ULL << kClockShift;
+constexpr uint64_t kMaxClock = 3;
+constexpr uint64_t kMultiTouchBit = 1ULL << 34;
+constexpr int kStateShift = 62;
+constexpr uint64_t kStateMask = 3ULL << kStateShift;
+
+enum class SlotState : uint64_t {
+  kEmpty = 0,
+  kConstruction = 1,
+  kVisible = 2,
+  kInvisible = 3,
+};
+
+constexpr uint64_t StateBits(SlotState state) {
+  return static_cast<uint64_t>(state) << kStateShift;
+}
+
+inline SlotState GetState(uint64_t meta) {
+  return static_cast<SlotState>(meta >> kStateShift);
+}
+
+inline uint64_t GetRefs(uint64_t meta) {
+  return meta & kRefsMask;
+}
+
+inline uint64_t GetClock(uint64_t meta) {
+  return (meta & kClockMask) >> kClockShift;
+}
+
+inline SubCacheType GetSubCacheType(uint64_t meta) {
+  return (meta & kMultiTouchBit) ? MULTI_TOUCH : SINGLE_TOUCH;
+}
+
+// Replaces the state of meta, keeping the reference counter, CLOCK countdown and sub cache type.
+inline uint64_t WithState(uint64_t meta, SlotState state) {
+  return (meta & ~kStateMask) | StateBits(state);
+}
+
+struct ClockHandle {
+  std::atomic<uint64_t> meta{0};
+  // Number of entries whose probe sequence passes through this slot. Lookup stops probing at the
+  // first slot without displacements.
+  std::atomic<uint32_t> displacements{0};
+
+  // The fields below are written by the thread that owns the slot in kConstruction state and
+  // are read only by threads that hold a reference to the kVisible or kInvisible slot.
+  uint32_t hash = 0;
+  QueryId query_id = kDefaultQueryId;
+  void* value = nullptr;
+  void (*deleter)(const Slice&, void* value) = nullptr;
+  std::unique_ptr<char[]> key_data;
+  size_t key_length = 0;
+  // Atomic because GetPinnedUsage reads it without holding a reference.
+  std::atomic<size_t> charge{0};
+  // The handle was allocated outside of the table, see the comment at the top of the file.
+  bool detached = false;
+
+  Slice key() const {
+    return Slice(key_data.get(), key_length);
+  }
+};
+
+class ClockCacheShard {
+ public:
+  ClockCacheShard() = default;
+
+  ~ClockCacheShard() {
+    if (!table_) {
+      return;
+    }
+    for (size_t i = 0; i <= mask_; ++i) {
+      auto& h = table_[i];
+      auto meta = h.meta.load(std::memory_order_acquire);
+      auto state = GetState(meta);
+      if ((state == SlotState::kVisible || state == SlotState::kInvisible) &&
+          GetRefs(meta) == 0) {
+        Free(&h, meta);
+      }
+    }
+  }
+
+  // Separate from constructor so caller can easily make an array of shards.
+  void Init(size_t capacity, bool strict_capacity_limit, size_t estimated_entry_charge) {
+    const size_t expected_entries =
+        capacity / std::max<size_t>(estimated_entry_charge, 1) / kTargetLoadFactor;
+    size_t length_bits = kMinTableLengthBits;
+    while (length_bits < kMaxTableLengthBits && (1ULL << length_bits) < expected_entries) {
+      ++length_bits;
+    }
+    mask_ = (1ULL << length_bits) - 1;
+    max_occupancy_ = static_cast<size_t>((mask_ + 1) * kMaxLoadFactor);
+    table_.reset(new ClockHandle[mask_ + 1]);
+    strict_capacity_limit_ = strict_capacity_limit;
+    SetCapacity(capacity);
+  }
+
+  void SetCapacity(size_t capacity) {
+    capacity_.store(capacity, std::memory_order_relaxed);
+    multi_touch_capacity_.store(
+        static_cast<size_t>(std::round((1 - FLAGS_cache_single_touch_ratio) * capacity)),
+        std::memory_order_relaxed);
+    auto usage = usage_.load(std::memory_order_relaxed);
+    if (usage > capacity) {
+      EvictFromClock(usage - capacity);
+    }
+  }
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+                Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, QueryId query_id,
+                        Statistics* statistics);
+  void Release(ClockHandle* h, bool evict_if_over_capacity);
+  void Erase(const Slice& key, uint32_t hash);
+
+  size_t Evict(size_t required) {
+    return EvictFromClock(required);
+  }
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    size_t result = detached_usage_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i <= mask_; ++i) {
+      const auto& h = table_[i];
+      auto meta = h.meta.load(std::memory_order_relaxed);
+      auto state = GetState(meta);
+      if ((state == SlotState::kVisible || state == SlotState::kInvisible) && GetRefs(meta) > 0) {
+        result += h.charge.load(std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t));
+
+  std::pair<size_t, size_t> TEST_GetIndividualUsages() const {
+    return std::make_pair(single_touch_usage_.load(std::memory_order_relaxed),
+                          multi_touch_usage_.load(std::memory_order_relaxed));
+  }
+
+ private:
+  class ProbeSequence {
+   public:
+    ProbeSequence(uint32_t hash, size_t mask)
+        : mask_(mask), index_(hash & mask),
+          // Odd increment visits every slot of the power of two sized table.
+          increment_(((static_cast<size_t>(hash) * 0x9e3779b9ULL) >> 16) | 1) {}
+
+    size_t index() const { return index_; }
+
+    void Next() {
+      index_ = (index_ + increment_) & mask_;
+    }
+
+   private:
+    size_t mask_;
+    size_t index_;
+    size_t increment_;
+  };
+
+  // Tries to acquire a reference to the visible entry with the specified key.
+  // Returns the meta word observed when the reference was acquired, or 0 when the slot does not
+  // contain such entry.
+  uint64_t TryRef(ClockHandle* h, const Slice& key, uint32_t hash);
+
+  // Calls f for each visible entry with the specified key, holding a reference to this entry.
+  template <class F>
+  void ForEachMatch(const Slice& key, uint32_t hash, const F& f);
+
+  // Frees entry at slot h, the calling thread should own the slot in kConstruction state.
+  // meta is the meta word of the slot before it was moved to kConstruction.
+  void Free(ClockHandle* h, uint64_t meta);
+
+  // Tries to take ownership of the unreferenced slot h with meta word equal to meta and free it.
+  bool TryFree(ClockHandle* h, uint64_t meta);
+
+  // Frees the detached handle h after its last reference was released.
+  void FreeDetached(ClockHandle* h, uint64_t meta);
+
+  // Concurrent inserts of the same key could all remove the old entries before any of them
+  // publishes its own one, leaving several visible entries with this key. Keeps only the entry
+  // with the lowest address, so racing inserts agree on the surviving entry.
+  void RemoveDuplicates(const Slice& key, uint32_t hash);
+
+  // Marks visible slot h as invisible. The caller should hold reference to h.
+  void MakeInvisible(ClockHandle* h);
+
+  // Runs CLOCK sweep until at least charge_to_free bytes are evicted or there is nothing to
+  // evict. Returns number of evicted bytes.
+  size_t EvictFromClock(size_t charge_to_free);
+
+  // Promotes single touch entry to the multi touch sub cache.
+  void PromoteToMultiTouch(ClockHandle* h, uint64_t meta);
+
+  void BumpClock(ClockHandle* h, uint64_t meta);
+
+  void AddUsage(SubCacheType subcache_type, size_t charge) {
+    usage_.fetch_add(charge, std::memory_order_relaxed);
+    SubCacheUsage(subcache_type).fetch_add(charge, std::memory_order_relaxed);
+    if (metrics_) {
+      SubCacheMetric(subcache_type)->IncrementBy(charge);
+      metrics_->cache_usage->IncrementBy(charge);
+    }
+  }
+
+  void RemoveUsage(SubCacheType subcache_type, size_t charge) {
+    usage_.fetch_sub(charge, std::memory_order_relaxed);
+    SubCacheUsage(subcache_type).fetch_sub(charge, std::memory_order_relaxed);
+    if (metrics_) {
+      SubCacheMetric(subcache_type)->DecrementBy(charge);
+      metrics_->cache_usage->DecrementBy(charge);
+    }
+  }
+
+  std::atomic<size_t>& SubCacheUsage(SubCacheType subcache_type) {
+    return subcache_type == MULTI_TOUCH ? multi_touch_usage_ : single_touch_usage_;
+  }
+
+  yb::AtomicGauge<uint64_t>* SubCacheMetric(SubCacheType subcache_type) {
+    return subcache_type == MULTI_TOUCH ? metrics_->multi_touch_cache_usage.get()
+                                        : metrics_->single_touch_cache_usage.get();
+  }
+
+  size_t SubCacheCapacity(SubCacheType subcache_type) const {
+    auto capacity = capacity_.load(std::memory_order_relaxed);
+    auto multi_touch_capacity = multi_touch_capacity_.load(std::memory_order_relaxed);
+    if (subcache_type == MULTI_TOUCH) {
+      return multi_touch_capacity;
+    }
+    // Single touch entries could use space unused by multi touch entries.
+    if (!strict_capacity_limit_ && FLAGS_cache_overflow_single_touch) {
+      auto multi_touch_usage = multi_touch_usage_.load(std::memory_order_relaxed);
+      return capacity - std::min(capacity, multi_touch_usage);
+    }
+    return capacity - multi_touch_capacity;
+  }
+
+  std::unique_ptr<ClockHandle[]> table_;
+  size_t mask_ = 0;
+  size_t max_occupancy_ = 0;
+  bool strict_capacity_limit_ = false;
+
+  std::atomic<size_t> capacity_{0};
+  std::atomic<size_t> multi_touch_capacity_{0};
+  std::atomic<size_t> usage_{0};
+  std::atomic<size_t> single_touch_usage_{0};
+  std::atomic<size_t> multi_touch_usage_{0};
+  std::atomic<size_t> occupancy_{0};
+  std::atomic<size_t> clock_hand_{0};
+  // Total charge of detached handles, all of them are pinned.
+  std::atomic<size_t> detached_usage_{0};
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+uint64_t ClockCacheShard::TryRef(ClockHandle* h, const Slice& key, uint32_t hash) {
+  if (GetState(h->meta.load(std::memory_order_relaxed)) != SlotState::kVisible) {
+    return 0;
+  }
+  auto meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel) + kOneRef;
+  if (GetState(meta) == SlotState::kVisible && h->hash == hash && h->key() == key) {
+    return meta;
+  }
+  Release(h, /* evict_if_over_capacity= */ false);
+  return 0;
+}
+
+template <class F>
+void ClockCacheShard::ForEachMatch(const Slice& key, uint32_t hash, const F& f) {
+  ProbeSequence probe(hash, mask_);
+  for (size_t i = 0; i <= mask_; ++i, probe.Next()) {
+    auto* h = &table_[probe.index()];
+    auto meta = TryRef(h, key, hash);
+    if (meta != 0 && !f(h, meta)) {
+      return;
+    }
+    if (h->displacements.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+void ClockCacheShard::Free(ClockHandle* h, uint64_t meta) {
+  const size_t charge = h->charge.load(std::memory_order_relaxed);
+  (*h->deleter)(h->key(), h->value);
+  RemoveUsage(GetSubCacheType(meta), charge);
+
+  // Roll back displacements along the probe sequence of the entry.
+  ProbeSequence probe(h->hash, mask_);
+  while (&table_[probe.index()] != h) {
+    table_[probe.index()].displacements.fetch_sub(1, std::memory_order_release);
+    probe.Next();
+  }
+
+  h->key_data.reset();
+  h->key_length = 0;
+  h->value = nullptr;
+  h->deleter = nullptr;
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  // Keep references acquired speculatively by concurrent readers.
+  h->meta.fetch_and(kRefsMask, std::memory_order_release);
+}
+
+bool ClockCacheShard::TryFree(ClockHandle* h, uint64_t meta) {
+  if (!h->meta.compare_exchange_strong(
+          meta, WithState(meta, SlotState::kConstruction), std::memory_order_acq_rel)) {
+    return false;
+  }
+  Free(h, meta);
+  return true;
+}
+
+void ClockCacheShard::FreeDetached(ClockHandle* h, uint64_t meta) {
+  const size_t charge = h->charge.load(std::memory_order_relaxed);
+  (*h->deleter)(h->key(), h->value);
+  RemoveUsage(GetSubCacheType(meta), charge);
+  detached_usage_.fetch_sub(charge, std::memory_order_relaxed);
+  delete h;
+}
+
+void ClockCacheShard::RemoveDuplicates(const Slice& key, uint32_t hash) {
+  ClockHandle* keep = nullptr;
+  size_t num_matches = 0;
+  ForEachMatch(key, hash, [this, &keep, &num_matches](ClockHandle* h, uint64_t) {
+    ++num_matches;
+    if (keep == nullptr || std::less<ClockHandle*>()(h, keep)) {
+      keep = h;
+    }
+    Release(h, /* evict_if_over_capacity= */ false);
+    return true;
+  });
+  if (num_matches < 2) {
+    return;
+  }
+  ForEachMatch(key, hash, [this, keep](ClockHandle* h, uint64_t) {
+    if (h != keep) {
+      MakeInvisible(h);
+    }
+    Release(h, /* evict_if_over_capacity= */ false);
+    return true;
+  });
+}
+
+void ClockCacheShard::MakeInvisible(ClockHandle* h) {
+  auto meta = h->meta.load(std::memory_order_relaxed);
+  while (GetState(meta) == SlotState::kVisible &&
+         !h->meta.compare_exchange_weak(
+             meta, WithState(meta, SlotState::kInvisible), std::memory_order_acq_rel)) {
+  }
+}
+
+size_t ClockCacheShard::EvictFromClock(size_t charge_to_free) {
+  const size_t length = mask_ + 1;
+  // Multi touch entries are protected while multi touch sub cache fits its capacity. Protection
+  // is dropped after a full pass that did not meet any unpinned single touch entry. After that
+  // each entry could be visited kMaxClock times before its countdown reaches zero.
+  const size_t max_steps = (kMaxClock + 3) * length;
+  bool protect_multi_touch = true;
+  bool seen_single_touch = false;
+  size_t freed = 0;
+  for (size_t step = 1; freed < charge_to_free && step <= max_steps; ++step) {
+    if (step % length == 0) {
+      protect_multi_touch = protect_multi_touch && seen_single_touch;
+      seen_single_touch = false;
+    }
+    auto* h = &table_[clock_hand_.fetch_add(1, std::memory_order_relaxed) & mask_];
+    auto meta = h->meta.load(std::memory_order_acquire);
+    if (GetState(meta) != SlotState::kVisible || GetRefs(meta) != 0) {
+      continue;
+    }
+    if (meta & kMultiTouchBit) {
+      if (protect_multi_touch &&
+          multi_touch_usage_.load(std::memory_order_relaxed) <=
+              multi_touch_capacity_.load(std::memory_order_relaxed)) {
+        continue;
+      }
+    } else {
+      seen_single_touch = true;
+    }
+    if (GetClock(meta) != 0) {
+      h->meta.compare_exchange_strong(meta, meta - kOneClock, std::memory_order_acq_rel);
+      continue;
+    }
+    const size_t charge = h->charge.load(std::memory_order_relaxed);
+    if (TryFree(h, meta)) {
+      freed += std::max<size_t>(charge, 1);
+    }
+  }
+  return freed;
+}
+
+Status ClockCacheShard::Insert(
+    const Slice& key, uint32_t hash, QueryId query_id, void* value, size_t charge,
+    void (*deleter)(const Slice& key, void* value), Cache::Handle** handle,
+    Statistics* statistics) {
+  // Don't use the cache if disabled by the caller using the special query id.
+  if (query_id == kNoCacheQueryId) {
+    return Status::OK();
+  }
+
+  // Remove entries with the same key. The new entry goes to the multi touch sub cache if the old
+  // one was there or was added by another query.
+  bool multi_touch_candidate = query_id == kInMultiTouchId;
+  ForEachMatch(key, hash, [this, query_id, &multi_touch_candidate](ClockHandle* h, uint64_t meta) {
+    if ((meta & kMultiTouchBit) || h->query_id != query_id) {
+      multi_touch_candidate = true;
+    }
+    MakeInvisible(h);
+    Release(h, /* evict_if_over_capacity= */ false);
+    return true;
+  });
+
+  SubCacheType subcache_type;
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    subcache_type = MULTI_TOUCH;
+  } else if (FLAGS_cache_single_touch_ratio == 1) {
+    // If there is no multi touch cache, default to single cache.
+    subcache_type = SINGLE_TOUCH;
+  } else {
+    subcache_type = multi_touch_candidate ? MULTI_TOUCH : SINGLE_TOUCH;
+  }
+
+  // Free space both in the cache and in the target sub cache.
+  const size_t capacity = capacity_.load(std::memory_order_relaxed);
+  const size_t usage = usage_.load(std::memory_order_relaxed) + charge;
+  const size_t subcache_capacity = SubCacheCapacity(subcache_type);
+  const size_t subcache_usage =
+      SubCacheUsage(subcache_type).load(std::memory_order_relaxed) + charge;
+  const size_t charge_to_free = std::max(
+      usage > capacity ? usage - capacity : 0,
+      subcache_usage > subcache_capacity ? subcache_usage - subcache_capacity : 0);
+  if (charge_to_free != 0) {
+    EvictFromClock(charge_to_free);
+  }
+  // Make room in the table, an evicted entry frees at least one slot. Eviction finds nothing when
+  // all entries are pinned.
+  while (occupancy_.load(std::memory_order_relaxed) >= max_occupancy_ && EvictFromClock(1) != 0) {
+  }
+
+  Status s;
+  ClockHandle* h = nullptr;
+  if (strict_capacity_limit_ &&
+      SubCacheUsage(subcache_type).load(std::memory_order_relaxed) + charge >
+          SubCacheCapacity(subcache_type)) {
+    s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+  } else if (occupancy_.fetch_add(1, std::memory_order_relaxed) >= max_occupancy_) {
+    occupancy_.fetch_sub(1, std::memory_order_relaxed);
+    if (strict_capacity_limit_) {
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache table being full.");
+    } else if (handle != nullptr) {
+      h = new ClockHandle;
+      h->detached = true;
+      h->meta.store(StateBits(SlotState::kConstruction), std::memory_order_relaxed);
+      detached_usage_.fetch_add(charge, std::memory_order_relaxed);
+    }
+    // Otherwise the value is not cached, as if it was evicted right after insert.
+  } else {
+    // The occupancy limit guarantees that there is an empty slot, but it could be temporarily
+    // held by concurrent readers or a concurrent Free, so retry the probe sequence.
+    while (h == nullptr) {
+      ProbeSequence probe(hash, mask_);
+      for (size_t i = 0; i <= mask_; ++i, probe.Next()) {
+        auto* candidate = &table_[probe.index()];
+        auto meta = candidate->meta.load(std::memory_order_relaxed);
+        if (GetState(meta) == SlotState::kEmpty &&
+            candidate->meta.compare_exchange_strong(
+                meta, WithState(meta, SlotState::kConstruction), std::memory_order_acq_rel)) {
+          h = candidate;
+          break;
+        }
+      }
+    }
+    ProbeSequence probe(hash, mask_);
+    while (&table_[probe.index()] != h) {
+      table_[probe.index()].displacements.fetch_add(1, std::memory_order_release);
+      probe.Next();
+    }
+  }
+
+  if (h != nullptr) {
+    h->hash = hash;
+    h->query_id = query_id;
+    h->value = value;
+    h->deleter = deleter;
+    h->key_data.reset(new char[key.size()]);
+    memcpy(h->key_data.get(), key.data(), key.size());
+    h->key_length = key.size();
+    h->charge.store(charge, std::memory_order_relaxed);
+    AddUsage(subcache_type, charge);
+
+    // Single touch entries start with the minimal countdown, so entries brought by a scan that
+    // are not touched again are evicted first.
+    uint64_t delta = StateBits(SlotState::kVisible) - StateBits(SlotState::kConstruction);
+    if (subcache_type == MULTI_TOUCH) {
+      delta += kMultiTouchBit + (kMaxClock - 1) * kOneClock;
+    } else {
+      delta += kOneClock;
+    }
+    if (handle != nullptr) {
+      delta += kOneRef;
+      *handle = reinterpret_cast<Cache::Handle*>(h);
+    }
+    h->meta.fetch_add(delta, std::memory_order_acq_rel);
+
+    if (!h->detached) {
+      RemoveDuplicates(key, hash);
+    }
+  } else if (handle == nullptr) {
+    (*deleter)(key, value);
+  } else {
+    *handle = nullptr;
+  }
+
+  if (statistics != nullptr) {
+    if (h != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+      if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+      } else if (subcache_type == SubCacheType::MULTI_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+      }
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+  }
+
+  return s;
+}
+
+void ClockCacheShard::PromoteToMultiTouch(ClockHandle* h, uint64_t meta) {
+  const size_t charge = h->charge.load(std::memory_order_relaxed);
+  if (strict_capacity_limit_ &&
+      multi_touch_usage_.load(std::memory_order_relaxed) + charge >
+          multi_touch_capacity_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  for (;;) {
+    if (GetState(meta) != SlotState::kVisible || (meta & kMultiTouchBit)) {
+      return;
+    }
+    auto new_meta = (meta & ~kClockMask) | kMultiTouchBit | (kMaxClock << kClockShift);
+    if (h->meta.compare_exchange_weak(meta, new_meta, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+  RemoveUsage(SINGLE_TOUCH, charge);
+  AddUsage(MULTI_TOUCH, charge);
+}
+
+void ClockCacheShard::BumpClock(ClockHandle* h, uint64_t meta) {
+  const uint64_t target = (meta & kMultiTouchBit) ? kMaxClock : 1;
+  // Avoid writing to the shared cache line when countdown is already at the target.
+  while (GetState(meta) == SlotState::kVisible && GetClock(meta) < target) {
+    auto new_meta = (meta & ~kClockMask) | (target << kClockShift);
+    if (h->meta.compare_exchange_weak(meta, new_meta, std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+Cache::Handle* ClockCacheShard::Lookup(
+    const Slice& key, uint32_t hash, QueryId query_id, Statistics* statistics) {
+  ClockHandle* found = nullptr;
+  uint64_t found_meta = 0;
+  ForEachMatch(key, hash, [&found, &found_meta](ClockHandle* h, uint64_t meta) {
+    found = h;
+    found_meta = meta;
+    return false;
+  });
+
+  if (found == nullptr) {
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_MISS);
+    }
+    return nullptr;
+  }
+
+  // Now the handle will be added to the multi touch pool only if it exists.
+  if (FLAGS_cache_single_touch_ratio < 1 && !(found_meta & kMultiTouchBit) &&
+      found->query_id != query_id) {
+    PromoteToMultiTouch(found, found_meta);
+  } else {
+    BumpClock(found, found_meta);
+  }
+
+  if (statistics != nullptr) {
+    const size_t charge = found->charge.load(std::memory_order_relaxed);
+    // overall cache hit
+    RecordTick(statistics, BLOCK_CACHE_HIT);
+    // total bytes read from cache
+    RecordTick(statistics, BLOCK_CACHE_BYTES_READ, charge);
+    if (GetSubCacheType(found->meta.load(std::memory_order_relaxed)) == SINGLE_TOUCH) {
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+      RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+      RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, charge);
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(found);
+}
+
+void ClockCacheShard::Release(ClockHandle* h, bool evict_if_over_capacity) {
+  auto meta = h->meta.fetch_sub(kOneRef, std::memory_order_acq_rel) - kOneRef;
+  DCHECK_NE(GetRefs(meta + kOneRef), 0);
+  if (GetRefs(meta) != 0) {
+    return;
+  }
+  if (h->detached) {
+    FreeDetached(h, meta);
+    return;
+  }
+  // If TryFree fails, then somebody else has acquired the reference meanwhile and this thread is
+  // no longer responsible for freeing the entry.
+  switch (GetState(meta)) {
+    case SlotState::kInvisible:
+      TryFree(h, meta);
+      return;
+    case SlotState::kVisible:
+      if (evict_if_over_capacity &&
+          usage_.load(std::memory_order_relaxed) > capacity_.load(std::memory_order_relaxed)) {
+        TryFree(h, meta);
+      }
+      return;
+    case SlotState::kEmpty: FALLTHROUGH_INTENDED;
+    case SlotState::kConstruction:
+      return;
+  }
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ForEachMatch(key, hash, [this](ClockHandle* h, uint64_t) {
+    MakeInvisible(h);
+    Release(h, /* evict_if_over_capacity= */ false);
+    return true;
+  });
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t)) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    auto* h = &table_[i];
+    if (GetState(h->meta.load(std::memory_order_relaxed)) != SlotState::kVisible) {
+      continue;
+    }
+    auto meta = h->meta.fetch_add(kOneRef, std::memory_order_acq_rel);
+    if (GetState(meta) == SlotState::kVisible) {
+      callback(h->value, h->charge.load(std::memory_order_relaxed));
+    }
+    Release(h, /* evict_if_over_capacity= */ false);
+  }
+}
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                    size_t estimated_entry_charge)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    int num_shards = 1 << num_shard_bits_;
+    shards_ = new ClockCacheShard[num_shards];
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].Init(per_shard, strict_capacity_limit, estimated_entry_charge);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_.store(capacity, std::memory_order_relaxed);
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  size_t Evict(size_t bytes_to_evict) override {
+    auto num_shards = 1ULL << num_shard_bits_;
+    size_t total_evicted = 0;
+    // Start at random shard.
+    auto index = Shard(yb::RandomUniformInt<uint32_t>());
+    for (size_t i = 0; bytes_to_evict > total_evicted && i != num_shards; ++i) {
+      total_evicted += shards_[index].Evict(bytes_to_evict - total_evicted);
+      index = (index + 1) & (num_shards - 1);
+    }
+    return total_evicted;
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    auto* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(h, /* evict_if_over_capacity= */ true);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override {
+    return capacity_.load(std::memory_order_relaxed);
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const override {
+    int num_shards = 1 << num_shard_bits_;
+    size_t usage = 0;
+    for (int s = 0; s < num_shards; s++) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    auto* h = reinterpret_cast<ClockHandle*>(e);
+    return rocksdb::GetSubCacheType(h->meta.load(std::memory_order_relaxed));
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    // Entries are visited without locks, so thread_safe does not make a difference.
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].ApplyToAllCacheEntries(callback);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    int num_shards = 1 << num_shard_bits_;
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> TEST_GetIndividualUsages() override {
+    std::vector<std::pair<size_t, size_t>> cache_sizes;
+    cache_sizes.reserve(1 << num_shard_bits_);
+
+    for (int i = 0; i < 1 << num_shard_bits_; ++i) {
+      cache_sizes.emplace_back(shards_[i].TEST_GetIndividualUsages());
+    }
+    return cache_sizes;
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  static bool IsValidQueryId(const QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+  ClockCacheShard* shards_;
+  std::atomic<uint64_t> last_id_{0};
+  size_t num_shard_bits_;
+  std::atomic<size_t> capacity_;
+  bool strict_capacity_limit_;
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits) {
+  return NewClockCache(capacity, num_shard_bits, false, kDefaultEstimatedEntryCharge);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+                                size_t estimated_entry_charge) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  if (num_shard_bits < 0) {
+    num_shard_bits = kDefaultNumShardBits;
+  }
+  return std::make_shared<ShardedClockCache>(
+      capacity, num_shard_bits, strict_capacity_limit, estimated_entry_charge);
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,460 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/testutil.h"
+
+#include "yb/util/test_macros.h"
+
+using std::shared_ptr;
+
+namespace rocksdb {
+
+namespace {
+
+std::string EncodeKey(int k) {
+  std::string result;
+  PutFixed32(&result, k);
+  return result;
+}
+
+int DecodeKey(const Slice& k) {
+  EXPECT_EQ(k.size(), 4);
+  return DecodeFixed32(k.data());
+}
+
+void* EncodeValue(uintptr_t v) { return reinterpret_cast<void*>(v); }
+
+int DecodeValue(void* v) {
+  return static_cast<int>(reinterpret_cast<uintptr_t>(v));
+}
+
+} // namespace
+
+class ClockCacheTest : public RocksDBTest {
+ public:
+  static constexpr QueryId kTestQueryId = 1;
+
+  static ClockCacheTest* current_;
+
+  static void Deleter(const Slice& key, void* v) {
+    std::lock_guard<std::mutex> lock(current_->mutex_);
+    current_->deleted_keys_.push_back(DecodeKey(key));
+    current_->deleted_values_.push_back(DecodeValue(v));
+  }
+
+  ClockCacheTest() {
+    current_ = this;
+  }
+
+  void SetUp() override {
+    RocksDBTest::SetUp();
+    // Single shard with one slot per unit of charge, so tests could reason about evictions.
+    cache_ = NewTestCache(100);
+  }
+
+  static shared_ptr<Cache> NewTestCache(size_t capacity, bool strict_capacity_limit = false) {
+    return NewClockCache(
+        capacity, 0 /* num_shard_bits */, strict_capacity_limit,
+        1 /* estimated_entry_charge */);
+  }
+
+  int Lookup(int key, QueryId query_id = kTestQueryId) {
+    Cache::Handle* handle = cache_->Lookup(EncodeKey(key), query_id);
+    const int r = (handle == nullptr) ? -1 : DecodeValue(cache_->Value(handle));
+    if (handle != nullptr) {
+      cache_->Release(handle);
+    }
+    return r;
+  }
+
+  Status Insert(int key, int value, int charge = 1, QueryId query_id = kTestQueryId,
+                Cache::Handle** handle = nullptr) {
+    return cache_->Insert(EncodeKey(key), query_id, EncodeValue(value), charge,
+                          &ClockCacheTest::Deleter, handle);
+  }
+
+  void Erase(int key) {
+    cache_->Erase(EncodeKey(key));
+  }
+
+  void AssertUsages(size_t single_touch_usage, size_t multi_touch_usage) {
+    auto usages = cache_->TEST_GetIndividualUsages();
+    ASSERT_EQ(1, usages.size());
+    ASSERT_EQ(single_touch_usage, usages[0].first);
+    ASSERT_EQ(multi_touch_usage, usages[0].second);
+  }
+
+  size_t NumDeleted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return deleted_keys_.size();
+  }
+
+  std::mutex mutex_;
+  std::vector<int> deleted_keys_;
+  std::vector<int> deleted_values_;
+  shared_ptr<Cache> cache_;
+};
+
+ClockCacheTest* ClockCacheTest::current_;
+
+TEST_F(ClockCacheTest, HitAndMiss) {
+  ASSERT_EQ(-1, Lookup(100));
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(-1, Lookup(200));
+  ASSERT_EQ(-1, Lookup(300));
+
+  ASSERT_OK(Insert(200, 201));
+  ASSERT_EQ(101, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(-1, Lookup(300));
+
+  // Replacing the value deletes the old one.
+  ASSERT_OK(Insert(100, 102));
+  ASSERT_EQ(102, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(-1, Lookup(300));
+
+  ASSERT_EQ(1, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+}
+
+TEST_F(ClockCacheTest, Erase) {
+  Erase(200);
+  ASSERT_EQ(0, deleted_keys_.size());
+
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_OK(Insert(200, 201));
+  Erase(100);
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(1, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(100);
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(201, Lookup(200));
+  ASSERT_EQ(1, deleted_keys_.size());
+}
+
+TEST_F(ClockCacheTest, ErasedEntriesArePinned) {
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(Insert(100, 101, 1 /* charge */, kTestQueryId, &handle));
+  ASSERT_EQ(1, cache_->GetPinnedUsage());
+
+  Erase(100);
+  ASSERT_EQ(-1, Lookup(100));
+  ASSERT_EQ(0, deleted_keys_.size());
+  ASSERT_EQ(101, DecodeValue(cache_->Value(handle)));
+  ASSERT_EQ(1, cache_->GetUsage());
+
+  cache_->Release(handle);
+  ASSERT_EQ(1, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(0, cache_->GetUsage());
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, UsageDoesNotExceedCapacity) {
+  const auto capacity = cache_->GetCapacity();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_OK(Insert(i, i + 1000, 3 /* charge */));
+    ASSERT_LE(cache_->GetUsage(), capacity);
+  }
+  // Recently inserted entry could not be evicted by eviction for itself.
+  ASSERT_EQ(1999, Lookup(999));
+  ASSERT_GE(NumDeleted(), 1000 - capacity / 3);
+}
+
+TEST_F(ClockCacheTest, PinnedEntriesAreNotEvicted) {
+  std::vector<Cache::Handle*> handles;
+  for (int i = 0; i < 30; ++i) {
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(Insert(i, i + 1000, 5 /* charge */, kTestQueryId, &handle));
+    handles.push_back(handle);
+  }
+  // Not strict cache could go over its capacity when all entries are pinned.
+  ASSERT_EQ(150, cache_->GetUsage());
+  ASSERT_EQ(150, cache_->GetPinnedUsage());
+  ASSERT_EQ(0, deleted_keys_.size());
+
+  // Releasing an entry of over capacity cache evicts it.
+  for (auto* handle : handles) {
+    cache_->Release(handle);
+  }
+  ASSERT_LE(cache_->GetUsage(), cache_->GetCapacity());
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+}
+
+TEST_F(ClockCacheTest, FullTable) {
+  // Table of 256 slots accepts up to 179 entries, pin more entries than that.
+  constexpr int kNumEntries = 300;
+  std::vector<Cache::Handle*> handles;
+  for (int i = 0; i < kNumEntries; ++i) {
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(Insert(i, i + 1000, 1 /* charge */, kTestQueryId, &handle));
+    ASSERT_NE(nullptr, handle);
+    ASSERT_EQ(i + 1000, DecodeValue(cache_->Value(handle)));
+    handles.push_back(handle);
+  }
+  ASSERT_EQ(kNumEntries, cache_->GetUsage());
+  ASSERT_EQ(kNumEntries, cache_->GetPinnedUsage());
+  ASSERT_EQ(0, deleted_keys_.size());
+  // Entries that did not fit the table are not found.
+  ASSERT_EQ(1000, Lookup(0));
+  ASSERT_EQ(-1, Lookup(kNumEntries - 1));
+
+  // Insert without handle succeeds, but the value is not cached.
+  ASSERT_OK(Insert(kNumEntries, kNumEntries + 1000));
+  ASSERT_EQ(-1, Lookup(kNumEntries));
+  ASSERT_EQ(1, deleted_keys_.size());
+  ASSERT_EQ(kNumEntries, deleted_keys_[0]);
+
+  for (auto* handle : handles) {
+    cache_->Release(handle);
+  }
+  ASSERT_LE(cache_->GetUsage(), cache_->GetCapacity());
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+
+  // Released entries make room for new ones.
+  ASSERT_OK(Insert(kNumEntries, kNumEntries + 1000));
+  ASSERT_EQ(kNumEntries + 1000, Lookup(kNumEntries));
+
+  cache_.reset();
+  ASSERT_EQ(kNumEntries + 2, NumDeleted());
+}
+
+TEST_F(ClockCacheTest, FullTableStrictCapacityLimit) {
+  // Table of 32 slots accepts up to 22 entries, while capacity is enough for all of them.
+  cache_ = NewClockCache(
+      1000, 0 /* num_shard_bits */, true /* strict_capacity_limit */,
+      100 /* estimated_entry_charge */);
+  std::vector<Cache::Handle*> handles;
+  for (int i = 0; i < 22; ++i) {
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(Insert(i, i + 1000, 1 /* charge */, kTestQueryId, &handle));
+    handles.push_back(handle);
+  }
+
+  Cache::Handle* handle = nullptr;
+  ASSERT_TRUE(Insert(22, 1022, 1 /* charge */, kTestQueryId, &handle).IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+
+  for (auto* h : handles) {
+    cache_->Release(h);
+  }
+}
+
+TEST_F(ClockCacheTest, ConcurrentInsertsOfSameKey) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumRounds = 200;
+
+  for (int round = 0; round != kNumRounds; ++round) {
+    cache_ = NewTestCache(100);
+    std::atomic<int> ready{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t != kNumThreads; ++t) {
+      threads.emplace_back([this, round, &ready] {
+        ready.fetch_add(1);
+        while (ready.load() != kNumThreads) {
+        }
+        ASSERT_OK(Insert(round, round));
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    // Only one of the racing entries stays in the cache.
+    ASSERT_EQ(1, cache_->GetUsage());
+    ASSERT_EQ(round, Lookup(round));
+  }
+}
+
+TEST_F(ClockCacheTest, StrictCapacityLimit) {
+  // Single touch sub cache does not overflow into multi touch one when limit is strict, so only
+  // 2 single touch entries fit.
+  cache_ = NewTestCache(10, true /* strict_capacity_limit */);
+  std::vector<Cache::Handle*> handles;
+  for (int i = 0; i < 2; ++i) {
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(Insert(i, i + 1000, 1 /* charge */, kTestQueryId, &handle));
+    handles.push_back(handle);
+  }
+
+  Cache::Handle* handle = nullptr;
+  ASSERT_TRUE(Insert(10, 1010, 1 /* charge */, kTestQueryId, &handle).IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_EQ(0, deleted_keys_.size());
+
+  // Value is deleted when insert without handle fails.
+  ASSERT_TRUE(Insert(10, 1010).IsIncomplete());
+  ASSERT_EQ(1, deleted_keys_.size());
+  ASSERT_EQ(10, deleted_keys_[0]);
+
+  for (auto* h : handles) {
+    cache_->Release(h);
+  }
+  ASSERT_OK(Insert(10, 1010));
+  ASSERT_EQ(1010, Lookup(10));
+}
+
+TEST_F(ClockCacheTest, MultiTouch) {
+  ASSERT_OK(Insert(100, 101));
+  ASSERT_EQ(101, Lookup(100));
+  // Lookups from the same query keep entry in single touch sub cache.
+  AssertUsages(1 /* single_touch */, 0 /* multi_touch */);
+
+  ASSERT_EQ(101, Lookup(100, kTestQueryId + 1));
+  AssertUsages(0 /* single_touch */, 1 /* multi_touch */);
+
+  Cache::Handle* handle = cache_->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(MULTI_TOUCH, cache_->GetSubCacheType(handle));
+  cache_->Release(handle);
+
+  // Replacing entry keeps it in multi touch sub cache.
+  ASSERT_OK(Insert(100, 102));
+  AssertUsages(0 /* single_touch */, 1 /* multi_touch */);
+
+  // Entries inserted with kInMultiTouchId go directly to multi touch sub cache.
+  ASSERT_OK(Insert(200, 201, 1 /* charge */, kInMultiTouchId));
+  AssertUsages(0 /* single_touch */, 2 /* multi_touch */);
+
+  // kNoCacheQueryId bypasses the cache.
+  ASSERT_OK(Insert(300, 301, 1 /* charge */, kNoCacheQueryId));
+  ASSERT_EQ(-1, Lookup(300));
+}
+
+TEST_F(ClockCacheTest, ScanResistance) {
+  constexpr int kNumHotEntries = 50;
+  for (int i = 0; i < kNumHotEntries; ++i) {
+    ASSERT_OK(Insert(i, i + 1000));
+    ASSERT_EQ(i + 1000, Lookup(i, kTestQueryId + 1));
+  }
+
+  // Large scan, that touches each block multiple times from the same query.
+  constexpr QueryId kScanQueryId = kTestQueryId + 2;
+  for (int i = kNumHotEntries; i < 10000; ++i) {
+    ASSERT_OK(Insert(i, i + 1000, 1 /* charge */, kScanQueryId));
+    ASSERT_EQ(i + 1000, Lookup(i, kScanQueryId));
+  }
+
+  for (int i = 0; i < kNumHotEntries; ++i) {
+    ASSERT_EQ(i + 1000, Lookup(i)) << "Hot entry " << i << " was evicted by scan";
+  }
+  ASSERT_LE(cache_->GetUsage(), cache_->GetCapacity());
+}
+
+TEST_F(ClockCacheTest, ApplyToAllCacheEntries) {
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Insert(i, i + 1000, i + 1 /* charge */));
+  }
+  static size_t total_charge;
+  total_charge = 0;
+  cache_->ApplyToAllCacheEntries([](void*, size_t charge) {
+    total_charge += charge;
+  }, true /* thread_safe */);
+  ASSERT_EQ(55, total_charge);
+}
+
+TEST_F(ClockCacheTest, SetCapacity) {
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_OK(Insert(i, i + 1000));
+  }
+  ASSERT_EQ(50, cache_->GetUsage());
+  cache_->SetCapacity(20);
+  ASSERT_EQ(20, cache_->GetCapacity());
+  ASSERT_LE(cache_->GetUsage(), 20);
+  ASSERT_EQ(NumDeleted() + cache_->GetUsage(), 50);
+}
+
+TEST_F(ClockCacheTest, Concurrent) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 500;
+  constexpr int kNumOperations = 20000;
+
+  cache_ = NewClockCache(100, 2 /* num_shard_bits */, false /* strict_capacity_limit */,
+                         1 /* estimated_entry_charge */);
+  std::atomic<size_t> num_inserted{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([this, t, &num_inserted, &failed] {
+      Random rnd(t + 1);
+      for (int i = 0; i < kNumOperations; ++i) {
+        int key = rnd.Uniform(kNumKeys);
+        auto query_id = rnd.Uniform(4);
+        switch (rnd.Uniform(4)) {
+          case 0: {
+            Cache::Handle* handle = nullptr;
+            if (cache_->Insert(EncodeKey(key), query_id, EncodeValue(key), 1,
+                               &ClockCacheTest::Deleter, &handle).ok()) {
+              ++num_inserted;
+              if (DecodeValue(cache_->Value(handle)) != key) {
+                failed = true;
+              }
+              cache_->Release(handle);
+            }
+            break;
+          }
+          case 1:
+            cache_->Erase(EncodeKey(key));
+            break;
+          default: {
+            Cache::Handle* handle = cache_->Lookup(EncodeKey(key), query_id);
+            if (handle != nullptr) {
+              if (DecodeValue(cache_->Value(handle)) != key) {
+                failed = true;
+              }
+              cache_->Release(handle);
+            }
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(failed);
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+  ASSERT_LE(cache_->GetUsage(), cache_->GetCapacity());
+
+  // Each inserted value is deleted exactly once.
+  cache_.reset();
+  ASSERT_EQ(num_inserted, NumDeleted());
+  for (size_t i = 0; i != deleted_keys_.size(); ++i) {
+    ASSERT_EQ(deleted_keys_[i], deleted_values_[i]);
+  }
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -102,6 +102,12 @@ inline uint8_t DecodeFixed8(const char* ptr) {
   return pointer_cast<const uint8_t*>(ptr)[0];
 }
 
+inline uint16_t DecodeFixed16(const char* ptr) {
+  return static_cast<uint16_t>(
+      static_cast<uint16_t>(static_cast<unsigned char>(ptr[0])) |
+      (static_cast<uint16_t>(static_cast<unsigned char>(ptr[1])) << 8));
+}
+
 inline uint32_t DecodeFixed32(const char* ptr) {
   if (port::kLittleEndian) {
     // Load the raw bytes
@@ -201,6 +207,11 @@ inline void PutFixed8(std::string* dst, uint8_t value) {
   dst->push_back(value);
 }
 
+inline void PutFixed16(std::string* dst, uint16_t value) {
+  dst->push_back(static_cast<char>(value & 0xff));
+  dst->push_back(static_cast<char>(value >> 8));
+}
+
 inline void PutFixed32(std::string* dst, uint32_t value) {
   char buf[sizeof(value)];
   EncodeFixed32(buf, value);
@@ -25,11 +25,14 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
 
+#include "yb/util/slice.h"
+
 #ifdef SNAPPY
 #include <snappy.h>
 #endif
@@ -110,6 +113,12 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
   }
 }
 
+// Whether blocks compressed with the specified type could use a sampled dictionary,
+// see CompressionOptions::max_dict_bytes.
+inline bool CompressionDictSupported(CompressionType compression_type) {
+  return compression_type == kLZ4Compression || compression_type == kLZ4HCCompression;
+}
+
 inline std::string CompressionTypeToString(CompressionType compression_type) {
   switch (compression_type) {
     case kNoCompression:
@@ -189,6 +198,33 @@ inline bool GetDecompressedSizeInfo(const char** input_data,
   *input_data = new_input_data;
   return true;
 }
+
+// Compression contexts are reused by subsequent blocks compressed by the same thread, instead of
+// being allocated for each block.
+template <class Context, class Result, Result (*Free)(Context*)>
+struct ContextDeleter {
+  void operator()(Context* context) const {
+    Free(context);
+  }
+};
+
+template <class Context, class Result, Result (*Free)(Context*)>
+using ContextPtr = std::unique_ptr<Context, ContextDeleter<Context, Result, Free>>;
+
+#if defined(LZ4)
+inline LZ4_stream_t* ThreadLocalLZ4Stream() {
+  thread_local ContextPtr<LZ4_stream_t, int, &LZ4_freeStream> stream(LZ4_createStream());
+  return stream.get();
+}
+
+#if LZ4_VERSION_NUMBER >= 10700  // r129+
+inline LZ4_streamHC_t* ThreadLocalLZ4StreamHC() {
+  thread_local ContextPtr<LZ4_streamHC_t, int, &LZ4_freeStreamHC> stream(LZ4_createStreamHC());
+  return stream.get();
+}
+#endif
+#endif
+
 }  // namespace compression
 
 // compress_format_version == 1 -- decompressed size is not included in the
@@ -498,7 +534,8 @@ inline char* BZip2_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4_Compress(const CompressionOptions& opts,
                          uint32_t compress_format_version, const char* input,
-                         size_t length, ::std::string* output) {
+                         size_t length, ::std::string* output,
+                         const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -521,9 +558,21 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  int outlen =
-      LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
-                                 static_cast<int>(length), compressBound);
+  int outlen;
+  if (compression_dict.empty()) {
+    outlen = LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
+                                        static_cast<int>(length), compressBound);
+  } else {
+    LZ4_stream_t* stream = compression::ThreadLocalLZ4Stream();
+    if (!stream) {
+      return false;
+    }
+    // Loading the dictionary makes the stream independent of the previously compressed block.
+    LZ4_loadDict(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+    outlen = LZ4_compress_fast_continue(
+        stream, input, &(*output)[output_header_len], static_cast<int>(length), compressBound,
+        /* acceleration= */ 1);
+  }
   if (outlen == 0) {
     return false;
   }
@@ -539,7 +588,8 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 // header in varint32 format
 inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
                             int* decompress_size,
-                            uint32_t compress_format_version) {
+                            uint32_t compress_format_version,
+                            const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   uint32_t output_len = 0;
   if (compress_format_version == 2) {
@@ -559,9 +609,15 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
     input_data += 8;
   }
   char* output = new char[output_len];
-  *decompress_size =
-      LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
-                          static_cast<int>(output_len));
+  if (compression_dict.empty()) {
+    *decompress_size =
+        LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
+                            static_cast<int>(output_len));
+  } else {
+    *decompress_size = LZ4_decompress_safe_usingDict(
+        input_data, output, static_cast<int>(input_length), static_cast<int>(output_len),
+        compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+  }
   if (*decompress_size < 0) {
     delete[] output;
     return nullptr;
@@ -578,7 +634,8 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 inline bool LZ4HC_Compress(const CompressionOptions& opts,
                            uint32_t compress_format_version, const char* input,
-                           size_t length, ::std::string* output) {
+                           size_t length, ::std::string* output,
+                           const Slice& compression_dict = Slice()) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -602,7 +659,22 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   int compressBound = LZ4_compressBound(static_cast<int>(length));
   output->resize(static_cast<size_t>(output_header_len + compressBound));
   int outlen;
-#ifdef LZ4_VERSION_MAJOR  // they only started defining this since r113
+#if LZ4_VERSION_NUMBER >= 10700  // r129+
+  if (!compression_dict.empty()) {
+    LZ4_streamHC_t* stream = compression::ThreadLocalLZ4StreamHC();
+    if (!stream) {
+      return false;
+    }
+    LZ4_resetStreamHC(stream, opts.level);
+    LZ4_loadDictHC(stream, compression_dict.cdata(), static_cast<int>(compression_dict.size()));
+    outlen = LZ4_compress_HC_continue(
+        stream, input, &(*output)[output_header_len], static_cast<int>(length), compressBound);
+  } else {
+    outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
+                                           static_cast<int>(length),
+                                           compressBound, opts.level);
+  }
+#elif defined(LZ4_VERSION_MAJOR)  // they only started defining this since r113
   outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
                                          static_cast<int>(length),
                                          compressBound, opts.level);
@@ -0,0 +1,32 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/util/compression_dict.h"
+
+namespace rocksdb {
+
+std::shared_ptr<const std::string> SampledCompressionDict::Get() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dict_;
+}
+
+void SampledCompressionDict::Update(const Slice& samples) {
+  if (samples.empty()) {
+    return;
+  }
+  auto dict = std::make_shared<const std::string>(samples.ToBuffer());
+  std::lock_guard<std::mutex> lock(mutex_);
+  dict_ = std::move(dict);
+}
+
+} // namespace rocksdb
@@ -0,0 +1,46 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+// Keeps the preset compression dictionary of a column family.
+// The dictionary is built from data block samples of the most recently written SST file and is
+// used to compress data blocks of SST files written after it. Each SST file stores the dictionary
+// it was compressed with, so replacing the dictionary does not affect existing files.
+// Dictionary used to prime LZ4/LZ4HC compression of SST data blocks of a column family.
+// It is not trained: its contents are the raw prefixes of data blocks sampled while building the
+// most recent SST file of the column family, concatenated as is. Such a dictionary lets blocks of
+// the next files reference byte sequences repeated across blocks, which a per-block compressor
+// cannot see otherwise.
+class SampledCompressionDict {
+ public:
+  // Returns current dictionary, nullptr if there is no dictionary yet.
+  std::shared_ptr<const std::string> Get() const;
+
+  // Replaces current dictionary with specified samples. Empty samples are ignored.
+  void Update(const Slice& samples);
+
+ private:
+  mutable std::mutex mutex_;
+  std::shared_ptr<const std::string> dict_;
+};
+
+} // namespace rocksdb
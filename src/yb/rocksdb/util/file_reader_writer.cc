@@ -90,6 +90,23 @@ Status RandomAccessFileReader::ReadAndValidate(
   return s;
 }
 
+void RandomAccessFileReader::MultiRead(
+    RandomAccessFile::ReadRequest* requests, size_t count) const {
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr);
+    IOSTATS_TIMER_GUARD(read_nanos);
+    file_->MultiRead(requests, count);
+    for (auto* request = requests; request != requests + count; ++request) {
+      IOSTATS_ADD_IF_POSITIVE(bytes_read, request->result.size());
+    }
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+}
+
 WritableFileWriter::~WritableFileWriter() {
   WARN_NOT_OK(Close(), "Failed to close file");
 }
@@ -0,0 +1,566 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// File based secondary cache.
+//
+// Each shard appends values to its current segment file and keeps an in-memory index from key to
+// the location of the value. When the shard exceeds its part of the capacity, its oldest segment
+// is deleted together with all index entries pointing to it, so eviction is FIFO over segments
+// and the device only sees sequential writes. Each value is stored with its CRC32C, so a value
+// that cannot be read back intact is treated as a miss.
+//
+// Insert only queues the value, the values are written by a background writer thread, so readers
+// that populate the cache do not wait for the device.
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/secondary_cache.h"
+#include "yb/rocksdb/util/crc32c.h"
+#include "yb/rocksdb/util/hash.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/status_log.h"
+#include "yb/util/thread.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr char kSegmentFileSuffix[] = ".sbc";
+constexpr size_t kMinSegmentsPerShard = 4;
+
+struct Segment {
+  uint64_t id;
+  std::string path;
+  std::shared_ptr<RandomAccessFile> reader;
+  size_t size = 0;
+};
+
+// Location of the value in the segment files.
+struct ValueLocation {
+  uint64_t segment_id;
+  uint64_t offset;
+  uint32_t size;
+  uint32_t crc;
+};
+
+struct PendingValue {
+  std::string key;
+  std::string value;
+};
+
+// Approximate memory used by the index entry: the hash table node with the key and the location,
+// and the bucket pointer.
+size_t IndexEntryCharge(size_t key_size) {
+  return key_size + sizeof(std::pair<const std::string, ValueLocation>) + 3 * sizeof(void*);
+}
+
+// Approximate memory used by the value waiting to be written, its key is stored twice: in the
+// queue and in the set of pending keys.
+size_t PendingValueCharge(const PendingValue& pending) {
+  return 2 * (pending.key.size() + sizeof(std::string)) + pending.value.size() +
+         sizeof(PendingValue) + 3 * sizeof(void*);
+}
+
+class FileSecondaryCacheShard {
+ public:
+  FileSecondaryCacheShard(
+      Env* env, std::string path_prefix, size_t capacity, size_t segment_size,
+      size_t max_pending_bytes, std::shared_ptr<yb::MemTracker> mem_tracker)
+      : env_(env), path_prefix_(std::move(path_prefix)), capacity_(capacity),
+        segment_size_(segment_size), max_pending_bytes_(max_pending_bytes),
+        mem_tracker_(std::move(mem_tracker)) {}
+
+  ~FileSecondaryCacheShard() {
+    current_writer_.reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& segment : segments_) {
+      // Concurrent lookups could still hold the reader, but the data remains readable through the
+      // open file after the file is deleted.
+      env_->CleanupFile(segment.path);
+      usage_.fetch_sub(segment.size, std::memory_order_relaxed);
+      if (metrics_) {
+        metrics_->secondary_cache_usage->DecrementBy(segment.size);
+      }
+    }
+    if (mem_tracker_) {
+      mem_tracker_->Release(consumption_.load(std::memory_order_relaxed));
+    }
+  }
+
+  void SetMetrics(std::shared_ptr<yb::CacheMetrics> metrics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics_ = std::move(metrics);
+  }
+
+  // Queues the value to be written by WritePending. Returns true if the value was queued.
+  bool Insert(const Slice& key, const Slice& value);
+  bool Lookup(const Slice& key, size_t expected_size, char* scratch);
+  void Erase(const Slice& key);
+
+  // Writes the values queued by Insert. Called by the writer thread only.
+  void WritePending();
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Write(const std::string& key, const std::string& value);
+
+  // Starts a new segment, dropping the oldest ones to fit into capacity.
+  Status StartSegment();
+
+  void ConsumeMemory(int64_t bytes) {
+    if (mem_tracker_ && bytes != 0) {
+      consumption_.fetch_add(bytes, std::memory_order_relaxed);
+      if (bytes > 0) {
+        mem_tracker_->Consume(bytes);
+      } else {
+        mem_tracker_->Release(-bytes);
+      }
+    }
+  }
+
+  Env* const env_;
+  const std::string path_prefix_;
+  const size_t capacity_;
+  const size_t segment_size_;
+  const size_t max_pending_bytes_;
+  const std::shared_ptr<yb::MemTracker> mem_tracker_;
+
+  std::mutex mutex_;
+  // Segment ids are consecutive, the last segment is the one being written.
+  std::deque<Segment> segments_ GUARDED_BY(mutex_);
+  std::unordered_map<std::string, ValueLocation> index_ GUARDED_BY(mutex_);
+  std::deque<PendingValue> pending_values_ GUARDED_BY(mutex_);
+  // Keys of pending_values_ that were not erased.
+  std::unordered_set<std::string> pending_keys_ GUARDED_BY(mutex_);
+  size_t pending_bytes_ GUARDED_BY(mutex_) = 0;
+  std::shared_ptr<yb::CacheMetrics> metrics_ GUARDED_BY(mutex_);
+  std::atomic<size_t> usage_{0};
+  std::atomic<int64_t> consumption_{0};
+
+  // Accessed by the writer thread only.
+  std::unique_ptr<WritableFile> current_writer_;
+  uint64_t current_segment_id_ = 0;
+  size_t current_size_ = 0;
+  // Set when a write to the current segment failed, so it could contain a partially written value.
+  bool current_sealed_ = false;
+  uint64_t next_segment_id_ = 0;
+};
+
+Status FileSecondaryCacheShard::StartSegment() {
+  const auto id = next_segment_id_;
+  auto path = strings::Substitute("$0-$1$2", path_prefix_, id, kSegmentFileSuffix);
+  std::unique_ptr<WritableFile> writer;
+  RETURN_NOT_OK(env_->NewWritableFile(path, &writer, EnvOptions()));
+  std::unique_ptr<RandomAccessFile> reader;
+  auto status = env_->NewRandomAccessFile(path, &reader, EnvOptions());
+  if (!status.ok()) {
+    writer.reset();
+    env_->CleanupFile(path);
+    return status;
+  }
+  ++next_segment_id_;
+
+  // The previous segment is closed only after the new one is opened, so on failure above values
+  // are still appended to the previous segment, or dropped if it is sealed or full.
+  if (current_writer_) {
+    WARN_NOT_OK(current_writer_->Close(), "Failed to close secondary cache segment");
+  }
+  current_writer_ = std::move(writer);
+  current_segment_id_ = id;
+  current_size_ = 0;
+  current_sealed_ = false;
+
+  std::vector<std::string> dropped_paths;
+  int64_t released_memory = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!segments_.empty() &&
+           usage_.load(std::memory_order_relaxed) + segment_size_ > capacity_) {
+      auto& oldest = segments_.front();
+      usage_.fetch_sub(oldest.size, std::memory_order_relaxed);
+      if (metrics_) {
+        metrics_->secondary_cache_usage->DecrementBy(oldest.size);
+      }
+      dropped_paths.push_back(std::move(oldest.path));
+      segments_.pop_front();
+    }
+    if (!dropped_paths.empty()) {
+      // Segments do not keep their keys, so the index is scanned once per dropped batch of
+      // segments instead of storing every key twice.
+      const auto oldest_id = segments_.empty() ? id : segments_.front().id;
+      size_t num_evicted = 0;
+      for (auto it = index_.begin(); it != index_.end();) {
+        if (it->second.segment_id < oldest_id) {
+          released_memory += IndexEntryCharge(it->first.size());
+          ++num_evicted;
+          it = index_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      if (metrics_) {
+        metrics_->secondary_cache_evictions->IncrementBy(num_evicted);
+      }
+    }
+    segments_.push_back(Segment {
+      .id = id,
+      .path = std::move(path),
+      .reader = std::move(reader),
+    });
+  }
+  ConsumeMemory(-released_memory);
+  // Concurrent lookups could still hold the reader, but the data remains readable through the open
+  // file after the file is deleted.
+  for (const auto& dropped_path : dropped_paths) {
+    env_->CleanupFile(dropped_path);
+  }
+  return Status::OK();
+}
+
+bool FileSecondaryCacheShard::Insert(const Slice& key, const Slice& value) {
+  if (value.size() > segment_size_) {
+    return false;
+  }
+  PendingValue pending {
+    .key = key.ToBuffer(),
+    .value = value.ToBuffer(),
+  };
+  const size_t charge = PendingValueCharge(pending);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(pending.key) || pending_keys_.count(pending.key) ||
+        pending_bytes_ + charge > max_pending_bytes_) {
+      return false;
+    }
+    pending_keys_.insert(pending.key);
+    pending_values_.push_back(std::move(pending));
+    pending_bytes_ += charge;
+  }
+  ConsumeMemory(charge);
+  return true;
+}
+
+void FileSecondaryCacheShard::WritePending() {
+  for (;;) {
+    PendingValue pending;
+    bool erased;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_values_.empty()) {
+        return;
+      }
+      pending = std::move(pending_values_.front());
+      pending_values_.pop_front();
+      pending_bytes_ -= PendingValueCharge(pending);
+      erased = pending_keys_.erase(pending.key) == 0;
+    }
+    if (!erased) {
+      Write(pending.key, pending.value);
+    }
+    ConsumeMemory(-static_cast<int64_t>(PendingValueCharge(pending)));
+  }
+}
+
+void FileSecondaryCacheShard::Write(const std::string& key, const std::string& value) {
+  if (!current_writer_ || current_sealed_ || current_size_ + value.size() > segment_size_) {
+    auto status = StartSegment();
+    if (!status.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to start secondary cache segment: " << status;
+      if (!current_writer_ || current_sealed_ || current_size_ + value.size() > segment_size_) {
+        return;
+      }
+    }
+  }
+  auto status = current_writer_->Append(value);
+  if (status.ok()) {
+    // Make the value visible to the reader of the segment.
+    status = current_writer_->Flush();
+  }
+  if (!status.ok()) {
+    YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to write to secondary cache segment "
+                                     << current_segment_id_ << ": " << status;
+    // Do not append anything else after a partially written value.
+    current_sealed_ = true;
+    return;
+  }
+
+  const ValueLocation location {
+    .segment_id = current_segment_id_,
+    .offset = current_size_,
+    .size = static_cast<uint32_t>(value.size()),
+    .crc = crc32c::Value(value.data(), value.size()),
+  };
+  current_size_ += value.size();
+  bool inserted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inserted = index_.emplace(key, location).second;
+    segments_.back().size += value.size();
+    usage_.fetch_add(value.size(), std::memory_order_relaxed);
+    if (metrics_) {
+      metrics_->secondary_cache_inserts->Increment();
+      metrics_->secondary_cache_usage->IncrementBy(value.size());
+    }
+  }
+  if (inserted) {
+    ConsumeMemory(IndexEntryCharge(key.size()));
+  }
+}
+
+bool FileSecondaryCacheShard::Lookup(const Slice& key, size_t expected_size, char* scratch) {
+  ValueLocation location{};
+  std::shared_ptr<RandomAccessFile> reader;
+  std::shared_ptr<yb::CacheMetrics> metrics;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics = metrics_;
+    auto it = index_.find(key.ToBuffer());
+    if (it != index_.end() && !segments_.empty()) {
+      // Segment ids are consecutive, so the segment could be found by its distance from the
+      // oldest one.
+      auto segment_idx = it->second.segment_id - segments_.front().id;
+      if (segment_idx < segments_.size()) {
+        location = it->second;
+        reader = segments_[segment_idx].reader;
+      }
+    }
+  }
+  if (!reader || location.size != expected_size) {
+    if (metrics) {
+      metrics->secondary_cache_misses->Increment();
+    }
+    return false;
+  }
+
+  // The read is done without holding the mutex, so lookups do not wait for each other's IO.
+  Slice result;
+  auto status = reader->Read(location.offset, location.size, &result, scratch);
+  if (!status.ok() || result.size() != location.size ||
+      crc32c::Value(result.cdata(), result.size()) != location.crc) {
+    YB_LOG_EVERY_N_SECS(WARNING, 10)
+        << "Failed to read value from secondary cache file " << reader->filename() << ": "
+        << (status.ok() ? STATUS(Corruption, "Checksum mismatch") : status);
+    Erase(key);
+    if (metrics) {
+      metrics->secondary_cache_misses->Increment();
+    }
+    return false;
+  }
+  if (result.cdata() != scratch) {
+    memcpy(scratch, result.cdata(), result.size());
+  }
+  if (metrics) {
+    metrics->secondary_cache_hits->Increment();
+  }
+  return true;
+}
+
+void FileSecondaryCacheShard::Erase(const Slice& key) {
+  // Space is reclaimed when the segment is dropped, memory of the pending value is reclaimed when
+  // the writer skips it.
+  auto key_str = key.ToBuffer();
+  int64_t released_memory = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.erase(key_str)) {
+      released_memory = IndexEntryCharge(key_str.size());
+    }
+    pending_keys_.erase(key_str);
+  }
+  ConsumeMemory(-released_memory);
+}
+
+class FileSecondaryCache : public SecondaryCache {
+ public:
+  explicit FileSecondaryCache(const FileSecondaryCacheOptions& options)
+      : num_shard_bits_(options.num_shard_bits), capacity_(options.capacity) {
+    const size_t num_shards = 1ULL << num_shard_bits_;
+    const size_t per_shard = capacity_ / num_shards;
+    // Dropping a segment should not free too large part of the shard.
+    const size_t segment_size = std::max<size_t>(
+        std::min(options.segment_size, per_shard / kMinSegmentsPerShard), 1);
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i != num_shards; ++i) {
+      shards_.push_back(std::make_unique<FileSecondaryCacheShard>(
+          options.env, strings::Substitute("$0/$1", options.path, i), per_shard,
+          segment_size, options.max_pending_write_bytes / num_shards, options.mem_tracker));
+    }
+  }
+
+  ~FileSecondaryCache() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closing_ = true;
+    }
+    writer_cond_.notify_one();
+    flush_cond_.notify_all();
+    if (writer_thread_) {
+      writer_thread_->Join();
+    }
+  }
+
+  Status Start() {
+    return yb::Thread::Create(
+        "rocksdb", "secondary_cache_writer", &FileSecondaryCache::WriterLoop, this,
+        &writer_thread_);
+  }
+
+  void Insert(const Slice& key, const Slice& value) override {
+    if (!shards_[Shard(HashSlice(key))]->Insert(key, value)) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      has_pending_writes_ = true;
+    }
+    writer_cond_.notify_one();
+  }
+
+  void Flush() override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_cond_.wait(lock, [this]() NO_THREAD_SAFETY_ANALYSIS {
+      return closing_ || (!has_pending_writes_ && !writing_);
+    });
+  }
+
+  bool Lookup(const Slice& key, size_t expected_size, char* scratch) override {
+    return shards_[Shard(HashSlice(key))]->Lookup(key, expected_size, scratch);
+  }
+
+  void Erase(const Slice& key) override {
+    shards_[Shard(HashSlice(key))]->Erase(key);
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override {
+    return capacity_;
+  }
+
+  size_t GetUsage() const override {
+    size_t usage = 0;
+    for (const auto& shard : shards_) {
+      usage += shard->GetUsage();
+    }
+    return usage;
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    auto metrics = std::make_shared<yb::CacheMetrics>(entity);
+    metrics->secondary_cache_usage->set_value(GetUsage());
+    for (const auto& shard : shards_) {
+      shard->SetMetrics(metrics);
+    }
+  }
+
+ private:
+  static uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  void WriterLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      writer_cond_.wait(lock, [this]() NO_THREAD_SAFETY_ANALYSIS {
+        return closing_ || has_pending_writes_;
+      });
+      if (closing_) {
+        return;
+      }
+      has_pending_writes_ = false;
+      writing_ = true;
+      lock.unlock();
+      for (const auto& shard : shards_) {
+        shard->WritePending();
+      }
+      lock.lock();
+      writing_ = false;
+      flush_cond_.notify_all();
+    }
+  }
+
+  const int num_shard_bits_;
+  const size_t capacity_;
+  std::vector<std::unique_ptr<FileSecondaryCacheShard>> shards_;
+  std::atomic<uint64_t> last_id_{0};
+
+  std::mutex mutex_;
+  std::condition_variable writer_cond_;
+  std::condition_variable flush_cond_;
+  bool has_pending_writes_ GUARDED_BY(mutex_) = false;
+  bool writing_ GUARDED_BY(mutex_) = false;
+  bool closing_ GUARDED_BY(mutex_) = false;
+  scoped_refptr<yb::Thread> writer_thread_;
+};
+
+} // namespace
+
+Status NewFileSecondaryCache(
+    const FileSecondaryCacheOptions& options, std::shared_ptr<SecondaryCache>* result) {
+  if (options.path.empty()) {
+    return STATUS(InvalidArgument, "Secondary cache path is not specified");
+  }
+  if (options.num_shard_bits < 0 || options.num_shard_bits >= 20) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Invalid number of secondary cache shard bits: $0",
+        options.num_shard_bits);
+  }
+  if (options.segment_size == 0) {
+    return STATUS(InvalidArgument, "Secondary cache segment size should be positive");
+  }
+  auto new_options = options;
+  if (!new_options.env) {
+    new_options.env = Env::Default();
+  }
+  auto* env = new_options.env;
+
+  // The index is kept in memory only, so files left by the previous run are useless.
+  RETURN_NOT_OK(env->CreateDirIfMissing(options.path));
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env->GetChildren(options.path, &children));
+  for (const auto& child : children) {
+    if (Slice(child).ends_with(kSegmentFileSuffix)) {
+      RETURN_NOT_OK(env->DeleteFile(options.path + "/" + child));
+    }
+  }
+
+  auto cache = std::make_shared<FileSecondaryCache>(new_options);
+  RETURN_NOT_OK(cache->Start());
+  *result = std::move(cache);
+  return Status::OK();
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,262 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/encryption/header_manager_impl.h"
+#include "yb/encryption/universe_key_manager.h"
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/secondary_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
+
+#include "yb/rocksutil/rocksdb_encrypted_file_factory.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+
+namespace rocksdb {
+
+namespace {
+
+class FailingEnv : public EnvWrapper {
+ public:
+  explicit FailingEnv(Env* target) : EnvWrapper(target) {}
+
+  Status NewWritableFile(const std::string& f, std::unique_ptr<WritableFile>* r,
+                         const EnvOptions& options) override {
+    if (fail_new_files_) {
+      return STATUS(IOError, "Injected failure");
+    }
+    return EnvWrapper::NewWritableFile(f, r, options);
+  }
+
+  void SetFailNewFiles(bool value) {
+    fail_new_files_ = value;
+  }
+
+ private:
+  std::atomic<bool> fail_new_files_{false};
+};
+
+} // namespace
+
+class FileSecondaryCacheTest : public RocksDBTest {
+ protected:
+  void SetUp() override {
+    RocksDBTest::SetUp();
+    env_ = Env::Default();
+    options_.path = test::TmpDir(env_) + "/file_secondary_cache_test";
+    options_.capacity = 4096;
+    options_.segment_size = 1024;
+    options_.num_shard_bits = 0;
+    options_.env = env_;
+    ASSERT_OK(NewFileSecondaryCache(options_, &cache_));
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    RocksDBTest::TearDown();
+  }
+
+  static std::string Value(int i, size_t size) {
+    return std::string(size, static_cast<char>('a' + i % 26));
+  }
+
+  std::string Lookup(const std::string& key, size_t size) {
+    std::string result(size, 0);
+    if (!cache_->Lookup(key, size, result.data())) {
+      return std::string();
+    }
+    return result;
+  }
+
+  size_t NumSegmentFiles() {
+    std::vector<std::string> children;
+    EXPECT_OK(env_->GetChildren(options_.path, &children));
+    size_t result = 0;
+    for (const auto& child : children) {
+      if (Slice(child).ends_with(".sbc")) {
+        ++result;
+      }
+    }
+    return result;
+  }
+
+  Env* env_;
+  FileSecondaryCacheOptions options_;
+  std::shared_ptr<SecondaryCache> cache_;
+};
+
+TEST_F(FileSecondaryCacheTest, InsertAndLookup) {
+  ASSERT_EQ("", Lookup("key1", 10));
+
+  cache_->Insert("key1", Value(1, 10));
+  cache_->Insert("key2", Value(2, 20));
+  cache_->Flush();
+  ASSERT_EQ(Value(1, 10), Lookup("key1", 10));
+  ASSERT_EQ(Value(2, 20), Lookup("key2", 20));
+  ASSERT_EQ(30, cache_->GetUsage());
+
+  // Value of unexpected size is a miss.
+  ASSERT_EQ("", Lookup("key1", 11));
+
+  // Second insert of the same key is ignored.
+  cache_->Insert("key1", Value(3, 10));
+  cache_->Flush();
+  ASSERT_EQ(Value(1, 10), Lookup("key1", 10));
+  ASSERT_EQ(30, cache_->GetUsage());
+
+  cache_->Erase("key1");
+  ASSERT_EQ("", Lookup("key1", 10));
+  ASSERT_EQ(Value(2, 20), Lookup("key2", 20));
+}
+
+TEST_F(FileSecondaryCacheTest, EvictOldestSegment) {
+  constexpr int kNumValues = 100;
+  constexpr size_t kValueSize = 100;
+  for (int i = 0; i != kNumValues; ++i) {
+    cache_->Insert(std::to_string(i), Value(i, kValueSize));
+    cache_->Flush();
+    ASSERT_LE(cache_->GetUsage(), options_.capacity);
+  }
+  ASSERT_LE(NumSegmentFiles(), options_.capacity / options_.segment_size);
+
+  // Values of the oldest segments are evicted, while the recently inserted ones are available.
+  ASSERT_EQ("", Lookup("0", kValueSize));
+  for (int i = kNumValues - 10; i != kNumValues; ++i) {
+    ASSERT_EQ(Value(i, kValueSize), Lookup(std::to_string(i), kValueSize));
+  }
+
+  // Values larger than segment are not cached.
+  cache_->Insert("large", Value(0, options_.segment_size + 1));
+  cache_->Flush();
+  ASSERT_EQ("", Lookup("large", options_.segment_size + 1));
+}
+
+// Segment files are written through the env of the cache, so with encryption at rest they do not
+// contain plaintext data blocks.
+TEST_F(FileSecondaryCacheTest, Encryption) {
+  auto key_bytes = yb::RandomBytes(32);
+  auto universe_key_manager = ASSERT_RESULT(yb::encryption::UniverseKeyManager::FromKey(
+      "key_id", yb::Slice(key_bytes.data(), key_bytes.size())));
+  auto encrypted_env = yb::NewRocksDBEncryptedEnv(
+      yb::encryption::DefaultHeaderManager(universe_key_manager.get()));
+  cache_.reset();
+  options_.env = encrypted_env.get();
+  ASSERT_OK(NewFileSecondaryCache(options_, &cache_));
+
+  const auto value = Value(7, 100);
+  cache_->Insert("key1", value);
+  cache_->Flush();
+  ASSERT_EQ(value, Lookup("key1", value.size()));
+
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, options_.path + "/0-0.sbc", &contents));
+  ASSERT_GT(contents.size(), value.size());
+  ASSERT_EQ(contents.find(value), std::string::npos);
+
+  // The cache should not outlive its env.
+  cache_.reset();
+}
+
+TEST_F(FileSecondaryCacheTest, Corruption) {
+  cache_->Insert("key1", Value(1, 10));
+  cache_->Insert("key2", Value(2, 10));
+  cache_->Flush();
+
+  // Corrupt the first value.
+  {
+    std::fstream file(options_.path + "/0-0.sbc", std::ios::in | std::ios::out);
+    ASSERT_TRUE(file.is_open());
+    file.seekp(5);
+    file.put('!');
+  }
+
+  ASSERT_EQ("", Lookup("key1", 10));
+  ASSERT_EQ(Value(2, 10), Lookup("key2", 10));
+}
+
+TEST_F(FileSecondaryCacheTest, CleanupOnCreate) {
+  cache_->Insert("key1", Value(1, 10));
+  cache_->Flush();
+  ASSERT_EQ(1, NumSegmentFiles());
+
+  std::shared_ptr<SecondaryCache> new_cache;
+  ASSERT_OK(NewFileSecondaryCache(options_, &new_cache));
+  ASSERT_EQ(0, NumSegmentFiles());
+  ASSERT_EQ(0, new_cache->GetUsage());
+}
+
+TEST_F(FileSecondaryCacheTest, FailedSegmentStart) {
+  FailingEnv env(env_);
+  options_.env = &env;
+  ASSERT_OK(NewFileSecondaryCache(options_, &cache_));
+
+  constexpr size_t kValueSize = 400;
+  cache_->Insert("key1", Value(1, kValueSize));
+  cache_->Insert("key2", Value(2, kValueSize));
+  cache_->Flush();
+
+  // The third value does not fit the current segment, and the new one could not be started.
+  env.SetFailNewFiles(true);
+  cache_->Insert("key3", Value(3, kValueSize));
+  cache_->Insert("key4", Value(4, 10));
+  cache_->Flush();
+  ASSERT_EQ("", Lookup("key3", kValueSize));
+  // Small value still fits the current segment.
+  ASSERT_EQ(Value(4, 10), Lookup("key4", 10));
+  ASSERT_EQ(Value(1, kValueSize), Lookup("key1", kValueSize));
+
+  env.SetFailNewFiles(false);
+  cache_->Insert("key3", Value(3, kValueSize));
+  cache_->Flush();
+  ASSERT_EQ(Value(3, kValueSize), Lookup("key3", kValueSize));
+  ASSERT_EQ(2, NumSegmentFiles());
+
+  cache_.reset();
+}
+
+TEST_F(FileSecondaryCacheTest, MemTracker) {
+  auto mem_tracker = yb::MemTracker::CreateTracker("file_secondary_cache_test");
+  options_.mem_tracker = mem_tracker;
+  ASSERT_OK(NewFileSecondaryCache(options_, &cache_));
+
+  cache_->Insert("key1", Value(1, 10));
+  cache_->Insert("key2", Value(2, 10));
+  cache_->Flush();
+  const auto index_consumption = mem_tracker->consumption();
+  ASSERT_GT(index_consumption, 0);
+  // Written values are not kept in memory.
+  ASSERT_LT(index_consumption, 1024);
+
+  cache_->Erase("key1");
+  ASSERT_LT(mem_tracker->consumption(), index_consumption);
+
+  cache_.reset();
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -254,6 +254,7 @@ DBOptions::DBOptions()
       num_reserved_small_compaction_threads(-1),
       compaction_size_threshold_bytes(std::numeric_limits<uint64_t>::max()),
       max_subcompactions(1),
+      min_subcompaction_input_size(1ULL << 30),
       max_background_flushes(1),
       max_log_file_size(0),
       log_file_time_to_roll(0),
@@ -342,6 +343,8 @@ void DBOptions::Dump(Logger* log) const {
       max_background_compactions);
   RHEADER(log, "                     Options.max_subcompactions: %" PRIu32,
       max_subcompactions);
+  RHEADER(log, "           Options.min_subcompaction_input_size: %" PRIu64,
+      min_subcompaction_input_size);
   RHEADER(log, "                 Options.max_background_flushes: %d",
       max_background_flushes);
   RHEADER(log, "                        Options.WAL_ttl_seconds: %" PRIu64,
@@ -455,6 +458,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -242,6 +242,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"compaction_size_threshold_bytes",
      {offsetof(struct DBOptions, compaction_size_threshold_bytes), OptionType::kUInt64T,
       OptionVerificationType::kNormal}},
+    {"min_subcompaction_input_size",
+     {offsetof(struct DBOptions, min_subcompaction_input_size), OptionType::kUInt64T,
+      OptionVerificationType::kNormal}},
     {"base_background_compactions",
      {offsetof(struct DBOptions, base_background_compactions), OptionType::kInt,
       OptionVerificationType::kNormal}},
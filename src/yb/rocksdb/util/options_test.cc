@@ -1676,6 +1676,7 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "initial_seqno=432;"
       "num_reserved_small_compaction_threads=-1;"
       "compaction_size_threshold_bytes=18446744073709551615;"
+      "min_subcompaction_input_size=4096;"
       "info_log_level=DEBUG_LEVEL;";
 
   return GetDBOptionsFromString(*source, kOptionsString, destination);
@@ -1872,7 +1873,11 @@ TEST_F(OptionsParserTest, BlockBasedTableOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(BlockBasedTableOptions, flush_block_policy_factory),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, block_cache_compressed),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, secondary_block_cache),
       BLACKLIST_ENTRY(BlockBasedTableOptions, data_block_key_value_encoding_format),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, data_block_index_type),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, data_block_hash_table_util_ratio),
+      BLACKLIST_ENTRY(BlockBasedTableOptions, data_block_hash_index_key_transformer),
       BLACKLIST_ENTRY(BlockBasedTableOptions, filter_policy),
       BLACKLIST_ENTRY(BlockBasedTableOptions, supported_filter_policies),
   };
@@ -1911,6 +1916,7 @@ TEST_F(OptionsParserTest, DBOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(DBOptions, wal_filter),
       BLACKLIST_ENTRY(DBOptions, boundary_extractor),
       BLACKLIST_ENTRY(DBOptions, compaction_context_factory),
+      BLACKLIST_ENTRY(DBOptions, subcompaction_key_transformer),
       BLACKLIST_ENTRY(DBOptions, max_file_size_for_compaction),
       BLACKLIST_ENTRY(DBOptions, mem_table_flush_filter_factory),
       BLACKLIST_ENTRY(DBOptions, log_prefix),
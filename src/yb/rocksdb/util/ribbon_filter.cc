@@ -0,0 +1,407 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Fixed-size Ribbon filter (see "Ribbon filter: practically smaller than Bloom and Xor" by
+// Peter C. Dillinger and Stefan Walzer). Each key is mapped to a 64-bit wide band of coefficients
+// starting at some slot and to a result of result_bits bits. Building the filter is solving the
+// system of linear equations over GF(2), querying is XOR of solution rows selected by key
+// coefficients compared with the key result. False positive rate is 2^-result_bits using
+// result_bits / kRibbonLoadFactor bits per key, while Bloom filter requires at least
+// 1.44 * result_bits bits per key for the same false positive rate.
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+#include "yb/util/logging.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Version tag stored in the last byte of each filter block. It allows filter blocks built using
+// different algorithms to coexist, and new versions to be added without breaking old SST files.
+//
+// Filter block layout:
+//     data: uint8[]
+//     num_units: uint32 - number of 64-slot ribbon blocks or number of bloom cache lines.
+//     param1: uint8 - result bits for ribbon, number of probes for bloom.
+//     param2: uint8 - hash seed for ribbon, unused for bloom.
+//     format_version: uint8
+//
+// Zero num_units means empty filter which doesn't match any key.
+enum class FilterFormatVersion : uint8_t {
+  // Ribbon filter, data is uint64[num_units * result_bits]: solution bits for slots
+  // [64 * i, 64 * i + 63] and result bit j are stored in (i * result_bits + j)-th word.
+  kRibbon = 1,
+
+  // Cache line blocked Bloom filter, used when Ribbon filter can't be built for the keys added.
+  // Data is num_units 64 bytes cache lines.
+  kBlockedBloom = 2,
+};
+
+constexpr size_t kMetaDataSize = sizeof(uint32_t) + 3;
+
+constexpr size_t kRibbonCoeffBits = 64;
+constexpr size_t kRibbonMaxResultBits = 8;
+constexpr uint32_t kRibbonMaxSeeds = 16;
+
+// Ratio of the number of keys to the number of slots. Probability of failing to build Ribbon
+// filter with 64-bit coefficients grows quickly above this ratio.
+constexpr double kRibbonLoadFactor = 0.92;
+
+constexpr size_t kBloomCacheLineBits = 512;
+constexpr size_t kBloomMaxProbes = 30;
+
+inline uint64_t Mix64(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+inline uint32_t FastRange32(uint32_t hash, uint32_t range) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(hash) * range) >> 32);
+}
+
+inline uint32_t FilterHash(const Slice& key) {
+  return BloomHash(key);
+}
+
+inline uint64_t RibbonRemix(uint32_t hash, uint32_t seed) {
+  return Mix64(((static_cast<uint64_t>(hash) << 32) | hash) ^
+               ((seed + 1) * 0x9e3779b97f4a7c15ULL));
+}
+
+struct RibbonEquation {
+  uint32_t start;
+  uint64_t coeff;
+  uint8_t result;
+};
+
+inline RibbonEquation MakeRibbonEquation(
+    uint32_t hash, uint32_t seed, uint32_t num_starts, size_t result_bits) {
+  const auto h = RibbonRemix(hash, seed);
+  return RibbonEquation {
+    .start = FastRange32(static_cast<uint32_t>(h >> 32), num_starts),
+    // The lowest coefficient bit corresponds to the start slot and is always set.
+    .coeff = Mix64(h ^ 0xc2b2ae3d27d4eb4fULL) | 1,
+    .result = static_cast<uint8_t>(h & ((1u << result_bits) - 1)),
+  };
+}
+
+inline size_t RibbonNumStarts(size_t num_blocks) {
+  return num_blocks * kRibbonCoeffBits - kRibbonCoeffBits + 1;
+}
+
+size_t RibbonResultBits(double error_rate) {
+  const auto result_bits = static_cast<size_t>(ceil(-log2(error_rate)));
+  return std::clamp<size_t>(result_bits, 1, kRibbonMaxResultBits);
+}
+
+class FixedSizeRibbonFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  FixedSizeRibbonFilterBitsBuilder(const FixedSizeRibbonFilterBitsBuilder&) = delete;
+  void operator=(const FixedSizeRibbonFilterBitsBuilder&) = delete;
+
+  FixedSizeRibbonFilterBitsBuilder(size_t total_bits, double error_rate)
+      : result_bits_(RibbonResultBits(error_rate)) {
+    DCHECK_GT(total_bits, 0);
+    // We need at least 2 blocks to have some freedom in choosing start slot.
+    num_blocks_ = std::max<size_t>(total_bits / (kRibbonCoeffBits * result_bits_), 2);
+    max_keys_ = static_cast<size_t>(num_blocks_ * kRibbonCoeffBits * kRibbonLoadFactor);
+    hashes_.reserve(max_keys_);
+  }
+
+  void AddKey(const Slice& key) override {
+    hashes_.push_back(FilterHash(key));
+  }
+
+  bool IsFull() const override { return hashes_.size() >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    const auto data_size = num_blocks_ * result_bits_ * sizeof(uint64_t);
+    std::unique_ptr<char[]> data(new char[data_size + kMetaDataSize]);
+    memset(data.get(), 0, data_size + kMetaDataSize);
+    char* meta = data.get() + data_size;
+
+    if (hashes_.empty()) {
+      meta[kMetaDataSize - 1] = static_cast<char>(FilterFormatVersion::kRibbon);
+    } else {
+      bool built = false;
+      for (uint32_t seed = 0; seed < kRibbonMaxSeeds && !built; ++seed) {
+        built = BuildRibbon(seed, data.get());
+        if (built) {
+          EncodeFixed32(meta, static_cast<uint32_t>(num_blocks_));
+          meta[4] = static_cast<char>(result_bits_);
+          meta[5] = static_cast<char>(seed);
+          meta[6] = static_cast<char>(FilterFormatVersion::kRibbon);
+        }
+      }
+      if (!built) {
+        // Should be very rare, but still possible. Use the same space for Bloom filter.
+        memset(data.get(), 0, data_size);
+        const auto num_lines = data_size * 8 / kBloomCacheLineBits;
+        const auto num_probes = BuildBlockedBloom(data.get(), num_lines);
+        EncodeFixed32(meta, static_cast<uint32_t>(num_lines));
+        meta[4] = static_cast<char>(num_probes);
+        meta[6] = static_cast<char>(FilterFormatVersion::kBlockedBloom);
+      }
+    }
+
+    hashes_.clear();
+    buf->reset(data.release());
+    return Slice(buf->get(), data_size + kMetaDataSize);
+  }
+
+ private:
+  // Builds Ribbon filter solution into data, returns false if system of equations for specified
+  // seed is not solvable.
+  bool BuildRibbon(uint32_t seed, char* data) {
+    const auto num_slots = num_blocks_ * kRibbonCoeffBits;
+    const auto num_starts = static_cast<uint32_t>(RibbonNumStarts(num_blocks_));
+    coeff_rows_.assign(num_slots, 0);
+    result_rows_.assign(num_slots, 0);
+
+    // Banding: on-the-fly Gaussian elimination, so that each non-empty row i has coefficient for
+    // slot i set and coefficients only for slots [i, i + 63].
+    for (const auto hash : hashes_) {
+      const auto equation = MakeRibbonEquation(hash, seed, num_starts, result_bits_);
+      auto i = equation.start;
+      auto coeff = equation.coeff;
+      auto result = equation.result;
+      for (;;) {
+        if (coeff_rows_[i] == 0) {
+          coeff_rows_[i] = coeff;
+          result_rows_[i] = result;
+          break;
+        }
+        coeff ^= coeff_rows_[i];
+        result ^= result_rows_[i];
+        if (coeff == 0) {
+          // Equation is linear combination of already added ones, which is fine for duplicate keys
+          // (or keys with the same hash), otherwise system is not solvable.
+          if (result != 0) {
+            return false;
+          }
+          break;
+        }
+        const auto shift = __builtin_ctzll(coeff);
+        i += shift;
+        coeff >>= shift;
+      }
+    }
+
+    // Back substitution. state[j] bit k holds result bit j of the solution for slot i + 1 + k.
+    uint64_t state[kRibbonMaxResultBits] = {};
+    for (size_t i = num_slots; i-- > 0;) {
+      const auto coeff = coeff_rows_[i];
+      const auto result = result_rows_[i];
+      char* block = data + (i / kRibbonCoeffBits) * result_bits_ * sizeof(uint64_t);
+      for (size_t j = 0; j != result_bits_; ++j) {
+        uint64_t bit = 0;
+        if (coeff != 0) {
+          bit = ((result >> j) ^ __builtin_parityll((coeff >> 1) & state[j])) & 1;
+        }
+        state[j] = (state[j] << 1) | bit;
+        if (bit) {
+          char* word = block + j * sizeof(uint64_t);
+          EncodeFixed64(word, DecodeFixed64(word) | (1ULL << (i % kRibbonCoeffBits)));
+        }
+      }
+    }
+    return true;
+  }
+
+  // Builds cache line blocked Bloom filter into data, returns number of probes.
+  size_t BuildBlockedBloom(char* data, size_t num_lines) {
+    const auto bits_per_key = static_cast<double>(num_lines * kBloomCacheLineBits) / hashes_.size();
+    const auto num_probes = std::clamp<size_t>(
+        static_cast<size_t>(bits_per_key * M_LN2), 1, kBloomMaxProbes);
+    for (const auto hash : hashes_) {
+      const auto h = Mix64(hash);
+      char* line = data + FastRange32(static_cast<uint32_t>(h >> 32), static_cast<uint32_t>(
+          num_lines)) * (kBloomCacheLineBits / 8);
+      auto probe = static_cast<uint32_t>(h);
+      for (size_t i = 0; i != num_probes; ++i) {
+        const auto bit = probe >> 23;
+        line[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        probe *= 0x9e3779b9;
+      }
+    }
+    return num_probes;
+  }
+
+  const size_t result_bits_;
+  size_t num_blocks_;
+  size_t max_keys_;
+  std::vector<uint32_t> hashes_;
+  std::vector<uint64_t> coeff_rows_;
+  std::vector<uint8_t> result_rows_;
+};
+
+class FixedSizeRibbonFilterBitsReader : public FilterBitsReader {
+ public:
+  FixedSizeRibbonFilterBitsReader(const FixedSizeRibbonFilterBitsReader&) = delete;
+  void operator=(const FixedSizeRibbonFilterBitsReader&) = delete;
+
+  explicit FixedSizeRibbonFilterBitsReader(const Slice& contents) : data_(contents.cdata()) {
+    if (contents.size() < kMetaDataSize) {
+      // Empty or broken filter, remain the same with bloom filter.
+      return;
+    }
+    const auto data_size = contents.size() - kMetaDataSize;
+    const char* meta = data_ + data_size;
+    num_units_ = DecodeFixed32(meta);
+    param1_ = static_cast<uint8_t>(meta[4]);
+    param2_ = static_cast<uint8_t>(meta[5]);
+    const auto format_version = static_cast<uint8_t>(meta[6]);
+    switch (static_cast<FilterFormatVersion>(format_version)) {
+      case FilterFormatVersion::kRibbon:
+        format_ = FilterFormatVersion::kRibbon;
+        valid_ = num_units_ == 0 ||
+                 (num_units_ >= 2 && param1_ >= 1 && param1_ <= kRibbonMaxResultBits &&
+                  data_size == num_units_ * param1_ * sizeof(uint64_t));
+        num_starts_ = num_units_ ? static_cast<uint32_t>(RibbonNumStarts(num_units_)) : 0;
+        break;
+      case FilterFormatVersion::kBlockedBloom:
+        format_ = FilterFormatVersion::kBlockedBloom;
+        valid_ = num_units_ == 0 ||
+                 (param1_ >= 1 && data_size >= num_units_ * kBloomCacheLineBits / 8);
+        break;
+      default:
+        // Filter block is written by newer version, treat it as matching all keys.
+        always_match_ = true;
+        break;
+    }
+    if (!valid_ && !always_match_) {
+      LOG(DFATAL) << "Corrupted filter block, format version: "
+                  << static_cast<int>(format_version) << ", size: " << contents.size();
+      always_match_ = true;
+    }
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (always_match_) {
+      return true;
+    }
+    if (!valid_ || num_units_ == 0) {
+      return false;
+    }
+    const auto hash = FilterHash(entry);
+    switch (format_) {
+      case FilterFormatVersion::kRibbon:
+        return RibbonMayMatch(hash);
+      case FilterFormatVersion::kBlockedBloom:
+        return BlockedBloomMayMatch(hash);
+    }
+    return true;
+  }
+
+ private:
+  bool RibbonMayMatch(uint32_t hash) const {
+    const size_t result_bits = param1_;
+    const auto equation = MakeRibbonEquation(hash, param2_, num_starts_, result_bits);
+    const auto offset = equation.start % kRibbonCoeffBits;
+    const size_t block_size = result_bits * sizeof(uint64_t);
+    const char* block = data_ + (equation.start / kRibbonCoeffBits) * block_size;
+    // Only used when offset is non zero, in this case start is not the last slot of the last block,
+    // so the next block always exists.
+    const char* next_block = block + block_size;
+    uint32_t result = 0;
+    for (size_t j = 0; j != result_bits; ++j) {
+      auto window = DecodeFixed64(block + j * sizeof(uint64_t)) >> offset;
+      if (offset) {
+        window |= DecodeFixed64(next_block + j * sizeof(uint64_t)) << (kRibbonCoeffBits - offset);
+      }
+      result |= static_cast<uint32_t>(__builtin_parityll(window & equation.coeff)) << j;
+    }
+    return result == equation.result;
+  }
+
+  bool BlockedBloomMayMatch(uint32_t hash) const {
+    const auto h = Mix64(hash);
+    const char* line = data_ + FastRange32(static_cast<uint32_t>(h >> 32), num_units_) *
+                               (kBloomCacheLineBits / 8);
+    auto probe = static_cast<uint32_t>(h);
+    for (size_t i = 0; i != param1_; ++i) {
+      const auto bit = probe >> 23;
+      if ((line[bit / 8] & (1 << (bit % 8))) == 0) {
+        return false;
+      }
+      probe *= 0x9e3779b9;
+    }
+    return true;
+  }
+
+  const char* data_;
+  uint32_t num_units_ = 0;
+  uint8_t param1_ = 0;
+  uint8_t param2_ = 0;
+  uint32_t num_starts_ = 0;
+  FilterFormatVersion format_ = FilterFormatVersion::kRibbon;
+  bool valid_ = false;
+  bool always_match_ = false;
+};
+
+class FixedSizeRibbonFilterPolicy : public FilterPolicy {
+ public:
+  FixedSizeRibbonFilterPolicy(size_t total_bits, double error_rate)
+      : total_bits_(total_bits), error_rate_(error_rate) {
+    DCHECK_GT(error_rate, 0);
+  }
+
+  FilterType GetFilterType() const override { return FilterType::kFixedSizeFilter; }
+
+  const char* Name() const override {
+    return "rocksdb.FixedSizeRibbonFilter";
+  }
+
+  // Not used in FixedSizeFilter. GetFilterBitsBuilder/Reader interface should be used.
+  void CreateFilter(const Slice* keys, int n, std::string* dst) const override {
+    assert(!"FixedSizeRibbonFilterPolicy::CreateFilter is not supported");
+  }
+
+  bool KeyMayMatch(const Slice& key, const Slice& filter) const override {
+    assert(!"FixedSizeRibbonFilterPolicy::KeyMayMatch is not supported");
+    return true;
+  }
+
+  FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    return new FixedSizeRibbonFilterBitsBuilder(total_bits_, error_rate_);
+  }
+
+  FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    return new FixedSizeRibbonFilterBitsReader(contents);
+  }
+
+ private:
+  size_t total_bits_;
+  double error_rate_;
+};
+
+} // namespace
+
+const FilterPolicy* NewFixedSizeRibbonFilterPolicy(size_t total_bits, double error_rate) {
+  return new FixedSizeRibbonFilterPolicy(total_bits, error_rate);
+}
+
+}  // namespace rocksdb
@@ -272,6 +272,11 @@ class StringSource: public RandomAccessFile {
     return Status::OK();
   }
 
+  void MultiRead(ReadRequest* requests, size_t count) const override {
+    total_multi_reads_++;
+    RandomAccessFile::MultiRead(requests, count);
+  }
+
   virtual size_t GetUniqueId(char* id) const override {
     char* rid = id;
     rid = EncodeVarint64(rid, uniq_id_);
@@ -289,12 +294,15 @@ class StringSource: public RandomAccessFile {
 
   void set_total_reads(int tr) { total_reads_ = tr; }
 
+  int total_multi_reads() const { return total_multi_reads_; }
+
  private:
   std::string filename_ = "StringSource";
   std::string contents_;
   uint64_t uniq_id_;
   bool mmap_;
   mutable int total_reads_;
+  mutable int total_multi_reads_ = 0;
 };
 
 class NullLogger : public Logger {
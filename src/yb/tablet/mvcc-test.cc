@@ -45,6 +45,7 @@
 #include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status.h"
+#include "yb/util/test_thread_holder.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals;
@@ -52,6 +53,8 @@ using std::vector;
 
 using yb::server::LogicalClock;
 
+DECLARE_bool(mvcc_lock_free_safe_time);
+
 namespace yb {
 namespace tablet {
 
@@ -92,6 +95,9 @@ TEST_F(MvccTest, Basic) {
 }
 
 TEST_F(MvccTest, SafeHybridTimeToReadAt) {
+  // Lock-free safe time calls are not added to the trace.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_mvcc_lock_free_safe_time) = false;
+
   std::ostringstream mvcc_op_trace_stream;
   manager_.TEST_DumpTrace(&mvcc_op_trace_stream);
   ASSERT_STR_CONTAINS(mvcc_op_trace_stream.str(), "No MVCC operations");
@@ -367,5 +373,45 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, CoarseMonoClock::now() + 100ms, FixedHybridTimeLease()));
 }
 
+TEST_F(MvccTest, ConcurrentSafeTime) {
+  constexpr int kNumReaders = 4;
+  constexpr int kNumOps = 20000;
+  constexpr int kMaxPending = 10;
+
+  TestThreadHolder thread_holder;
+  for (int i = 0; i != kNumReaders; ++i) {
+    thread_holder.AddThreadFunctor([this, i, &stop = thread_holder.stop_flag()] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      while (!stop.load(std::memory_order_acquire)) {
+        // Readers with and without lease use different max returned safe time.
+        auto safe_time = i % 2
+            ? manager_.SafeTime(FixedHybridTimeLease())
+            : manager_.SafeTimeForFollower(HybridTime::kMin, CoarseTimePoint::max());
+        ASSERT_GE(safe_time, last_safe_time);
+        last_safe_time = safe_time;
+      }
+    });
+  }
+
+  // MvccManager checks that hybrid time of each added operation is greater than any returned safe
+  // time.
+  std::deque<std::pair<HybridTime, OpId>> pending;
+  for (int i = 1; i <= kNumOps; ++i) {
+    OpId op_id(1, i);
+    pending.emplace_back(manager_.AddLeaderPending(op_id), op_id);
+    if (pending.size() > kMaxPending || RandomUniformBool()) {
+      manager_.Replicated(pending.front().first, pending.front().second);
+      pending.pop_front();
+    }
+    manager_.UpdatePropagatedSafeTimeOnLeader(FixedHybridTimeLease());
+  }
+  while (!pending.empty()) {
+    manager_.Replicated(pending.front().first, pending.front().second);
+    pending.pop_front();
+  }
+
+  thread_holder.Stop();
+}
+
 } // namespace tablet
 } // namespace yb
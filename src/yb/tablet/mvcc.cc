@@ -43,6 +43,7 @@
 #include "yb/util/flags.h"
 #include "yb/util/format.h"
 #include "yb/util/logging.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
 
 using std::ostream;
@@ -56,6 +57,11 @@ DEFINE_test_flag(int64, mvcc_op_trace_num_items, 32,
 DEFINE_test_flag(int32, inject_mvcc_delay_add_leader_pending_ms, 0,
                  "Inject delay after MvccManager::AddLeaderPending read clock.");
 
+DEFINE_RUNTIME_bool(mvcc_lock_free_safe_time, true,
+                    "Calculate safe time without taking the MVCC mutex, when the caller does "
+                    "not have to wait for it.");
+TAG_FLAG(mvcc_lock_free_safe_time, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -153,14 +159,6 @@ struct SafeTimeForFollowerTraceItem {
   }
 };
 
-struct LastReplicatedHybridTimeTraceItem {
-  HybridTime last_replicated;
-
-  std::string ToString() const {
-    return Format("LastReplicatedHybridTime $0", YB_STRUCT_TO_STRING(last_replicated));
-  }
-};
-
 typedef boost::variant<
     SetLeaderOnlyModeTraceItem,
     SetLastReplicatedTraceItem,
@@ -171,8 +169,7 @@ typedef boost::variant<
     ReplicatedTraceItem,
     AbortedTraceItem,
     SafeTimeTraceItem,
-    SafeTimeForFollowerTraceItem,
-    LastReplicatedHybridTimeTraceItem
+    SafeTimeForFollowerTraceItem
     > TraceItemVariant;
 
 class ItemPrintingVisitor : public boost::static_visitor<>{
@@ -248,6 +245,55 @@ std::string SafeTimeWithSource::ToString() const {
 // MvccManager
 // ------------------------------------------------------------------------------------------------
 
+// ------------------------------------------------------------------------------------------------
+// MvccManager::AtomicSafeTimeWithSource
+// ------------------------------------------------------------------------------------------------
+
+SafeTimeWithSource MvccManager::AtomicSafeTimeWithSource::Load() const {
+  return SafeTimeWithSource {
+    .safe_time = safe_time_.load(std::memory_order_acquire),
+    .source = source_.load(std::memory_order_acquire),
+  };
+}
+
+void MvccManager::AtomicSafeTimeWithSource::UpdateMax(
+    HybridTime safe_time, SafeTimeSource source) {
+  auto current = safe_time_.load(std::memory_order_acquire);
+  while (current < safe_time) {
+    if (safe_time_.compare_exchange_weak(current, safe_time, std::memory_order_acq_rel)) {
+      source_.store(source, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+// ------------------------------------------------------------------------------------------------
+// MvccManager::ModificationScope
+// ------------------------------------------------------------------------------------------------
+
+// Marks modification of the state used to calculate safe time, so lock-free readers that
+// overlap with it fall back to the mutex.
+// Sequentially consistent increments are used, so a leader operation, that reads the clock after
+// the first increment, gets hybrid time greater than safe time of any lock-free reader that did
+// not notice this modification, since such reader had read the clock before the increment.
+class MvccManager::ModificationScope {
+ public:
+  explicit ModificationScope(MvccManager* mvcc) : mvcc_(*mvcc) {
+    mvcc_.version_.fetch_add(1);
+  }
+
+  ~ModificationScope() {
+    mvcc_.version_.fetch_add(1);
+  }
+
+ private:
+  MvccManager& mvcc_;
+};
+
+// ------------------------------------------------------------------------------------------------
+// MvccManager
+// ------------------------------------------------------------------------------------------------
+
 MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
     : prefix_(std::move(prefix)),
       clock_(std::move(clock)) {
@@ -260,6 +306,21 @@ MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
 MvccManager::~MvccManager() {
 }
 
+void MvccManager::UpdateQueueFront() {
+  queue_front_ht_.store(
+      queue_.empty() ? HybridTime::kInvalid : queue_.front().hybrid_time,
+      std::memory_order_release);
+}
+
+void MvccManager::NotifyWaiters() {
+  // Waiter increments num_waiters_ under the mutex before checking its predicate, so after the
+  // mutex was released by the modifying thread it is either visible here or the waiter sees the
+  // modification.
+  if (num_waiters_.load(std::memory_order_acquire)) {
+    cond_.notify_all();
+  }
+}
+
 void MvccManager::Replicated(HybridTime ht, const OpId& op_id) {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ", " << op_id << ")";
   CHECK(!op_id.empty());
@@ -272,10 +333,12 @@ void MvccManager::Replicated(HybridTime ht, const OpId& op_id) {
     CHECK(!queue_.empty()) << InvariantViolationLogPrefix();
     CHECK_EQ(queue_.front(),
              (QueueItem{ .hybrid_time = ht, .op_id = op_id })) << InvariantViolationLogPrefix();
+    ModificationScope modification(this);
     queue_.pop_front();
-    last_replicated_ = ht;
+    UpdateQueueFront();
+    last_replicated_.store(ht, std::memory_order_release);
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::Aborted(HybridTime ht, const OpId& op_id) {
@@ -290,9 +353,11 @@ void MvccManager::Aborted(HybridTime ht, const OpId& op_id) {
     CHECK_EQ(queue_.back(),
              (QueueItem{ .hybrid_time = ht, .op_id = op_id }))
         << InvariantViolationLogPrefix() << "It is allowed to abort only last operation";
+    ModificationScope modification(this);
     queue_.pop_back();
+    UpdateQueueFront();
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 bool BadNextOpId(const OpId& prev, const OpId& next) {
@@ -307,6 +372,8 @@ bool BadNextOpId(const OpId& prev, const OpId& next) {
 
 HybridTime MvccManager::AddLeaderPending(const OpId& op_id) {
   std::lock_guard<std::mutex> lock(mutex_);
+  // Clock should be read after lock-free readers are notified about the modification.
+  ModificationScope modification(this);
   auto ht = clock_->Now();
   AtomicFlagSleepMs(&FLAGS_TEST_inject_mvcc_delay_add_leader_pending_ms);
   VLOG_WITH_PREFIX(1) << __func__ << "(" << op_id << "), time: " << ht;
@@ -326,6 +393,7 @@ void MvccManager::AddFollowerPending(HybridTime ht, const OpId& op_id) {
   std::lock_guard<std::mutex> lock(mutex_);
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ", " << op_id << ")";
 
+  ModificationScope modification(this);
   AddPending(ht, op_id, /* is_follower_side= */ true);
 
   if (op_trace_) {
@@ -341,13 +409,19 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
 
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back().hybrid_time;
 
+  const auto max_safe_time_returned_with_lease = max_safe_time_returned_with_lease_.Load();
+  const auto max_safe_time_returned_without_lease = max_safe_time_returned_without_lease_.Load();
+  const auto max_safe_time_returned_for_follower = max_safe_time_returned_for_follower_.Load();
+  const auto propagated_safe_time = propagated_safe_time_.load(std::memory_order_acquire);
+  const auto last_replicated = last_replicated_.load(std::memory_order_acquire);
+
   HybridTime sanity_check_lower_bound =
       std::max({
-          max_safe_time_returned_with_lease_.safe_time,
-          max_safe_time_returned_without_lease_.safe_time,
-          max_safe_time_returned_for_follower_.safe_time,
-          propagated_safe_time_,
-          last_replicated_,
+          max_safe_time_returned_with_lease.safe_time,
+          max_safe_time_returned_without_lease.safe_time,
+          max_safe_time_returned_for_follower.safe_time,
+          propagated_safe_time,
+          last_replicated,
           last_ht_in_queue});
 
   if (ht <= sanity_check_lower_bound) {
@@ -365,12 +439,12 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
 #define LOG_INFO_FOR_HT_LOWER_BOUND(t) LOG_INFO_FOR_HT_LOWER_BOUND_IMPL(t, t)
 
       ss << "New operation's hybrid time too low: " << ht << ", op id: " << op_id
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_with_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_without_lease_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_for_follower_)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_with_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_without_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_for_follower)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_ht_in_queue)
-         << LOG_INFO_FOR_HT_LOWER_BOUND(propagated_safe_time_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(propagated_safe_time)
          << "\n  " << EXPR_VALUE_FOR_LOG(queue_.size())
          << "\n  " << EXPR_VALUE_FOR_LOG(queue_);
       return ss.str();
@@ -406,6 +480,9 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
     .hybrid_time = ht,
     .op_id = op_id,
   });
+  if (queue_.size() == 1) {
+    UpdateQueueFront();
+  }
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -416,9 +493,10 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
     if (op_trace_) {
       op_trace_->Add(SetLastReplicatedTraceItem { .ht = ht });
     }
-    last_replicated_ = ht;
+    ModificationScope modification(this);
+    last_replicated_.store(ht, std::memory_order_release);
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
@@ -429,16 +507,18 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
     if (op_trace_) {
       op_trace_->Add(SetPropagatedSafeTimeOnFollowerTraceItem { .ht = ht });
     }
-    if (ht >= propagated_safe_time_) {
-      propagated_safe_time_ = ht;
+    const auto propagated_safe_time = propagated_safe_time_.load(std::memory_order_acquire);
+    if (ht >= propagated_safe_time) {
+      ModificationScope modification(this);
+      propagated_safe_time_.store(ht, std::memory_order_release);
     } else {
       LOG_WITH_PREFIX(WARNING)
           << "Received propagated safe time " << ht << " less than the old value: "
-          << propagated_safe_time_ << ". This could happen on followers when a new leader "
+          << propagated_safe_time << ". This could happen on followers when a new leader "
           << "is elected.";
     }
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
@@ -452,21 +532,24 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
                                    CoarseTimePoint::max(), // deadline
                                    ht_lease,
                                    &lock);
+    const auto propagated_safe_time = propagated_safe_time_.load(std::memory_order_acquire);
 #ifndef NDEBUG
     // This should only be called from RaftConsensus::UpdateMajorityReplicated, and ht_lease passed
     // in here should keep increasing, so we should not see propagated_safe_time_ going backwards.
-    CHECK_GE(safe_time, propagated_safe_time_)
+    CHECK_GE(safe_time, propagated_safe_time)
         << InvariantViolationLogPrefix()
         << "ht_lease: " << ht_lease;
-    propagated_safe_time_ = safe_time;
+    ModificationScope modification(this);
+    propagated_safe_time_.store(safe_time, std::memory_order_release);
 #else
     // Do not crash in production.
-    if (safe_time < propagated_safe_time_) {
+    if (safe_time < propagated_safe_time) {
       YB_LOG_EVERY_N_SECS(ERROR, 5) << LogPrefix()
-          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time_)
+          << "Previously saw " << EXPR_VALUE_FOR_LOG(propagated_safe_time)
           << ", but now safe time is " << safe_time;
     } else {
-      propagated_safe_time_ = safe_time;
+      ModificationScope modification(this);
+      propagated_safe_time_.store(safe_time, std::memory_order_release);
     }
 #endif
 
@@ -477,7 +560,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
       });
     }
   }
-  cond_.notify_all();
+  NotifyWaiters();
 }
 
 void MvccManager::SetLeaderOnlyMode(bool leader_only) {
@@ -487,56 +570,104 @@ void MvccManager::SetLeaderOnlyMode(bool leader_only) {
       .leader_only = leader_only
     });
   }
-  leader_only_mode_ = leader_only;
+  ModificationScope modification(this);
+  leader_only_mode_.store(leader_only, std::memory_order_release);
+}
+
+HybridTime MvccManager::TryGetSafeTimeForFollowerLockFree(HybridTime min_allowed) const {
+  const auto version = version_.load(std::memory_order_acquire);
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+  const auto max_returned = max_safe_time_returned_for_follower_.safe_time();
+  const auto propagated_safe_time = propagated_safe_time_.load(std::memory_order_acquire);
+  const auto last_replicated = last_replicated_.load(std::memory_order_acquire);
+  const auto queue_front_ht = queue_front_ht_.load(std::memory_order_acquire);
+
+  SafeTimeWithSource result;
+  if (propagated_safe_time > last_replicated) {
+    if (!queue_front_ht || propagated_safe_time < queue_front_ht) {
+      result = { propagated_safe_time, SafeTimeSource::kPropagated };
+    } else {
+      result = { queue_front_ht.Decremented(), SafeTimeSource::kNextInQueue };
+    }
+  } else {
+    result = { last_replicated, SafeTimeSource::kLastReplicated };
+  }
+
+  if (result.safe_time < min_allowed || version_.load() != version) {
+    return HybridTime::kInvalid;
+  }
+
+  CHECK_GE(result.safe_time, max_returned)
+      << InvariantViolationLogPrefix()
+      << "result: " << result.ToString()
+      << ", max_safe_time_returned_for_follower_: "
+      << max_safe_time_returned_for_follower_.Load().ToString();
+  max_safe_time_returned_for_follower_.UpdateMax(result.safe_time, result.source);
+  VTRACE(2, "Returning safe time $0. Source $1", yb::ToString(result.safe_time),
+         yb::ToString(result.source));
+  return result.safe_time;
 }
 
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const NO_THREAD_SAFETY_ANALYSIS {
-  std::unique_lock<std::mutex> lock(mutex_);
-
-  if (leader_only_mode_) {
+  if (leader_only_mode_.load(std::memory_order_acquire)) {
     // If there are no followers (RF == 1), use SafeTime() because propagated_safe_time_ might not
     // have a valid value.
+    return SafeTime(min_allowed, deadline, FixedHybridTimeLease());
+  }
+
+  if (FLAGS_mvcc_lock_free_safe_time) {
+    auto result = TryGetSafeTimeForFollowerLockFree(min_allowed);
+    if (result) {
+      return result;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  if (leader_only_mode_.load(std::memory_order_acquire)) {
     return DoGetSafeTime(min_allowed, deadline, FixedHybridTimeLease(), &lock);
   }
 
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
+    const auto propagated_safe_time = propagated_safe_time_.load(std::memory_order_acquire);
+    const auto last_replicated = last_replicated_.load(std::memory_order_acquire);
     // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
     // could be greater than propagated_safe_time_.
-    if (propagated_safe_time_ > last_replicated_) {
-      if (queue_.empty() || propagated_safe_time_ < queue_.front().hybrid_time) {
-        result.safe_time = propagated_safe_time_;
+    if (propagated_safe_time > last_replicated) {
+      if (queue_.empty() || propagated_safe_time < queue_.front().hybrid_time) {
+        result.safe_time = propagated_safe_time;
         result.source = SafeTimeSource::kPropagated;
       } else {
         result.safe_time = queue_.front().hybrid_time.Decremented();
         result.source = SafeTimeSource::kNextInQueue;
       }
     } else {
-      result.safe_time = last_replicated_;
+      result.safe_time = last_replicated;
       result.source = SafeTimeSource::kLastReplicated;
     }
     VTRACE(3, "Current safe time $0. Source $1", yb::ToString(result.safe_time),
            yb::ToString(result.source));
     return result.safe_time >= min_allowed;
   };
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline, predicate)) {
+  if (!WaitFor(deadline, predicate, &lock)) {
     return HybridTime::kInvalid;
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result.ToString();
-  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower_.safe_time)
+  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower_.safe_time())
       << InvariantViolationLogPrefix()
       << "result: " << result.ToString()
       << ", max_safe_time_returned_for_follower_: "
-      << max_safe_time_returned_for_follower_.ToString();
+      << max_safe_time_returned_for_follower_.Load().ToString();
   VTRACE(2, "Min requested safe time was $0", yb::ToString(min_allowed));
   VTRACE(2, "Returning safe time $0. Source $1", yb::ToString(result.safe_time),
          yb::ToString(result.source));
-  max_safe_time_returned_for_follower_ = result;
+  max_safe_time_returned_for_follower_.UpdateMax(result.safe_time, result.source);
   if (op_trace_) {
     op_trace_->Add(SafeTimeForFollowerTraceItem {
       .min_allowed = min_allowed,
@@ -547,11 +678,74 @@ HybridTime MvccManager::SafeTimeForFollower(
   return result.safe_time;
 }
 
+HybridTime MvccManager::TryGetSafeTimeLockFree(
+    HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const {
+  const auto version = version_.load(std::memory_order_acquire);
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+
+  const bool has_lease = !ht_lease.empty();
+  const auto max_returned_with_lease = max_safe_time_returned_with_lease_.safe_time();
+  const auto enforced_min_time = has_lease ? max_returned_with_lease
+                                           : max_safe_time_returned_without_lease_.safe_time();
+  const auto queue_front_ht = queue_front_ht_.load(std::memory_order_acquire);
+
+  HybridTime result;
+  SafeTimeSource source;
+  if (!queue_front_ht) {
+    result = ht_lease.time.is_valid() ? std::max(max_returned_with_lease, ht_lease.time)
+                                      : clock_->Now();
+    source = SafeTimeSource::kNow;
+  } else {
+    result = queue_front_ht.Decremented();
+    source = SafeTimeSource::kNextInQueue;
+  }
+
+  if (has_lease) {
+    auto used_lease = std::max(ht_lease.lease, max_returned_with_lease);
+    if (result > used_lease) {
+      result = used_lease;
+      source = SafeTimeSource::kHybridTimeLease;
+    }
+  }
+
+  result = std::max(result, last_replicated_.load(std::memory_order_acquire));
+
+  // Sequentially consistent load, see ModificationScope.
+  if (result < min_allowed || version_.load() != version) {
+    return HybridTime::kInvalid;
+  }
+
+  CHECK_GE(result, enforced_min_time)
+      << InvariantViolationLogPrefix()
+      << ": " << EXPR_VALUE_FOR_LOG(has_lease)
+      << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
+      << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
+      << ", " << EXPR_VALUE_FOR_LOG(queue_front_ht);
+
+  (has_lease ? max_safe_time_returned_with_lease_ : max_safe_time_returned_without_lease_)
+      .UpdateMax(result, source);
+  VTRACE(2, "Returning safe time $0. Source $1. Min requested safe time was $2",
+         yb::ToString(result), yb::ToString(source), yb::ToString(min_allowed));
+  return result;
+}
+
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
 HybridTime MvccManager::SafeTime(
     HybridTime min_allowed,
     CoarseTimePoint deadline,
     const FixedHybridTimeLease& ht_lease) const NO_THREAD_SAFETY_ANALYSIS {
+  // Lock-free calls are not added to op_trace_, since it is protected by the mutex.
+  if (FLAGS_mvcc_lock_free_safe_time) {
+    CHECK(ht_lease.lease.is_valid()) << InvariantViolationLogPrefix();
+    CHECK_LE(min_allowed, ht_lease.lease) << InvariantViolationLogPrefix();
+    auto result = TryGetSafeTimeLockFree(min_allowed, ht_lease);
+    if (result) {
+      return result;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
   auto safe_time = DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
   if (op_trace_) {
@@ -565,6 +759,24 @@ HybridTime MvccManager::SafeTime(
   return safe_time;
 }
 
+template <class Predicate>
+bool MvccManager::WaitFor(
+    CoarseTimePoint deadline, const Predicate& predicate,
+    std::unique_lock<std::mutex>* lock) const {
+  if (predicate()) {
+    return true;
+  }
+  num_waiters_.fetch_add(1, std::memory_order_acq_rel);
+  auto se = ScopeExit([this] {
+    num_waiters_.fetch_sub(1, std::memory_order_acq_rel);
+  });
+  if (deadline == CoarseTimePoint::max()) {
+    cond_.wait(*lock, predicate);
+    return true;
+  }
+  return cond_.wait_until(*lock, deadline, predicate);
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const CoarseTimePoint deadline,
                                       const FixedHybridTimeLease& ht_lease,
@@ -582,11 +794,18 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   }
 
   HybridTime result;
+  HybridTime enforced_min_time;
   SafeTimeSource source = SafeTimeSource::kUnknown;
-  auto predicate = [this, &result, &source, min_allowed, ht_lease, has_lease] {
+  auto predicate = [this, &result, &enforced_min_time, &source, min_allowed, ht_lease,
+                    has_lease] {
+    // Lock-free readers could concurrently increase max safe time, so it is loaded before the safe
+    // time is calculated.
+    const auto max_returned_with_lease = max_safe_time_returned_with_lease_.safe_time();
+    enforced_min_time = has_lease ? max_returned_with_lease
+                                  : max_safe_time_returned_without_lease_.safe_time();
     if (queue_.empty()) {
       result = ht_lease.time.is_valid()
-          ? std::max(max_safe_time_returned_with_lease_.safe_time, ht_lease.time)
+          ? std::max(max_returned_with_lease, ht_lease.time)
           : clock_->Now();
       source = SafeTimeSource::kNow;
       VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
@@ -597,7 +816,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
     }
 
     if (has_lease) {
-      auto used_lease = std::max({ht_lease.lease, max_safe_time_returned_with_lease_.safe_time});
+      auto used_lease = std::max({ht_lease.lease, max_returned_with_lease});
       if (result > used_lease) {
         result = used_lease;
         source = SafeTimeSource::kHybridTimeLease;
@@ -606,7 +825,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
     // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
     // is safe to read at least at last_replicated_.
-    result = std::max(result, last_replicated_);
+    result = std::max(result, last_replicated_.load(std::memory_order_acquire));
     VTRACE(3, "Current safe time $0. Source $1", yb::ToString(result),
            yb::ToString(source));
 
@@ -615,51 +834,40 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline, predicate)) {
+  if (!WaitFor(deadline, predicate, lock)) {
     return HybridTime::kInvalid;
   }
   VLOG_WITH_PREFIX_AND_FUNC(1)
       << "(" << min_allowed << ", " << ht_lease << "),  result = " << result;
 
-  auto enforced_min_time = has_lease ? max_safe_time_returned_with_lease_.safe_time
-                                     : max_safe_time_returned_without_lease_.safe_time;
   CHECK_GE(result, enforced_min_time)
       << InvariantViolationLogPrefix()
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
       << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
-      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
+      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_.load())
       << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
       << ", " << EXPR_VALUE_FOR_LOG(ToString(deadline))
       << ", " << EXPR_VALUE_FOR_LOG(queue_.size())
       << ", " << EXPR_VALUE_FOR_LOG(queue_);
 
-  if (has_lease) {
-    max_safe_time_returned_with_lease_ = { result, source };
-  } else {
-    max_safe_time_returned_without_lease_ = { result, source };
-  }
+  (has_lease ? max_safe_time_returned_with_lease_ : max_safe_time_returned_without_lease_)
+      .UpdateMax(result, source);
   VTRACE(2, "Returning safe time $0. Source $1. Min requested safe time was $2",
          yb::ToString(result), yb::ToString(source), yb::ToString(min_allowed));
   return result;
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
-  if (op_trace_) {
-    op_trace_->Add(LastReplicatedHybridTimeTraceItem {
-      .last_replicated = last_replicated_
-    });
-  }
-  return last_replicated_;
+  auto result = last_replicated_.load(std::memory_order_acquire);
+  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+  return result;
 }
 
 // Using NO_THREAD_SAFETY_ANALYSIS here because we're only reading op_trace_ here and it is set
 // in the constructor.
-MvccManager::InvariantViolationLoggingHelper MvccManager::InvariantViolationLogPrefix() const {
+MvccManager::InvariantViolationLoggingHelper MvccManager::InvariantViolationLogPrefix() const
+    NO_THREAD_SAFETY_ANALYSIS {
   return { prefix_, op_trace_.get() };
 }
 
@@ -31,6 +31,7 @@
 //
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <vector>
@@ -79,6 +80,11 @@ inline std::ostream& operator<<(std::ostream& out, const FixedHybridTimeLease& h
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Operations are added and removed under the mutex, but the state that is used to calculate safe
+// time is also published through atomics, guarded by a sequence counter. So SafeTime calls, that
+// don't have to wait, are served without taking the mutex. Only readers that wait for safe time
+// take the mutex, and they are notified only when there are such readers.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -159,17 +165,64 @@ class MvccManager {
   const std::string& LogPrefix() const { return prefix_; }
 
   struct InvariantViolationLoggingHelper;
-  InvariantViolationLoggingHelper InvariantViolationLogPrefix() const REQUIRES(mutex_);
+  // Could be used by lock-free readers, since trace is dumped only when invariant is violated.
+  InvariantViolationLoggingHelper InvariantViolationLogPrefix() const;
 
   friend std::ostream& operator<<(
       std::ostream& out, const InvariantViolationLoggingHelper& helper);
 
   void AddPending(HybridTime ht, const OpId& op_id, bool is_follower_side) REQUIRES(mutex_);
 
+  // Tries to calculate safe time without taking the mutex. Returns invalid hybrid time if the
+  // state was concurrently modified, or if the safe time is less than min_allowed, so the caller
+  // has to wait for it.
+  HybridTime TryGetSafeTimeLockFree(
+      HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const;
+  HybridTime TryGetSafeTimeForFollowerLockFree(HybridTime min_allowed) const;
+
+  // Publishes hybrid time of the queue front to lock-free readers.
+  void UpdateQueueFront() REQUIRES(mutex_);
+
+  // Waits until predicate is satisfied or deadline is reached, returns false in the latter case.
+  template <class Predicate>
+  bool WaitFor(
+      CoarseTimePoint deadline, const Predicate& predicate,
+      std::unique_lock<std::mutex>* lock) const REQUIRES(mutex_);
+
+  // Wakes up readers waiting for safe time, if there are any. Should be called after the mutex is
+  // released.
+  void NotifyWaiters();
+
+  class ModificationScope;
+
+  // Safe time with source, that could be updated concurrently by lock-free readers.
+  // Only the safe time is used for invariant checks, the source is kept for diagnostics.
+  class AtomicSafeTimeWithSource {
+   public:
+    SafeTimeWithSource Load() const;
+
+    HybridTime safe_time() const {
+      return safe_time_.load(std::memory_order_acquire);
+    }
+
+    void UpdateMax(HybridTime safe_time, SafeTimeSource source);
+
+   private:
+    std::atomic<HybridTime> safe_time_{HybridTime::kMin};
+    std::atomic<SafeTimeSource> source_{SafeTimeSource::kUnknown};
+  };
+
   std::string prefix_;
   server::ClockPtr clock_;
   mutable std::mutex mutex_;
   mutable std::condition_variable cond_;
+  // Number of readers waiting on cond_.
+  mutable std::atomic<size_t> num_waiters_{0};
+
+  // Incremented before and after each modification of the state used to calculate safe time, so
+  // it is odd while modification is in progress. Lock-free readers check that it did not change
+  // while they were reading the state.
+  std::atomic<uint64_t> version_{0};
 
   struct QueueItem {
     HybridTime hybrid_time;
@@ -198,18 +251,21 @@ class MvccManager {
   // An ordered queue of times of tracked operations.
   std::deque<QueueItem> queue_;
 
-  HybridTime last_replicated_ = HybridTime::kMin;
+  // Hybrid time of the first item in queue_, invalid if queue_ is empty.
+  std::atomic<HybridTime> queue_front_ht_{HybridTime::kInvalid};
+
+  std::atomic<HybridTime> last_replicated_{HybridTime::kMin};
 
   // If we are a follower, this is the latest safe time sent by the leader to us. If we are the
   // leader, this is a safe time that gets updated every time the majority-replicated watermarks
   // change.
-  HybridTime propagated_safe_time_ = HybridTime::kMin;
+  std::atomic<HybridTime> propagated_safe_time_{HybridTime::kMin};
   // Special flag for RF==1 mode when propagated_safe_time_ can be not up-to-date.
-  bool leader_only_mode_ = false;
+  std::atomic<bool> leader_only_mode_{false};
 
-  mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
-  mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_with_lease_;
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_without_lease_;
+  mutable AtomicSafeTimeWithSource max_safe_time_returned_for_follower_;
 
   std::unique_ptr<MvccOpTrace> op_trace_ GUARDED_BY(mutex_);
 };
@@ -18,7 +18,10 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/common/pgsql_error.h"
 
+#include "yb/docdb/rocksdb_writer.h"
+
 #include "yb/tablet/transaction_participant_context.h"
+#include "yb/tablet/transaction_status_batcher.h"
 
 #include "yb/tserver/tserver_service.pb.h"
 
@@ -40,6 +43,11 @@ DEFINE_UNKNOWN_int64(transaction_abort_check_interval_ms, 5000 * yb::kTimeMultip
 DEFINE_UNKNOWN_int64(transaction_abort_check_timeout_ms, 30000 * yb::kTimeMultiplier,
              "Timeout used when checking for aborted transactions.");
 
+DEFINE_RUNTIME_bool(batch_transaction_status_requests, false,
+                    "Whether status requests of transactions of all tablets of the tablet server "
+                    "should be batched per status tablet and coalesced per transaction.");
+TAG_FLAG(batch_transaction_status_requests, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -234,6 +242,13 @@ void RunningTransaction::SendStatusRequest(
     int64_t serial_no, const RunningTransactionPtr& shared_self) {
   TRACE_FUNC();
   VTRACE(1, yb::ToString(metadata_.transaction_id));
+  if (context_.status_batcher_ && FLAGS_batch_transaction_status_requests) {
+    context_.status_batcher_->RequestStatus(
+        &context_, metadata_.status_tablet, metadata_.transaction_id,
+        context_.participant_context_.Now(),
+        std::bind(&RunningTransaction::StatusReceived, this, _1, _2, serial_no, shared_self));
+    return;
+  }
   tserver::GetTransactionStatusRequestPB req;
   req.set_tablet_id(metadata_.status_tablet);
   req.add_transaction_id()->assign(
@@ -560,6 +575,15 @@ void RunningTransaction::SetApplyOpId(const OpId& op_id) {
   apply_record_op_id_ = op_id;
 }
 
+void RunningTransaction::EnableIntentsCache() {
+  cached_intents_ = std::make_shared<docdb::CachedIntents>();
+}
+
+std::shared_ptr<docdb::CachedIntents> RunningTransaction::TakeCachedIntents() {
+  cached_intents_bytes_ = 0;
+  return std::move(cached_intents_);
+}
+
 bool RunningTransaction::ProcessingApply() const {
   return processing_apply_.load(std::memory_order_acquire);
 }
@@ -122,6 +122,26 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     return apply_record_op_id_;
   }
 
+  // Strong write intents of this transaction are kept in memory, see docdb::CachedIntents.
+  void EnableIntentsCache();
+
+  // Returns null when intents of this transaction are not kept in memory.
+  const std::shared_ptr<docdb::CachedIntents>& cached_intents() const {
+    return cached_intents_;
+  }
+
+  // Size of cached intents that is accounted by the participant.
+  size_t cached_intents_bytes() const {
+    return cached_intents_bytes_;
+  }
+
+  void set_cached_intents_bytes(size_t value) {
+    cached_intents_bytes_ = value;
+  }
+
+  // Stops keeping intents of this transaction in memory, and returns already kept intents.
+  std::shared_ptr<docdb::CachedIntents> TakeCachedIntents();
+
   // Whether this transactions is currently applying intents.
   bool ProcessingApply() const;
 
@@ -193,6 +213,9 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
 
   // Time of the next check whether this transaction has been aborted.
   HybridTime abort_check_ht_;
+
+  std::shared_ptr<docdb::CachedIntents> cached_intents_;
+  size_t cached_intents_bytes_ = 0;
 };
 
 Status MakeAbortedStatus(const TransactionId& id);
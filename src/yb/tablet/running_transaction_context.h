@@ -94,6 +94,8 @@ class RunningTransactionContext {
   rpc::Rpcs rpcs_;
   TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
+  // Tablet server wide batcher of transaction status requests, could be nullptr.
+  TransactionStatusBatcher* status_batcher_ = nullptr;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
 
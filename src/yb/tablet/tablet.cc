@@ -54,6 +54,7 @@
 #include "yb/common/ql_wire_protocol.h"
 
 #include "yb/consensus/consensus.messages.h"
+#include "yb/consensus/consensus_round.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/opid_util.h"
 
@@ -67,6 +68,7 @@
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_compaction_filter_intents.h"
 #include "yb/docdb/docdb_debug.h"
+#include "yb/docdb/docdb_filter_policy.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
@@ -103,6 +105,8 @@
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_error.h"
 
+#include "yb/util/atomic.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flags.h"
@@ -227,6 +231,10 @@ DEFINE_test_flag(int32, slowdown_backfill_by_ms, 0,
 DEFINE_test_flag(uint64, backfill_paging_size, 0,
                  "If set > 0, returns early after processing this number of rows.");
 
+DEFINE_test_flag(int32, concurrent_apply_delay_ms, 0,
+                 "Delay of each write applied by ApplyWritesConcurrently, in milliseconds. Used in "
+                 "tests to make concurrent applies of the same wave overlap.");
+
 DEFINE_test_flag(bool, tablet_verify_flushed_frontier_after_modifying, false,
                  "After modifying the flushed frontier in RocksDB, verify that the restored value "
                  "of it is as expected. Used for testing.");
@@ -270,12 +278,16 @@ DECLARE_int32(rocksdb_level0_stop_writes_trigger);
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int64(apply_intents_task_injected_delay_ms);
 DECLARE_string(regular_tablets_data_block_key_value_encoding);
+DECLARE_bool(regular_tablets_data_block_hash_index);
+DECLARE_uint32(rocksdb_max_subcompactions);
+DECLARE_uint64(rocksdb_min_subcompaction_input_size_bytes);
 DECLARE_int64(cdc_intent_retention_ms);
 
 DEFINE_test_flag(uint64, inject_sleep_before_applying_intents_ms, 0,
                  "Sleep before applying intents to docdb after transaction commit");
 
 DECLARE_bool(TEST_invalidate_last_change_metadata_op);
+DECLARE_uint32(tablet_max_concurrent_apply_writes);
 
 using namespace std::placeholders;
 
@@ -350,6 +362,28 @@ docdb::ConsensusFrontiers* InitFrontiers(
   return InitFrontiers(data.op_id, data.log_ht, HybridTime::kInvalid, frontiers);
 }
 
+Result<docdb::ConsensusFrontiers*> InitWriteFrontiers(
+    const OpId& op_id, HybridTime hybrid_time, const docdb::LWKeyValueWriteBatchPB& write_batch,
+    docdb::ConsensusFrontiers* frontiers) {
+  auto frontiers_ptr = InitFrontiers(op_id, hybrid_time, /* commit_ht= */ HybridTime::kInvalid,
+                                     frontiers);
+  if (frontiers_ptr) {
+    auto ttl = write_batch.has_ttl()
+        ? MonoDelta::FromNanoseconds(write_batch.ttl())
+        : docdb::ValueControlFields::kMaxTtl;
+    frontiers_ptr->Largest().set_max_value_level_ttl_expiration_time(
+        docdb::FileExpirationFromValueTTL(hybrid_time, ttl));
+    for (const auto& p : write_batch.table_schema_version()) {
+      // Since new frontiers does not contain schema version just add it there.
+      auto table_id = p.table_id().empty()
+          ? Uuid::Nil() : VERIFY_RESULT(Uuid::FromSlice(p.table_id()));
+      frontiers_ptr->Smallest().AddSchemaVersion(table_id, p.schema_version());
+      frontiers_ptr->Largest().AddSchemaVersion(table_id, p.schema_version());
+    }
+  }
+  return frontiers_ptr;
+}
+
 rocksdb::UserFrontierPtr MemTableFrontierFromDb(
     rocksdb::DB* db,
     rocksdb::UpdateUserValueType type) {
@@ -506,6 +540,7 @@ Tablet::Tablet(const TabletInitData& data)
         client_future_, clock(), DCHECK_NOTNULL(tablet_metrics_entity_),
         DCHECK_NOTNULL(data.wait_queue_pool)->NewToken(ThreadPool::ExecutionMode::SERIAL)));
     }
+    transaction_participant_->SetStatusBatcher(data.transaction_status_batcher);
   }
 
   // Create index table metadata cache for secondary index update.
@@ -727,6 +762,10 @@ Status Tablet::OpenKeyValueTablet() {
         VERIFY_RESULT(docdb::GetConfiguredKeyValueEncodingFormat(
             FLAGS_regular_tablets_data_block_key_value_encoding));
   }
+  if (FLAGS_regular_tablets_data_block_hash_index) {
+    table_options.data_block_index_type = rocksdb::DataBlockIndexType::kBinarySearchAndHash;
+    table_options.data_block_hash_index_key_transformer = docdb::DocKeyHashIndexKeyTransformer();
+  }
   rocksdb::Options rocksdb_options;
   InitRocksDBOptions(
       &rocksdb_options, LogPrefix(docdb::StorageDbType::kRegular), std::move(table_options));
@@ -780,6 +819,15 @@ Status Tablet::OpenKeyValueTablet() {
   rocksdb_options.level0_stop_writes_trigger = std::numeric_limits<int>::max();
 
   rocksdb::Options regular_rocksdb_options(rocksdb_options);
+  if (FLAGS_rocksdb_max_subcompactions > 1) {
+    // Subcompaction boundaries are placed between DocKeys, so the DocDB compaction feed of each
+    // subcompaction sees all entries of the documents it processes.
+    regular_rocksdb_options.max_subcompactions = FLAGS_rocksdb_max_subcompactions;
+    regular_rocksdb_options.min_subcompaction_input_size =
+        FLAGS_rocksdb_min_subcompaction_input_size_bytes;
+    regular_rocksdb_options.subcompaction_key_transformer =
+        docdb::DocKeyHashIndexKeyTransformer();
+  }
   regular_rocksdb_options.listeners.push_back(
       std::make_shared<RegularRocksDbListener>(this, regular_rocksdb_options.log_prefix));
 
@@ -1049,6 +1097,7 @@ void Tablet::CompleteShutdown(DisableFlushOnShutdown disable_flush_on_shutdown)
   }
 
   cleanup_intent_files_token_.reset();
+  apply_pool_token_.reset();
 
   if (transaction_coordinator_) {
     transaction_coordinator_->Shutdown();
@@ -1247,6 +1296,10 @@ Status Tablet::ApplyRowOperations(
     metrics_->rows_inserted->IncrementBy(put_batch.write_pairs().size());
   }
 
+  if (operation->consensus_round() && !already_applied_to_regular_db) {
+    already_applied_to_regular_db = TakeConcurrentlyApplied(operation->op_id());
+  }
+
   return ApplyOperation(
       *operation, write_request.batch_idx(), put_batch, already_applied_to_regular_db);
 }
@@ -1255,30 +1308,180 @@ Status Tablet::ApplyOperation(
     const Operation& operation, int64_t batch_idx,
     const docdb::LWKeyValueWriteBatchPB& write_batch,
     AlreadyAppliedToRegularDB already_applied_to_regular_db) {
-  auto hybrid_time = operation.WriteHybridTime();
-
   docdb::ConsensusFrontiers frontiers;
   // Even if we have an external hybrid time, use the local commit hybrid time in the consensus
   // frontier.
-  auto frontiers_ptr =
-      InitFrontiers(operation.op_id(), operation.hybrid_time(),
-      /* commit_ht= */ HybridTime::kInvalid, &frontiers);
-  if (frontiers_ptr) {
-    auto ttl = write_batch.has_ttl()
-        ? MonoDelta::FromNanoseconds(write_batch.ttl())
-        : docdb::ValueControlFields::kMaxTtl;
-    frontiers_ptr->Largest().set_max_value_level_ttl_expiration_time(
-        docdb::FileExpirationFromValueTTL(operation.hybrid_time(), ttl));
-    for (const auto& p : write_batch.table_schema_version()) {
-      // Since new frontiers does not contain schema version just add it there.
-      auto table_id = p.table_id().empty()
-          ? Uuid::Nil() : VERIFY_RESULT(Uuid::FromSlice(p.table_id()));
-      frontiers_ptr->Smallest().AddSchemaVersion(table_id, p.schema_version());
-      frontiers_ptr->Largest().AddSchemaVersion(table_id, p.schema_version());
+  auto frontiers_ptr = VERIFY_RESULT(InitWriteFrontiers(
+      operation.op_id(), operation.hybrid_time(), write_batch, &frontiers));
+  return ApplyKeyValueRowOperations(
+      batch_idx, write_batch, frontiers_ptr, operation.WriteHybridTime(),
+      already_applied_to_regular_db);
+}
+
+// Write operation that is applied concurrently with other write operations.
+struct Tablet::ConcurrentApplyEntry {
+  OpId op_id;
+  HybridTime hybrid_time;
+  const LWWritePB* write = nullptr;
+};
+
+namespace {
+
+// Returns true if write request could be applied concurrently with other such requests, i.e. it
+// is a regular non-transactional write, that is idempotent on replay during bootstrap.
+// Fills keys with encoded doc keys of the rows modified by the request.
+bool IsConcurrentlyApplicableWrite(
+    const consensus::LWReplicateMsg& replicate, boost::container::small_vector_base<Slice>* keys) {
+  if (replicate.op_type() != consensus::OperationType::WRITE_OP || !replicate.has_write()) {
+    return false;
+  }
+  const auto& write = replicate.write();
+  if (write.has_external_hybrid_time()) {
+    return false;
+  }
+  const auto& write_batch = write.write_batch();
+  if (write_batch.has_transaction() || write_batch.enable_replicate_transaction_status_table() ||
+      !write_batch.apply_external_transactions().empty() || write_batch.write_pairs().empty()) {
+    return false;
+  }
+  for (const auto& pair : write_batch.write_pairs()) {
+    if (pair.has_transaction() || pair.has_external_hybrid_time()) {
+      return false;
+    }
+    // Same row level granularity, as used by the lock batch of the write query.
+    auto doc_key_size = docdb::DocKey::EncodedSize(pair.key(), docdb::DocKeyPart::kWholeDocKey);
+    if (!doc_key_size.ok()) {
+      return false;
     }
+    keys->push_back(pair.key().Prefix(*doc_key_size));
   }
-  return ApplyKeyValueRowOperations(
-      batch_idx, write_batch, frontiers_ptr, hybrid_time, already_applied_to_regular_db);
+  return true;
+}
+
+} // namespace
+
+void Tablet::ApplyWritesConcurrently(
+    const OpId& last_applied_op_id, const consensus::ConsensusRounds& rounds) {
+  const auto max_concurrency = FLAGS_tablet_max_concurrent_apply_writes;
+  // The last round is always left for in order apply, so it moves op id of frontiers past all
+  // concurrently applied rounds.
+  if (max_concurrency < 2 || rounds.size() < 3 || snapshot_coordinator_) {
+    return;
+  }
+
+  std::vector<ConcurrentApplyEntry> wave;
+  std::unordered_set<Slice, Slice::Hash> wave_keys;
+  boost::container::small_vector<Slice, 16> keys;
+  for (auto it = rounds.begin(), end = rounds.end() - 1; it != end; ++it) {
+    const auto& replicate = *(**it).replicate_msg();
+    const auto op_id = (**it).id();
+    {
+      std::lock_guard<std::mutex> lock(concurrently_applied_mutex_);
+      if (concurrently_applied_op_indexes_.count(op_id.index)) {
+        // Already applied during previous call, but not yet applied in order.
+        continue;
+      }
+    }
+    keys.clear();
+    // Writes of other kinds, and operations of other types, act as a barrier, because they could
+    // depend on the state of the tablet produced by preceding writes.
+    if (!IsConcurrentlyApplicableWrite(replicate, &keys)) {
+      break;
+    }
+    bool conflicts = false;
+    for (const auto& key : keys) {
+      if (wave_keys.count(key)) {
+        conflicts = true;
+        break;
+      }
+    }
+    if (conflicts) {
+      ApplyWritesWave(last_applied_op_id, max_concurrency, &wave);
+      wave_keys.clear();
+    }
+    wave_keys.insert(keys.begin(), keys.end());
+    wave.push_back(ConcurrentApplyEntry {
+      .op_id = op_id,
+      .hybrid_time = HybridTime(replicate.hybrid_time()),
+      .write = &replicate.write(),
+    });
+  }
+  ApplyWritesWave(last_applied_op_id, max_concurrency, &wave);
+}
+
+void Tablet::ApplyWritesWave(
+    const OpId& last_applied_op_id, size_t max_concurrency,
+    std::vector<ConcurrentApplyEntry>* wave) {
+  if (wave->size() < 2) {
+    // Single write is just applied in order.
+    wave->clear();
+    return;
+  }
+
+  struct State {
+    std::vector<ConcurrentApplyEntry> entries;
+    std::atomic<size_t> next_entry{0};
+    CountDownLatch latch;
+
+    explicit State(std::vector<ConcurrentApplyEntry>* wave)
+        : entries(std::move(*wave)), latch(entries.size()) {}
+  };
+
+  auto state = std::make_shared<State>(wave);
+  wave->clear();
+  auto apply = [this, state, last_applied_op_id] {
+    for (;;) {
+      auto idx = state->next_entry.fetch_add(1, std::memory_order_acq_rel);
+      if (idx >= state->entries.size()) {
+        return;
+      }
+      auto& entry = state->entries[idx];
+      UpdateAtomicMax(&max_concurrent_applies_,
+                      num_concurrent_applies_.fetch_add(1, std::memory_order_acq_rel) + 1);
+      if (FLAGS_TEST_concurrent_apply_delay_ms > 0) {
+        SleepFor(MonoDelta::FromMilliseconds(FLAGS_TEST_concurrent_apply_delay_ms));
+      }
+      // Frontiers use op id that was already applied in order. So flushed op id does not pass
+      // operations, that are not yet applied, and writes of this wave are replayed during
+      // bootstrap if the in order apply did not reach them before restart.
+      docdb::ConsensusFrontiers frontiers;
+      auto frontiers_ptr = InitWriteFrontiers(
+          last_applied_op_id, entry.hybrid_time, entry.write->write_batch(), &frontiers);
+      auto status = frontiers_ptr.ok()
+          ? ApplyKeyValueRowOperations(
+                entry.write->batch_idx(), entry.write->write_batch(), *frontiers_ptr,
+                entry.hybrid_time)
+          : frontiers_ptr.status();
+      if (status.ok()) {
+        std::lock_guard<std::mutex> lock(concurrently_applied_mutex_);
+        concurrently_applied_op_indexes_.insert(entry.op_id.index);
+      } else {
+        // Write will be applied in order.
+        LOG_WITH_PREFIX(WARNING) << "Concurrent apply of " << entry.op_id << " failed: " << status;
+      }
+      num_concurrent_applies_.fetch_sub(1, std::memory_order_acq_rel);
+      state->latch.CountDown();
+    }
+  };
+
+  // Current thread also applies writes, so waiting for the thread pool could not dead lock.
+  const auto num_tasks = std::min(state->entries.size(), max_concurrency) - 1;
+  for (size_t i = 0; i != num_tasks && apply_pool_token_; ++i) {
+    if (!apply_pool_token_->SubmitFunc(apply).ok()) {
+      break;
+    }
+  }
+  apply();
+  state->latch.Wait();
+}
+
+AlreadyAppliedToRegularDB Tablet::TakeConcurrentlyApplied(const OpId& op_id) {
+  std::lock_guard<std::mutex> lock(concurrently_applied_mutex_);
+  return AlreadyAppliedToRegularDB(concurrently_applied_op_indexes_.erase(op_id.index) != 0);
+}
+
+void Tablet::SetApplyPool(ThreadPool* thread_pool) {
+  apply_pool_token_ = thread_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
 }
 
 Status Tablet::WriteTransactionalBatch(
@@ -1300,8 +1503,9 @@ Status Tablet::WriteTransactionalBatch(
     store_metadata = add_result.get();
   }
   boost::container::small_vector<uint8_t, 16> encoded_replicated_batch_idx_set;
+  std::shared_ptr<docdb::CachedIntents> cached_intents;
   auto prepare_batch_data = transaction_participant()->PrepareBatchData(
-      transaction_id, batch_idx, &encoded_replicated_batch_idx_set);
+      transaction_id, batch_idx, &encoded_replicated_batch_idx_set, &cached_intents);
   if (!prepare_batch_data) {
     // If metadata is missing it could be caused by aborted and removed transaction.
     // In this case we should not add new intents for it.
@@ -1322,6 +1526,7 @@ Status Tablet::WriteTransactionalBatch(
   if (store_metadata) {
     writer.SetMetadataToStore(&put_batch.transaction());
   }
+  writer.SetCachedIntents(cached_intents.get());
   rocksdb::WriteBatch write_batch;
   write_batch.SetDirectWriter(&writer);
   RequestScope request_scope = VERIFY_RESULT(RequestScope::Create(transaction_participant_.get()));
@@ -1888,6 +2093,8 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+// When intents of the transaction were kept in memory, they are applied from memory, and only
+// removal reads the reverse index.
 Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApplyData& data) {
   VLOG_WITH_PREFIX(4) << __func__ << ": " << data.transaction_id;
 
@@ -1897,13 +2104,26 @@ Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApply
   // transaction is done properly in the rare situation where the committed transaction's intents
   // are still in intents db and not yet in regular db.
   AtomicFlagSleepMs(&FLAGS_TEST_inject_sleep_before_applying_intents_ms);
+  const bool apply_cached =
+      data.cached_intents && !data.apply_state &&
+      docdb::CachedIntentsWriter::CanApply(*data.cached_intents);
   docdb::ApplyIntentsContext context(
       data.transaction_id, data.apply_state, data.aborted, data.commit_ht, data.log_ht,
-      &key_bounds_, intents_db_.get());
-  docdb::IntentsWriter intents_writer(
-      data.apply_state ? data.apply_state->key : Slice(), intents_db_.get(), &context);
+      &key_bounds_, apply_cached ? nullptr : intents_db_.get());
   rocksdb::WriteBatch regular_write_batch;
-  regular_write_batch.SetDirectWriter(&intents_writer);
+  std::optional<docdb::CachedIntentsWriter> cached_writer;
+  std::optional<docdb::IntentsWriter> intents_writer;
+  if (apply_cached) {
+    VLOG_WITH_PREFIX(4) << "Apply " << data.cached_intents->size() << " cached intents";
+    if (metrics_) {
+      metrics_->transactions_applied_from_cached_intents->Increment();
+    }
+    regular_write_batch.SetDirectWriter(&cached_writer.emplace(
+        *data.cached_intents, &context));
+  } else {
+    regular_write_batch.SetDirectWriter(&intents_writer.emplace(
+        data.apply_state ? data.apply_state->key : Slice(), intents_db_.get(), &context));
+  }
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
   docdb::ConsensusFrontiers frontiers;
@@ -321,6 +321,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const docdb::LWKeyValueWriteBatchPB& write_batch,
       AlreadyAppliedToRegularDB already_applied_to_regular_db = AlreadyAppliedToRegularDB::kFalse);
 
+  // Applies non-conflicting non-transactional writes from prefix of committed rounds concurrently,
+  // before rounds are applied in order. All rounds except the last one are considered, so the last
+  // round advances op id of frontiers past concurrently applied rounds.
+  // last_applied_op_id - op id of the last operation that was applied in order.
+  // Concurrently applied writes are not applied to the regular DB again by ApplyRowOperations.
+  void ApplyWritesConcurrently(
+      const OpId& last_applied_op_id, const consensus::ConsensusRounds& rounds);
+
   // Apply a set of RocksDB row operations.
   // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
   Status ApplyKeyValueRowOperations(
@@ -601,6 +609,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   size_t TEST_CountRegularDBRecords();
 
+  // Max number of writes that were applied by ApplyWritesConcurrently at the same time.
+  size_t TEST_MaxConcurrentApplies() const {
+    return max_concurrent_applies_.load(std::memory_order_acquire);
+  }
+
   Status CreateReadIntents(
       const TransactionMetadataPB& transaction_metadata,
       const SubTransactionMetadataPB& subtransaction_metadata,
@@ -683,6 +696,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void SetCleanupPool(ThreadPool* thread_pool);
 
+  // Sets pool used by ApplyWritesConcurrently.
+  void SetApplyPool(ThreadPool* thread_pool);
+
   TabletSnapshots& snapshots() {
     return *snapshots_;
   }
@@ -826,6 +842,17 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       HybridTime hybrid_time,
       const rocksdb::UserFrontiers* frontiers);
 
+  struct ConcurrentApplyEntry;
+
+  // Concurrently applies writes of the wave, that don't conflict with each other, and clears it.
+  void ApplyWritesWave(
+      const OpId& last_applied_op_id, size_t max_concurrency,
+      std::vector<ConcurrentApplyEntry>* wave);
+
+  // Returns whether the write operation with specified op id was applied concurrently, and
+  // forgets about it.
+  AlreadyAppliedToRegularDB TakeConcurrentlyApplied(const OpId& op_id);
+
   Result<TransactionOperationContext> CreateTransactionOperationContext(
       const boost::optional<TransactionId>& transaction_id,
       bool is_ysql_catalog_table,
@@ -1064,6 +1091,16 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<ThreadPoolToken> cleanup_intent_files_token_;
 
+  std::unique_ptr<ThreadPoolToken> apply_pool_token_;
+
+  std::mutex concurrently_applied_mutex_;
+  // Indexes of operations that were applied by ApplyWritesConcurrently, but not yet in order.
+  std::unordered_set<int64_t> concurrently_applied_op_indexes_
+      GUARDED_BY(concurrently_applied_mutex_);
+  // Number of writes being applied by ApplyWritesConcurrently right now, and its max.
+  std::atomic<size_t> num_concurrent_applies_{0};
+  std::atomic<size_t> max_concurrent_applies_{0};
+
   std::unique_ptr<TabletSnapshots> snapshots_;
 
   SnapshotCoordinator* snapshot_coordinator_ = nullptr;
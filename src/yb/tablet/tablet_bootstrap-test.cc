@@ -56,6 +56,7 @@
 #include "yb/util/tsan_util.h"
 
 DECLARE_bool(skip_flushed_entries);
+DECLARE_int32(bootstrap_num_segments_to_read_ahead);
 DECLARE_int32(retryable_request_timeout_secs);
 
 using std::shared_ptr;
@@ -237,6 +238,7 @@ class BootstrapTest : public LogTestBase {
       .append_pool = log_thread_pool_.get(),
       .allocation_pool = log_thread_pool_.get(),
       .log_sync_pool = log_thread_pool_.get(),
+      .read_ahead_pool = log_thread_pool_.get(),
       .retryable_requests = nullptr,
       .test_hooks = test_hooks_
     };
@@ -296,6 +298,30 @@ TEST_F(BootstrapTest, TestBootstrap) {
   IterateTabletRows(tablet.get(), &results);
 }
 
+// Tests that segments that are read ahead are replayed in order.
+TEST_F(BootstrapTest, TestBootstrapReadAhead) {
+  FLAGS_bootstrap_num_segments_to_read_ahead = 3;
+  constexpr int kNumSegments = 10;
+  BuildLog();
+  for (int i = 1; i <= kNumSegments; ++i) {
+    if (i > 1) {
+      ASSERT_OK(RollLog());
+    }
+    const auto op_id = MakeOpId(1, i);
+    AppendReplicateBatch(op_id, op_id, {TupleForAppend(i, i, "read ahead")});
+  }
+
+  TabletPtr tablet;
+  ConsensusBootstrapInfo boot_info;
+  ASSERT_OK(BootstrapTestTablet(&tablet, &boot_info));
+  ASSERT_OPID_EQ(MakeOpId(1, kNumSegments), boot_info.last_id);
+  ASSERT_OPID_EQ(MakeOpId(1, kNumSegments), boot_info.last_committed_id);
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumSegments, results.size());
+}
+
 // Tests attempting a local bootstrap of a tablet that was in the middle of a remote bootstrap
 // before "crashing".
 TEST_F(BootstrapTest, TestIncompleteRemoteBootstrap) {
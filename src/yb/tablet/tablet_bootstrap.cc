@@ -32,6 +32,8 @@
 
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <deque>
+#include <future>
 #include <map>
 #include <set>
 
@@ -100,6 +102,7 @@
 #include "yb/util/status.h"
 #include "yb/util/status_format.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_UNKNOWN_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -130,6 +133,13 @@ DECLARE_int32(retryable_request_timeout_secs);
 
 DEFINE_UNKNOWN_uint64(transaction_status_tablet_log_segment_size_bytes, 4_MB,
               "The segment size for transaction status tablet log roll-overs, in bytes.");
+DEFINE_RUNTIME_int32(bootstrap_num_segments_to_read_ahead, 2,
+                     "Number of log segments that are read, checksummed and decoded by background "
+                     "threads, while entries of the previous segment are replayed during tablet "
+                     "bootstrap. 0 - read segments on the replay thread. Each segment that was "
+                     "read ahead is kept in memory until it is replayed.");
+TAG_FLAG(bootstrap_num_segments_to_read_ahead, advanced);
+
 DEFINE_test_flag(int32, tablet_bootstrap_delay_ms, 0,
                  "Time (in ms) to delay tablet bootstrap by.");
 
@@ -485,6 +495,68 @@ bool WriteOpHasTransaction(const consensus::LWReplicateMsg& replicate) {
   return false;
 }
 
+// Reads log segments in order, up to read_ahead segments ahead of the one that is being replayed.
+// So reading from disk, checksum verification and decoding of entries overlap with the replay and
+// run in parallel for different segments, on the thread pool.
+class SegmentReadAhead {
+ public:
+  // Segments are read on the calling thread, when thread_pool is null or read_ahead is 0.
+  SegmentReadAhead(
+      log::SegmentSequence::const_iterator begin, log::SegmentSequence::const_iterator end,
+      size_t read_ahead, ThreadPool* thread_pool)
+      : next_(begin), end_(end), read_ahead_(thread_pool ? read_ahead : 0),
+        token_(read_ahead_ ? thread_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT)
+                           : nullptr) {
+  }
+
+  // Returns entries of the next segment, waiting for them to be read if necessary.
+  log::ReadEntriesResult Next() {
+    StartReads();
+    auto read = std::move(reads_.front());
+    reads_.pop_front();
+    StartReads();
+    if (!read.submitted) {
+      (*read.task)();
+    }
+    return read.result.get();
+  }
+
+ private:
+  using ReadTask = std::packaged_task<log::ReadEntriesResult()>;
+
+  struct Read {
+    std::shared_ptr<ReadTask> task;
+    std::future<log::ReadEntriesResult> result;
+    bool submitted = false;
+  };
+
+  void StartReads() {
+    while (next_ != end_ && reads_.size() <= read_ahead_) {
+      auto task = std::make_shared<ReadTask>([segment = *next_] { return segment->ReadEntries(); });
+      Read read {
+        .task = task,
+        .result = task->get_future(),
+      };
+      // The segment that is returned by the next call to Next is read on the calling thread, when
+      // read ahead is turned off or the pool does not accept tasks.
+      if (token_) {
+        auto status = token_->SubmitFunc([task] { (*task)(); });
+        LOG_IF(DFATAL, !status.ok()) << "Failed to submit segment read: " << status;
+        read.submitted = status.ok();
+      }
+      reads_.push_back(std::move(read));
+      ++next_;
+    }
+  }
+
+  log::SegmentSequence::const_iterator next_;
+  const log::SegmentSequence::const_iterator end_;
+  const size_t read_ahead_;
+  // Tasks own their state, so reads that did not complete do not refer to this object.
+  std::unique_ptr<ThreadPoolToken> token_;
+  std::deque<Read> reads_;
+};
+
 }  // anonymous namespace
 
 YB_STRONGLY_TYPED_BOOL(NeedsRecovery);
@@ -1329,10 +1401,16 @@ class TabletBootstrap {
     yb::OpId last_committed_op_id;
     yb::OpId last_read_entry_op_id;
     RestartSafeCoarseTimePoint last_entry_time;
+    // When WAL is rewritten, replayed entries are appended to the last segment, so it could be
+    // read only after replay of all previous segments.
+    SegmentReadAhead read_ahead(
+        iter, segments.end(),
+        skip_wal_rewrite_ ? std::max(FLAGS_bootstrap_num_segments_to_read_ahead, 0) : 0,
+        data_.read_ahead_pool);
     for (; iter != segments.end(); ++iter) {
       const scoped_refptr<ReadableLogSegment>& segment = *iter;
 
-      auto read_result = segment->ReadEntries();
+      auto read_result = read_ahead.Next();
       last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
       if (!read_result.entries.empty()) {
         last_read_entry_op_id = yb::OpId::FromPB(read_result.entries.back()->replicate().id());
@@ -161,6 +161,9 @@ struct BootstrapTabletData {
   ThreadPool* append_pool = nullptr;
   ThreadPool* allocation_pool = nullptr;
   ThreadPool* log_sync_pool = nullptr;
+  // Log segments are read ahead of the replay on this pool, see
+  // --bootstrap_num_segments_to_read_ahead. When null, they are read by the bootstrap thread.
+  ThreadPool* read_ahead_pool = nullptr;
   consensus::RetryableRequests* retryable_requests = nullptr;
   std::shared_ptr<TabletBootstrapTestHooksIf> test_hooks = nullptr;
   bool bootstrap_retryable_requests = true;
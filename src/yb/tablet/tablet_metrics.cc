@@ -135,6 +135,11 @@ METRIC_DEFINE_counter(tablet, failed_batch_lock,
   yb::MetricUnit::kUnits,
   "Number of times that WriteQuery fails to obtain batch lock");
 
+METRIC_DEFINE_counter(tablet, transactions_applied_from_cached_intents,
+  "Transactions Applied From Cached Intents",
+  yb::MetricUnit::kTransactions,
+  "Number of transactions applied from cached intents, without reading the intents DB");
+
 using strings::Substitute;
 
 namespace yb {
@@ -158,7 +163,8 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& table_entity,
     MINIT(tablet_entity, pgsql_consistent_prefix_read_rows),
     MINIT(tablet_entity, tablet_data_corruptions),
     MINIT(tablet_entity, rows_inserted),
-    MINIT(tablet_entity, failed_batch_lock) {
+    MINIT(tablet_entity, failed_batch_lock),
+    MINIT(tablet_entity, transactions_applied_from_cached_intents) {
 }
 #undef MINIT
 
@@ -72,6 +72,7 @@ struct TabletMetrics {
 
   scoped_refptr<Counter> rows_inserted;
   scoped_refptr<Counter> failed_batch_lock;
+  scoped_refptr<Counter> transactions_applied_from_cached_intents;
 };
 
 class ScopedTabletMetricsTracker {
@@ -36,6 +36,7 @@ class Cache;
 class EventListener;
 class MemoryMonitor;
 class Env;
+class SecondaryCache;
 
 struct RocksDBPriorityThreadPoolMetrics;
 }
@@ -46,12 +47,16 @@ class AutoFlagsManager;
 class Env;
 class MemTracker;
 class MetricRegistry;
+class ThreadPool;
 
 namespace tablet {
 
 // Common for all tablets within TabletManager.
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  std::shared_ptr<rocksdb::SecondaryCache> secondary_block_cache;
+  // Pool used to read SST data blocks in parallel, when they are prefetched for batched reads.
+  ThreadPool* block_prefetch_pool = nullptr;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
   yb::Env* env = Env::Default();
@@ -83,6 +88,7 @@ struct TabletInitData {
   TransactionManagerProvider transaction_manager_provider;
   docdb::LocalWaitingTxnRegistry* waiting_txn_registry = nullptr;
   ThreadPool* wait_queue_pool = nullptr;
+  TransactionStatusBatcher* transaction_status_batcher = nullptr;
   AutoFlagsManager* auto_flags_manager = nullptr;
   ThreadPool* full_compaction_pool;
   scoped_refptr<yb::AtomicGauge<uint64_t>> post_split_compaction_added;
@@ -265,6 +265,7 @@ Status TabletPeer::InitTabletPeer(
     });
 
     tablet_->SetCleanupPool(raft_pool);
+    tablet_->SetApplyPool(raft_pool);
 
     ConsensusOptions options;
     options.tablet_id = meta_->raft_group_id();
@@ -1314,6 +1315,11 @@ bool TabletPeer::ShouldApplyWrite() {
   return tablet_->ShouldApplyWrite();
 }
 
+void TabletPeer::ApplyConcurrently(
+    const OpId& last_applied_op_id, const consensus::ConsensusRounds& rounds) {
+  tablet_->ApplyWritesConcurrently(last_applied_op_id, rounds);
+}
+
 consensus::Consensus* TabletPeer::consensus() const {
   return raft_consensus();
 }
@@ -237,6 +237,9 @@ class TabletPeer : public std::enable_shared_from_this<TabletPeer>,
   // Returns false if it is preferable to don't apply write operation.
   bool ShouldApplyWrite() override;
 
+  void ApplyConcurrently(
+      const OpId& last_applied_op_id, const consensus::ConsensusRounds& rounds) override;
+
   consensus::Consensus* consensus() const;
   consensus::RaftConsensus* raft_consensus() const;
 
@@ -30,6 +30,7 @@
 #include "yb/consensus/consensus_util.h"
 
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/rocksdb_writer.h"
 #include "yb/docdb/transaction_dump.h"
 
 #include "yb/rpc/poller.h"
@@ -44,6 +45,7 @@
 #include "yb/tablet/running_transaction_context.h"
 #include "yb/tablet/transaction_loader.h"
 #include "yb/tablet/transaction_participant_context.h"
+#include "yb/tablet/transaction_status_batcher.h"
 #include "yb/tablet/transaction_status_resolver.h"
 
 #include "yb/tserver/tserver_service.pb.h"
@@ -100,6 +102,14 @@ DEFINE_NON_RUNTIME_int32(wait_queue_poll_interval_ms, 100,
     "The interval duration between wait queue polls to fetch transaction statuses of "
     "active blockers.");
 
+DEFINE_RUNTIME_uint64(txn_max_cached_intents_bytes, 0,
+    "Max total size of strong write intents that the transaction participant of a tablet caches "
+    "in memory, so committed transactions are applied without reading their intents back from the "
+    "intents DB. Intents are still written to the intents DB, the cache only saves reads on apply. "
+    "Intents of a transaction that does not fit are read from the intents DB. "
+    "0 disables the cache.");
+TAG_FLAG(txn_max_cached_intents_bytes, advanced);
+
 DECLARE_int64(transaction_abort_check_timeout_ms);
 
 DECLARE_int64(cdc_intent_retention_ms);
@@ -175,6 +185,10 @@ class TransactionParticipant::Impl
     return wait_queue_.get();
   }
 
+  void SetStatusBatcher(TransactionStatusBatcher* status_batcher) {
+    status_batcher_ = status_batcher;
+  }
+
   bool StartShutdown() {
     bool expected = false;
     if (!closing_.compare_exchange_strong(expected, true)) {
@@ -220,6 +234,10 @@ class TransactionParticipant::Impl
       mem_tracker_->UnregisterFromParent();
     }
 
+    if (status_batcher_) {
+      // Running transactions use their context as the owner of status requests.
+      status_batcher_->Abort(static_cast<RunningTransactionContext*>(this));
+    }
     rpcs_.Shutdown();
     loader_.Shutdown();
     for (auto& resolver : status_resolvers) {
@@ -259,8 +277,14 @@ class TransactionParticipant::Impl
       return STATUS(InvalidArgument, Format("For external transaction $0, status tablet is empty",
                                              metadata.transaction_id));
     }
-    transactions_.insert(std::make_shared<RunningTransaction>(
-        metadata, TransactionalBatchData(), OneWayBitmap(), metadata.start_time, this));
+    auto transaction = std::make_shared<RunningTransaction>(
+        metadata, TransactionalBatchData(), OneWayBitmap(), metadata.start_time, this);
+    if (GetAtomicFlag(&FLAGS_txn_max_cached_intents_bytes)) {
+      // Transaction is new, so all its intents will be written after this point, either by
+      // replicated write or by WAL replay.
+      transaction->EnableIntentsCache();
+    }
+    transactions_.insert(std::move(transaction));
     mem_tracker_->Consume(kRunningTransactionSize);
     TransactionsModifiedUnlocked(&min_running_notifier);
     return true;
@@ -355,7 +379,8 @@ class TransactionParticipant::Impl
 
   boost::optional<std::pair<IsolationLevel, TransactionalBatchData>> PrepareBatchData(
       const TransactionId& id, size_t batch_idx,
-      boost::container::small_vector_base<uint8_t>* encoded_replicated_batches) {
+      boost::container::small_vector_base<uint8_t>* encoded_replicated_batches,
+      std::shared_ptr<docdb::CachedIntents>* cached_intents) {
     // We are not trying to cleanup intents here because we don't know whether this transaction
     // has intents of not.
     auto lock_and_iterator = LockAndFind(
@@ -365,6 +390,7 @@ class TransactionParticipant::Impl
     }
     auto& transaction = lock_and_iterator.transaction();
     transaction.AddReplicatedBatch(batch_idx, encoded_replicated_batches);
+    *cached_intents = transaction.cached_intents();
     return std::make_pair(transaction.metadata().isolation, transaction.last_batch_data());
   }
 
@@ -377,6 +403,12 @@ class TransactionParticipant::Impl
       return;
     }
     (**it).BatchReplicated(data);
+    CachedIntentsChangedUnlocked(&**it);
+  }
+
+  size_t TEST_CachedIntentsBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_intents_bytes_;
   }
 
   void RequestStatusAt(const StatusRequest& request) {
@@ -658,7 +690,7 @@ class TransactionParticipant::Impl
     participant_context_.StrandEnqueue(cleanup_aborts_task.get());
   }
 
-  Status ProcessApply(const TransactionApplyData& data) {
+  Status ProcessApply(const TransactionApplyData& data) EXCLUDES(mutex_) {
     VLOG_WITH_PREFIX(2) << "Apply: " << data.ToString();
 
     loader_.WaitLoaded(data.transaction_id);
@@ -670,6 +702,7 @@ class TransactionParticipant::Impl
     }
 
     bool was_previously_committed = false;
+    std::shared_ptr<docdb::CachedIntents> cached_intents;
 
     {
       // It is our last chance to load transaction metadata, if missing.
@@ -700,6 +733,9 @@ class TransactionParticipant::Impl
         CHECK(transactions_.modify(lock_and_iterator.iterator, [&data](auto& txn) {
           txn->SetLocalCommitData(data.commit_ht, data.aborted);
         }));
+        // Transaction does not receive new intents after commit.
+        AssertLocked(lock_and_iterator);
+        cached_intents = ReleaseCachedIntentsUnlocked(&lock_and_iterator.transaction());
         if (!lock_and_iterator.transaction().external_transaction()) {
           LOG_IF_WITH_PREFIX(DFATAL, data.log_ht < last_safe_time_)
               << "Apply transaction before last safe time " << data.transaction_id
@@ -718,7 +754,9 @@ class TransactionParticipant::Impl
         // TODO(wait-queues): Consider signaling before replicating the transaction update.
         wait_queue_->SignalCommitted(data.transaction_id, data.commit_ht);
       }
-      auto apply_state = CHECK_RESULT(applier_.ApplyIntents(data));
+      auto apply_data = data;
+      apply_data.cached_intents = std::move(cached_intents);
+      auto apply_state = CHECK_RESULT(applier_.ApplyIntents(apply_data));
 
       VLOG_WITH_PREFIX(4) << "TXN: " << data.transaction_id << ": apply state: "
                           << apply_state.ToString();
@@ -1429,6 +1467,11 @@ class TransactionParticipant::Impl
     }
   };
 
+  // Tells thread safety analysis that mutex_ is held by the lock of the LockAndFind result.
+  void AssertLocked(const LockAndFindResult& lock_and_iterator) ASSERT_CAPABILITY(mutex_) {
+    DCHECK(lock_and_iterator.lock.owns_lock() && lock_and_iterator.lock.mutex() == &mutex_);
+  }
+
   LockAndFindResult LockAndFind(
       const TransactionId& id, const std::string& reason, TransactionLoadFlags flags) {
     loader_.WaitLoaded(id);
@@ -1538,11 +1581,42 @@ class TransactionParticipant::Impl
     if (transaction.WasAborted()) {
       metric_aborted_transactions_pending_cleanup_->Decrement();
     }
+    ReleaseCachedIntentsUnlocked(&transaction);
     transactions_.erase(it);
     mem_tracker_->Release(kRunningTransactionSize);
     TransactionsModifiedUnlocked(min_running_notifier);
   }
 
+  // Accounts size of cached intents of the transaction, after a batch was added to them.
+  // When total size exceeds the limit, intents of the transaction are dropped, so it will be
+  // applied from the intents DB.
+  void CachedIntentsChangedUnlocked(RunningTransaction* transaction) REQUIRES(mutex_) {
+    const auto& intents = transaction->cached_intents();
+    if (!intents) {
+      return;
+    }
+    const auto old_bytes = transaction->cached_intents_bytes();
+    const auto new_bytes = intents->bytes();
+    if (cached_intents_bytes_ - old_bytes + new_bytes >
+            GetAtomicFlag(&FLAGS_txn_max_cached_intents_bytes)) {
+      VLOG_WITH_PREFIX(2) << "Drop cached intents of " << transaction->id() << ": "
+                          << new_bytes << " bytes, total: " << cached_intents_bytes_;
+      ReleaseCachedIntentsUnlocked(transaction);
+      return;
+    }
+    cached_intents_bytes_ += new_bytes - old_bytes;
+    mem_tracker_->Consume(new_bytes - old_bytes);
+    transaction->set_cached_intents_bytes(new_bytes);
+  }
+
+  std::shared_ptr<docdb::CachedIntents> ReleaseCachedIntentsUnlocked(
+      RunningTransaction* transaction) REQUIRES(mutex_) {
+    const auto bytes = transaction->cached_intents_bytes();
+    cached_intents_bytes_ -= bytes;
+    mem_tracker_->Release(bytes);
+    return transaction->TakeCachedIntents();
+  }
+
   void CleanupRecentlyRemovedTransactions(CoarseTimePoint now) {
     while (!recently_removed_transactions_cleanup_queue_.empty() &&
            recently_removed_transactions_cleanup_queue_.front().time <= now) {
@@ -1866,6 +1940,10 @@ class TransactionParticipant::Impl
   std::unique_ptr<docdb::WaitQueue> wait_queue_;
 
   std::shared_ptr<MemTracker> mem_tracker_ GUARDED_BY(mutex_);
+
+  // Total size of cached intents of running transactions, see
+  // --txn_max_cached_intents_bytes.
+  size_t cached_intents_bytes_ GUARDED_BY(mutex_) = 0;
 };
 
 TransactionParticipant::TransactionParticipant(
@@ -1899,8 +1977,9 @@ Result<TransactionMetadata> TransactionParticipant::PrepareMetadata(
 boost::optional<std::pair<IsolationLevel, TransactionalBatchData>>
     TransactionParticipant::PrepareBatchData(
     const TransactionId& id, size_t batch_idx,
-    boost::container::small_vector_base<uint8_t>* encoded_replicated_batches) {
-  return impl_->PrepareBatchData(id, batch_idx, encoded_replicated_batches);
+    boost::container::small_vector_base<uint8_t>* encoded_replicated_batches,
+    std::shared_ptr<docdb::CachedIntents>* cached_intents) {
+  return impl_->PrepareBatchData(id, batch_idx, encoded_replicated_batches, cached_intents);
 }
 
 void TransactionParticipant::BatchReplicated(
@@ -1921,6 +2000,10 @@ Result<std::pair<size_t, size_t>> TransactionParticipant::TEST_CountIntents() co
   return impl_->TEST_CountIntents();
 }
 
+size_t TransactionParticipant::TEST_CachedIntentsBytes() const {
+  return impl_->TEST_CachedIntentsBytes();
+}
+
 void TransactionParticipant::RequestStatusAt(const StatusRequest& request) {
   return impl_->RequestStatusAt(request);
 }
@@ -2021,6 +2104,10 @@ docdb::WaitQueue* TransactionParticipant::wait_queue() const {
   return impl_->wait_queue();
 }
 
+void TransactionParticipant::SetStatusBatcher(TransactionStatusBatcher* status_batcher) {
+  impl_->SetStatusBatcher(status_batcher);
+}
+
 void TransactionParticipant::StartShutdown() {
   impl_->StartShutdown();
 }
@@ -79,6 +79,9 @@ struct TransactionApplyData {
   // Owned by running transaction if non-null.
   const docdb::ApplyTransactionState* apply_state = nullptr;
   bool is_external = false;
+  // Strong write intents of the transaction, if they were kept in memory. In this case the
+  // transaction is applied without reading its intents from the intents DB.
+  std::shared_ptr<const docdb::CachedIntents> cached_intents;
 
   std::string ToString() const;
 };
@@ -119,6 +122,10 @@ class TransactionParticipant : public TransactionStatusManager {
 
   docdb::WaitQueue* wait_queue() const;
 
+  // Status requests of running transactions are sent through status_batcher when it is set and
+  // --batch_transaction_status_requests is enabled.
+  void SetStatusBatcher(TransactionStatusBatcher* status_batcher);
+
   // Notify participant that this context is ready and it could start performing its requests.
   void Start();
 
@@ -136,12 +143,16 @@ class TransactionParticipant : public TransactionStatusManager {
   //
   // Returns boost::none when transaction is unknown.
   //
+  // cached_intents is set to the cached intents of the transaction, when they are kept, so
+  // the intents of the batch should be added to them.
+  //
   // When external_transaction is set for xcluster transactions, the function ignores the start time
   // of the txn when fetching the transaction since the txn status record and intent bach can come
   // out of order.
   boost::optional<std::pair<IsolationLevel, TransactionalBatchData>> PrepareBatchData(
       const TransactionId& id, size_t batch_idx,
-      boost::container::small_vector_base<uint8_t>* encoded_replicated_batches);
+      boost::container::small_vector_base<uint8_t>* encoded_replicated_batches,
+      std::shared_ptr<docdb::CachedIntents>* cached_intents);
 
   void BatchReplicated(const TransactionId& id, const TransactionalBatchData& data);
 
@@ -241,6 +252,9 @@ class TransactionParticipant : public TransactionStatusManager {
   // Returns pair of number of intents and number of transactions.
   Result<std::pair<size_t, size_t>> TEST_CountIntents() const;
 
+  // Total size of intents kept in memory, see --txn_max_cached_intents_bytes.
+  size_t TEST_CachedIntentsBytes() const;
+
   OneWayBitmap TEST_TransactionReplicatedBatches(const TransactionId& id) const;
 
  private:
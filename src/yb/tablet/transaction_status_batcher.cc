@@ -0,0 +1,459 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/transaction_status_batcher.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "yb/client/client.h"
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rpc/rpc.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/cast.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status_format.h"
+
+DECLARE_int32(max_transactions_in_status_request);
+
+DEFINE_RUNTIME_uint64(transaction_status_cache_ttl_ms, 1000,
+                      "Time to keep committed transaction statuses received by "
+                      "transaction status batcher, so other tablets of the tablet server could "
+                      "resolve the same transaction without asking its status tablet. "
+                      "0 disables the cache.");
+TAG_FLAG(transaction_status_cache_ttl_ms, advanced);
+
+using namespace std::placeholders;
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+struct Waiter {
+  const void* owner;
+  client::GetTransactionStatusCallback callback;
+};
+
+using Waiters = std::vector<Waiter>;
+
+// Moves callbacks of waiters that belong to owner to out.
+void ExtractOwnerWaiters(
+    const void* owner, Waiters* waiters, std::vector<client::GetTransactionStatusCallback>* out) {
+  auto it = std::remove_if(waiters->begin(), waiters->end(), [owner, out](auto& waiter) {
+    if (waiter.owner != owner) {
+      return false;
+    }
+    out->push_back(std::move(waiter.callback));
+    return true;
+  });
+  waiters->erase(it, waiters->end());
+}
+
+// Extracts response for the transaction with the specified index from the batched response.
+tserver::GetTransactionStatusResponsePB ExtractResponse(
+    const tserver::GetTransactionStatusResponsePB& response, int idx) {
+  tserver::GetTransactionStatusResponsePB result;
+  result.add_status(response.status(idx));
+  result.add_status_hybrid_time(response.status_hybrid_time(idx));
+  if (response.has_propagated_hybrid_time()) {
+    result.set_propagated_hybrid_time(response.propagated_hybrid_time());
+  }
+  if (idx < response.num_replicated_batches_size()) {
+    result.add_num_replicated_batches(response.num_replicated_batches(idx));
+  }
+  if (idx < response.coordinator_safe_time_size()) {
+    result.add_coordinator_safe_time(response.coordinator_safe_time(idx));
+  }
+  if (idx < response.aborted_subtxn_set_size()) {
+    *result.add_aborted_subtxn_set() = response.aborted_subtxn_set(idx);
+  }
+  return result;
+}
+
+} // namespace
+
+class TransactionStatusBatcher::Impl {
+ public:
+  explicit Impl(const std::shared_future<client::YBClient*>& client_future)
+      : client_future_(client_future) {}
+
+  ~Impl() {
+    LOG_IF(DFATAL, !closing_) << "Destroy transaction status batcher without Shutdown";
+  }
+
+  void Shutdown() {
+    {
+      std::lock_guard lock(mutex_);
+      closing_ = true;
+    }
+    // Aborted RPCs invoke their callbacks, so waiters of all batches are notified.
+    rpcs_.Shutdown();
+
+    std::vector<client::GetTransactionStatusCallback> callbacks;
+    {
+      std::lock_guard lock(mutex_);
+      for (auto& [status_tablet, queue] : queues_) {
+        for (auto& [id, waiters] : queue.waiters) {
+          for (auto& waiter : waiters) {
+            callbacks.push_back(std::move(waiter.callback));
+          }
+        }
+      }
+      queues_.clear();
+      cache_.clear();
+      expiration_queue_.clear();
+    }
+    NotifyAborted(callbacks, "Transaction status batcher is shutting down");
+  }
+
+  void RequestStatus(
+      const void* owner, const TabletId& status_tablet, const TransactionId& transaction_id,
+      HybridTime propagated_hybrid_time, client::GetTransactionStatusCallback callback) {
+    std::unique_lock lock(mutex_);
+    if (closing_) {
+      lock.unlock();
+      callback(STATUS(Aborted, "Transaction status batcher is shutting down"), {});
+      return;
+    }
+
+    auto cached_response = CachedResponseUnlocked(status_tablet, transaction_id);
+    if (cached_response) {
+      lock.unlock();
+      VLOG(4) << "Cached status of " << transaction_id << ": "
+              << cached_response->ShortDebugString();
+      callback(Status::OK(), *cached_response);
+      return;
+    }
+
+    ++num_requests_;
+    auto& queue = queues_[status_tablet];
+    queue.propagated_hybrid_time.MakeAtLeast(propagated_hybrid_time);
+    auto it = queue.waiters.find(transaction_id);
+    if (it == queue.waiters.end()) {
+      it = queue.waiters.emplace(transaction_id, Waiters()).first;
+      queue.ids.push_back(transaction_id);
+    }
+    it->second.push_back(Waiter {
+      .owner = owner,
+      .callback = std::move(callback),
+    });
+
+    auto* batch = PrepareBatchUnlocked(status_tablet, &queue);
+    lock.unlock();
+    if (batch) {
+      SendBatch(batch);
+    }
+  }
+
+  void Abort(const void* owner) {
+    std::vector<client::GetTransactionStatusCallback> callbacks;
+    {
+      std::unique_lock lock(mutex_);
+      for (auto& [status_tablet, queue] : queues_) {
+        for (auto it = queue.waiters.begin(); it != queue.waiters.end();) {
+          ExtractOwnerWaiters(owner, &it->second, &callbacks);
+          if (it->second.empty()) {
+            it = queue.waiters.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
+      // In flight RPCs are not aborted, since they could contain transactions of other owners.
+      for (auto& batch : batches_) {
+        for (auto& waiters : batch.waiters) {
+          ExtractOwnerWaiters(owner, &waiters, &callbacks);
+        }
+      }
+      running_callbacks_cond_.wait(lock, [this, owner]() NO_THREAD_SAFETY_ANALYSIS {
+        return !running_callbacks_.contains(owner);
+      });
+    }
+    NotifyAborted(callbacks, "Transaction status request aborted");
+  }
+
+  size_t TEST_num_requests() const {
+    std::lock_guard lock(mutex_);
+    return num_requests_;
+  }
+
+  size_t TEST_num_rpcs() const {
+    std::lock_guard lock(mutex_);
+    return num_rpcs_;
+  }
+
+ private:
+  struct TabletQueue {
+    // Transactions in the order of requests. Could contain transactions that are no longer present
+    // in waiters, because all their waiters were aborted. Such transactions are skipped.
+    std::vector<TransactionId> ids;
+    std::unordered_map<TransactionId, Waiters, TransactionIdHash> waiters;
+    HybridTime propagated_hybrid_time = HybridTime::kMin;
+    size_t requests_in_flight = 0;
+  };
+
+  struct Batch {
+    TabletId status_tablet;
+    HybridTime propagated_hybrid_time;
+    std::vector<TransactionId> ids;
+    std::vector<Waiters> waiters;
+    rpc::Rpcs::Handle handle;
+  };
+
+  using Batches = std::list<Batch>;
+
+  struct CacheEntry {
+    TabletId status_tablet;
+    tserver::GetTransactionStatusResponsePB response;
+    CoarseTimePoint expiration;
+  };
+
+  // Returns batch that should be sent, or nullptr if requests of the queue should wait.
+  Batch* PrepareBatchUnlocked(const TabletId& status_tablet, TabletQueue* queue) REQUIRES(mutex_) {
+    if (queue->waiters.empty()) {
+      queue->ids.clear();
+      return nullptr;
+    }
+    const auto max_batch_size = static_cast<size_t>(
+        std::max(FLAGS_max_transactions_in_status_request, 1));
+    // While there is a request in flight, requests are accumulated to be sent in the next batch.
+    if (queue->requests_in_flight != 0 && queue->waiters.size() < max_batch_size) {
+      return nullptr;
+    }
+
+    auto& batch = batches_.emplace_back();
+    batch.status_tablet = status_tablet;
+    batch.propagated_hybrid_time = queue->propagated_hybrid_time;
+    batch.handle = rpcs_.InvalidHandle();
+    auto it = queue->ids.begin();
+    for (; it != queue->ids.end() && batch.ids.size() < max_batch_size; ++it) {
+      auto waiters_it = queue->waiters.find(*it);
+      if (waiters_it == queue->waiters.end()) {
+        continue;
+      }
+      batch.ids.push_back(*it);
+      batch.waiters.push_back(std::move(waiters_it->second));
+      queue->waiters.erase(waiters_it);
+    }
+    queue->ids.erase(queue->ids.begin(), it);
+    ++queue->requests_in_flight;
+    ++num_rpcs_;
+    return &batch;
+  }
+
+  void SendBatch(Batch* batch) {
+    VLOG(3) << "Request status of " << batch->ids.size() << " transactions from "
+            << batch->status_tablet;
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(batch->status_tablet);
+    req.set_propagated_hybrid_time(batch->propagated_hybrid_time.ToUint64());
+    for (const auto& id : batch->ids) {
+      req.add_transaction_id()->assign(pointer_cast<const char*>(id.data()), id.size());
+    }
+
+    auto client = client_future_.get();
+    if (!client || !rpcs_.RegisterAndStart(
+        client::GetTransactionStatus(
+            TransactionRpcDeadline(),
+            nullptr /* tablet */,
+            client,
+            &req,
+            std::bind(&Impl::StatusReceived, this, _1, _2, batch)),
+        &batch->handle)) {
+      StatusReceived(STATUS(Aborted, "Aborted because cannot start RPC"), {}, batch);
+    }
+  }
+
+  void StatusReceived(
+      Status status, const tserver::GetTransactionStatusResponsePB& response, Batch* batch) {
+    VLOG(3) << "Received statuses from " << batch->status_tablet << ": " << status << ", "
+            << response.ShortDebugString();
+
+    // RPC is unregistered after all callbacks are invoked, so Shutdown waits for them.
+    auto handle = batch->handle;
+
+    if (status.ok() && response.has_error()) {
+      status = StatusFromPB(response.error().status());
+    }
+    auto size = batch->ids.size();
+    if (status.ok() && (static_cast<size_t>(response.status().size()) != size ||
+                        static_cast<size_t>(response.status_hybrid_time().size()) != size)) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of statuses, $0 expected: $1", size,
+          response.ShortDebugString());
+      LOG(DFATAL) << status;
+    }
+
+    std::vector<std::pair<Waiter, tserver::GetTransactionStatusResponsePB>> notifications;
+    Batch* next_batch = nullptr;
+    {
+      std::lock_guard lock(mutex_);
+      auto cache_ttl = std::chrono::milliseconds(FLAGS_transaction_status_cache_ttl_ms);
+      auto now = CoarseMonoClock::now();
+      CleanupCacheUnlocked(now);
+      for (size_t i = 0; i != size; ++i) {
+        if (batch->waiters[i].empty() && (!status.ok() || cache_ttl.count() == 0)) {
+          continue;
+        }
+        tserver::GetTransactionStatusResponsePB txn_response;
+        if (status.ok()) {
+          txn_response = ExtractResponse(response, narrow_cast<int>(i));
+          // Aborted status is not cached, since RunningTransaction::GetStatusAt re-resolves it
+          // for some transactions, e.g. external ones, and should get a fresh response.
+          if (cache_ttl.count() != 0 && txn_response.status(0) == TransactionStatus::COMMITTED) {
+            AddToCacheUnlocked(
+                batch->status_tablet, batch->ids[i], txn_response, now + cache_ttl);
+          }
+        }
+        for (auto& waiter : batch->waiters[i]) {
+          ++running_callbacks_[waiter.owner];
+          notifications.emplace_back(std::move(waiter), txn_response);
+        }
+      }
+
+      auto queue_it = queues_.find(batch->status_tablet);
+      if (queue_it != queues_.end()) {
+        --queue_it->second.requests_in_flight;
+        if (!closing_) {
+          next_batch = PrepareBatchUnlocked(queue_it->first, &queue_it->second);
+        }
+        if (!next_batch && queue_it->second.requests_in_flight == 0 &&
+            queue_it->second.waiters.empty()) {
+          queues_.erase(queue_it);
+        }
+      }
+      // Batch is not referenced by anybody else after it was removed from the list.
+      batches_.remove_if([batch](const Batch& entry) { return &entry == batch; });
+    }
+
+    if (next_batch) {
+      SendBatch(next_batch);
+    }
+
+    for (auto& [waiter, txn_response] : notifications) {
+      waiter.callback(status, txn_response);
+      std::lock_guard lock(mutex_);
+      auto it = running_callbacks_.find(waiter.owner);
+      if (--it->second == 0) {
+        running_callbacks_.erase(it);
+        running_callbacks_cond_.notify_all();
+      }
+    }
+
+    rpcs_.Unregister(&handle);
+  }
+
+  std::optional<tserver::GetTransactionStatusResponsePB> CachedResponseUnlocked(
+      const TabletId& status_tablet, const TransactionId& transaction_id) REQUIRES(mutex_) {
+    CleanupCacheUnlocked(CoarseMonoClock::now());
+    auto it = cache_.find(transaction_id);
+    // Status of a promoted transaction should be requested from its new status tablet.
+    if (it == cache_.end() || it->second.status_tablet != status_tablet) {
+      return std::nullopt;
+    }
+    return it->second.response;
+  }
+
+  void AddToCacheUnlocked(
+      const TabletId& status_tablet, const TransactionId& transaction_id,
+      const tserver::GetTransactionStatusResponsePB& response, CoarseTimePoint expiration)
+      REQUIRES(mutex_) {
+    cache_[transaction_id] = CacheEntry {
+      .status_tablet = status_tablet,
+      .response = response,
+      .expiration = expiration,
+    };
+    expiration_queue_.emplace_back(expiration, transaction_id);
+  }
+
+  void CleanupCacheUnlocked(CoarseTimePoint now) REQUIRES(mutex_) {
+    while (!expiration_queue_.empty() && expiration_queue_.front().first <= now) {
+      auto it = cache_.find(expiration_queue_.front().second);
+      // Entry could be replaced by a more recent response, that expires later.
+      if (it != cache_.end() && it->second.expiration <= now) {
+        cache_.erase(it);
+      }
+      expiration_queue_.pop_front();
+    }
+  }
+
+  void NotifyAborted(
+      const std::vector<client::GetTransactionStatusCallback>& callbacks, const char* message) {
+    for (const auto& callback : callbacks) {
+      callback(STATUS(Aborted, message), {});
+    }
+  }
+
+  const std::shared_future<client::YBClient*> client_future_;
+  rpc::Rpcs rpcs_;
+
+  mutable std::mutex mutex_;
+  bool closing_ GUARDED_BY(mutex_) = false;
+  std::unordered_map<TabletId, TabletQueue> queues_ GUARDED_BY(mutex_);
+  Batches batches_ GUARDED_BY(mutex_);
+  std::unordered_map<TransactionId, CacheEntry, TransactionIdHash> cache_ GUARDED_BY(mutex_);
+  std::deque<std::pair<CoarseTimePoint, TransactionId>> expiration_queue_ GUARDED_BY(mutex_);
+  // Number of callbacks of each owner that are being invoked.
+  std::unordered_map<const void*, size_t> running_callbacks_ GUARDED_BY(mutex_);
+  std::condition_variable running_callbacks_cond_;
+  size_t num_requests_ GUARDED_BY(mutex_) = 0;
+  size_t num_rpcs_ GUARDED_BY(mutex_) = 0;
+};
+
+TransactionStatusBatcher::TransactionStatusBatcher(
+    const std::shared_future<client::YBClient*>& client_future)
+    : impl_(new Impl(client_future)) {}
+
+TransactionStatusBatcher::~TransactionStatusBatcher() = default;
+
+void TransactionStatusBatcher::Shutdown() {
+  impl_->Shutdown();
+}
+
+void TransactionStatusBatcher::RequestStatus(
+    const void* owner, const TabletId& status_tablet, const TransactionId& transaction_id,
+    HybridTime propagated_hybrid_time, client::GetTransactionStatusCallback callback) {
+  impl_->RequestStatus(
+      owner, status_tablet, transaction_id, propagated_hybrid_time, std::move(callback));
+}
+
+void TransactionStatusBatcher::Abort(const void* owner) {
+  impl_->Abort(owner);
+}
+
+size_t TransactionStatusBatcher::TEST_num_requests() const {
+  return impl_->TEST_num_requests();
+}
+
+size_t TransactionStatusBatcher::TEST_num_rpcs() const {
+  return impl_->TEST_num_rpcs();
+}
+
+} // namespace tablet
+} // namespace yb
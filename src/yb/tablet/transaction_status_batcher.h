@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <future>
+#include <memory>
+
+#include "yb/client/client_fwd.h"
+#include "yb/client/transaction_rpc.h"
+
+#include "yb/common/entity_ids_types.h"
+#include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
+
+namespace yb {
+namespace tablet {
+
+// Coalesces transaction status requests of all transaction participants of a tablet server.
+//
+// Requests to the same status tablet are batched into a single GetTransactionStatus RPC. A new RPC
+// is sent when there is no RPC in flight to this status tablet, or when enough transactions are
+// queued to fill a whole RPC. Queued requests for the same transaction share a single entry of the
+// RPC. Committed statuses are cached for --transaction_status_cache_ttl_ms, so other participants
+// do not ask about the same transaction. Aborted statuses are not cached, since participants
+// re-resolve them, e.g. for external transactions.
+class TransactionStatusBatcher {
+ public:
+  explicit TransactionStatusBatcher(const std::shared_future<client::YBClient*>& client_future);
+  ~TransactionStatusBatcher();
+
+  void Shutdown();
+
+  // Requests status of the transaction from the status tablet. The callback receives a response
+  // for this single transaction, in the same format as GetTransactionStatus RPC.
+  // owner identifies the requester, so its requests could be aborted by Abort.
+  void RequestStatus(
+      const void* owner, const TabletId& status_tablet, const TransactionId& transaction_id,
+      HybridTime propagated_hybrid_time, client::GetTransactionStatusCallback callback);
+
+  // Aborts all requests of the owner, their callbacks are invoked with Aborted status.
+  // Waits until running callbacks of the owner complete, so the owner could be destroyed after it.
+  void Abort(const void* owner);
+
+  // Number of requests that were not served from the cache.
+  size_t TEST_num_requests() const;
+
+  // Number of GetTransactionStatus RPCs sent for those requests.
+  size_t TEST_num_rpcs() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace tablet
+} // namespace yb
@@ -213,6 +213,10 @@ void WriteQuery::Finished(WriteOperation* operation, const Status& status) {
   }
 
   auto tablet = *tablet_result;
+  if (status.ok() && response_ && operation->has_hybrid_time() &&
+      !operation->request()->write_batch().has_transaction()) {
+    response_->set_write_hybrid_time(operation->hybrid_time().ToUint64());
+  }
   if (status.ok()) {
     TabletMetrics* metrics = tablet->metrics();
     if (metrics) {
@@ -1220,7 +1220,6 @@ Status PgClientSession::FetchSequenceTuple(
     const PgFetchSequenceTupleRequestPB& req, PgFetchSequenceTupleResponsePB* resp,
     rpc::RpcContext* context) {
   using pggate::PgDocData;
-  using pggate::PgWireDataHeader;
 
   const int64_t sequence_id = req.seq_oid();
   const int64_t inc_by = req.inc_by();
@@ -1325,7 +1324,6 @@ Status PgClientSession::ReadSequenceTuple(
     const PgReadSequenceTupleRequestPB& req, PgReadSequenceTupleResponsePB* resp,
     rpc::RpcContext* context) {
   using pggate::PgDocData;
-  using pggate::PgWireDataHeader;
 
   PgObjectId table_oid(kPgSequencesDataDatabaseOid, kPgSequencesDataTableOid);
   auto table = VERIFY_RESULT(table_cache_.Get(table_oid.GetYbTableId()));
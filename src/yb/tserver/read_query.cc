@@ -54,6 +54,9 @@ DEFINE_test_flag(bool, assert_reads_served_by_follower, false, "If set, we verif
                  "consistency level is CONSISTENT_PREFIX, and that this server is not the leader "
                  "for the tablet");
 
+DEFINE_test_flag(bool, reject_follower_read_your_writes, false,
+                 "If set, followers reject all read-your-writes reads as stale.");
+
 DEFINE_RUNTIME_bool(parallelize_read_ops, true,
     "Controls whether multiple (Redis) read ops that are present in a operation "
     "should be executed in parallel.");
@@ -65,6 +68,13 @@ DEFINE_RUNTIME_bool(ysql_follower_reads_avoid_waiting_for_safe_time, true,
     "faster than waiting for safe time to catch up.");
 TAG_FLAG(ysql_follower_reads_avoid_waiting_for_safe_time, advanced);
 
+DEFINE_RUNTIME_uint32(follower_read_your_writes_max_wait_ms, 50,
+    "Max time a follower waits for its safe time to reach the hybrid time of the last write of "
+    "the session that issued a read-your-writes consistent prefix read. If safe time does not "
+    "catch up in time, the read is rejected as stale, and the client retries it at another "
+    "follower or at the leader.");
+TAG_FLAG(follower_read_your_writes_max_wait_ms, advanced);
+
 namespace yb {
 namespace tserver {
 
@@ -111,6 +121,10 @@ class ReadQuery : public std::enable_shared_from_this<ReadQuery>, public rpc::Th
   // Picks read based for specified read context.
   Status DoPickReadTime(server::Clock* clock);
 
+  // Safe time for the read that does not specify read time. Read-your-writes reads served by a
+  // follower wait until its safe time reaches the last write of the session.
+  Result<HybridTime> SafeTimeForSingleShardRead();
+
   bool transactional() const;
 
   tablet::Tablet* tablet() const;
@@ -412,7 +426,7 @@ Status ReadQuery::DoPickReadTime(server::Clock* clock) {
     start_time = MonoTime::Now();
   }
   if (!read_time_) {
-    safe_ht_to_read_ = VERIFY_RESULT(abstract_tablet_->SafeTime(require_lease_));
+    safe_ht_to_read_ = VERIFY_RESULT(SafeTimeForSingleShardRead());
     // If the read time is not specified, then it is a single-shard read.
     // So we should restart it in server in case of failure.
     read_time_.read = safe_ht_to_read_;
@@ -450,6 +464,30 @@ Status ReadQuery::DoPickReadTime(server::Clock* clock) {
   return Status::OK();
 }
 
+Result<HybridTime> ReadQuery::SafeTimeForSingleShardRead() {
+  if (!reading_from_non_leader_ || !req_->has_read_your_writes_ht()) {
+    return abstract_tablet_->SafeTime(require_lease_);
+  }
+  // The session expects to see its own writes, so wait for them to be replicated to this
+  // follower instead of reading a prefix that does not contain them.
+  const HybridTime last_write_ht(req_->read_your_writes_ht());
+  const auto deadline = std::min(
+      context_.GetClientDeadline(),
+      CoarseMonoClock::now() +
+          MonoDelta::FromMilliseconds(FLAGS_follower_read_your_writes_max_wait_ms));
+  auto result = FLAGS_TEST_reject_follower_read_your_writes
+      ? STATUS(TimedOut, "Rejected by test flag")
+      : abstract_tablet_->SafeTime(require_lease_, last_write_ht, deadline);
+  if (!result.ok() && result.status().IsTimedOut()) {
+    VLOG(1) << "Follower safe time did not reach session write time " << last_write_ht
+            << ": " << result.status();
+    return STATUS(
+        IllegalState, "Follower has not caught up with session writes",
+        TabletServerError(TabletServerErrorPB::STALE_FOLLOWER));
+  }
+  return result;
+}
+
 bool ReadQuery::IsPgsqlFollowerReadAtAFollower() const {
   return reading_from_non_leader_ &&
          (!req_->pgsql_batch().empty() &&
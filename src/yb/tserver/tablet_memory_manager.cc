@@ -21,19 +21,33 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/secondary_cache.h"
 
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/enums.h"
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status_log.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
+
+namespace yb {
+namespace tserver {
+namespace {
+
+YB_DEFINE_ENUM(BlockCacheType, (LRU)(CLOCK));
+
+} // namespace
+} // namespace tserver
+} // namespace yb
 
 DEFINE_UNKNOWN_bool(enable_log_cache_gc, true,
             "Set to true to enable log cache garbage collector.");
@@ -76,9 +90,40 @@ DEFINE_UNKNOWN_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_UNKNOWN_string(db_block_cache_type, "lru",
+              "Eviction policy of the shared block cache:\n"
+              "  lru - mutex protected LRU lists with single touch and multi touch pools\n"
+              "  clock - CLOCK eviction over a lock-free table, lookups do not take locks. "
+              "Keeps single touch and multi touch pools of the LRU cache.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+static bool ValidateBlockCacheType(const char* flag_name, const std::string& value) {
+  auto cache_type = yb::ParseEnumInsensitive<yb::tserver::BlockCacheType>(value);
+  if (!cache_type.ok()) {
+    LOG(ERROR) << flag_name << ": " << cache_type.status();
+    return false;
+  }
+  return true;
+}
+
+DEFINE_validator(db_block_cache_type, &ValidateBlockCacheType);
+
+DEFINE_UNKNOWN_string(db_secondary_block_cache_path, "",
+              "Directory on a fast local device, such as NVMe, for the secondary block cache. "
+              "Blocks read from the SST files are also stored there, so a block evicted from the "
+              "in-memory block cache could be read back without going to the SST file. "
+              "The directory content is discarded on restart. Empty value disables the cache.");
+TAG_FLAG(db_secondary_block_cache_path, advanced);
+
+DEFINE_UNKNOWN_int64(db_secondary_block_cache_size_bytes, 64_GB,
+             "Maximal size of the secondary block cache files (in bytes).");
+TAG_FLAG(db_secondary_block_cache_size_bytes, advanced);
+
 DEFINE_test_flag(bool, pretend_memory_exceeded_enforce_flush, false,
                   "Always pretend memory has been exceeded to enforce background flush.");
 
+DECLARE_int64(db_block_size_bytes);
+
 namespace yb {
 namespace tserver {
 
@@ -146,6 +191,49 @@ int64_t GetTargetBlockCacheSize(const int32_t default_block_cache_size_percentag
   return target_block_cache_size_bytes;
 }
 
+std::shared_ptr<rocksdb::Cache> CreateBlockCache(int64_t block_cache_size_bytes) {
+  // The flag value is checked by ValidateBlockCacheType at startup.
+  const auto cache_type = CHECK_RESULT(
+      ParseEnumInsensitive<BlockCacheType>(FLAGS_db_block_cache_type));
+  switch (cache_type) {
+    case BlockCacheType::LRU:
+      return rocksdb::NewLRUCache(block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits);
+    case BlockCacheType::CLOCK:
+      // Entries of the block cache are data blocks, so the block size is a good estimate for
+      // the entry charge.
+      return rocksdb::NewClockCache(
+          block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+          /* strict_capacity_limit= */ false, FLAGS_db_block_size_bytes);
+  }
+  FATAL_INVALID_ENUM_VALUE(BlockCacheType, cache_type);
+}
+
+std::shared_ptr<rocksdb::SecondaryCache> CreateSecondaryBlockCache(
+    rocksdb::Env* env, const MemTrackerPtr& parent_mem_tracker) {
+  if (FLAGS_db_secondary_block_cache_path.empty() ||
+      FLAGS_db_secondary_block_cache_size_bytes <= 0) {
+    return nullptr;
+  }
+  rocksdb::FileSecondaryCacheOptions cache_options;
+  cache_options.path = FLAGS_db_secondary_block_cache_path;
+  cache_options.capacity = FLAGS_db_secondary_block_cache_size_bytes;
+  cache_options.num_shard_bits = FLAGS_db_block_cache_num_shard_bits;
+  cache_options.env = env;
+  cache_options.mem_tracker = MemTracker::FindOrCreateTracker(
+      "SecondaryBlockCache", parent_mem_tracker);
+  std::shared_ptr<rocksdb::SecondaryCache> result;
+  auto status = rocksdb::NewFileSecondaryCache(cache_options, &result);
+  if (!status.ok()) {
+    // The secondary cache is an optimization only, so the server could work without it.
+    LOG(WARNING) << "Failed to create secondary block cache at "
+                 << FLAGS_db_secondary_block_cache_path << ": " << status;
+    return nullptr;
+  }
+  LOG(INFO) << "Created secondary block cache at " << FLAGS_db_secondary_block_cache_path
+            << " of " << HumanReadableNumBytes::ToString(cache_options.capacity);
+  return result;
+}
+
 size_t GetLogCacheSize(tablet::TabletPeer* peer) {
   return down_cast<consensus::RaftConsensus*>(peer->consensus())->LogCacheSize();
 }
@@ -196,14 +284,25 @@ void TabletMemoryManager::InitBlockCache(
       server_mem_tracker_);
 
   if (block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                FLAGS_db_block_cache_num_shard_bits);
+    options->block_cache = CreateBlockCache(block_cache_size_bytes);
     options->block_cache->SetMetrics(metrics);
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(options->block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
   }
 }
 
+void TabletMemoryManager::InitSecondaryBlockCache(
+    const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options) {
+  if (!options->block_cache) {
+    return;
+  }
+  options->secondary_block_cache = CreateSecondaryBlockCache(
+      options->rocksdb_env, server_mem_tracker_);
+  if (options->secondary_block_cache) {
+    options->secondary_block_cache->SetMetrics(metrics);
+  }
+}
+
 void TabletMemoryManager::InitLogCacheGC() {
   auto log_cache_mem_tracker = consensus::LogCache::GetServerMemTracker(server_mem_tracker_);
   log_cache_gc_ = std::make_shared<FunctorGC>(
@@ -55,6 +55,11 @@ class TabletMemoryManager {
   Status Init();
   void Shutdown();
 
+  // Creates the secondary block cache when it is configured. Its files are written through
+  // options->rocksdb_env, so it should be called after the env is set, e.g. to the encrypted one.
+  void InitSecondaryBlockCache(
+      const scoped_refptr<MetricEntity>& metrics, tablet::TabletOptions* options);
+
   // The MemTracker associated with the block cache.
   std::shared_ptr<MemTracker> block_based_table_mem_tracker();
 
@@ -87,6 +87,7 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/transaction_status_batcher.h"
 
 #include "yb/tserver/full_compaction_manager.h"
 #include "yb/tserver/heartbeater.h"
@@ -228,6 +229,11 @@ DEFINE_UNKNOWN_int32(post_split_trigger_compaction_pool_max_threads, 1,
 DEFINE_UNKNOWN_int32(post_split_trigger_compaction_pool_max_queue_size, 16,
              "DEPRECATED. Use full_compaction_pool_max_queue_size.");
 
+DEFINE_NON_RUNTIME_int32(block_prefetch_pool_max_threads, 16,
+                         "Max number of threads used to read SST data blocks in parallel, when "
+                         "blocks for a batched read are prefetched. 0 to read blocks by the "
+                         "thread that handles the read.");
+
 DEFINE_NON_RUNTIME_int32(full_compaction_pool_max_threads, 1,
              "The maximum number of threads allowed for full_compaction_pool_. This "
              "pool is used to run full compactions on tablets, either on a shceduled basis "
@@ -429,6 +435,11 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_min_threads(1)
                .unlimited_threads()
                .Build(&allocation_pool_));
+  // Used only during tablet bootstrap, the number of threads is bounded by the number of
+  // bootstrap threads multiplied by --bootstrap_num_segments_to_read_ahead.
+  CHECK_OK(ThreadPoolBuilder("log-read-ahead")
+               .unlimited_threads()
+               .Build(&log_read_ahead_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -456,6 +467,12 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
               .set_metrics(THREAD_POOL_METRICS_INSTANCE(
                   server_->metric_entity(), wait_queue_resume_waiter_pool))
               .Build(&wait_queue_pool_));
+  if (FLAGS_block_prefetch_pool_max_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("block-prefetch")
+                .set_max_threads(FLAGS_block_prefetch_pool_max_threads)
+                .Build(&block_prefetch_pool_));
+    tablet_options_.block_prefetch_pool = block_prefetch_pool_.get();
+  }
   ts_split_op_apply_ = METRIC_ts_split_op_apply.Instantiate(server_->metric_entity(), 0);
   ts_post_split_compaction_added_ =
       METRIC_ts_post_split_compaction_added.Instantiate(server_->metric_entity(), 0);
@@ -482,6 +499,7 @@ Status TSTabletManager::Init() {
 
   tablet_options_.env = server_->GetEnv();
   tablet_options_.rocksdb_env = server_->GetRocksDBEnv();
+  mem_manager_->InitSecondaryBlockCache(server_->metric_entity(), &tablet_options_);
   tablet_options_.listeners = server_->options().listeners;
   if (docdb::GetRocksDBRateLimiterSharingMode() == docdb::RateLimiterSharingMode::TSERVER) {
     tablet_options_.rate_limiter = docdb::CreateRocksDBRateLimiter();
@@ -527,6 +545,9 @@ Status TSTabletManager::Init() {
         client_future(), scoped_refptr<server::Clock>(server_->clock()));
   }
 
+  transaction_status_batcher_ = std::make_unique<tablet::TransactionStatusBatcher>(
+      client_future());
+
   deque<RaftGroupMetadataPtr> metas;
 
   // First, load all of the tablet metadata. We do this before we start
@@ -1572,6 +1593,7 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
       },
       .waiting_txn_registry = waiting_txn_registry_.get(),
       .wait_queue_pool = wait_queue_pool_.get(),
+      .transaction_status_batcher = transaction_status_batcher_.get(),
       .full_compaction_pool = full_compaction_pool(),
       .post_split_compaction_added = ts_post_split_compaction_added_
     };
@@ -1581,6 +1603,7 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
       .append_pool = append_pool(),
       .allocation_pool = allocation_pool_.get(),
       .log_sync_pool = log_sync_pool(),
+      .read_ahead_pool = log_read_ahead_pool_.get(),
       .retryable_requests = &retryable_requests,
       .bootstrap_retryable_requests = bootstrap_retryable_requests,
       .consensus_meta = cmeta.get(),
@@ -1745,6 +1768,7 @@ void TSTabletManager::StartShutdown() {
 
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
+  log_read_ahead_pool_->Shutdown();
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
@@ -1794,6 +1818,9 @@ void TSTabletManager::CompleteShutdown() {
   if (wait_queue_pool_) {
     wait_queue_pool_->Shutdown();
   }
+  if (block_prefetch_pool_) {
+    block_prefetch_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(mutex_);
@@ -1812,6 +1839,11 @@ void TSTabletManager::CompleteShutdown() {
   if (waiting_txn_registry_) {
     waiting_txn_registry_->CompleteShutdown();
   }
+
+  // Participants of all tablets are shut down at this point, so nobody waits for statuses.
+  if (transaction_status_batcher_) {
+    transaction_status_batcher_->Shutdown();
+  }
 }
 
 std::string TSTabletManager::LogPrefix() const {
@@ -362,6 +362,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   tablet::TabletOptions* TEST_tablet_options() { return &tablet_options_; }
 
+  tablet::TransactionStatusBatcher* TEST_transaction_status_batcher() {
+    return transaction_status_batcher_.get();
+  }
+
   // Trigger asynchronous compactions concurrently on the provided tablets.
   Status TriggerAdminCompactionAndWait(const TabletPtrs& tablets);
 
@@ -608,6 +612,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Thread pool for log allocation threads, shared between all tablets.
   std::unique_ptr<ThreadPool> allocation_pool_;
 
+  // Thread pool for reading log segments ahead of their replay during tablet bootstrap.
+  std::unique_ptr<ThreadPool> log_read_ahead_pool_;
+
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
@@ -622,6 +629,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<ThreadPool> wait_queue_pool_;
 
+  // Used by table readers to read SST data blocks in parallel, see
+  // rocksdb::BlockBasedTableOptions::prefetch_thread_pool.
+  std::unique_ptr<ThreadPool> block_prefetch_pool_;
+
   std::unique_ptr<rpc::Poller> tablets_cleaner_;
 
   // Used for verifying tablet data integrity.
@@ -634,6 +645,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<rpc::Poller> waiting_txn_registry_poller_;
 
+  // Batches transaction status requests of all tablets of this tablet server.
+  std::unique_ptr<tablet::TransactionStatusBatcher> transaction_status_batcher_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -71,6 +71,23 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+
+METRIC_DEFINE_counter(server, block_cache_secondary_inserts,
+                      "Secondary Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks written to the secondary block cache");
+METRIC_DEFINE_counter(server, block_cache_secondary_hits,
+                      "Secondary Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of secondary block cache lookups that found a block");
+METRIC_DEFINE_counter(server, block_cache_secondary_misses,
+                      "Secondary Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of secondary block cache lookups that didn't yield a block");
+METRIC_DEFINE_counter(server, block_cache_secondary_evictions,
+                      "Secondary Block Cache Evictions", yb::MetricUnit::kBlocks,
+                      "Number of blocks evicted from the secondary block cache");
+METRIC_DEFINE_gauge_uint64(server, block_cache_secondary_usage,
+                           "Secondary Block Cache Usage",
+                           yb::MetricUnit::kBytes,
+                           "Disk space consumed by the secondary block cache");
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -85,7 +102,12 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(cache_misses_caching, block_cache_misses_caching),
     GINIT(cache_usage, block_cache_usage),
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
-    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
+    GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage),
+    MINIT(secondary_cache_inserts, block_cache_secondary_inserts),
+    MINIT(secondary_cache_hits, block_cache_secondary_hits),
+    MINIT(secondary_cache_misses, block_cache_secondary_misses),
+    MINIT(secondary_cache_evictions, block_cache_secondary_evictions),
+    GINIT(secondary_cache_usage, block_cache_secondary_usage) {
 }
 #undef MINIT
 #undef GINIT
@@ -57,6 +57,13 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
+
+  // Secondary (on-device) tier of the block cache.
+  scoped_refptr<Counter> secondary_cache_inserts;
+  scoped_refptr<Counter> secondary_cache_hits;
+  scoped_refptr<Counter> secondary_cache_misses;
+  scoped_refptr<Counter> secondary_cache_evictions;
+  scoped_refptr<AtomicGauge<uint64_t> > secondary_cache_usage;
 };
 
 } // namespace yb
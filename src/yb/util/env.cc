@@ -19,11 +19,21 @@
 
 #include "yb/util/env.h"
 
+#include <unistd.h>
+
+#include "yb/util/errno.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flags.h"
+#include "yb/util/io_uring.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
 #include "yb/util/path_util.h"
 #include "yb/util/result.h"
 #include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
+#include "yb/util/thread_restrictions.h"
+
+DECLARE_bool(writable_file_use_fsync);
 
 using std::string;
 
@@ -51,6 +61,109 @@ Status WritableFile::AppendVector(const std::vector<Slice>& data_vector) {
 WritableFile::~WritableFile() {
 }
 
+Result<int> WritableFile::PrepareSync() {
+  return STATUS(NotSupported, "Sync by file descriptor is not supported");
+}
+
+namespace {
+
+struct FileSync {
+  WritableFile* file;
+  int fd;
+  Status* status;
+
+  void Complete(const Status& sync_status) {
+    file->FinishSync(sync_status);
+    *status = sync_status;
+  }
+
+  // error is 0 on success, or errno on failure.
+  void CompleteWithErrno(int error) {
+    Complete(error ? STATUS_FROM_ERRNO_SPECIAL_EIO_HANDLING(file->filename(), error)
+                   : Status::OK());
+  }
+
+  void BlockingSync() {
+    auto result = FLAGS_writable_file_use_fsync ? fsync(fd) : fdatasync(fd);
+    CompleteWithErrno(result < 0 ? errno : 0);
+  }
+};
+
+} // namespace
+
+void WritableFile::SyncFiles(WritableFile* const* files, size_t count, Status* statuses) {
+  auto* io_uring = count > 1 ? ThreadLocalIoUring() : nullptr;
+  if (!io_uring) {
+    for (size_t i = 0; i != count; ++i) {
+      statuses[i] = files[i]->Sync();
+    }
+    return;
+  }
+  ThreadRestrictions::AssertIOAllowed();
+
+  std::vector<FileSync> syncs;
+  syncs.reserve(count);
+  for (size_t i = 0; i != count; ++i) {
+    auto fd = files[i]->PrepareSync();
+    if (!fd.ok()) {
+      statuses[i] = fd.status().IsNotSupported() ? files[i]->Sync() : fd.status();
+    } else if (*fd < 0) {
+      statuses[i] = Status::OK();
+    } else {
+      syncs.push_back(FileSync {
+        .file = files[i],
+        .fd = *fd,
+        .status = &statuses[i],
+      });
+    }
+  }
+
+  const bool datasync = !FLAGS_writable_file_use_fsync;
+  // Same scheme as in PosixRandomAccessFile::MultiRead.
+  size_t submitted = 0;
+  size_t prepared = 0;
+  size_t in_flight = 0;
+  bool ring_failed = false;
+  while (in_flight > 0 || (!ring_failed && submitted < syncs.size())) {
+    while (!ring_failed && prepared < syncs.size() &&
+           in_flight + prepared - submitted < io_uring->queue_depth()) {
+      if (!io_uring->PrepareFsync(syncs[prepared].fd, datasync, prepared)) {
+        break;
+      }
+      ++prepared;
+    }
+
+    auto result = io_uring->Submit(/* wait_nr= */ 1);
+    if (result.ok()) {
+      submitted += *result;
+      in_flight += *result;
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << result.status() << ", falling back to blocking syncs";
+      ring_failed = true;
+      prepared = submitted;
+      if (in_flight > 0) {
+        SleepFor(MonoDelta::FromMilliseconds(1));
+      }
+    }
+
+    uint64_t idx;
+    int32_t res;
+    while (io_uring->PopCompletion(&idx, &res)) {
+      auto& sync = syncs[idx];
+      if (res == -EINTR || res == -EAGAIN) {
+        sync.BlockingSync();
+      } else {
+        sync.CompleteWithErrno(res < 0 ? -res : 0);
+      }
+      --in_flight;
+    }
+  }
+
+  for (auto i = submitted; i != syncs.size(); ++i) {
+    syncs[i].BlockingSync();
+  }
+}
+
 RWFile::~RWFile() {
 }
 
@@ -308,6 +421,10 @@ Result<uint64_t> EnvWrapper::GetFileINode(const std::string& f) {
   return target_->GetFileINode(f);
 }
 
+Result<uint64_t> EnvWrapper::GetFileNumLinks(const std::string& f) {
+  return target_->GetFileNumLinks(f);
+}
+
 Result<uint64_t> EnvWrapper::GetFileSizeOnDisk(const std::string& f) {
   return target_->GetFileSizeOnDisk(f);
 }
@@ -301,6 +301,9 @@ class Env {
 
   virtual Result<uint64_t> GetFileINode(const std::string& fname) = 0;
 
+  // Returns the number of hard links to fname.
+  virtual Result<uint64_t> GetFileNumLinks(const std::string& fname) = 0;
+
   virtual Status LinkFile(const std::string& src,
                                   const std::string& target) = 0;
 
@@ -527,6 +530,21 @@ class WritableFile {
 
   virtual Status Sync() = 0;
 
+  // First phase of SyncFiles. Writes out buffered data and returns file descriptor, that should
+  // be synced to make the data durable, or -1 if there is nothing to sync.
+  // Returns NotSupported if the file could be synced only by Sync.
+  virtual Result<int> PrepareSync();
+
+  // Second phase of SyncFiles, called with the result of syncing descriptor returned by
+  // PrepareSync.
+  virtual void FinishSync(const Status& status) {}
+
+  // Syncs several files, possibly of different tablets or even different drives. Each file is
+  // synced by its own fsync or fdatasync. When io_uring is enabled, they are submitted by a single
+  // system call and executed concurrently. Otherwise files are synced one by one.
+  // Status of syncing files[i] is stored to statuses[i].
+  static void SyncFiles(WritableFile* const* files, size_t count, Status* statuses);
+
   virtual uint64_t Size() const = 0;
 
   // Returns the filename provided when the WritableFile was constructed.
@@ -557,6 +575,8 @@ class WritableFileWrapper : public WritableFile {
   Status Close() override;
   Status Flush(FlushMode mode) override;
   Status Sync() override;
+  Result<int> PrepareSync() override { return target_->PrepareSync(); }
+  void FinishSync(const Status& status) override { target_->FinishSync(status); }
   uint64_t Size() const override { return target_->Size(); }
   const std::string& filename() const override { return target_->filename(); }
 
@@ -712,6 +732,7 @@ class EnvWrapper : public Env {
   Status DeleteRecursively(const std::string& d) override;
   Result<uint64_t> GetFileSize(const std::string& f) override;
   Result<uint64_t> GetFileINode(const std::string& f) override;
+  Result<uint64_t> GetFileNumLinks(const std::string& f) override;
   Result<uint64_t> GetFileSizeOnDisk(const std::string& f) override;
   Result<uint64_t> GetBlockSize(const std::string& f) override;
   Result<FilesystemStats> GetFilesystemStatsBytes(const std::string& f) override;
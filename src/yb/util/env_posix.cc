@@ -446,6 +446,20 @@ class PosixWritableFile : public WritableFile {
     return Status::OK();
   }
 
+  Result<int> PrepareSync() override {
+    if (!pending_sync_ || FLAGS_never_fsync) {
+      return -1;
+    }
+    pending_sync_ = false;
+    return fd_;
+  }
+
+  void FinishSync(const Status& status) override {
+    if (!status.ok()) {
+      pending_sync_ = true;
+    }
+  }
+
   uint64_t Size() const override {
     return filesize_;
   }
@@ -619,6 +633,12 @@ class PosixDirectIOWritableFile final : public PosixWritableFile {
     return DoWrite();
   }
 
+  Result<int> PrepareSync() override {
+    ThreadRestrictions::AssertIOAllowed();
+    RETURN_NOT_OK(DoWrite());
+    return -1;
+  }
+
   uint64_t Size() const override {
     return real_size_;
   }
@@ -1125,6 +1145,11 @@ class PosixEnv : public Env {
         fname, "PosixEnv::GetFileINode", [](const struct stat& sbuf) { return sbuf.st_ino; });
   }
 
+  Result<uint64_t> GetFileNumLinks(const std::string& fname) override {
+    return GetFileStat(
+        fname, "PosixEnv::GetFileNumLinks", [](const struct stat& sbuf) { return sbuf.st_nlink; });
+  }
+
   Result<uint64_t> GetFileSizeOnDisk(const std::string& fname) override {
     return GetFileStat(
         fname, "PosixEnv::GetFileSizeOnDisk", [](const struct stat& sbuf) {
@@ -29,6 +29,12 @@ Status RandomAccessFile::ReadAndValidate(
   return validator.Validate(*result);
 }
 
+void RandomAccessFile::MultiRead(ReadRequest* requests, size_t count) const {
+  for (auto* request = requests; request != requests + count; ++request) {
+    request->status = Read(request->offset, request->n, &request->result, request->scratch);
+  }
+}
+
 Status RandomAccessFile::Read(uint64_t offset, size_t n, Slice* result, char* scratch) {
   return Read(offset, n, result, reinterpret_cast<uint8_t*>(scratch));
 }
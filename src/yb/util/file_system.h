@@ -136,6 +136,21 @@ class RandomAccessFile : public FileWithUniqueId {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                               uint8_t *scratch) const = 0;
 
+  struct ReadRequest {
+    uint64_t offset;
+    size_t n;
+    uint8_t* scratch;
+    // Output, see Read.
+    Slice result;
+    Status status;
+  };
+
+  // Performs several reads, see Read for details. Implementation could issue all the reads at
+  // once, the default one does them one by one.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual void MultiRead(ReadRequest* requests, size_t count) const;
+
   // Similar to Read, but uses the given callback to validate the result.
   virtual Status ReadAndValidate(
       uint64_t offset, size_t n, Slice* result, char* scratch, const ReadValidator& validator);
@@ -18,6 +18,9 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+
+#include <vector>
 
 #ifdef __linux__
 #include <linux/fs.h>
@@ -28,7 +31,10 @@
 #include "yb/util/coding.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/errno.h"
+#include "yb/util/io_uring.h"
+#include "yb/util/logging.h"
 #include "yb/util/malloc.h"
+#include "yb/util/monotime.h"
 #include "yb/util/result.h"
 #include "yb/util/stats/iostats_context_imp.h"
 #include "yb/util/test_kill.h"
@@ -204,6 +210,92 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+void PosixRandomAccessFile::MultiRead(ReadRequest* requests, size_t count) const {
+  auto* io_uring = count > 1 ? ThreadLocalIoUring() : nullptr;
+  if (!io_uring) {
+    RandomAccessFile::MultiRead(requests, count);
+    return;
+  }
+  ThreadRestrictions::AssertIOAllowed();
+
+  std::vector<iovec> iovecs(count);
+  // Requests [0, submitted) were submitted to the kernel, in_flight of them are not completed yet.
+  // Requests [submitted, prepared) are in the submission queue.
+  size_t submitted = 0;
+  size_t prepared = 0;
+  size_t in_flight = 0;
+  bool ring_failed = false;
+  while (in_flight > 0 || (!ring_failed && submitted < count)) {
+    // Limit the number of requests in flight, so completion queue never overflows.
+    while (!ring_failed && prepared < count &&
+           in_flight + prepared - submitted < io_uring->queue_depth()) {
+      auto& request = requests[prepared];
+      iovecs[prepared] = iovec { .iov_base = request.scratch, .iov_len = request.n };
+      if (!io_uring->PrepareReadV(fd_, &iovecs[prepared], 1, request.offset, prepared)) {
+        break;
+      }
+      ++prepared;
+    }
+
+    auto result = io_uring->Submit(/* wait_nr= */ 1);
+    if (result.ok()) {
+      submitted += *result;
+      in_flight += *result;
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << filename_ << ": " << result.status()
+                                       << ", falling back to blocking reads";
+      // Requests that were not submitted are dropped by the ring, they are read directly below.
+      ring_failed = true;
+      prepared = submitted;
+      if (in_flight > 0) {
+        SleepFor(MonoDelta::FromMilliseconds(1));
+      }
+    }
+
+    uint64_t idx;
+    int32_t res;
+    while (io_uring->PopCompletion(&idx, &res)) {
+      CompleteRead(&requests[idx], res);
+      --in_flight;
+    }
+  }
+
+  for (auto* request = requests + submitted; request != requests + count; ++request) {
+    request->status = Read(request->offset, request->n, &request->result, request->scratch);
+  }
+
+  if (!use_os_buffer_) {
+    // we need to fadvise away the entire range of pages because
+    // we do not want readahead pages to be cached.
+    Fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);  // free OS pages
+  }
+}
+
+void PosixRandomAccessFile::CompleteRead(ReadRequest* request, int32_t result) const {
+  if (result == -EINTR || result == -EAGAIN) {
+    // Retry with blocking read.
+    request->status = Read(request->offset, request->n, &request->result, request->scratch);
+    return;
+  }
+  if (result < 0) {
+    request->result = Slice(request->scratch, size_t(0));
+    request->status = STATUS_IO_ERROR(filename_, -result);
+    return;
+  }
+  size_t read_bytes = result;
+  if (read_bytes < request->n) {
+    // Short read, could be the end of file. Read the rest with blocking read, that handles it.
+    Slice rest;
+    request->status = Read(
+        request->offset + read_bytes, request->n - read_bytes, &rest,
+        request->scratch + read_bytes);
+    read_bytes += rest.size();
+  } else {
+    request->status = Status::OK();
+  }
+  request->result = Slice(request->scratch, read_bytes);
+}
+
 Result<uint64_t> PosixRandomAccessFile::Size() const {
   TRACE_EVENT1("io", __PRETTY_FUNCTION__, "path", filename_);
   ThreadRestrictions::AssertIOAllowed();
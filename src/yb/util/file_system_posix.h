@@ -49,6 +49,9 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       uint8_t* scratch) const override;
 
+  // Issues all reads at once through io_uring when it is available.
+  void MultiRead(ReadRequest* requests, size_t count) const override;
+
   Result<uint64_t> Size() const override;
 
   Result<uint64_t> INode() const override;
@@ -64,6 +67,8 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 
  private:
+  void CompleteRead(ReadRequest* request, int32_t result) const;
+
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
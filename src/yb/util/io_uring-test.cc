@@ -0,0 +1,197 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/env.h"
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/io_uring.h"
+#include "yb/util/scope_exit.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DECLARE_bool(enable_io_uring);
+
+namespace yb {
+
+class IoUringTest : public YBTest {
+ protected:
+  std::string Content(size_t size) {
+    std::string result(size, 0);
+    for (size_t i = 0; i != size; ++i) {
+      result[i] = static_cast<char>('a' + i % 26);
+    }
+    return result;
+  }
+
+  void TestMultiRead(bool enable_io_uring) {
+    google::FlagSaver saver;
+    FLAGS_enable_io_uring = enable_io_uring;
+
+    constexpr size_t kFileSize = 100000;
+    const auto path = GetTestPath("multi_read");
+    const auto content = Content(kFileSize);
+    ASSERT_OK(WriteStringToFile(env_.get(), content, path));
+
+    std::unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(path, &file));
+
+    // More requests than the queue depth, the last one crosses end of file.
+    constexpr size_t kNumRequests = 100;
+    constexpr size_t kRequestSize = 4000;
+    constexpr size_t kStep = 997;
+    std::vector<std::string> buffers(kNumRequests, std::string(kRequestSize, 0));
+    std::vector<RandomAccessFile::ReadRequest> requests(kNumRequests);
+    for (size_t i = 0; i != kNumRequests; ++i) {
+      auto& request = requests[i];
+      request.offset = i + 1 == kNumRequests ? kFileSize - kRequestSize / 2 : i * kStep;
+      request.n = kRequestSize;
+      request.scratch = reinterpret_cast<uint8_t*>(buffers[i].data());
+    }
+    file->MultiRead(requests.data(), requests.size());
+
+    for (const auto& request : requests) {
+      ASSERT_OK(request.status);
+      ASSERT_EQ(content.substr(request.offset, request.n), request.result.ToBuffer());
+    }
+  }
+
+  void TestSyncFiles(bool enable_io_uring) {
+    google::FlagSaver saver;
+    FLAGS_enable_io_uring = enable_io_uring;
+
+    // More files than the queue depth, some of them without unsynced data.
+    constexpr size_t kNumFiles = 100;
+    std::vector<std::unique_ptr<WritableFile>> files(kNumFiles);
+    std::vector<WritableFile*> file_ptrs;
+    for (size_t i = 0; i != kNumFiles; ++i) {
+      ASSERT_OK(env_->NewWritableFile(GetTestPath(Format("sync_$0", i)), &files[i]));
+      if (i % 3) {
+        ASSERT_OK(files[i]->Append(Content(i * 10)));
+      }
+      file_ptrs.push_back(files[i].get());
+    }
+    std::vector<Status> statuses(kNumFiles);
+    WritableFile::SyncFiles(file_ptrs.data(), file_ptrs.size(), statuses.data());
+    for (const auto& status : statuses) {
+      ASSERT_OK(status);
+    }
+    for (size_t i = 0; i != kNumFiles; ++i) {
+      ASSERT_OK(files[i]->Close());
+      ASSERT_EQ(ASSERT_RESULT(env_->GetFileSize(files[i]->filename())), i % 3 ? i * 10 : 0);
+    }
+  }
+};
+
+TEST_F(IoUringTest, ReadWrite) {
+  auto io_uring_result = IoUring::Create(8);
+  if (!io_uring_result.ok() && io_uring_result.status().IsNotSupported()) {
+    LOG(INFO) << "Skipping test: " << io_uring_result.status();
+    return;
+  }
+  auto io_uring = ASSERT_RESULT(std::move(io_uring_result));
+  ASSERT_GE(io_uring->queue_depth(), 8);
+
+  const auto path = GetTestPath("read_write");
+  int fd = open(path.c_str(), O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+  auto se = ScopeExit([fd] { close(fd); });
+
+  auto content = Content(1000);
+  iovec write_iov[] = {
+    { .iov_base = content.data(), .iov_len = 600 },
+    { .iov_base = content.data() + 600, .iov_len = content.size() - 600 },
+  };
+  ASSERT_TRUE(io_uring->PrepareWriteV(fd, write_iov, 2, 0, 1));
+  ASSERT_EQ(ASSERT_RESULT(io_uring->Submit(1)), 1);
+  uint64_t user_data;
+  int32_t result;
+  ASSERT_TRUE(io_uring->PopCompletion(&user_data, &result));
+  ASSERT_EQ(user_data, 1);
+  ASSERT_EQ(result, content.size());
+  ASSERT_FALSE(io_uring->PopCompletion(&user_data, &result));
+
+  std::string first(100, 0);
+  std::string second(content.size(), 0);
+  iovec read_iov[] = {
+    { .iov_base = first.data(), .iov_len = first.size() },
+    { .iov_base = second.data(), .iov_len = second.size() },
+  };
+  ASSERT_TRUE(io_uring->PrepareReadV(fd, &read_iov[0], 1, 200, 2));
+  // Reads past end of file are short.
+  ASSERT_TRUE(io_uring->PrepareReadV(fd, &read_iov[1], 1, 500, 3));
+  ASSERT_EQ(ASSERT_RESULT(io_uring->Submit(2)), 2);
+  for (int i = 0; i != 2; ++i) {
+    ASSERT_TRUE(io_uring->PopCompletion(&user_data, &result));
+    if (user_data == 2) {
+      ASSERT_EQ(result, first.size());
+      ASSERT_EQ(content.substr(200, first.size()), first);
+    } else {
+      ASSERT_EQ(user_data, 3);
+      ASSERT_EQ(result, content.size() - 500);
+      ASSERT_EQ(content.substr(500), second.substr(0, result));
+    }
+  }
+}
+
+TEST_F(IoUringTest, Fsync) {
+  auto io_uring_result = IoUring::Create(8);
+  if (!io_uring_result.ok() && io_uring_result.status().IsNotSupported()) {
+    LOG(INFO) << "Skipping test: " << io_uring_result.status();
+    return;
+  }
+  auto io_uring = ASSERT_RESULT(std::move(io_uring_result));
+
+  const auto path = GetTestPath("fsync");
+  int fd = open(path.c_str(), O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+  auto se = ScopeExit([fd] { close(fd); });
+
+  auto content = Content(100);
+  ASSERT_EQ(write(fd, content.data(), content.size()), content.size());
+  ASSERT_TRUE(io_uring->PrepareFsync(fd, /* datasync= */ true, 1));
+  ASSERT_TRUE(io_uring->PrepareFsync(fd, /* datasync= */ false, 2));
+  ASSERT_EQ(ASSERT_RESULT(io_uring->Submit(2)), 2);
+  for (int i = 0; i != 2; ++i) {
+    uint64_t user_data;
+    int32_t result;
+    ASSERT_TRUE(io_uring->PopCompletion(&user_data, &result));
+    ASSERT_TRUE(user_data == 1 || user_data == 2);
+    ASSERT_EQ(result, 0);
+  }
+}
+
+TEST_F(IoUringTest, MultiReadBlocking) {
+  TestMultiRead(/* enable_io_uring= */ false);
+}
+
+TEST_F(IoUringTest, MultiReadIoUring) {
+  TestMultiRead(/* enable_io_uring= */ true);
+}
+
+TEST_F(IoUringTest, SyncFilesBlocking) {
+  TestSyncFiles(/* enable_io_uring= */ false);
+}
+
+TEST_F(IoUringTest, SyncFilesIoUring) {
+  TestSyncFiles(/* enable_io_uring= */ true);
+}
+
+} // namespace yb
@@ -0,0 +1,338 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/io_uring.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "yb/util/errno.h"
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/status_format.h"
+
+DEFINE_RUNTIME_bool(enable_io_uring, false,
+                    "Use io_uring for batches of file reads, when it is supported by the kernel. "
+                    "Falls back to blocking reads otherwise.");
+TAG_FLAG(enable_io_uring, advanced);
+
+DEFINE_UNKNOWN_uint32(io_uring_queue_depth, 64,
+                      "Number of submission queue entries in the per thread io_uring.");
+TAG_FLAG(io_uring_queue_depth, advanced);
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#define YB_HAS_IO_URING 1
+#else
+#define YB_HAS_IO_URING 0
+#endif
+
+namespace yb {
+
+#if YB_HAS_IO_URING
+
+namespace {
+
+int SysIoUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysIoUringEnter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+template <class T>
+T LoadAcquire(const T* ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template <class T>
+void StoreRelease(T* ptr, T value) {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+// Memory mapped region shared with the kernel.
+class MappedRegion {
+ public:
+  MappedRegion() = default;
+
+  MappedRegion(MappedRegion&& rhs) : data_(rhs.data_), size_(rhs.size_) {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  ~MappedRegion() {
+    if (data_) {
+      munmap(data_, size_);
+    }
+  }
+
+  Status Map(int fd, size_t size, off_t offset) {
+    auto* data = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (data == MAP_FAILED) {
+      return STATUS_FROM_ERRNO("Failed to map io_uring region", errno);
+    }
+    data_ = static_cast<char*>(data);
+    size_ = size;
+    return Status::OK();
+  }
+
+  template <class T>
+  T* At(size_t offset) const {
+    return reinterpret_cast<T*>(data_ + offset);
+  }
+
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace
+
+struct IoUring::Impl {
+  int fd = -1;
+  MappedRegion sq_ring;
+  // Empty when kernel maps submission and completion rings with a single mmap.
+  MappedRegion cq_ring;
+  MappedRegion sqes_region;
+
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t sq_mask;
+  uint32_t sq_entries;
+  uint32_t* sq_array;
+  io_uring_sqe* sqes;
+
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  uint32_t cq_mask;
+  io_uring_cqe* cqes;
+
+  // Number of prepared, but not yet submitted requests.
+  uint32_t prepared = 0;
+
+  ~Impl() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  Status Init(uint32_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd = SysIoUringSetup(queue_depth, &params);
+    if (fd < 0) {
+      auto error = errno;
+      if (error == ENOSYS || error == EPERM || error == EINVAL) {
+        return STATUS_FORMAT(
+            NotSupported, "io_uring is not supported: $0", ErrnoToString(error));
+      }
+      return STATUS_FROM_ERRNO("io_uring_setup failed", error);
+    }
+
+    size_t sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+    RETURN_NOT_OK(sq_ring.Map(fd, sq_ring_size, IORING_OFF_SQ_RING));
+    if (!single_mmap) {
+      RETURN_NOT_OK(cq_ring.Map(fd, cq_ring_size, IORING_OFF_CQ_RING));
+    }
+    RETURN_NOT_OK(sqes_region.Map(
+        fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+
+    sq_head = sq_ring.At<uint32_t>(params.sq_off.head);
+    sq_tail = sq_ring.At<uint32_t>(params.sq_off.tail);
+    sq_mask = *sq_ring.At<uint32_t>(params.sq_off.ring_mask);
+    sq_entries = *sq_ring.At<uint32_t>(params.sq_off.ring_entries);
+    sq_array = sq_ring.At<uint32_t>(params.sq_off.array);
+    sqes = sqes_region.At<io_uring_sqe>(0);
+
+    const auto& cq = single_mmap ? sq_ring : cq_ring;
+    cq_head = cq.At<uint32_t>(params.cq_off.head);
+    cq_tail = cq.At<uint32_t>(params.cq_off.tail);
+    cq_mask = *cq.At<uint32_t>(params.cq_off.ring_mask);
+    cqes = cq.At<io_uring_cqe>(params.cq_off.cqes);
+    return Status::OK();
+  }
+
+  bool Prepare(
+      uint8_t opcode, int file, const iovec* iov, int iovcnt, uint64_t offset,
+      uint64_t user_data, uint32_t op_flags = 0) {
+    // Only this thread modifies the tail, the kernel advances the head on submission.
+    const auto tail = *sq_tail;
+    if (tail - LoadAcquire(sq_head) >= sq_entries) {
+      return false;
+    }
+    const auto index = tail & sq_mask;
+    auto& sqe = sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = file;
+    sqe.off = offset;
+    sqe.addr = reinterpret_cast<uint64_t>(iov);
+    sqe.len = iovcnt;
+    sqe.fsync_flags = op_flags;
+    sqe.user_data = user_data;
+    sq_array[index] = index;
+    StoreRelease(sq_tail, tail + 1);
+    ++prepared;
+    return true;
+  }
+
+  Result<size_t> Submit(size_t wait_nr) {
+    const auto flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+      auto result = SysIoUringEnter(
+          fd, prepared, static_cast<uint32_t>(wait_nr), flags);
+      if (result >= 0) {
+        prepared -= result;
+        return result;
+      }
+      if (errno != EINTR) {
+        auto error = errno;
+        // Nothing was consumed by the kernel, so drop the prepared requests. Otherwise they would
+        // be submitted by the next call, when their buffers could be already released.
+        StoreRelease(sq_tail, *sq_tail - prepared);
+        prepared = 0;
+        return STATUS_FROM_ERRNO("io_uring_enter failed", error);
+      }
+    }
+  }
+
+  bool PopCompletion(uint64_t* user_data, int32_t* result) {
+    // Only this thread modifies the head, the kernel advances the tail on completion.
+    const auto head = *cq_head;
+    if (head == LoadAcquire(cq_tail)) {
+      return false;
+    }
+    const auto& cqe = cqes[head & cq_mask];
+    *user_data = cqe.user_data;
+    *result = cqe.res;
+    StoreRelease(cq_head, head + 1);
+    return true;
+  }
+};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t queue_depth) {
+  auto impl = std::make_unique<Impl>();
+  RETURN_NOT_OK(impl->Init(queue_depth));
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl)));
+}
+
+uint32_t IoUring::queue_depth() const {
+  return impl_->sq_entries;
+}
+
+bool IoUring::PrepareReadV(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  return impl_->Prepare(IORING_OP_READV, fd, iov, iovcnt, offset, user_data);
+}
+
+bool IoUring::PrepareWriteV(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  return impl_->Prepare(IORING_OP_WRITEV, fd, iov, iovcnt, offset, user_data);
+}
+
+bool IoUring::PrepareFsync(int fd, bool datasync, uint64_t user_data) {
+  return impl_->Prepare(
+      IORING_OP_FSYNC, fd, /* iov= */ nullptr, /* iovcnt= */ 0, /* offset= */ 0, user_data,
+      datasync ? IORING_FSYNC_DATASYNC : 0);
+}
+
+Result<size_t> IoUring::Submit(size_t wait_nr) {
+  return impl_->Submit(wait_nr);
+}
+
+bool IoUring::PopCompletion(uint64_t* user_data, int32_t* result) {
+  return impl_->PopCompletion(user_data, result);
+}
+
+#else
+
+struct IoUring::Impl {};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t queue_depth) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+uint32_t IoUring::queue_depth() const {
+  return 0;
+}
+
+bool IoUring::PrepareReadV(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+bool IoUring::PrepareWriteV(
+    int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data) {
+  return false;
+}
+
+bool IoUring::PrepareFsync(int fd, bool datasync, uint64_t user_data) {
+  return false;
+}
+
+Result<size_t> IoUring::Submit(size_t wait_nr) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+bool IoUring::PopCompletion(uint64_t* user_data, int32_t* result) {
+  return false;
+}
+
+#endif
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+IoUring::~IoUring() = default;
+
+IoUring* ThreadLocalIoUring() {
+  static std::atomic<bool> unsupported{false};
+  if (!FLAGS_enable_io_uring || unsupported.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  thread_local std::unique_ptr<IoUring> io_uring;
+  thread_local bool failed = false;
+  if (!io_uring && !failed) {
+    auto result = IoUring::Create(FLAGS_io_uring_queue_depth);
+    if (result.ok()) {
+      io_uring = std::move(*result);
+    } else if (result.status().IsNotSupported()) {
+      if (!unsupported.exchange(true, std::memory_order_relaxed)) {
+        LOG(WARNING) << result.status() << ", falling back to blocking IO";
+      }
+    } else {
+      // Could be a per thread problem, like reaching the limit of open files, so just this
+      // thread falls back to blocking IO.
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to create io_uring: " << result.status();
+      failed = true;
+    }
+  }
+  return io_uring.get();
+}
+
+} // namespace yb
@@ -0,0 +1,74 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Minimal wrapper over Linux io_uring, that talks to the kernel with raw system calls, so it does
+// not depend on liburing. Requests are prepared into the submission queue, submitted by a single
+// system call, and their results are taken from the completion queue.
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <memory>
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+class IoUring {
+ public:
+  // Creates new ring with at least queue_depth submission queue entries. Returns NotSupported
+  // if the platform or the kernel does not support io_uring.
+  static Result<std::unique_ptr<IoUring>> Create(uint32_t queue_depth);
+
+  ~IoUring();
+
+  IoUring(const IoUring&) = delete;
+  void operator=(const IoUring&) = delete;
+
+  // Number of requests that could be prepared before Submit() is called.
+  uint32_t queue_depth() const;
+
+  // Prepares vectored read from fd at offset into iov. iov should remain valid until the
+  // completion of the request is received. user_data is returned with the completion.
+  // Returns false if the submission queue is full.
+  bool PrepareReadV(int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data);
+
+  // Prepares vectored write to fd at offset from iov. Same requirements as for PrepareReadV.
+  bool PrepareWriteV(int fd, const iovec* iov, int iovcnt, uint64_t offset, uint64_t user_data);
+
+  // Prepares fsync of fd, or fdatasync if datasync is true.
+  bool PrepareFsync(int fd, bool datasync, uint64_t user_data);
+
+  // Submits prepared requests and waits until at least wait_nr completions are available.
+  // Returns the number of submitted requests. Prepared requests that were not submitted remain in
+  // the queue, but on failure they are dropped.
+  Result<size_t> Submit(size_t wait_nr = 0);
+
+  // Takes next completion from the completion queue. Returns false if there are no completions.
+  // result is the number of transferred bytes, or -errno on failure.
+  bool PopCompletion(uint64_t* user_data, int32_t* result);
+
+ private:
+  struct Impl;
+
+  explicit IoUring(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+// Returns io_uring of the current thread, or nullptr if io_uring is disabled by
+// --enable_io_uring or is not supported by the kernel. In the latter case io_uring is disabled
+// for the whole process after the first failure, so callers fall back to blocking IO.
+IoUring* ThreadLocalIoUring();
+
+} // namespace yb
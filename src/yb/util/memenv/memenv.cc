@@ -350,6 +350,14 @@ class InMemoryEnv : public EnvWrapper {
     return 0;
   }
 
+  Result<uint64_t> GetFileNumLinks(const std::string& fname) override {
+    MutexLock lock(mutex_);
+    if (file_map_.find(fname) == file_map_.end()) {
+      return STATUS(IOError, fname, "File not found");
+    }
+    return 1;
+  }
+
   Result<uint64_t> GetFileSizeOnDisk(const std::string& fname) override {
     return GetFileSize(fname);
   }
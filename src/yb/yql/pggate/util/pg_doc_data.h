@@ -14,11 +14,10 @@
 #pragma once
 
 #include "yb/common/common_fwd.h"
+#include "yb/common/pg_wire.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
-#include "yb/yql/pggate/util/pg_wire.h"
-
 namespace yb {
 namespace pggate {
 
@@ -14,7 +14,8 @@
 
 #pragma once
 
-#include "yb/yql/pggate/util/pg_wire.h"
+#include "yb/common/pg_wire.h"
+
 #include "yb/yql/pggate/ybc_pg_typedefs.h"
 
 namespace yb {
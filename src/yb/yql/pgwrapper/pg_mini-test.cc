@@ -105,6 +105,7 @@ DECLARE_string(time_source);
 
 DECLARE_bool(ysql_enable_packed_row);
 DECLARE_bool(ysql_enable_packed_row_for_colocated_table);
+DECLARE_bool(ysql_write_row_values_directly);
 
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_uint64(pg_client_session_expiration_ms);
@@ -525,6 +526,37 @@ TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(Simple)) {
   ASSERT_EQ(value, "hello");
 }
 
+// Reads all columns except the key without filtering, so values decoded by DocDB are written
+// straight to the result buffer, unless ysql_write_row_values_directly is disabled.
+TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(WriteRowValuesDirectly)) {
+  const std::string kExpected =
+      "2,30000000000,2.5,true,text,12.345,00ff;"
+      "NULL,NULL,NULL,NULL,NULL,NULL,NULL;"
+      "-1,NULL,NULL,false,,NULL,";
+
+  auto conn = ASSERT_RESULT(Connect());
+  for (auto packed_row : {false, true}) {
+    // Rows are stored in the format being checked, since they are inserted after setting the flag.
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_ysql_enable_packed_row) = packed_row;
+    ASSERT_OK(conn.Execute(
+        "CREATE TABLE t (key INT, i2 SMALLINT, i8 BIGINT, f8 DOUBLE PRECISION, b BOOL, s TEXT, "
+        "n NUMERIC, bin BYTEA, PRIMARY KEY (key ASC))"));
+    ASSERT_OK(conn.Execute(
+        "INSERT INTO t VALUES (1, 2, 30000000000, 2.5, true, 'text', 12.345, '\\x00ff')"));
+    ASSERT_OK(conn.Execute("INSERT INTO t (key) VALUES (2)"));
+    ASSERT_OK(conn.Execute("INSERT INTO t VALUES (3, -1, NULL, NULL, false, '', NULL, '')"));
+
+    for (auto write_directly : {true, false}) {
+      SCOPED_TRACE(Format("packed_row: $0, write_directly: $1", packed_row, write_directly));
+      ANNOTATE_UNPROTECTED_WRITE(FLAGS_ysql_write_row_values_directly) = write_directly;
+      auto values = ASSERT_RESULT(conn.FetchAllAsString(
+          "SELECT i2, i8, f8, b::text, s, n::text, encode(bin, 'hex') FROM t", ",", ";"));
+      ASSERT_EQ(values, kExpected);
+    }
+    ASSERT_OK(conn.Execute("DROP TABLE t"));
+  }
+}
+
 TEST_F(PgMiniTest, YB_DISABLE_TEST_IN_TSAN(Tracing)) {
   FLAGS_enable_tracing = false;
   auto conn = ASSERT_RESULT(Connect());
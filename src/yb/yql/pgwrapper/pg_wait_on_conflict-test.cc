@@ -19,6 +19,7 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/fs/fs_manager.h"
+#include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/tserver/mini_tablet_server.h"
@@ -37,11 +38,13 @@
 #include "yb/util/async_util.h"
 #include "yb/util/backoff_waiter.h"
 #include "yb/util/env.h"
+#include "yb/util/metrics.h"
 
 #include "yb/util/pb_util.h"
 
 DECLARE_bool(enable_wait_queues);
 DECLARE_bool(enable_deadlock_detection);
+DECLARE_bool(report_released_waiters_to_deadlock_detector);
 DECLARE_bool(TEST_select_all_status_tablets);
 DECLARE_string(ysql_pg_conf_csv);
 DECLARE_bool(enable_automatic_tablet_splitting);
@@ -58,6 +61,8 @@ DECLARE_bool(ysql_enable_pack_full_row_update);
 
 using namespace std::literals;
 
+METRIC_DECLARE_gauge_uint64(deadlock_detector_waiters);
+
 namespace yb {
 namespace pgwrapper {
 
@@ -433,6 +438,66 @@ TEST_F(PgWaitQueuesTest, YB_DISABLE_TEST_IN_TSAN(MultipleWaitersUnblock)) {
   thread_holder.WaitAndStop(10s * kTimeMultiplier);
 }
 
+// Waiters that were released are removed from the wait-for graph, and a deadlock among the same
+// transactions is still detected by the immediate probes, without waiting for the periodic scan.
+TEST_F(PgWaitQueuesTest, YB_DISABLE_TEST_IN_TSAN(ReportReleasedWaiters)) {
+  FLAGS_report_released_waiters_to_deadlock_detector = true;
+
+  auto detector_waiters = [this] {
+    uint64_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        result += METRIC_deadlock_detector_waiters.Instantiate(
+            tablet->GetTabletMetricsEntity(), 0)->value();
+      }
+    }
+    return result;
+  };
+
+  auto setup_conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(setup_conn.Execute("CREATE TABLE foo (k INT PRIMARY KEY, v INT)"));
+  ASSERT_OK(setup_conn.Execute("insert into foo select generate_series(0, 10), 0"));
+
+  auto conn1 = ASSERT_RESULT(Connect());
+  auto conn2 = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn1.StartTransaction(IsolationLevel::SNAPSHOT_ISOLATION));
+  ASSERT_OK(conn2.StartTransaction(IsolationLevel::SNAPSHOT_ISOLATION));
+
+  // conn2 waits for conn1 and is released when conn1 rolls back its subtransaction.
+  ASSERT_OK(conn1.Execute("SAVEPOINT a"));
+  ASSERT_OK(conn1.Execute("UPDATE foo SET v=1 WHERE k=0"));
+  auto released = std::async(std::launch::async, [&conn2] {
+    return conn2.Execute("UPDATE foo SET v=2 WHERE k=0");
+  });
+  ASSERT_OK(WaitFor([&conn2] { return conn2.IsBusy(); }, 1s * kTimeMultiplier, "conn2 blocked"));
+  ASSERT_OK(WaitFor([&detector_waiters] { return detector_waiters() > 0; },
+                    5s * kTimeMultiplier, "Waiter registered in deadlock detector"));
+  ASSERT_OK(conn1.Execute("ROLLBACK TO SAVEPOINT a"));
+  ASSERT_OK(released.get());
+  // Released waiter is removed from the detector right away. The periodic scan would keep it, since
+  // its transaction is still running.
+  ASSERT_OK(WaitFor([&detector_waiters] { return detector_waiters() == 0; },
+                    5s * kTimeMultiplier, "Released waiter removed from deadlock detector"));
+
+  // Now create a deadlock between the same transactions.
+  ASSERT_OK(conn1.Execute("UPDATE foo SET v=1 WHERE k=1"));
+  auto blocked = std::async(std::launch::async, [&conn1] {
+    return conn1.Execute("UPDATE foo SET v=1 WHERE k=0");
+  });
+  ASSERT_OK(WaitFor([&conn1] { return conn1.IsBusy(); }, 1s * kTimeMultiplier, "conn1 blocked"));
+
+  auto start = CoarseMonoClock::Now();
+  auto status2 = conn2.Execute("UPDATE foo SET v=2 WHERE k=1");
+  auto status1 = blocked.get();
+  ASSERT_LE(CoarseMonoClock::Now() - start, 10s * kTimeMultiplier);
+
+  // At least one of the transactions is aborted to resolve the deadlock.
+  auto committed1 = status1.ok() && conn1.CommitTransaction().ok();
+  auto committed2 = status2.ok() && conn2.CommitTransaction().ok();
+  ASSERT_FALSE(committed1 && committed2);
+}
+
 TEST_F(PgWaitQueuesTest, YB_DISABLE_TEST_IN_TSAN(LongWaitBeforeDeadlock)) {
   auto setup_conn = ASSERT_RESULT(Connect());
   constexpr int kClients = 2;